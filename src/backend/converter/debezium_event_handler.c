@@ -30,6 +30,7 @@ extern int myConnectorId;
 extern bool synchdb_log_event_on_error;
 extern char * g_eventStr;
 extern HTAB * dataCacheHash;
+extern bool synchdb_snapshot_defer_index_build;
 
 static DdlType name_to_ddltype(const char * name);
 static DbzType getDbzTypeFromString(const char * typestring);
@@ -42,6 +43,7 @@ static DBZ_DML * parseDBZDML(Jsonb * jb, char op, ConnectorType type,
 		Jsonb * source, bool isfirst, bool islast);
 
 static bool isInSnapshot = false;
+static bool deferredIndexChecked = false;
 
 static DdlType
 name_to_ddltype(const char * name)
@@ -606,10 +608,14 @@ parseDBZDML(Jsonb * jb, char op, ConnectorType type, Jsonb * source, bool isfirs
 	DataCacheKey cachekey = {0};
 	DataCacheEntry * cacheentry;
 	Bitmapset * pkattrs;
+	Bitmapset * keyattrs;
 
 	/* these are the components that compose of an object ID before transformation */
 	char * db = NULL, * schema = NULL, * table = NULL;
 
+	/* source object ID as received, set if it has to be resolved */
+	char * srcobjid = NULL;
+
 	initStringInfo(&strinfo);
 	initStringInfo(&objid);
 	dbzdml = (DBZ_DML *) palloc0(sizeof(DBZ_DML));
@@ -686,47 +692,92 @@ parseDBZDML(Jsonb * jb, char op, ConnectorType type, Jsonb * source, bool isfirs
 			dbzdml->dbz_ts_ms = strtoull(strinfo.data, NULL, 10);
 	}
 
-	/* table name transformation and normalized objectid to lower case */
-	for (j = 0; j < objid.len; j++)
-		objid.data[j] = (char) pg_tolower((unsigned char) objid.data[j]);
+	dbzdml->op = op;
 
-	dbzdml->remoteObjectId = pstrdup(objid.data);
-	dbzdml->mappedObjectId = transform_object_name(dbzdml->remoteObjectId, "table");
-	if (dbzdml->mappedObjectId)
+	/* resolve the source object with a single probe if it has been seen before */
+	cacheentry = fc_get_resolved_object(objid.data, dbzdml);
+	found = (cacheentry != NULL);
+	if (!found)
 	{
-		char * objectIdCopy = pstrdup(dbzdml->mappedObjectId);
-		char * db2 = NULL, * table2 = NULL, * schema2 = NULL;
+		srcobjid = pstrdup(objid.data);
 
-		splitIdString(objectIdCopy, &db2, &schema2, &table2, false);
-		if (!table2)
+		/* table name transformation and normalized objectid to lower case */
+		for (j = 0; j < objid.len; j++)
+			objid.data[j] = (char) pg_tolower((unsigned char) objid.data[j]);
+
+		dbzdml->remoteObjectId = pstrdup(objid.data);
+		dbzdml->mappedObjectId = transform_object_name(dbzdml->remoteObjectId, "table");
+		if (dbzdml->mappedObjectId)
 		{
-			/* save the error */
-			char * msg = palloc0(SYNCHDB_ERRMSG_SIZE);
-			snprintf(msg, SYNCHDB_ERRMSG_SIZE, "transformed object ID is invalid: %s",
-					dbzdml->mappedObjectId);
-			set_shm_connector_errmsg(myConnectorId, msg);
+			char * objectIdCopy = pstrdup(dbzdml->mappedObjectId);
+			char * db2 = NULL, * table2 = NULL, * schema2 = NULL;
 
-			/* trigger pg's error shutdown routine */
-			elog(ERROR, "%s", msg);
+			splitIdString(objectIdCopy, &db2, &schema2, &table2, false);
+			if (!table2)
+			{
+				/* save the error */
+				char * msg = palloc0(SYNCHDB_ERRMSG_SIZE);
+				snprintf(msg, SYNCHDB_ERRMSG_SIZE, "transformed object ID is invalid: %s",
+						dbzdml->mappedObjectId);
+				set_shm_connector_errmsg(myConnectorId, msg);
+
+				/* trigger pg's error shutdown routine */
+				elog(ERROR, "%s", msg);
+			}
+			else
+				dbzdml->table = pstrdup(table2);
+
+			if (schema2)
+				dbzdml->schema = pstrdup(schema2);
+			else
+				dbzdml->schema = pstrdup("public");
 		}
 		else
-			dbzdml->table = pstrdup(table2);
+		{
+			/* by default, remote's db is mapped to schema in pg */
+			dbzdml->schema = pstrdup(db);
+			dbzdml->table = pstrdup(table);
 
-		if (schema2)
-			dbzdml->schema = pstrdup(schema2);
-		else
-			dbzdml->schema = pstrdup("public");
-	}
-	else
-	{
-		/* by default, remote's db is mapped to schema in pg */
-		dbzdml->schema = pstrdup(db);
-		dbzdml->table = pstrdup(table);
+			resetStringInfo(&strinfo);
+			appendStringInfo(&strinfo, "%s.%s", dbzdml->schema, dbzdml->table);
+			dbzdml->mappedObjectId = pstrdup(strinfo.data);
+		}
+
+		/*
+		 * before parsing, we need to make sure the target namespace and table
+		 * do exist in PostgreSQL, and also fetch their attribute type IDs. PG
+		 * automatically converts upper case letters to lower when they are
+		 * created. However, catalog lookups are case sensitive so here we must
+		 * convert db and table to all lower case letters.
+		 */
+		for (j = 0; j < strlen(dbzdml->schema); j++)
+			dbzdml->schema[j] = (char) pg_tolower((unsigned char) dbzdml->schema[j]);
+
+		for (j = 0; j < strlen(dbzdml->table); j++)
+			dbzdml->table[j] = (char) pg_tolower((unsigned char) dbzdml->table[j]);
 
-		resetStringInfo(&strinfo);
-		appendStringInfo(&strinfo, "%s.%s", dbzdml->schema, dbzdml->table);
-		dbzdml->mappedObjectId = pstrdup(strinfo.data);
+		/* prepare cache key */
+		strlcpy(cachekey.schema, dbzdml->schema, sizeof(cachekey.schema));
+		strlcpy(cachekey.table, dbzdml->table, sizeof(cachekey.table));
+
+		cacheentry = (DataCacheEntry *) hash_search(dataCacheHash, &cachekey, HASH_ENTER, &found);
+
+		if (!found)
+		{
+			/* a new entry only becomes valid once it is fully populated */
+			cacheentry->tupdesc = NULL;
+			cacheentry->typeidhash = NULL;
+			cacheentry->namejsonposhash = NULL;
+			cacheentry->valid = false;
+		}
+		else if (!cacheentry->valid)
+		{
+			/* the target table has changed since it was cached, rebuild the entry */
+			fc_clear_data_cache_entry(cacheentry);
+			found = false;
+		}
 	}
+
 	/* free the temporary pointers */
 	if (db)
 	{
@@ -744,26 +795,6 @@ parseDBZDML(Jsonb * jb, char op, ConnectorType type, Jsonb * source, bool isfirs
 		table = NULL;
 	}
 
-	dbzdml->op = op;
-
-	/*
-	 * before parsing, we need to make sure the target namespace and table
-	 * do exist in PostgreSQL, and also fetch their attribute type IDs. PG
-	 * automatically converts upper case letters to lower when they are
-	 * created. However, catalog lookups are case sensitive so here we must
-	 * convert db and table to all lower case letters.
-	 */
-	for (j = 0; j < strlen(dbzdml->schema); j++)
-		dbzdml->schema[j] = (char) pg_tolower((unsigned char) dbzdml->schema[j]);
-
-	for (j = 0; j < strlen(dbzdml->table); j++)
-		dbzdml->table[j] = (char) pg_tolower((unsigned char) dbzdml->table[j]);
-
-	/* prepare cache key */
-	strlcpy(cachekey.schema, dbzdml->schema, sizeof(cachekey.schema));
-	strlcpy(cachekey.table, dbzdml->table, sizeof(cachekey.table));
-
-	cacheentry = (DataCacheEntry *) hash_search(dataCacheHash, &cachekey, HASH_ENTER, &found);
 	if (found)
 	{
 		/* use the cached data type hash for lookup later */
@@ -771,6 +802,7 @@ parseDBZDML(Jsonb * jb, char op, ConnectorType type, Jsonb * source, bool isfirs
 		dbzdml->tableoid = cacheentry->tableoid;
 		namejsonposhash = cacheentry->namejsonposhash;
 		dbzdml->natts = cacheentry->natts;
+		dbzdml->haskeyidx = cacheentry->haskeyidx;
 	}
 	else
 	{
@@ -826,6 +858,18 @@ parseDBZDML(Jsonb * jb, char op, ConnectorType type, Jsonb * source, bool isfirs
 		/* get primary key bitmapset */
 		pkattrs = RelationGetIndexAttrBitmap(rel, INDEX_ATTR_BITMAP_PRIMARY_KEY);
 
+		/*
+		 * get the key columns of the index the apply path uses to locate old
+		 * tuples. This mirrors GetRelationIdentityOrPK(): replica identity
+		 * index first, then primary key. Only these columns of a before image
+		 * need to be converted when such index exists.
+		 */
+		keyattrs = RelationGetIndexAttrBitmap(rel, INDEX_ATTR_BITMAP_IDENTITY_KEY);
+		if (!keyattrs && pkattrs)
+			keyattrs = bms_copy(pkattrs);
+		cacheentry->haskeyidx = (keyattrs != NULL);
+		dbzdml->haskeyidx = cacheentry->haskeyidx;
+
 		/* cache tupdesc and save natts for later use */
 		cacheentry->tupdesc = CreateTupleDescCopy(tupdesc);
 		dbzdml->natts = tupdesc->natts;
@@ -843,11 +887,14 @@ parseDBZDML(Jsonb * jb, char op, ConnectorType type, Jsonb * source, bool isfirs
 				entry->typemod = attr->atttypmod;
 				if (pkattrs && bms_is_member(attnum - FirstLowInvalidHeapAttributeNumber, pkattrs))
 					entry->ispk =true;
+				entry->iskey = (keyattrs &&
+						bms_is_member(attnum - FirstLowInvalidHeapAttributeNumber, keyattrs));
 				get_type_category_preferred(entry->oid, &entry->typcategory, &entry->typispreferred);
 				strlcpy(entry->typname, format_type_be(attr->atttypid), NAMEDATALEN);
 			}
 		}
 		bms_free(pkattrs);
+		bms_free(keyattrs);
 		table_close(rel, AccessShareLock);
 
 		/*
@@ -864,6 +911,14 @@ parseDBZDML(Jsonb * jb, char op, ConnectorType type, Jsonb * source, bool isfirs
 
 			elog(ERROR, "cannot parse schema section of change event JSON. Abort");
 		}
+		cacheentry->valid = true;
+	}
+
+	/* remember the resolution for the next DML on the same source object */
+	if (srcobjid)
+	{
+		fc_set_resolved_object(srcobjid, dbzdml, cacheentry);
+		pfree(srcobjid);
 	}
 
 	switch(op)
@@ -1000,7 +1055,7 @@ parseDBZDML(Jsonb * jb, char op, ConnectorType type, Jsonb * source, bool isfirs
 
 						/* transform the column name if needed */
 						initStringInfo(&colNameObjId);
-						appendStringInfo(&colNameObjId, "%s.%s", objid.data, colval->name);
+						appendStringInfo(&colNameObjId, "%s.%s", dbzdml->remoteObjectId, colval->name);
 						mappedColumnName = transform_object_name(colNameObjId.data, "column");
 						if (mappedColumnName)
 						{
@@ -1019,6 +1074,7 @@ parseDBZDML(Jsonb * jb, char op, ConnectorType type, Jsonb * source, bool isfirs
 							colval->position = entry->position;
 							colval->typemod = entry->typemod;
 							colval->ispk = entry->ispk;
+							colval->iskey = entry->iskey;
 							colval->typcategory = entry->typcategory;
 							colval->typispreferred = entry->typispreferred;
 							colval->typname = pstrdup(entry->typname);
@@ -1159,7 +1215,7 @@ parseDBZDML(Jsonb * jb, char op, ConnectorType type, Jsonb * source, bool isfirs
 
 						/* transform the column name if needed */
 						initStringInfo(&colNameObjId);
-						appendStringInfo(&colNameObjId, "%s.%s", objid.data, colval->name);
+						appendStringInfo(&colNameObjId, "%s.%s", dbzdml->remoteObjectId, colval->name);
 						mappedColumnName = transform_object_name(colNameObjId.data, "column");
 
 						if (mappedColumnName)
@@ -1179,6 +1235,7 @@ parseDBZDML(Jsonb * jb, char op, ConnectorType type, Jsonb * source, bool isfirs
 							colval->position = entry->position;
 							colval->typemod = entry->typemod;
 							colval->ispk = entry->ispk;
+							colval->iskey = entry->iskey;
 							colval->typcategory = entry->typcategory;
 							colval->typispreferred = entry->typispreferred;
 							colval->typname = pstrdup(entry->typname);
@@ -1342,7 +1399,7 @@ parseDBZDML(Jsonb * jb, char op, ConnectorType type, Jsonb * source, bool isfirs
 
 							/* transform the column name if needed */
 							initStringInfo(&colNameObjId);
-							appendStringInfo(&colNameObjId, "%s.%s", objid.data, colval->name);
+							appendStringInfo(&colNameObjId, "%s.%s", dbzdml->remoteObjectId, colval->name);
 							mappedColumnName = transform_object_name(colNameObjId.data, "column");
 							if (mappedColumnName)
 							{
@@ -1361,6 +1418,7 @@ parseDBZDML(Jsonb * jb, char op, ConnectorType type, Jsonb * source, bool isfirs
 								colval->position = entry->position;
 								colval->typemod = entry->typemod;
 								colval->ispk = entry->ispk;
+								colval->iskey = entry->iskey;
 								colval->typcategory = entry->typcategory;
 								colval->typispreferred = entry->typispreferred;
 								colval->typname = pstrdup(entry->typname);
@@ -1444,9 +1502,13 @@ fc_processDBZChangeEvent(const char * event, SynchdbStatistics * myBatchStats,
 	bool islastsnapshot = false;
 	int ret = -1;
 	struct timeval tv;
+	instr_time lat;
 	Datum datum_elems[2] = {CStringGetTextDatum("payload"), CStringGetTextDatum("source")};
 	Datum datum_payload[1] = {CStringGetTextDatum("payload")};
 
+	/* parse latency includes the conversion of the event text to jsonb */
+	start_connector_latency(&lat);
+
 	tempContext = AllocSetContextCreate(TopMemoryContext,
 										"FORMAT_CONVERTER",
 										ALLOCSET_DEFAULT_SIZES);
@@ -1544,6 +1606,16 @@ fc_processDBZChangeEvent(const char * event, SynchdbStatistics * myBatchStats,
 	    {
 	    	if (get_shm_connector_stage_enum(myConnectorId) != STAGE_CHANGE_DATA_CAPTURE)
 	    		set_shm_connector_stage(myConnectorId, STAGE_CHANGE_DATA_CAPTURE);
+
+	    	/*
+	    	 * build indexes left deferred by a snapshot that was interrupted
+	    	 * before it could complete - checked once per worker
+	    	 */
+	    	if (!deferredIndexChecked)
+	    	{
+	    		ra_buildDeferredIndexes(name);
+	    		deferredIndexChecked = true;
+	    	}
 	    }
 	    pfree(tmp);
 
@@ -1674,6 +1746,8 @@ fc_processDBZChangeEvent(const char * event, SynchdbStatistics * myBatchStats,
     		return -1;
     	}
 
+    	record_event_latency(LATENCY_OP_DDL, LATENCY_STAGE_PARSE, &lat);
+
     	/* (2) convert */
     	set_shm_connector_state(myConnectorId, STATE_CONVERTING);
     	pgddl = convert2PGDDL(dbzddl, type);
@@ -1687,6 +1761,8 @@ fc_processDBZChangeEvent(const char * event, SynchdbStatistics * myBatchStats,
     		return -1;
     	}
 
+    	record_event_latency(LATENCY_OP_DDL, LATENCY_STAGE_CONVERT, &lat);
+
     	/* (3) execute */
     	set_shm_connector_state(myConnectorId, STATE_EXECUTING);
     	ret = ra_executePGDDL(pgddl, type);
@@ -1701,6 +1777,8 @@ fc_processDBZChangeEvent(const char * event, SynchdbStatistics * myBatchStats,
     		return -1;
     	}
 
+    	record_event_latency(LATENCY_OP_DDL, LATENCY_STAGE_EXECUTE, &lat);
+
 		/* (4) update attribute map table */
     	updateSynchdbAttribute(dbzddl, pgddl, get_shm_connector_type_enum(myConnectorId), name);
 
@@ -1729,7 +1807,11 @@ fc_processDBZChangeEvent(const char * event, SynchdbStatistics * myBatchStats,
 
 		/* (6) clean up */
     	if (islastsnapshot)
+    	{
     		isInSnapshot = false;
+    		ra_buildDeferredIndexes(name);
+    		deferredIndexChecked = true;
+    	}
 
     	set_shm_connector_state(myConnectorId, (islastsnapshot &&
     			((flag & CONNFLAG_SCHEMA_SYNC_MODE) || (flag & CONNFLAG_INITIAL_SNAPSHOT_MODE)) ?
@@ -1742,6 +1824,7 @@ fc_processDBZChangeEvent(const char * event, SynchdbStatistics * myBatchStats,
         /* Process DML event */
     	DBZ_DML * dbzdml = NULL;
     	PG_DML * pgdml = NULL;
+    	LatencyOp latop = latency_op_from_char(strinfo.data[0]);
 
     	/* (1) parse */
     	set_shm_connector_state(myConnectorId, STATE_PARSING);
@@ -1755,6 +1838,8 @@ fc_processDBZChangeEvent(const char * event, SynchdbStatistics * myBatchStats,
 			return -1;
 		}
 
+    	record_event_latency(latop, LATENCY_STAGE_PARSE, &lat);
+
     	/* (2) convert */
     	set_shm_connector_state(myConnectorId, STATE_CONVERTING);
     	pgdml = convert2PGDML(dbzdml, type);
@@ -1768,8 +1853,13 @@ fc_processDBZChangeEvent(const char * event, SynchdbStatistics * myBatchStats,
     		return -1;
     	}
 
+    	record_event_latency(latop, LATENCY_STAGE_CONVERT, &lat);
+
     	/* (3) execute */
     	set_shm_connector_state(myConnectorId, STATE_EXECUTING);
+    	if (isInSnapshot && synchdb_snapshot_defer_index_build && pgdml->op == 'r')
+    		ra_deferSecondaryIndexes(name, pgdml->tableoid);
+
     	ret = ra_executePGDML(pgdml, type, myBatchStats, isInSnapshot);
     	if(ret)
     	{
@@ -1782,6 +1872,8 @@ fc_processDBZChangeEvent(const char * event, SynchdbStatistics * myBatchStats,
     		return -1;
     	}
 
+    	record_event_latency(latop, LATENCY_STAGE_EXECUTE, &lat);
+
     	/* (4) record only the first and last change event's processing timestamps only */
     	if (islast)
     	{
@@ -1803,7 +1895,11 @@ fc_processDBZChangeEvent(const char * event, SynchdbStatistics * myBatchStats,
 
        	/* (5) clean up */
     	if (islastsnapshot)
+    	{
     		isInSnapshot = false;
+    		ra_buildDeferredIndexes(name);
+    		deferredIndexChecked = true;
+    	}
 
     	set_shm_connector_state(myConnectorId, (islastsnapshot &&
     			((flag & CONNFLAG_SCHEMA_SYNC_MODE) || (flag & CONNFLAG_INITIAL_SNAPSHOT_MODE)) ?
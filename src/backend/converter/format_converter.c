@@ -29,6 +29,7 @@
 #include "fmgr.h"
 #include "utils/jsonb.h"
 #include "utils/builtins.h"
+#include "utils/numeric.h"
 #include "catalog/namespace.h"
 #include "utils/lsyscache.h"
 #include "utils/rel.h"
@@ -37,9 +38,11 @@
 #include <sys/time.h>
 #include <dlfcn.h>
 #include "common/base64.h"
+#include "utils/codec_utils.h"
 #include "port/pg_bswap.h"
 #include "utils/datetime.h"
 #include "utils/memutils.h"
+#include "utils/inval.h"
 
 /* synchdb includes */
 #include "converter/format_converter.h"
@@ -55,6 +58,9 @@ extern int myConnectorId;
 
 /* data transformation related hash tables */
 HTAB * dataCacheHash = NULL;
+static HTAB * objResolveHash = NULL;
+static uint32 objResolveGeneration = 0;
+static bool dataCacheCallbackRegistered = false;
 static HTAB * objectMappingHash = NULL;
 static HTAB * transformExpressionHash = NULL;
 
@@ -255,6 +261,9 @@ DatatypeHashEntry sqlserver_defaultTypeMappings[] =
 
 #define SIZE_SQLSERVER_DATATYPE_MAPPING (sizeof(sqlserver_defaultTypeMappings) / sizeof(DatatypeHashEntry))
 
+/* widest fixed-width decimal converted to a Datum without a string */
+#define NUMERIC_FASTPATH_BYTES 16
+
 static void remove_precision(char * str, bool * removed);
 static int count_active_columns(TupleDesc tupdesc);
 static void bytearray_to_escaped_string(const unsigned char *byte_array,
@@ -286,6 +295,8 @@ static char * composeAlterColumnClauses(const char * objid, ConnectorType type,
 static void expand_struct_value(char * in, DBZ_DML_COLUMN_VALUE * colval,
 		ConnectorType conntype);
 static char * handle_base64_to_numeric_with_scale(const char * in, int scale);
+static bool handle_base64_to_numeric_datum(const char * in, Oid datatype, int scale,
+		int typmod, Datum * result);
 static char * handle_string_to_numeric(const char * in, bool addquote);
 static char * handle_base64_to_bit(const char * in, bool addquote, int typemod);
 static char * handle_string_to_bit(const char * in, bool addquote);
@@ -313,6 +324,8 @@ static char * handle_data_by_type_category(char * in, DBZ_DML_COLUMN_VALUE * col
 		ConnectorType conntype, bool addquote);
 static char * processDataByType(DBZ_DML_COLUMN_VALUE * colval, bool addquote,
 		char * remoteObjectId, ConnectorType type);
+static void processDataByTypeToPG(DBZ_DML_COLUMN_VALUE * colval,
+		PG_DML_COLUMN_VALUE * pgcolval, char * remoteObjectId, ConnectorType type);
 
 /*
  * remove_precision
@@ -375,12 +388,9 @@ bytearray_to_escaped_string(const unsigned char *byte_array, size_t length, char
 	strcpy(output_string, "'\\x");
 	ptr = output_string + 3; /* Skip "'\\x" */
 
-	for (size_t i = 0; i < length; i++)
-	{
-		sprintf(ptr, "%02X", byte_array[i]);
-		ptr += 2;
-	}
-	strcat(ptr, "'");
+	codec_hex_encode(byte_array, length, ptr);
+	ptr += length * 2;
+	strcpy(ptr, "'");
 }
 
 /*
@@ -1660,11 +1670,7 @@ handle_base64_to_numeric_with_scale(const char * in, int scale)
 	char * out = NULL;
 	bool isneg = false;
 
-#if SYNCHDB_PG_MAJOR_VERSION >= 1800
-	tmpoutlen = pg_b64_decode(in, strlen(in), tmpout, tmpoutlen);
-#else
-	tmpoutlen = pg_b64_decode(in, strlen(in), (char *)tmpout, tmpoutlen);
-#endif
+	tmpoutlen = codec_b64_decode(in, strlen(in), tmpout, tmpoutlen);
 	value = derive_decimal_string_from_byte(tmpout, tmpoutlen);
 	/* if value is negative, we set isneg = true */
 	if (value[0] == '-')
@@ -1756,11 +1762,7 @@ handle_base64_to_bit(const char * in, bool addquote, int typemod)
 	unsigned char * tmpout = (unsigned char *) palloc0(tmpoutlen);
 	char * out = NULL;
 
-#if SYNCHDB_PG_MAJOR_VERSION >= 1800
-	tmpoutlen = pg_b64_decode(in, strlen(in), tmpout, tmpoutlen);
-#else
-	tmpoutlen = pg_b64_decode(in, strlen(in), (char*)tmpout, tmpoutlen);
-#endif
+	tmpoutlen = codec_b64_decode(in, strlen(in), tmpout, tmpoutlen);
 	if (addquote)
 	{
 		/* 8 bits per byte + 2 single quotes + b + terminating null */
@@ -1884,11 +1886,7 @@ handle_base64_to_date(const char * in, bool addquote, int timerep)
 	int tmpoutlen = pg_b64_dec_len(strlen(in));
 	unsigned char * tmpout = (unsigned char *) palloc0(tmpoutlen + 1);
 
-#if SYNCHDB_PG_MAJOR_VERSION >= 1800
-	tmpoutlen = pg_b64_decode(in, strlen(in), tmpout, tmpoutlen);
-#else
-	tmpoutlen = pg_b64_decode(in, strlen(in), (char *)tmpout, tmpoutlen);
-#endif
+	tmpoutlen = codec_b64_decode(in, strlen(in), tmpout, tmpoutlen);
 	input = derive_value_from_byte(tmpout, tmpoutlen);
 	return construct_datestr(input, addquote, timerep);
 }
@@ -1994,11 +1992,7 @@ handle_base64_to_timestamp(const char * in, bool addquote, int timerep, int type
 	int tmpoutlen = pg_b64_dec_len(strlen(in));
 	unsigned char * tmpout = (unsigned char *) palloc0(tmpoutlen + 1);
 
-#if SYNCHDB_PG_MAJOR_VERSION >= 1800
-	tmpoutlen = pg_b64_decode(in, strlen(in), tmpout, tmpoutlen);
-#else
-	tmpoutlen = pg_b64_decode(in, strlen(in), (char *)tmpout, tmpoutlen);
-#endif
+	tmpoutlen = codec_b64_decode(in, strlen(in), tmpout, tmpoutlen);
 	input = derive_value_from_byte(tmpout, tmpoutlen);
 	return construct_timestampstr(input, addquote, timerep, typemod);
 }
@@ -2173,11 +2167,7 @@ handle_base64_to_time(const char * in, bool addquote, int timerep, int typemod)
 	int tmpoutlen = pg_b64_dec_len(strlen(in));
 	unsigned char * tmpout = (unsigned char *) palloc0(tmpoutlen + 1);
 
-#if SYNCHDB_PG_MAJOR_VERSION >= 1800
-	tmpoutlen = pg_b64_decode(in, strlen(in), tmpout, tmpoutlen);
-#else
-	tmpoutlen = pg_b64_decode(in, strlen(in), (char *)tmpout, tmpoutlen);
-#endif
+	tmpoutlen = codec_b64_decode(in, strlen(in), tmpout, tmpoutlen);
 	input = derive_value_from_byte(tmpout, tmpoutlen);
 	return construct_timetr(input, addquote, timerep, typemod);
 }
@@ -2207,11 +2197,7 @@ handle_base64_to_byte(const char * in, bool addquote)
 	unsigned char * tmpout = (unsigned char *) palloc0(tmpoutlen);
 	char * out = NULL;
 
-#if SYNCHDB_PG_MAJOR_VERSION >= 1800
-	tmpoutlen = pg_b64_decode(in, strlen(in), tmpout, tmpoutlen);
-#else
-	tmpoutlen = pg_b64_decode(in, strlen(in), (char*)tmpout, tmpoutlen);
-#endif
+	tmpoutlen = codec_b64_decode(in, strlen(in), tmpout, tmpoutlen);
 	if (addquote)
 	{
 		/* hexstring + 2 single quotes + '\x' + terminating null */
@@ -2380,11 +2366,7 @@ handle_base64_to_interval(const char * in, bool addquote, int timerep, int typem
 	unsigned char * tmpout = (unsigned char *) palloc0(tmpoutlen);
 	long long input = 0;
 
-#if SYNCHDB_PG_MAJOR_VERSION >= 1800
-	tmpoutlen = pg_b64_decode(in, strlen(in), tmpout, tmpoutlen);
-#else
-	tmpoutlen = pg_b64_decode(in, strlen(in), (char *)tmpout, tmpoutlen);
-#endif
+	tmpoutlen = codec_b64_decode(in, strlen(in), tmpout, tmpoutlen);
 	input = derive_value_from_byte(tmpout, tmpoutlen);
 	return construct_intervalstr(input, addquote, timerep, typemod);
 }
@@ -2618,6 +2600,155 @@ handle_data_by_type_category(char * in, DBZ_DML_COLUMN_VALUE * colval, Connector
 	return out;
 }
 
+/*
+ * handle_base64_to_numeric_datum
+ *
+ * fast path for fixed-width decimals that fit in 64 or 128 bits. The
+ * two's-complement bytes are folded into an integer and the Datum is built
+ * directly, skipping the decimal string round trip. Returns false when the
+ * value does not qualify and the string based conversion must be used.
+ */
+static bool
+handle_base64_to_numeric_datum(const char * in, Oid datatype, int scale,
+		int typmod, Datum * result)
+{
+	unsigned char bytes[NUMERIC_FASTPATH_BYTES + 2];
+	int len = strlen(in);
+	int nbytes;
+	int i;
+	Datum num;
+
+	/* 16 bytes take at most 24 base64 characters */
+	if (len == 0 || len > 24 || scale < 0)
+		return false;
+
+	if (datatype == INT8OID && scale != 0)
+		return false;
+
+	nbytes = codec_b64_decode(in, len, bytes, sizeof(bytes));
+	if (nbytes <= 0 || nbytes > NUMERIC_FASTPATH_BYTES)
+		return false;
+
+	if (nbytes <= (int) sizeof(int64))
+	{
+		/* sign extend from the first byte, then shift the rest in */
+		int64 val = (int8) bytes[0];
+
+		for (i = 1; i < nbytes; i++)
+			val = (int64) (((uint64) val << 8) | bytes[i]);
+
+		if (datatype == INT8OID)
+		{
+			*result = Int64GetDatum(val);
+			return true;
+		}
+		num = NumericGetDatum(int64_div_fast_to_numeric(val, scale));
+	}
+	else
+	{
+#ifdef HAVE_INT128
+		/*
+		 * there is no public constructor of numeric from int128, so format
+		 * the digits with the decimal point in one pass and use numeric_in
+		 */
+		int128 val = (int8) bytes[0];
+		uint128 mag;
+		char buffer[128];
+		char * p = buffer + sizeof(buffer) - 1;
+		int ndigits = 0;
+
+		if (scale > 64)
+			return false;
+
+		for (i = 1; i < nbytes; i++)
+			val = (int128) (((uint128) val << 8) | bytes[i]);
+
+		/* int8 targets need the value to fit in 64 bits */
+		if (datatype == INT8OID)
+			return false;
+
+		mag = val < 0 ? -((uint128) val) : (uint128) val;
+		*p = '\0';
+		do
+		{
+			*--p = '0' + (int) (mag % 10);
+			mag /= 10;
+			if (++ndigits == scale)
+				*--p = '.';
+		} while (mag != 0 || ndigits < scale);
+
+		if (*p == '.')
+			*--p = '0';
+		if (val < 0)
+			*--p = '-';
+
+		num = DirectFunctionCall3(numeric_in, CStringGetDatum(p),
+								  ObjectIdGetDatum(InvalidOid),
+								  Int32GetDatum(-1));
+#else
+		return false;
+#endif
+	}
+
+	if (datatype == MONEYOID)
+		*result = DirectFunctionCall1(numeric_cash, num);
+	else if (typmod >= 0)
+		*result = DirectFunctionCall2(numeric, num, Int32GetDatum(typmod));
+	else
+		*result = num;
+
+	return true;
+}
+
+/*
+ * processDataByTypeToPG
+ *
+ * converts a column value of a change event into the form consumed by the
+ * heap apply path. Fixed-width decimals going into numeric, int8 or money
+ * columns are turned into a Datum right away when possible. Everything else
+ * goes through processDataByType and is parsed by the type's input function
+ * at apply time.
+ */
+static void
+processDataByTypeToPG(DBZ_DML_COLUMN_VALUE * colval, PG_DML_COLUMN_VALUE * pgcolval,
+		char * remoteObjectId, ConnectorType type)
+{
+	char * data;
+
+	pgcolval->datatype = colval->datatype;
+	pgcolval->position = colval->position;
+
+	if (colval->dbztype == DBZTYPE_BYTES && colval->value &&
+		(colval->datatype == NUMERICOID || colval->datatype == INT8OID ||
+		 colval->datatype == MONEYOID) &&
+		strcasecmp(colval->value, "NULL"))
+	{
+		char * transformExpression = transform_data_expression(remoteObjectId,
+				colval->remoteColumnName);
+
+		/* values with a transform expression still need their string form */
+		if (transformExpression)
+			pfree(transformExpression);
+		else if (handle_base64_to_numeric_datum(colval->value, colval->datatype,
+					colval->datatype == MONEYOID ? 4 : colval->scale,
+					colval->typemod, &pgcolval->datum))
+		{
+			pgcolval->isdatum = true;
+			pgcolval->value = NULL;
+			return;
+		}
+	}
+
+	data = processDataByType(colval, false, remoteObjectId, type);
+	if (data != NULL)
+	{
+		pgcolval->value = pstrdup(data);
+		pfree(data);
+	}
+	else
+		pgcolval->value = pstrdup("NULL");
+}
+
 /*
  * processDataByType
  *
@@ -3056,7 +3187,7 @@ PG_DML *
 convert2PGDML(DBZ_DML * dbzdml, ConnectorType type)
 {
 	PG_DML * pgdml = (PG_DML*) palloc0(sizeof(PG_DML));
-	ListCell * cell, * cell2;
+	ListCell * cell;
 
 	StringInfoData strinfo;
 
@@ -3114,19 +3245,7 @@ convert2PGDML(DBZ_DML * dbzdml, ConnectorType type)
 					DBZ_DML_COLUMN_VALUE * colval = (DBZ_DML_COLUMN_VALUE *) lfirst(cell);
 					PG_DML_COLUMN_VALUE * pgcolval = palloc0(sizeof(PG_DML_COLUMN_VALUE));
 
-					char * data = processDataByType(colval, false, dbzdml->remoteObjectId, type);
-
-					if (data != NULL)
-					{
-						pgcolval->value = pstrdup(data);
-						pfree(data);
-					}
-					else
-						pgcolval->value = pstrdup("NULL");
-
-					pgcolval->datatype = colval->datatype;
-					pgcolval->position = colval->position;
-
+					processDataByTypeToPG(colval, pgcolval, dbzdml->remoteObjectId, type);
 					pgdml->columnValuesAfter = lappend(pgdml->columnValuesAfter, pgcolval);
 				}
 				pgdml->columnValuesBefore = NULL;
@@ -3188,25 +3307,23 @@ convert2PGDML(DBZ_DML * dbzdml, ConnectorType type)
 			}
 			else
 			{
-				/* --- Convert to use Heap AM to handler DML --- */
+				/*
+				 * --- Convert to use Heap AM to handler DML ---
+				 *
+				 * before image is only used to locate the old tuple. If the target
+				 * has a replica identity or primary key index, only its key columns
+				 * are needed. Otherwise the full row is needed for sequential scan.
+				 */
 				foreach(cell, dbzdml->columnValuesBefore)
 				{
 					DBZ_DML_COLUMN_VALUE * colval = (DBZ_DML_COLUMN_VALUE *) lfirst(cell);
-					PG_DML_COLUMN_VALUE * pgcolval = palloc0(sizeof(PG_DML_COLUMN_VALUE));
+					PG_DML_COLUMN_VALUE * pgcolval;
 
-					char * data = processDataByType(colval, false, dbzdml->remoteObjectId, type);
-
-					if (data != NULL)
-					{
-						pgcolval->value = pstrdup(data);
-						pfree(data);
-					}
-					else
-						pgcolval->value = pstrdup("NULL");
-
-					pgcolval->datatype = colval->datatype;
-					pgcolval->position = colval->position;
+					if (dbzdml->haskeyidx && !colval->iskey)
+						continue;
 
+					pgcolval = palloc0(sizeof(PG_DML_COLUMN_VALUE));
+					processDataByTypeToPG(colval, pgcolval, dbzdml->remoteObjectId, type);
 					pgdml->columnValuesBefore = lappend(pgdml->columnValuesBefore, pgcolval);
 				}
 				pgdml->columnValuesAfter = NULL;
@@ -3290,41 +3407,70 @@ convert2PGDML(DBZ_DML * dbzdml, ConnectorType type)
 			}
 			else
 			{
-				/* --- Convert to use Heap AM to handler DML --- */
-				forboth(cell, dbzdml->columnValuesAfter, cell2, dbzdml->columnValuesBefore)
-				{
-					DBZ_DML_COLUMN_VALUE * colval_after = (DBZ_DML_COLUMN_VALUE *) lfirst(cell);
-					DBZ_DML_COLUMN_VALUE * colval_before = (DBZ_DML_COLUMN_VALUE *) lfirst(cell2);
-					PG_DML_COLUMN_VALUE * pgcolval_after = palloc0(sizeof(PG_DML_COLUMN_VALUE));
-					PG_DML_COLUMN_VALUE * pgcolval_before = palloc0(sizeof(PG_DML_COLUMN_VALUE));
+				DBZ_DML_COLUMN_VALUE ** beforebypos = NULL;
 
-					char * data = processDataByType(colval_after, false, dbzdml->remoteObjectId, type);
+				/*
+				 * --- Convert to use Heap AM to handler DML ---
+				 *
+				 * index the before image by attribute position so we can tell
+				 * which after values have not changed by comparing their raw
+				 * representation. Unchanged columns are not converted at all;
+				 * the apply path takes them from the located local tuple.
+				 */
+				if (dbzdml->columnValuesBefore != NIL && dbzdml->natts > 0)
+				{
+					beforebypos = (DBZ_DML_COLUMN_VALUE **)
+						palloc0(sizeof(DBZ_DML_COLUMN_VALUE *) * dbzdml->natts);
 
-					if (data != NULL)
+					foreach(cell, dbzdml->columnValuesBefore)
 					{
-						pgcolval_after->value = pstrdup(data);
-						pfree(data);
+						DBZ_DML_COLUMN_VALUE * colval_before = (DBZ_DML_COLUMN_VALUE *) lfirst(cell);
+
+						if (colval_before->position > 0 && colval_before->position <= dbzdml->natts)
+							beforebypos[colval_before->position - 1] = colval_before;
 					}
-					else
-						pgcolval_after->value = pstrdup("NULL");
+				}
 
-					pgcolval_after->datatype = colval_after->datatype;
-					pgcolval_after->position = colval_after->position;
-					pgdml->columnValuesAfter = lappend(pgdml->columnValuesAfter, pgcolval_after);
+				foreach(cell, dbzdml->columnValuesAfter)
+				{
+					DBZ_DML_COLUMN_VALUE * colval_after = (DBZ_DML_COLUMN_VALUE *) lfirst(cell);
+					PG_DML_COLUMN_VALUE * pgcolval_after;
 
-					data = processDataByType(colval_before, false, dbzdml->remoteObjectId, type);
-					if (data != NULL)
+					if (beforebypos && colval_after->position > 0 &&
+						colval_after->position <= dbzdml->natts)
 					{
-						pgcolval_before->value = pstrdup(data);
-						pfree(data);
+						DBZ_DML_COLUMN_VALUE * colval_before = beforebypos[colval_after->position - 1];
+
+						if (colval_before && colval_before->value && colval_after->value &&
+							!strcmp(colval_before->value, colval_after->value))
+							continue;
 					}
-					else
-						pgcolval_before->value = pstrdup("NULL");
 
-					pgcolval_before->datatype = colval_before->datatype;
-					pgcolval_before->position = colval_before->position;
+					pgcolval_after = palloc0(sizeof(PG_DML_COLUMN_VALUE));
+					processDataByTypeToPG(colval_after, pgcolval_after, dbzdml->remoteObjectId, type);
+					pgdml->columnValuesAfter = lappend(pgdml->columnValuesAfter, pgcolval_after);
+				}
+
+				/*
+				 * before image is only used to locate the old tuple. If the target
+				 * has a replica identity or primary key index, only its key columns
+				 * are needed. Otherwise the full row is needed for sequential scan.
+				 */
+				foreach(cell, dbzdml->columnValuesBefore)
+				{
+					DBZ_DML_COLUMN_VALUE * colval_before = (DBZ_DML_COLUMN_VALUE *) lfirst(cell);
+					PG_DML_COLUMN_VALUE * pgcolval_before;
+
+					if (dbzdml->haskeyidx && !colval_before->iskey)
+						continue;
+
+					pgcolval_before = palloc0(sizeof(PG_DML_COLUMN_VALUE));
+					processDataByTypeToPG(colval_before, pgcolval_before, dbzdml->remoteObjectId, type);
 					pgdml->columnValuesBefore = lappend(pgdml->columnValuesBefore, pgcolval_before);
 				}
+
+				if (beforebypos)
+					pfree(beforebypos);
 			}
 			break;
 		}
@@ -3584,6 +3730,53 @@ fc_deinitFormatConverter(ConnectorType connectorType)
 	}
 }
 
+/*
+ * datacache_relcache_callback
+ *
+ * Relcache invalidation callback that marks the data cache entry of a changed
+ * target table as invalid, so only that entry is rebuilt the next time a DML
+ * for it is parsed. An invalid relid means all relations may have changed.
+ * Nothing is freed here as callbacks may fire while an entry is in use.
+ */
+static void
+datacache_relcache_callback(Datum arg, Oid relid)
+{
+	HASH_SEQ_STATUS status;
+	DataCacheEntry * entry;
+
+	if (!dataCacheHash)
+		return;
+
+	hash_seq_init(&status, dataCacheHash);
+	while ((entry = (DataCacheEntry *) hash_seq_search(&status)) != NULL)
+	{
+		if (relid == InvalidOid || entry->tableoid == relid)
+			entry->valid = false;
+	}
+}
+
+/*
+ * fc_clear_data_cache_entry
+ *
+ * Free what a data cache entry holds about its target table, before the entry
+ * is rebuilt or removed.
+ */
+void
+fc_clear_data_cache_entry(DataCacheEntry * entry)
+{
+	if (entry->tupdesc)
+		FreeTupleDesc(entry->tupdesc);
+	if (entry->typeidhash)
+		hash_destroy(entry->typeidhash);
+	if (entry->namejsonposhash)
+		hash_destroy(entry->namejsonposhash);
+
+	entry->tupdesc = NULL;
+	entry->typeidhash = NULL;
+	entry->namejsonposhash = NULL;
+	entry->valid = false;
+}
+
 void
 fc_initDataCache(void)
 {
@@ -3598,6 +3791,23 @@ fc_initDataCache(void)
 							 256,
 							 &info,
 							 HASH_ELEM | HASH_BLOBS | HASH_CONTEXT);
+
+	/* init source object resolution hash that points into the data cache */
+	info.keysize = sizeof(ObjResolveHashKey);
+	info.entrysize = sizeof(ObjResolveHashEntry);
+	info.hcxt = CurrentMemoryContext;
+
+	objResolveHash = hash_create("object resolution hash",
+							 256,
+							 &info,
+							 HASH_ELEM | HASH_STRINGS | HASH_CONTEXT);
+
+	/* callbacks cannot be unregistered, register once for the process */
+	if (!dataCacheCallbackRegistered)
+	{
+		CacheRegisterRelcacheCallback(datacache_relcache_callback, (Datum) 0);
+		dataCacheCallbackRegistered = true;
+	}
 }
 
 void
@@ -3609,6 +3819,12 @@ fc_deinitDataCache(void)
 		hash_destroy(dataCacheHash);
 		dataCacheHash = NULL;
 	}
+
+	if (objResolveHash)
+	{
+		hash_destroy(objResolveHash);
+		objResolveHash = NULL;
+	}
 }
 
 void
@@ -3619,6 +3835,75 @@ fc_resetDataCache(void)
 	fc_initDataCache();
 }
 
+/*
+ * fc_get_resolved_object
+ *
+ * Resolve a DML's source object ID, exactly as received from the source, to its
+ * target table with a single hash probe. On a hit, the DML's object IDs, schema,
+ * table and table information are filled in and the data cache entry of the
+ * target table is returned. Returns NULL if the object ID has not been resolved
+ * yet, or a DDL or object mapping change has happened since.
+ */
+DataCacheEntry *
+fc_get_resolved_object(const char * srcobjid, DBZ_DML * dml)
+{
+	ObjResolveHashEntry * entry;
+
+	if (!objResolveHash || strlen(srcobjid) >= sizeof(((ObjResolveHashKey *) 0)->srcObjId))
+		return NULL;
+
+	entry = (ObjResolveHashEntry *) hash_search(objResolveHash, srcobjid, HASH_FIND, NULL);
+	if (!entry || entry->generation != objResolveGeneration || !entry->centry->valid)
+		return NULL;
+
+	dml->remoteObjectId = pstrdup(entry->remoteObjectId);
+	dml->mappedObjectId = pstrdup(entry->mappedObjectId);
+	dml->schema = pstrdup(entry->centry->key.schema);
+	dml->table = pstrdup(entry->centry->key.table);
+	dml->tableoid = entry->centry->tableoid;
+	dml->natts = entry->centry->natts;
+	dml->haskeyidx = entry->centry->haskeyidx;
+	return entry->centry;
+}
+
+/*
+ * fc_set_resolved_object
+ *
+ * Remember the target table a source object ID has been resolved to, so the
+ * next DML on it can skip name normalization, object mapping and the data
+ * cache lookup. Object IDs too long for the cache are simply not remembered.
+ */
+void
+fc_set_resolved_object(const char * srcobjid, const DBZ_DML * dml, DataCacheEntry * centry)
+{
+	ObjResolveHashEntry * entry;
+
+	if (!objResolveHash || !centry ||
+		strlen(srcobjid) >= sizeof(entry->key.srcObjId) ||
+		strlen(dml->remoteObjectId) >= sizeof(entry->remoteObjectId) ||
+		strlen(dml->mappedObjectId) >= sizeof(entry->mappedObjectId))
+		return;
+
+	entry = (ObjResolveHashEntry *) hash_search(objResolveHash, srcobjid, HASH_ENTER, NULL);
+	entry->generation = objResolveGeneration;
+	entry->centry = centry;
+	strlcpy(entry->remoteObjectId, dml->remoteObjectId, sizeof(entry->remoteObjectId));
+	strlcpy(entry->mappedObjectId, dml->mappedObjectId, sizeof(entry->mappedObjectId));
+}
+
+/*
+ * fc_invalidate_resolved_objects
+ *
+ * Invalidate all resolved source objects. Must be called whenever a data cache
+ * entry is removed or object mapping rules change, as resolved objects point to
+ * data cache entries and depend on the mapping rules.
+ */
+void
+fc_invalidate_resolved_objects(void)
+{
+	objResolveGeneration++;
+}
+
 bool
 fc_load_objmap(const char * name, ConnectorType connectorType)
 {
@@ -3662,6 +3947,9 @@ fc_load_objmap(const char * name, ConnectorType connectorType)
 		elog(ERROR, "data type hash not initialized");
 	}
 
+	/* mapping rules may change, so source objects must be resolved again */
+	fc_invalidate_resolved_objects();
+
 	ret = ra_listObjmaps(name, &objs, &numobjs);
 	if (ret)
 	{
@@ -3887,9 +4175,38 @@ fc_load_objmap(const char * name, ConnectorType connectorType)
 			pfree(dstcopy);
 		}
 	}
+
+	/* ra_listObjmaps() allocates the rules in TopMemoryContext */
+	pfree(objs);
 	return true;
 }
 
+/*
+ * fc_unload_objmap
+ *
+ * Destroy the object mapping and transform expression hashes built by
+ * fc_load_objmap(). Must be called before the memory context they were
+ * loaded in goes away. Data type rules are merged into the data type hashes
+ * of fc_initFormatConverter() and stay.
+ */
+void
+fc_unload_objmap(void)
+{
+	if (objectMappingHash)
+	{
+		hash_destroy(objectMappingHash);
+		objectMappingHash = NULL;
+	}
+
+	if (transformExpressionHash)
+	{
+		hash_destroy(transformExpressionHash);
+		transformExpressionHash = NULL;
+	}
+
+	fc_invalidate_resolved_objects();
+}
+
 
 /*
  * find_exact_string_match
@@ -4346,6 +4663,7 @@ convert2PGDDL(DBZ_DDL * dbzddl, ConnectorType type)
 	else if (dbzddl->type == DDL_DROP_TABLE)
 	{
 		DataCacheKey cachekey = {0};
+		DataCacheEntry * cacheentry;
 		bool found = false;
 
 		mappedObjName = transform_object_name(dbzddl->id, "table");
@@ -4416,8 +4734,13 @@ convert2PGDDL(DBZ_DDL * dbzddl, ConnectorType type)
 		/* drop data cache for schema.table if exists */
 		strlcpy(cachekey.schema, schema, SYNCHDB_CONNINFO_DB_NAME_SIZE);
 		strlcpy(cachekey.table, table, SYNCHDB_CONNINFO_DB_NAME_SIZE);
-		hash_search(dataCacheHash, &cachekey, HASH_REMOVE, &found);
-
+		cacheentry = (DataCacheEntry *) hash_search(dataCacheHash, &cachekey, HASH_FIND, NULL);
+		if (cacheentry)
+		{
+			fc_clear_data_cache_entry(cacheentry);
+			hash_search(dataCacheHash, &cachekey, HASH_REMOVE, &found);
+			fc_invalidate_resolved_objects();
+		}
 	}
 	else if (dbzddl->type == DDL_ALTER_TABLE)
 	{
@@ -4429,6 +4752,7 @@ convert2PGDDL(DBZ_DDL * dbzddl, ConnectorType type)
 		Relation rel;
 		TupleDesc tupdesc;
 		DataCacheKey cachekey = {0};
+		DataCacheEntry * cacheentry;
 		StringInfoData colNameObjId;
 
 		initStringInfo(&colNameObjId);
@@ -4503,10 +4827,12 @@ convert2PGDDL(DBZ_DDL * dbzddl, ConnectorType type)
 			pgddl->tbname = pstrdup(table);
 		}
 
-		/* drop data cache for schema.table if exists */
+		/* the table is about to change, rebuild its data cache entry on next use */
 		strlcpy(cachekey.schema, schema, SYNCHDB_CONNINFO_DB_NAME_SIZE);
 		strlcpy(cachekey.table, table, SYNCHDB_CONNINFO_DB_NAME_SIZE);
-		hash_search(dataCacheHash, &cachekey, HASH_REMOVE, &found);
+		cacheentry = (DataCacheEntry *) hash_search(dataCacheHash, &cachekey, HASH_FIND, NULL);
+		if (cacheentry)
+			cacheentry->valid = false;
 
 		/*
 		 * For ALTER, we must obtain the current schema in PostgreSQL and identify
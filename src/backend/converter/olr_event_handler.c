@@ -20,6 +20,7 @@
 #include "parser/parser.h"
 #include "mb/pg_wchar.h"
 #include "nodes/parsenodes.h"
+#include "common/shortest_dec.h"
 #include "synchdb/synchdb.h"
 #include <time.h>
 #include <sys/time.h>
@@ -28,6 +29,7 @@
 #include "converter/olr_event_handler.h"
 #include "converter/format_converter.h"
 #include "olr/olr_client.h"
+#include "olr/OraProtoBuf.pb-c.h"
 
 /* extern globals */
 extern int myConnectorId;
@@ -42,6 +44,7 @@ extern char * g_eventStr;
 typedef List * (*oracle_raw_parser_fn)(const char *str, RawParseMode mode);
 static oracle_raw_parser_fn synchdb_oracle_raw_parser = NULL;
 static void * handle = NULL;
+static instr_time eventLatency;	/* start of the pipeline stage currently timed */
 
 static char * strtoupper(const char *input);
 static OlrType getOlrTypeFromString(const char * typestring);
@@ -53,9 +56,29 @@ static void destroyOLRDDL(OLR_DDL * ddlinfo);
 static void destroyOLRDML(OLR_DML * dmlinfo);
 static OLR_DDL * parseOLRDDL(Jsonb * jb, Jsonb * payload, orascn * scn,
 		orascn * c_scn, orascn * c_idx, bool isfirst, bool islast);
+static OLR_DDL * buildOLRDDL(const char * db, const char * schema, const char * tablename,
+		const char * sqltext, uint64 src_ts_ms);
+static OLR_DML * initOLRDML(char op, const char * db, const char * schema,
+		const char * table, StringInfo objid, DataCacheEntry ** cacheentry);
+static void appendOLRColumnValue(OLR_DML * olrdml, const char * objid, const char * key,
+		const char * value, HTAB * typeidhash, HTAB * namejsonposhash, bool before);
 static OLR_DML * parseOLRDML(Jsonb * jb, char op, Jsonb * payload,
 		orascn * scn, orascn * c_scn, orascn * c_idx,
 		bool isfirst, bool islast);
+static void load_oracle_parser(void);
+static void applyOLRTxBoundary(bool isbegin, orascn scn, orascn c_scn, orascn c_idx,
+		uint64 src_ts_ms, SynchdbStatistics * myBatchStats, bool * sendconfirm,
+		bool isfirst, bool islast);
+static int applyOLRDML(OLR_DML * olrdml, orascn scn, orascn c_scn, orascn c_idx,
+		SynchdbStatistics * myBatchStats, bool * sendconfirm, bool isfirst, bool islast);
+static int applyOLRDDL(OLR_DDL * olrddl, orascn scn, orascn c_scn, orascn c_idx,
+		const char * name, SynchdbStatistics * myBatchStats, bool * sendconfirm,
+		bool isfirst, bool islast);
+static OlrType getOlrTypeFromColumnType(OpenLogReplicator__Pb__ColumnType type);
+static HTAB * build_olr_schema_pbpos_hash(OpenLogReplicator__Pb__Schema * pbschema);
+static char * olrValueToString(OpenLogReplicator__Pb__Value * value);
+static OLR_DML * parseOLRDMLProtobuf(OpenLogReplicator__Pb__RedoResponse * response,
+		OpenLogReplicator__Pb__Payload * payload, char op, bool isfirst, bool islast);
 
 
 static char *
@@ -372,13 +395,9 @@ parseOLRDDL(Jsonb * jb, Jsonb * payload, orascn * scn, orascn * c_scn, orascn *
 	JsonbValue vbuf;
 	Jsonb * jbschema;
 	OLR_DDL * olrddl = NULL;
-	OLR_DDL_COLUMN * ddlcol = NULL;
 	Datum datum_path_schema[1] = {CStringGetTextDatum("schema")};
-	char * db = NULL, * schema = NULL, * table = NULL;
-	StringInfoData sql;
-	List * ptree = NULL;
-	ListCell * cell;
-	int j = 0;
+	char * db = NULL, * schema = NULL, * table = NULL, * sql = NULL;
+	uint64 src_ts_ms = 0;
 
 	/* scn - required */
 	v = getKeyJsonValueFromContainer(&jb->root, "scn", strlen("scn"), &vbuf);
@@ -427,9 +446,63 @@ parseOLRDDL(Jsonb * jb, Jsonb * payload, orascn * scn, orascn * c_scn, orascn *
 	/* fetch owner -> considered schema - optional*/
 	v = getKeyJsonValueFromContainer(&jbschema->root, "owner", strlen("owner"), &vbuf);
 	if (v)
-	{
 		schema = pnstrdup(v->val.string.val, v->val.string.len);
 
+	/* fetch payload.0.schema.table - required */
+	v = getKeyJsonValueFromContainer(&jbschema->root, "table", strlen("table"), &vbuf);
+	if (!v)
+	{
+		elog(WARNING, "malformed change request - no payload.0.schema.table value");
+		goto end;
+	}
+	table = pnstrdup(v->val.string.val, v->val.string.len);
+
+	/* fetch sql - required */
+	v = getKeyJsonValueFromContainer(&payload->root, "sql", strlen("sql"), &vbuf);
+	if (!v)
+	{
+		elog(WARNING, "malformed change request - no payload.0.sql value");
+		goto end;
+	}
+	sql = pnstrdup(v->val.string.val, v->val.string.len);
+
+	/* tm - only on first and last record within a batch */
+	if (isfirst || islast)
+	{
+		v = getKeyJsonValueFromContainer(&jb->root, "tm", strlen("tm"), &vbuf);
+		if (v)
+		{
+			src_ts_ms = DatumGetUInt64(DirectFunctionCall1(numeric_int8,
+					NumericGetDatum(v->val.numeric))) / 1000 / 1000;
+		}
+	}
+
+	olrddl = buildOLRDDL(db, schema, table, sql, src_ts_ms);
+end:
+	return olrddl;
+}
+
+/*
+ * buildOLRDDL
+ *
+ * Function to parse the Oracle DDL statement of a change event into OLR_DDL.
+ * Returns NULL if the DDL is not intended for a white-listed user table or
+ * cannot be parsed.
+ */
+static OLR_DDL *
+buildOLRDDL(const char * db, const char * schema, const char * tablename,
+		const char * sqltext, uint64 src_ts_ms)
+{
+	OLR_DDL * olrddl = NULL;
+	OLR_DDL_COLUMN * ddlcol = NULL;
+	char * table = NULL;
+	StringInfoData sql;
+	List * ptree = NULL;
+	ListCell * cell;
+	int j = 0;
+
+	if (schema)
+	{
 		/* we want to make sure the owner matches our conninfo record */
 		if (strcasecmp(schema, get_shm_connector_user_by_id(myConnectorId)))
 		{
@@ -448,31 +521,15 @@ parseOLRDDL(Jsonb * jb, Jsonb * payload, orascn * scn, orascn * c_scn, orascn *
 		goto end;
 	}
 
-	/* fetch payload.0.schema.table - required */
-	v = getKeyJsonValueFromContainer(&jbschema->root, "table", strlen("table"), &vbuf);
-	if (!v)
-	{
-		elog(WARNING, "malformed change request - no payload.0.schema.table value");
-		goto end;
-	}
-	table = pnstrdup(v->val.string.val, v->val.string.len);
-
-	if (!is_whitelist_table(table))
+	if (!is_whitelist_table(tablename))
 	{
-		elog(DEBUG1, "table %s is not white-listed...", table);
+		elog(DEBUG1, "table %s is not white-listed...", tablename);
 		goto end;
 	}
+	table = pstrdup(tablename);
 
-	/* fetch sql - required */
 	initStringInfo(&sql);
-	v = getKeyJsonValueFromContainer(&payload->root, "sql", strlen("sql"), &vbuf);
-	if (!v)
-	{
-		elog(WARNING, "malformed change request - no payload.0.sql value");
-		goto end;
-	}
-
-	appendBinaryStringInfo(&sql, v->val.string.val, v->val.string.len);
+	appendStringInfoString(&sql, sqltext);
 	//remove_double_quotes(&sql);
 
 	if (!is_whitelist_sql(&sql))
@@ -483,17 +540,8 @@ parseOLRDDL(Jsonb * jb, Jsonb * payload, orascn * scn, orascn * c_scn, orascn *
 
 	/* construct the ddl struct */
 	olrddl = (DBZ_DDL*) palloc0(sizeof(DBZ_DDL));
+	olrddl->src_ts_ms = src_ts_ms;
 
-	/* tm - only on first and last record within a batch */
-	if (isfirst || islast)
-	{
-		v = getKeyJsonValueFromContainer(&jb->root, "tm", strlen("tm"), &vbuf);
-		if (v)
-		{
-			olrddl->src_ts_ms = DatumGetUInt64(DirectFunctionCall1(numeric_int8,
-					NumericGetDatum(v->val.numeric))) / 1000 / 1000;
-		}
-	}
 	/* Parse the Oracle SQL */
 	PG_TRY();
 	{
@@ -1130,132 +1178,67 @@ end:
 }
 
 /*
- * parseOLRDML
+ * initOLRDML
+ *
+ * Function to allocate an OLR_DML for a change event on db.schema.table and
+ * resolve its target table in PostgreSQL. objid receives the normalized remote
+ * object ID and cacheentry the data cache entry of the target table, whose
+ * namejsonposhash is left for the caller to build from the event's column
+ * schema when it is not cached yet. Returns NULL if the table is not
+ * white-listed.
  */
 static OLR_DML *
-parseOLRDML(Jsonb * jb, char op, Jsonb * payload, orascn * scn, orascn * c_scn, orascn * c_idx, bool isfirst, bool islast)
+initOLRDML(char op, const char * db, const char * schema, const char * table,
+		StringInfo objid, DataCacheEntry ** cacheentry)
 {
-	JsonbValue * v = NULL;
-	JsonbValue vbuf;
-	Jsonb * jbschema;
 	OLR_DML * olrdml = NULL;
-	StringInfoData strinfo, objid;
+	StringInfoData strinfo;
 	bool found;
 	HTAB * typeidhash;
-	HTAB * namejsonposhash;
 	HASHCTL hash_ctl;
 	NameOidEntry * entry;
-	NameJsonposEntry * entry2;
 	Oid schemaoid;
 	Relation rel;
 	TupleDesc tupdesc;
 	int attnum, j = 0;
 	DataCacheKey cachekey = {0};
-	DataCacheEntry * cacheentry;
+	DataCacheEntry * centry;
 	Bitmapset * pkattrs;
-	char * db = NULL, * schema = NULL, * table = NULL;
-
-	Datum datum_path_schema[1] = {CStringGetTextDatum("schema")};
-
-	/* scn - required */
-	v = getKeyJsonValueFromContainer(&jb->root, "scn", strlen("scn"), &vbuf);
-	if (!v)
-	{
-		elog(WARNING, "malformed change request - no scn value");
-		return NULL;
-	}
-	*scn = DatumGetUInt64(DirectFunctionCall1(numeric_int8, NumericGetDatum(v->val.numeric)));
-
-	/* commit scn - required */
-	v = getKeyJsonValueFromContainer(&jb->root, "c_scn", strlen("c_scn"), &vbuf);
-	if (!v)
-	{
-		elog(WARNING, "malformed change request - no c_scn value");
-		return NULL;
-	}
-	*c_scn = DatumGetUInt64(DirectFunctionCall1(numeric_int8, NumericGetDatum(v->val.numeric)));
-
-	/* commit index - required */
-	v = getKeyJsonValueFromContainer(&jb->root, "c_idx", strlen("c_idx"), &vbuf);
-	if (!v)
-	{
-		elog(WARNING, "malformed change request - no c_idx value");
-		return NULL;
-	}
-	*c_idx = DatumGetUInt64(DirectFunctionCall1(numeric_int8, NumericGetDatum(v->val.numeric)));
+	Bitmapset * keyattrs;
+	char * srcobjid;
 
-	/* db - required */
-	v = getKeyJsonValueFromContainer(&jb->root, "db", strlen("db"), &vbuf);
-	if (!v)
+	if (!is_whitelist_table(table))
 	{
-		elog(WARNING, "malformed change request - no db value");
+		elog(DEBUG1, "table %s is not white-listed", table);
 		return NULL;
 	}
-	db = pnstrdup(v->val.string.val, v->val.string.len);
 
 	olrdml = palloc0(sizeof(DBZ_DML));
 	olrdml->op = op;
 
-	initStringInfo(&objid);
-	initStringInfo(&strinfo);
-	appendStringInfo(&objid, "%s.", db);
-
-	/* tm - only at first and last record within a batch */
-	if (isfirst || islast)
-	{
-		v = getKeyJsonValueFromContainer(&jb->root, "tm", strlen("tm"), &vbuf);
-		if (v)
-		{
-			olrdml->src_ts_ms = DatumGetUInt64(DirectFunctionCall1(numeric_int8,
-					NumericGetDatum(v->val.numeric))) / 1000 / 1000;
-		}
-	}
-	elog(DEBUG1, "scn %llu c_scn %llu db %s op is %c", *scn, *c_scn, db, op);
-
-	/* fetch payload.0.schema */
-	jbschema = GET_JSONB_ELEM(payload, &datum_path_schema[0], 1);
-	if (!jbschema)
-	{
-		elog(WARNING, "malformed change request - no payload.0.schema struct");
-		destroyOLRDML(olrdml);
-		olrdml = NULL;
-		goto end;
-	}
-
-	/* fetch owner -> considered schema - optional*/
-	v = getKeyJsonValueFromContainer(&jbschema->root, "owner", strlen("owner"), &vbuf);
-	if (v)
-	{
-		schema = pnstrdup(v->val.string.val, v->val.string.len);
-		appendStringInfo(&objid, "%s.", schema);
-	}
-
-	/* fetch payload.0.schema.table - required */
-	v = getKeyJsonValueFromContainer(&jbschema->root, "table", strlen("table"), &vbuf);
-	if (!v)
-	{
-		elog(WARNING, "malformed change request - no payload.0.schema.table value");
-		destroyOLRDML(olrdml);
-		olrdml = NULL;
-		goto end;
-	}
-	table = pnstrdup(v->val.string.val, v->val.string.len);
+	appendStringInfo(objid, "%s.", db);
+	if (schema)
+		appendStringInfo(objid, "%s.", schema);
+	appendStringInfo(objid, "%s", table);
 
-	if (!is_whitelist_table(table))
+	/* resolve the source object with a single probe if it has been seen before */
+	centry = fc_get_resolved_object(objid->data, olrdml);
+	if (centry)
 	{
-		elog(DEBUG1, "table %s is not white-listed", table);
-		destroyOLRDML(olrdml);
-		olrdml = NULL;
-		goto end;
+		resetStringInfo(objid);
+		appendStringInfoString(objid, olrdml->remoteObjectId);
+		*cacheentry = centry;
+		return olrdml;
 	}
+	srcobjid = pstrdup(objid->data);
 
-	appendStringInfo(&objid, "%s", table);
+	initStringInfo(&strinfo);
 
 	/* table name transformation and normalized objectid to lower case */
-	for (j = 0; j < objid.len; j++)
-		objid.data[j] = (char) pg_tolower((unsigned char) objid.data[j]);
+	for (j = 0; j < objid->len; j++)
+		objid->data[j] = (char) pg_tolower((unsigned char) objid->data[j]);
 
-	olrdml->remoteObjectId = pstrdup(objid.data);
+	olrdml->remoteObjectId = pstrdup(objid->data);
 	olrdml->mappedObjectId = transform_object_name(olrdml->remoteObjectId, "table");
 	if (olrdml->mappedObjectId)
 	{
@@ -1292,6 +1275,7 @@ parseOLRDML(Jsonb * jb, char op, Jsonb * payload, orascn * scn, orascn * c_scn,
 		appendStringInfo(&strinfo, "%s.%s", olrdml->schema, olrdml->table);
 		olrdml->mappedObjectId = pstrdup(strinfo.data);
 	}
+	pfree(strinfo.data);
 
 	/*
 	 * before parsing, we need to make sure the target namespace and table
@@ -1310,14 +1294,28 @@ parseOLRDML(Jsonb * jb, char op, Jsonb * payload, orascn * scn, orascn * c_scn,
 	strlcpy(cachekey.schema, olrdml->schema, sizeof(cachekey.schema));
 	strlcpy(cachekey.table, olrdml->table, sizeof(cachekey.table));
 
-	cacheentry = (DataCacheEntry *) hash_search(dataCacheHash, &cachekey, HASH_ENTER, &found);
+	centry = (DataCacheEntry *) hash_search(dataCacheHash, &cachekey, HASH_ENTER, &found);
+
+	if (!found)
+	{
+		/* a new entry only becomes valid once it is fully populated */
+		centry->tupdesc = NULL;
+		centry->typeidhash = NULL;
+		centry->namejsonposhash = NULL;
+		centry->valid = false;
+	}
+	else if (!centry->valid)
+	{
+		/* the target table has changed since it was cached, rebuild the entry */
+		fc_clear_data_cache_entry(centry);
+		found = false;
+	}
 	if (found)
 	{
-		/* use the cached data type hash for lookup later */
-		typeidhash = cacheentry->typeidhash;
-		olrdml->tableoid = cacheentry->tableoid;
-		namejsonposhash = cacheentry->namejsonposhash;
-		olrdml->natts = cacheentry->natts;
+		/* use the cached table information */
+		olrdml->tableoid = centry->tableoid;
+		olrdml->natts = centry->natts;
+		olrdml->haskeyidx = centry->haskeyidx;
 	}
 	else
 	{
@@ -1350,9 +1348,10 @@ parseOLRDML(Jsonb * jb, char op, Jsonb * payload, orascn * scn, orascn * c_scn,
 		}
 
 		/* populate cached information */
-		strlcpy(cacheentry->key.schema, olrdml->schema, sizeof(cachekey.schema));
-		strlcpy(cacheentry->key.table, olrdml->table, sizeof(cachekey.table));
-		cacheentry->tableoid = olrdml->tableoid;
+		strlcpy(centry->key.schema, olrdml->schema, sizeof(cachekey.schema));
+		strlcpy(centry->key.table, olrdml->table, sizeof(cachekey.table));
+		centry->tableoid = olrdml->tableoid;
+		centry->namejsonposhash = NULL;
 
 		/* prepare a cached hash table for datatype look up with column name */
 		memset(&hash_ctl, 0, sizeof(hash_ctl));
@@ -1360,13 +1359,13 @@ parseOLRDML(Jsonb * jb, char op, Jsonb * payload, orascn * scn, orascn * c_scn,
 		hash_ctl.entrysize = sizeof(NameOidEntry);
 		hash_ctl.hcxt = TopMemoryContext;
 
-		cacheentry->typeidhash = hash_create("Name to OID Hash Table",
-											 512,
-											 &hash_ctl,
-											 HASH_ELEM | HASH_STRINGS | HASH_CONTEXT);
+		centry->typeidhash = hash_create("Name to OID Hash Table",
+										 512,
+										 &hash_ctl,
+										 HASH_ELEM | HASH_STRINGS | HASH_CONTEXT);
 
 		/* point to the cached datatype hash */
-		typeidhash = cacheentry->typeidhash;
+		typeidhash = centry->typeidhash;
 
 		/*
 		 * get the column data type IDs for all columns from PostgreSQL catalog
@@ -1379,10 +1378,22 @@ parseOLRDML(Jsonb * jb, char op, Jsonb * payload, orascn * scn, orascn * c_scn,
 		/* get primary key bitmapset */
 		pkattrs = RelationGetIndexAttrBitmap(rel, INDEX_ATTR_BITMAP_PRIMARY_KEY);
 
+		/*
+		 * get the key columns of the index the apply path uses to locate old
+		 * tuples. This mirrors GetRelationIdentityOrPK(): replica identity
+		 * index first, then primary key. Only these columns of a before image
+		 * need to be converted when such index exists.
+		 */
+		keyattrs = RelationGetIndexAttrBitmap(rel, INDEX_ATTR_BITMAP_IDENTITY_KEY);
+		if (!keyattrs && pkattrs)
+			keyattrs = bms_copy(pkattrs);
+		centry->haskeyidx = (keyattrs != NULL);
+		olrdml->haskeyidx = centry->haskeyidx;
+
 		/* cache tupdesc and save natts for later use */
-		cacheentry->tupdesc = CreateTupleDescCopy(tupdesc);
+		centry->tupdesc = CreateTupleDescCopy(tupdesc);
 		olrdml->natts = tupdesc->natts;
-		cacheentry->natts = olrdml->natts;
+		centry->natts = olrdml->natts;
 
 		for (attnum = 1; attnum <= tupdesc->natts; attnum++)
 		{
@@ -1396,76 +1407,262 @@ parseOLRDML(Jsonb * jb, char op, Jsonb * payload, orascn * scn, orascn * c_scn,
 				entry->typemod = attr->atttypmod;
 				if (pkattrs && bms_is_member(attnum - FirstLowInvalidHeapAttributeNumber, pkattrs))
 					entry->ispk =true;
+				entry->iskey = (keyattrs &&
+						bms_is_member(attnum - FirstLowInvalidHeapAttributeNumber, keyattrs));
 				get_type_category_preferred(entry->oid, &entry->typcategory, &entry->typispreferred);
 				strlcpy(entry->typname, format_type_be(attr->atttypid), NAMEDATALEN);
 			}
 		}
 		bms_free(pkattrs);
+		bms_free(keyattrs);
 		table_close(rel, AccessShareLock);
+		centry->valid = true;
+	}
 
-		/*
-		 * build another hash to store json value's locations of schema data for correct additional param lookups
-		 * todo: combine this hash with typeidhash above to save one hash
-		 */
-		cacheentry->namejsonposhash = build_olr_schema_jsonpos_hash(jbschema);
-		namejsonposhash = cacheentry->namejsonposhash;
-		if (!namejsonposhash)
-		{
-			/* dump the JSON change event as additional detail if available */
-			if (synchdb_log_event_on_error && g_eventStr != NULL)
-				elog(LOG, "%s", g_eventStr);
+	/* remember the resolution for the next DML on the same source object */
+	fc_set_resolved_object(srcobjid, olrdml, centry);
+	pfree(srcobjid);
 
-			elog(ERROR, "cannot parse columns section of OLR change event JSON. Abort");
-		}
+	*cacheentry = centry;
+	return olrdml;
+}
+
+/*
+ * appendOLRColumnValue
+ *
+ * Function to resolve a column value of a change event against the target
+ * table and add it to the before or after image of olrdml
+ */
+static void
+appendOLRColumnValue(OLR_DML * olrdml, const char * objid, const char * key, const char * value,
+		HTAB * typeidhash, HTAB * namejsonposhash, bool before)
+{
+	char * mappedColumnName = NULL;
+	StringInfoData colNameObjId;
+	DBZ_DML_COLUMN_VALUE * colval = NULL;
+	NameOidEntry * entry;
+	NameJsonposEntry * entry2;
+	bool found;
+	int j = 0;
+
+	colval = (DBZ_DML_COLUMN_VALUE *) palloc0(sizeof(DBZ_DML_COLUMN_VALUE));
+	colval->name = pstrdup(key);
+
+	/* convert to lower case column name */
+	for (j = 0; j < strlen(colval->name); j++)
+		colval->name[j] = (char) pg_tolower((unsigned char) colval->name[j]);
+
+	colval->value = pstrdup(value);
+	/* a copy of original column name for expression rule lookup at later stage */
+	colval->remoteColumnName = pstrdup(colval->name);
+
+	/* transform the column name if needed */
+	initStringInfo(&colNameObjId);
+	appendStringInfo(&colNameObjId, "%s.%s", objid, colval->name);
+	mappedColumnName = transform_object_name(colNameObjId.data, "column");
+	if (mappedColumnName)
+	{
+		/* replace the column name with looked up value here */
+		pfree(colval->name);
+		colval->name = pstrdup(mappedColumnName);
 	}
-	switch (olrdml->op)
+	if (colNameObjId.data)
+		pfree(colNameObjId.data);
+
+	/* look up its data type */
+	entry = (NameOidEntry *) hash_search(typeidhash, colval->name, HASH_FIND, &found);
+	if (found)
 	{
-		case 'c':
-		{
-			/* parse after */
-			Jsonb * dmldata = NULL;
-			JsonbIterator *it;
-			JsonbValue v;
-			JsonbIteratorToken r;
-			char * key = NULL;
-			char * value = NULL;
-			DBZ_DML_COLUMN_VALUE * colval = NULL;
-			Datum datum_elems[1] = {CStringGetTextDatum("after")};
+		colval->datatype = entry->oid;
+		colval->position = entry->position;
+		colval->typemod = entry->typemod;
+		colval->ispk = entry->ispk;
+		colval->iskey = entry->iskey;
+		colval->typcategory = entry->typcategory;
+		colval->typispreferred = entry->typispreferred;
+		colval->typname = pstrdup(entry->typname);
+	}
+	else
+		elog(ERROR, "cannot find data type for column %s. None-existent column?", colval->name);
 
-			dmldata = GET_JSONB_ELEM(payload, &datum_elems[0], 1);
-			if (dmldata)
-			{
-				int pause = 0;
-				it = JsonbIteratorInit(&dmldata->root);
-				while ((r = JsonbIteratorNext(&it, &v, false)) != WJB_DONE)
-				{
-					switch (r)
-					{
-						case WJB_BEGIN_OBJECT:
-							if (key != NULL)
-							{
-								pause = 1;
-							}
-							break;
-						case WJB_END_OBJECT:
-							if (pause)
-							{
-								pause = 0;
-								if (key)
-								{
-									int pathsize = strlen("after.") + strlen(key) + 1;
-									char * tmpPath = (char *) palloc0 (pathsize);
-									snprintf(tmpPath, pathsize, "after.%s", key);
-									getPathElementString(payload, tmpPath, &strinfo, false);
-									value = pstrdup(strinfo.data);
-									if(tmpPath)
-										pfree(tmpPath);
-								}
-							}
-							break;
-						case WJB_BEGIN_ARRAY:
-							if (key)
-							{
+	entry2 = (NameJsonposEntry *) hash_search(namejsonposhash, colval->remoteColumnName, HASH_FIND, &found);
+	if (found)
+	{
+		colval->dbztype = entry2->dbztype;
+		colval->timerep = entry2->timerep;
+		colval->scale = entry2->scale;
+	}
+	else
+		elog(ERROR, "cannot find olr column schema data for column %s(%s). invalid change event?",
+				colval->name, colval->remoteColumnName);
+
+	if (before)
+		olrdml->columnValuesBefore = lappend(olrdml->columnValuesBefore, colval);
+	else
+		olrdml->columnValuesAfter = lappend(olrdml->columnValuesAfter, colval);
+}
+
+/*
+ * parseOLRDML
+ */
+static OLR_DML *
+parseOLRDML(Jsonb * jb, char op, Jsonb * payload, orascn * scn, orascn * c_scn, orascn * c_idx, bool isfirst, bool islast)
+{
+	JsonbValue * v = NULL;
+	JsonbValue vbuf;
+	Jsonb * jbschema;
+	OLR_DML * olrdml = NULL;
+	StringInfoData strinfo, objid;
+	HTAB * typeidhash;
+	HTAB * namejsonposhash;
+	DataCacheEntry * cacheentry;
+	char * db = NULL, * schema = NULL, * table = NULL;
+
+	Datum datum_path_schema[1] = {CStringGetTextDatum("schema")};
+
+	/* scn - required */
+	v = getKeyJsonValueFromContainer(&jb->root, "scn", strlen("scn"), &vbuf);
+	if (!v)
+	{
+		elog(WARNING, "malformed change request - no scn value");
+		return NULL;
+	}
+	*scn = DatumGetUInt64(DirectFunctionCall1(numeric_int8, NumericGetDatum(v->val.numeric)));
+
+	/* commit scn - required */
+	v = getKeyJsonValueFromContainer(&jb->root, "c_scn", strlen("c_scn"), &vbuf);
+	if (!v)
+	{
+		elog(WARNING, "malformed change request - no c_scn value");
+		return NULL;
+	}
+	*c_scn = DatumGetUInt64(DirectFunctionCall1(numeric_int8, NumericGetDatum(v->val.numeric)));
+
+	/* commit index - required */
+	v = getKeyJsonValueFromContainer(&jb->root, "c_idx", strlen("c_idx"), &vbuf);
+	if (!v)
+	{
+		elog(WARNING, "malformed change request - no c_idx value");
+		return NULL;
+	}
+	*c_idx = DatumGetUInt64(DirectFunctionCall1(numeric_int8, NumericGetDatum(v->val.numeric)));
+
+	/* db - required */
+	v = getKeyJsonValueFromContainer(&jb->root, "db", strlen("db"), &vbuf);
+	if (!v)
+	{
+		elog(WARNING, "malformed change request - no db value");
+		return NULL;
+	}
+	db = pnstrdup(v->val.string.val, v->val.string.len);
+
+	initStringInfo(&objid);
+	initStringInfo(&strinfo);
+
+	/* fetch payload.0.schema */
+	jbschema = GET_JSONB_ELEM(payload, &datum_path_schema[0], 1);
+	if (!jbschema)
+	{
+		elog(WARNING, "malformed change request - no payload.0.schema struct");
+		goto end;
+	}
+
+	/* fetch owner -> considered schema - optional*/
+	v = getKeyJsonValueFromContainer(&jbschema->root, "owner", strlen("owner"), &vbuf);
+	if (v)
+		schema = pnstrdup(v->val.string.val, v->val.string.len);
+
+	/* fetch payload.0.schema.table - required */
+	v = getKeyJsonValueFromContainer(&jbschema->root, "table", strlen("table"), &vbuf);
+	if (!v)
+	{
+		elog(WARNING, "malformed change request - no payload.0.schema.table value");
+		goto end;
+	}
+	table = pnstrdup(v->val.string.val, v->val.string.len);
+
+	olrdml = initOLRDML(op, db, schema, table, &objid, &cacheentry);
+	if (!olrdml)
+		goto end;
+
+	/* tm - only at first and last record within a batch */
+	if (isfirst || islast)
+	{
+		v = getKeyJsonValueFromContainer(&jb->root, "tm", strlen("tm"), &vbuf);
+		if (v)
+		{
+			olrdml->src_ts_ms = DatumGetUInt64(DirectFunctionCall1(numeric_int8,
+					NumericGetDatum(v->val.numeric))) / 1000 / 1000;
+		}
+	}
+	elog(DEBUG1, "scn %llu c_scn %llu db %s op is %c", *scn, *c_scn, db, op);
+
+	/*
+	 * build another hash to store json value's locations of schema data for correct
+	 * additional param lookups, once per table
+	 */
+	if (!cacheentry->namejsonposhash)
+	{
+		cacheentry->namejsonposhash = build_olr_schema_jsonpos_hash(jbschema);
+		if (!cacheentry->namejsonposhash)
+		{
+			/* dump the JSON change event as additional detail if available */
+			if (synchdb_log_event_on_error && g_eventStr != NULL)
+				elog(LOG, "%s", g_eventStr);
+
+			elog(ERROR, "cannot parse columns section of OLR change event JSON. Abort");
+		}
+	}
+	typeidhash = cacheentry->typeidhash;
+	namejsonposhash = cacheentry->namejsonposhash;
+
+	switch (olrdml->op)
+	{
+		case 'c':
+		{
+			/* parse after */
+			Jsonb * dmldata = NULL;
+			JsonbIterator *it;
+			JsonbValue v;
+			JsonbIteratorToken r;
+			char * key = NULL;
+			char * value = NULL;
+			Datum datum_elems[1] = {CStringGetTextDatum("after")};
+
+			dmldata = GET_JSONB_ELEM(payload, &datum_elems[0], 1);
+			if (dmldata)
+			{
+				int pause = 0;
+				it = JsonbIteratorInit(&dmldata->root);
+				while ((r = JsonbIteratorNext(&it, &v, false)) != WJB_DONE)
+				{
+					switch (r)
+					{
+						case WJB_BEGIN_OBJECT:
+							if (key != NULL)
+							{
+								pause = 1;
+							}
+							break;
+						case WJB_END_OBJECT:
+							if (pause)
+							{
+								pause = 0;
+								if (key)
+								{
+									int pathsize = strlen("after.") + strlen(key) + 1;
+									char * tmpPath = (char *) palloc0 (pathsize);
+									snprintf(tmpPath, pathsize, "after.%s", key);
+									getPathElementString(payload, tmpPath, &strinfo, false);
+									value = pstrdup(strinfo.data);
+									if(tmpPath)
+										pfree(tmpPath);
+								}
+							}
+							break;
+						case WJB_BEGIN_ARRAY:
+							if (key)
+							{
 								pfree(key);
 								key = NULL;
 							}
@@ -1514,60 +1711,8 @@ parseOLRDML(Jsonb * jb, char op, Jsonb * payload, orascn * scn, orascn * c_scn,
 					/* check if we have a key - value pair */
 					if (key != NULL && value != NULL)
 					{
-						char * mappedColumnName = NULL;
-						StringInfoData colNameObjId;
-
-						colval = (DBZ_DML_COLUMN_VALUE *) palloc0(sizeof(DBZ_DML_COLUMN_VALUE));
-						colval->name = pstrdup(key);
-
-						/* convert to lower case column name */
-						for (j = 0; j < strlen(colval->name); j++)
-							colval->name[j] = (char) pg_tolower((unsigned char) colval->name[j]);
-
-						colval->value = pstrdup(value);
-						/* a copy of original column name for expression rule lookup at later stage */
-						colval->remoteColumnName = pstrdup(colval->name);
-
-						/* transform the column name if needed */
-						initStringInfo(&colNameObjId);
-						appendStringInfo(&colNameObjId, "%s.%s", objid.data, colval->name);
-						mappedColumnName = transform_object_name(colNameObjId.data, "column");
-						if (mappedColumnName)
-						{
-							/* replace the column name with looked up value here */
-							pfree(colval->name);
-							colval->name = pstrdup(mappedColumnName);
-						}
-						if (colNameObjId.data)
-							pfree(colNameObjId.data);
-
-						/* look up its data type */
-						entry = (NameOidEntry *) hash_search(typeidhash, colval->name, HASH_FIND, &found);
-						if (found)
-						{
-							colval->datatype = entry->oid;
-							colval->position = entry->position;
-							colval->typemod = entry->typemod;
-							colval->ispk = entry->ispk;
-							colval->typcategory = entry->typcategory;
-							colval->typispreferred = entry->typispreferred;
-							colval->typname = pstrdup(entry->typname);
-						}
-						else
-							elog(ERROR, "cannot find data type for column %s. None-existent column?", colval->name);
-
-						entry2 = (NameJsonposEntry *) hash_search(namejsonposhash, colval->remoteColumnName, HASH_FIND, &found);
-						if (found)
-						{
-							colval->dbztype = entry2->dbztype;
-							colval->timerep = entry2->timerep;
-							colval->scale = entry2->scale;
-						}
-						else
-							elog(ERROR, "cannot find olr json column schema data for column %s(%s). invalid json event?",
-									colval->name, colval->remoteColumnName);
-
-						olrdml->columnValuesAfter = lappend(olrdml->columnValuesAfter, colval);
+						appendOLRColumnValue(olrdml, objid.data, key, value,
+								typeidhash, namejsonposhash, false);
 						pfree(key);
 						pfree(value);
 						key = NULL;
@@ -1586,7 +1731,6 @@ parseOLRDML(Jsonb * jb, char op, Jsonb * payload, orascn * scn, orascn * c_scn,
 			JsonbIteratorToken r;
 			char * key = NULL;
 			char * value = NULL;
-			DBZ_DML_COLUMN_VALUE * colval = NULL;
 			Datum datum_elems_before[1] = {CStringGetTextDatum("before")};
 			Datum datum_elems_after[1] = {CStringGetTextDatum("after")};
 			int i = 0;
@@ -1682,64 +1826,8 @@ parseOLRDML(Jsonb * jb, char op, Jsonb * payload, orascn * scn, orascn * c_scn,
 						/* check if we have a key - value pair */
 						if (key != NULL && value != NULL)
 						{
-							char * mappedColumnName = NULL;
-							StringInfoData colNameObjId;
-
-							colval = (DBZ_DML_COLUMN_VALUE *) palloc0(sizeof(DBZ_DML_COLUMN_VALUE));
-							colval->name = pstrdup(key);
-
-							/* convert to lower case column name */
-							for (j = 0; j < strlen(colval->name); j++)
-								colval->name[j] = (char) pg_tolower((unsigned char) colval->name[j]);
-
-							colval->value = pstrdup(value);
-							/* a copy of original column name for expression rule lookup at later stage */
-							colval->remoteColumnName = pstrdup(colval->name);
-
-							/* transform the column name if needed */
-							initStringInfo(&colNameObjId);
-							appendStringInfo(&colNameObjId, "%s.%s", objid.data, colval->name);
-							mappedColumnName = transform_object_name(colNameObjId.data, "column");
-							if (mappedColumnName)
-							{
-								/* replace the column name with looked up value here */
-								pfree(colval->name);
-								colval->name = pstrdup(mappedColumnName);
-							}
-							if (colNameObjId.data)
-								pfree(colNameObjId.data);
-
-							/* look up its data type */
-							entry = (NameOidEntry *) hash_search(typeidhash, colval->name, HASH_FIND, &found);
-							if (found)
-							{
-								colval->datatype = entry->oid;
-								colval->position = entry->position;
-								colval->typemod = entry->typemod;
-								colval->ispk = entry->ispk;
-								colval->typcategory = entry->typcategory;
-								colval->typispreferred = entry->typispreferred;
-								colval->typname = pstrdup(entry->typname);
-							}
-							else
-								elog(ERROR, "cannot find data type for column %s. None-existent column?", colval->name);
-
-							entry2 = (NameJsonposEntry *) hash_search(namejsonposhash, colval->remoteColumnName, HASH_FIND, &found);
-							if (found)
-							{
-								colval->dbztype = entry2->dbztype;
-								colval->timerep = entry2->timerep;
-								colval->scale = entry2->scale;
-							}
-							else
-								elog(ERROR, "cannot find olr json column schema data for column %s(%s). invalid json event?",
-										colval->name, colval->remoteColumnName);
-
-							if (i == 0)
-								olrdml->columnValuesBefore = lappend(olrdml->columnValuesBefore, colval);
-							else
-								olrdml->columnValuesAfter = lappend(olrdml->columnValuesAfter, colval);
-
+							appendOLRColumnValue(olrdml, objid.data, key, value,
+									typeidhash, namejsonposhash, i == 0);
 							pfree(key);
 							pfree(value);
 							key = NULL;
@@ -1759,7 +1847,6 @@ parseOLRDML(Jsonb * jb, char op, Jsonb * payload, orascn * scn, orascn * c_scn,
 			JsonbIteratorToken r;
 			char * key = NULL;
 			char * value = NULL;
-			DBZ_DML_COLUMN_VALUE * colval = NULL;
 			Datum datum_elems[1] = {CStringGetTextDatum("before")};
 
 			dmldata = GET_JSONB_ELEM(payload, &datum_elems[0], 1);
@@ -1844,60 +1931,8 @@ parseOLRDML(Jsonb * jb, char op, Jsonb * payload, orascn * scn, orascn * c_scn,
 					/* check if we have a key - value pair */
 					if (key != NULL && value != NULL)
 					{
-						char * mappedColumnName = NULL;
-						StringInfoData colNameObjId;
-
-						colval = (DBZ_DML_COLUMN_VALUE *) palloc0(sizeof(DBZ_DML_COLUMN_VALUE));
-						colval->name = pstrdup(key);
-
-						/* convert to lower case column name */
-						for (j = 0; j < strlen(colval->name); j++)
-							colval->name[j] = (char) pg_tolower((unsigned char) colval->name[j]);
-
-						colval->value = pstrdup(value);
-						/* a copy of original column name for expression rule lookup at later stage */
-						colval->remoteColumnName = pstrdup(colval->name);
-
-						/* transform the column name if needed */
-						initStringInfo(&colNameObjId);
-						appendStringInfo(&colNameObjId, "%s.%s", objid.data, colval->name);
-						mappedColumnName = transform_object_name(colNameObjId.data, "column");
-						if (mappedColumnName)
-						{
-							/* replace the column name with looked up value here */
-							pfree(colval->name);
-							colval->name = pstrdup(mappedColumnName);
-						}
-						if (colNameObjId.data)
-							pfree(colNameObjId.data);
-
-						/* look up its data type */
-						entry = (NameOidEntry *) hash_search(typeidhash, colval->name, HASH_FIND, &found);
-						if (found)
-						{
-							colval->datatype = entry->oid;
-							colval->position = entry->position;
-							colval->typemod = entry->typemod;
-							colval->ispk = entry->ispk;
-							colval->typcategory = entry->typcategory;
-							colval->typispreferred = entry->typispreferred;
-							colval->typname = pstrdup(entry->typname);
-						}
-						else
-							elog(ERROR, "cannot find data type for column %s. None-existent column?", colval->name);
-
-						entry2 = (NameJsonposEntry *) hash_search(namejsonposhash, colval->remoteColumnName, HASH_FIND, &found);
-						if (found)
-						{
-							colval->dbztype = entry2->dbztype;
-							colval->timerep = entry2->timerep;
-							colval->scale = entry2->scale;
-						}
-						else
-							elog(ERROR, "cannot find olr json column schema data for column %s(%s). invalid json event?",
-									colval->name, colval->remoteColumnName);
-
-						olrdml->columnValuesBefore = lappend(olrdml->columnValuesBefore, colval);
+						appendOLRColumnValue(olrdml, objid.data, key, value,
+								typeidhash, namejsonposhash, true);
 						pfree(key);
 						pfree(value);
 						key = NULL;
@@ -1931,62 +1966,281 @@ end:
 }
 
 /*
- * fc_processOLRChangeEvent
+ * load_oracle_parser
  *
- * Main function to process Openlog Replicator change event
+ * Function to load the oracle parser library used to parse DDLs, if not
+ * loaded yet
  */
-int
-fc_processOLRChangeEvent(void * event, SynchdbStatistics * myBatchStats,
-		const char * name, bool * sendconfirm, bool isfirst, bool islast)
+static void
+load_oracle_parser(void)
 {
-	Datum jsonb_datum;
-	Jsonb * jb = NULL;
-	Jsonb * payload = NULL;
-	JsonbValue * v = NULL;
-	JsonbValue vbuf;
-	char * op = NULL;
-	int ret = -1;
-	MemoryContext tempContext, oldContext;
-	struct timeval tv;
-
-	Datum datum_path_payload[2] = {CStringGetTextDatum("payload"), CStringGetTextDatum("0")};
+	char * oralib_path = NULL, * error = NULL;
 
-	tempContext = AllocSetContextCreate(TopMemoryContext,
-										"FORMAT_CONVERTER",
-										ALLOCSET_DEFAULT_SIZES);
+	if (synchdb_oracle_raw_parser != NULL)
+		return;
 
-	oldContext = MemoryContextSwitchTo(tempContext);
+	oralib_path = psprintf("%s/%s", pkglib_path, ORACLE_RAW_PARSER_LIB);
 
-    /* Convert event string to JSONB */
-	PG_TRY();
+	/* Load the shared library */
+	handle = dlopen(oralib_path, RTLD_NOW | RTLD_GLOBAL);
+	if (!handle)
 	{
-#if SYNCHDB_PG_MAJOR_VERSION >= 1700
-		jsonb_datum = jsonb_from_text((text *) event, false);
-#else
-	    jsonb_datum = DirectFunctionCall1(jsonb_in, CStringGetDatum((char *) event));
-#endif
-	    jb = DatumGetJsonbP(jsonb_datum);
+		set_shm_connector_errmsg(myConnectorId, "failed to load oracle_parser.so");
+		ereport(ERROR,
+				(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+				 errmsg("failed to load oracle_parser.so at %s", oralib_path),
+				 errhint("%s",  dlerror())));
+
 	}
-	PG_CATCH();
+	pfree(oralib_path);
+
+	synchdb_oracle_raw_parser = (oracle_raw_parser_fn) dlsym(handle, "synchdb_oracle_raw_parser");
+	if ((error = dlerror()) != NULL)
 	{
-		FlushErrorState();
-#if SYNCHDB_PG_MAJOR_VERSION >= 1700
-		elog(DEBUG1, "bad json message: %s", text_to_cstring(event));
-#else
-		elog(DEBUG1, "bad json message: %s", (char *) event);
-#endif
-		increment_connector_statistics(myBatchStats, STATS_BAD_CHANGE_EVENT, 1);
-		MemoryContextSwitchTo(oldContext);
-		MemoryContextDelete(tempContext);
-		return -1;
+		set_shm_connector_errmsg(myConnectorId, "failed to load synchdb_oracle_raw_parser symbol");
+		ereport(ERROR,
+				(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+				 errmsg("failed to load synchdb_oracle_raw_parser function symbol"),
+				 errhint("make sure synchdb_oracle_raw_parser() function in libsynchdb_oracle_parser.so is "
+						 "publicly accessible ")));
 	}
-	PG_END_TRY();
+}
 
-#if SYNCHDB_PG_MAJOR_VERSION >= 1700
-	elog(DEBUG1, "%s", text_to_cstring(event));
-#else
-	elog(DEBUG1, "%s", (char *) event);
+/*
+ * applyOLRTxBoundary
+ *
+ * Function to process a begin or commit change event. src_ts_ms is 0 when
+ * the event carries no timestamp.
+ */
+static void
+applyOLRTxBoundary(bool isbegin, orascn scn, orascn c_scn, orascn c_idx, uint64 src_ts_ms,
+		SynchdbStatistics * myBatchStats, bool * sendconfirm, bool isfirst, bool islast)
+{
+	struct timeval tv;
+
+	/* transaction boundary */
+	if (isbegin)
+	{
+		/* todo */
+		increment_connector_statistics(myBatchStats, STATS_TX, 1);
+	}
+	else
+	{
+		/* todo */
+		increment_connector_statistics(myBatchStats, STATS_TX, 1);
+	}
+	set_shm_connector_state(myConnectorId, STATE_SYNCING);
+
+	/* update processing timestamps */
+	if (islast)
+	{
+		if (src_ts_ms)
+			myBatchStats->genstats.stats_last_src_ts = src_ts_ms;
+		gettimeofday(&tv, NULL);
+		myBatchStats->genstats.stats_last_pg_ts = (tv.tv_sec * 1000) + (tv.tv_usec / 1000);
+	}
+
+	if (isfirst)
+	{
+		if (src_ts_ms)
+			myBatchStats->genstats.stats_first_src_ts = src_ts_ms;
+		gettimeofday(&tv, NULL);
+		myBatchStats->genstats.stats_first_pg_ts = (tv.tv_sec * 1000) + (tv.tv_usec / 1000);
+	}
+
+	olr_client_set_scns(scn, c_scn, c_idx);
+	*sendconfirm = true;
+}
+
+/*
+ * applyOLRDML
+ *
+ * Function to convert and execute a parsed DML change event. olrdml is
+ * destroyed by this function. Returns 0 on success, -1 on failure.
+ */
+static int
+applyOLRDML(OLR_DML * olrdml, orascn scn, orascn c_scn, orascn c_idx,
+		SynchdbStatistics * myBatchStats, bool * sendconfirm, bool isfirst, bool islast)
+{
+	PG_DML * pgdml = NULL;
+	struct timeval tv;
+	int ret = -1;
+
+	/* (2) convert */
+	set_shm_connector_state(myConnectorId, STATE_CONVERTING);
+	pgdml = convert2PGDML(olrdml, TYPE_OLR);
+	if (!pgdml)
+	{
+		set_shm_connector_state(myConnectorId, STATE_SYNCING);
+		increment_connector_statistics(myBatchStats, STATS_BAD_CHANGE_EVENT, 1);
+		destroyOLRDML(olrdml);
+		return -1;
+	}
+	record_event_latency(latency_op_from_char(olrdml->op), LATENCY_STAGE_CONVERT, &eventLatency);
+
+	/* (3) execute */
+	set_shm_connector_state(myConnectorId, STATE_EXECUTING);
+	ret = ra_executePGDML(pgdml, TYPE_OLR, myBatchStats, false);
+	if(ret)
+	{
+		set_shm_connector_state(myConnectorId, STATE_SYNCING);
+		increment_connector_statistics(myBatchStats, STATS_BAD_CHANGE_EVENT, 1);
+		destroyOLRDML(olrdml);
+		destroyPGDML(pgdml);
+		return -1;
+	}
+	record_event_latency(latency_op_from_char(olrdml->op), LATENCY_STAGE_EXECUTE, &eventLatency);
+
+	/* (4) record scn, c_scn and processing timestamps */
+	olr_client_set_scns(scn, c_scn, c_idx);
+	* sendconfirm = true;
+
+	if (islast)
+	{
+		myBatchStats->genstats.stats_last_src_ts = olrdml->src_ts_ms;
+		gettimeofday(&tv, NULL);
+		myBatchStats->genstats.stats_last_pg_ts = (tv.tv_sec * 1000) + (tv.tv_usec / 1000);
+	}
+
+	if (isfirst)
+	{
+		myBatchStats->genstats.stats_first_src_ts = olrdml->src_ts_ms;
+		gettimeofday(&tv, NULL);
+		myBatchStats->genstats.stats_first_pg_ts = (tv.tv_sec * 1000) + (tv.tv_usec / 1000);
+	}
+
+	/* (5) clean up */
+	set_shm_connector_state(myConnectorId, STATE_SYNCING);
+	destroyOLRDML(olrdml);
+	destroyPGDML(pgdml);
+	return 0;
+}
+
+/*
+ * applyOLRDDL
+ *
+ * Function to convert and execute a parsed DDL change event. olrddl is
+ * destroyed by this function. Returns 0 on success, -1 on failure.
+ */
+static int
+applyOLRDDL(OLR_DDL * olrddl, orascn scn, orascn c_scn, orascn c_idx, const char * name,
+		SynchdbStatistics * myBatchStats, bool * sendconfirm, bool isfirst, bool islast)
+{
+	PG_DDL * pgddl = NULL;
+	struct timeval tv;
+	int ret = -1;
+
+	/* (3) convert */
+	set_shm_connector_state(myConnectorId, STATE_CONVERTING);
+	pgddl = convert2PGDDL(olrddl, TYPE_OLR);
+	if (!pgddl)
+	{
+		set_shm_connector_state(myConnectorId, STATE_SYNCING);
+		increment_connector_statistics(myBatchStats, STATS_BAD_CHANGE_EVENT, 1);
+		destroyOLRDDL(olrddl);
+		return -1;
+	}
+	record_event_latency(LATENCY_OP_DDL, LATENCY_STAGE_CONVERT, &eventLatency);
+
+	/* (4) execute */
+	set_shm_connector_state(myConnectorId, STATE_EXECUTING);
+	ret = ra_executePGDDL(pgddl, TYPE_OLR);
+	if(ret)
+	{
+		set_shm_connector_state(myConnectorId, STATE_SYNCING);
+		increment_connector_statistics(myBatchStats, STATS_BAD_CHANGE_EVENT, 1);
+		destroyOLRDDL(olrddl);
+		destroyPGDDL(pgddl);
+		return -1;
+	}
+	record_event_latency(LATENCY_OP_DDL, LATENCY_STAGE_EXECUTE, &eventLatency);
+
+	/* (5) record scn, c_scn and processing timestmaps */
+	olr_client_set_scns(scn, c_scn, c_idx);
+	* sendconfirm = true;
+
+	if (islast)
+	{
+		myBatchStats->genstats.stats_last_src_ts = olrddl->src_ts_ms;
+		gettimeofday(&tv, NULL);
+		myBatchStats->genstats.stats_last_pg_ts = (tv.tv_sec * 1000) + (tv.tv_usec / 1000);
+	}
+
+	if (isfirst)
+	{
+		myBatchStats->genstats.stats_first_src_ts = olrddl->src_ts_ms;
+		gettimeofday(&tv, NULL);
+		myBatchStats->genstats.stats_first_pg_ts = (tv.tv_sec * 1000) + (tv.tv_usec / 1000);
+	}
+
+	/* (6) update attribute map table */
+	updateSynchdbAttribute(olrddl, pgddl, TYPE_OLR, name);
+
+	/* (7) clean up */
+	set_shm_connector_state(myConnectorId, STATE_SYNCING);
+	destroyOLRDDL(olrddl);
+	destroyPGDDL(pgddl);
+	return 0;
+}
+
+/*
+ * fc_processOLRChangeEvent
+ *
+ * Main function to process Openlog Replicator change event
+ */
+int
+fc_processOLRChangeEvent(void * event, SynchdbStatistics * myBatchStats,
+		const char * name, bool * sendconfirm, bool isfirst, bool islast)
+{
+	Datum jsonb_datum;
+	Jsonb * jb = NULL;
+	Jsonb * payload = NULL;
+	JsonbValue * v = NULL;
+	JsonbValue vbuf;
+	char * op = NULL;
+	int ret = -1;
+	MemoryContext tempContext, oldContext;
+
+	Datum datum_path_payload[2] = {CStringGetTextDatum("payload"), CStringGetTextDatum("0")};
+
+	/* parse latency includes the conversion of the event text to jsonb */
+	start_connector_latency(&eventLatency);
+
+	tempContext = AllocSetContextCreate(TopMemoryContext,
+										"FORMAT_CONVERTER",
+										ALLOCSET_DEFAULT_SIZES);
+
+	oldContext = MemoryContextSwitchTo(tempContext);
+
+    /* Convert event string to JSONB */
+	PG_TRY();
+	{
+#if SYNCHDB_PG_MAJOR_VERSION >= 1700
+		jsonb_datum = jsonb_from_text((text *) event, false);
+#else
+	    jsonb_datum = DirectFunctionCall1(jsonb_in, CStringGetDatum((char *) event));
+#endif
+	    jb = DatumGetJsonbP(jsonb_datum);
+	}
+	PG_CATCH();
+	{
+		FlushErrorState();
+#if SYNCHDB_PG_MAJOR_VERSION >= 1700
+		elog(DEBUG1, "bad json message: %s", text_to_cstring(event));
+#else
+		elog(DEBUG1, "bad json message: %s", (char *) event);
 #endif
+		increment_connector_statistics(myBatchStats, STATS_BAD_CHANGE_EVENT, 1);
+		MemoryContextSwitchTo(oldContext);
+		MemoryContextDelete(tempContext);
+		return -1;
+	}
+	PG_END_TRY();
+
+#if SYNCHDB_PG_MAJOR_VERSION >= 1700
+	elog(DEBUG1, "%s", text_to_cstring(event));
+#else
+	elog(DEBUG1, "%s", (char *) event);
 
 	/* payload - required */
 	payload = GET_JSONB_ELEM(jb, &datum_path_payload[0], 2);
@@ -2019,6 +2273,7 @@ fc_processOLRChangeEvent(void * event, SynchdbStatistics * myBatchStats,
 	if (!strcasecmp(op, "begin") || !strcasecmp(op, "commit"))
 	{
 		orascn scn = 0, c_scn = 0, c_idx = 0;
+		uint64 src_ts_ms = 0;
 
 		/* scn - required */
 		v = getKeyJsonValueFromContainer(&jb->root, "scn", strlen("scn"), &vbuf);
@@ -2056,53 +2311,22 @@ fc_processOLRChangeEvent(void * event, SynchdbStatistics * myBatchStats,
 		}
 		c_idx = DatumGetUInt64(DirectFunctionCall1(numeric_int8, NumericGetDatum(v->val.numeric)));
 
-		/* transaction boundary */
-		if (!strcasecmp(op, "begin"))
-		{
-			/* todo */
-			increment_connector_statistics(myBatchStats, STATS_TX, 1);
-		}
-		else if (!strcasecmp(op, "commit"))
-		{
-			/* todo */
-			increment_connector_statistics(myBatchStats, STATS_TX, 1);
-		}
-		set_shm_connector_state(myConnectorId, STATE_SYNCING);
-
 		/* tm - only at first and last record within a batch */
-		/* update processing timestamps */
-    	if (islast)
-    	{
-			v = getKeyJsonValueFromContainer(&jb->root, "tm", strlen("tm"), &vbuf);
-			if (v)
-			{
-				myBatchStats->genstats.stats_last_src_ts = DatumGetUInt64(DirectFunctionCall1(numeric_int8,
-						NumericGetDatum(v->val.numeric))) / 1000 / 1000;
-			}
-			gettimeofday(&tv, NULL);
-			myBatchStats->genstats.stats_last_pg_ts = (tv.tv_sec * 1000) + (tv.tv_usec / 1000);
-    	}
-
-    	if (isfirst)
-    	{
+		if (isfirst || islast)
+		{
 			v = getKeyJsonValueFromContainer(&jb->root, "tm", strlen("tm"), &vbuf);
 			if (v)
-			{
-				myBatchStats->genstats.stats_first_src_ts = DatumGetUInt64(DirectFunctionCall1(numeric_int8,
+				src_ts_ms = DatumGetUInt64(DirectFunctionCall1(numeric_int8,
 						NumericGetDatum(v->val.numeric))) / 1000 / 1000;
-			}
-			gettimeofday(&tv, NULL);
-			myBatchStats->genstats.stats_first_pg_ts = (tv.tv_sec * 1000) + (tv.tv_usec / 1000);
-    	}
+		}
 
-    	olr_client_set_scns(scn, c_scn, c_idx);
-    	*sendconfirm = true;
+		applyOLRTxBoundary(!strcasecmp(op, "begin"), scn, c_scn, c_idx, src_ts_ms,
+				myBatchStats, sendconfirm, isfirst, islast);
 	}
 	else if (!strcasecmp(op, "c") || !strcasecmp(op, "u") || !strcasecmp(op, "d"))
 	{
 		/* DMLs */
 		OLR_DML * olrdml = NULL;
-		PG_DML * pgdml = NULL;
 		orascn scn = 0, c_scn = 0, c_idx = 0;
 
 		/* increment batch statistics */
@@ -2128,97 +2352,28 @@ fc_processOLRChangeEvent(void * event, SynchdbStatistics * myBatchStats,
 			return -1;
 		}
 
-    	/* (2) convert */
-    	set_shm_connector_state(myConnectorId, STATE_CONVERTING);
-    	pgdml = convert2PGDML(olrdml, TYPE_OLR);
-    	if (!pgdml)
-    	{
-    		set_shm_connector_state(myConnectorId, STATE_SYNCING);
-    		increment_connector_statistics(myBatchStats, STATS_BAD_CHANGE_EVENT, 1);
-    		destroyOLRDML(olrdml);
-    		MemoryContextSwitchTo(oldContext);
-    		MemoryContextDelete(tempContext);
-    		return -1;
-    	}
-
-    	/* (3) execute */
-    	set_shm_connector_state(myConnectorId, STATE_EXECUTING);
-    	ret = ra_executePGDML(pgdml, TYPE_OLR, myBatchStats, false);
-    	if(ret)
-    	{
-    		set_shm_connector_state(myConnectorId, STATE_SYNCING);
-    		increment_connector_statistics(myBatchStats, STATS_BAD_CHANGE_EVENT, 1);
-        	destroyOLRDML(olrdml);
-        	destroyPGDML(pgdml);
-        	MemoryContextSwitchTo(oldContext);
-        	MemoryContextDelete(tempContext);
-    		return -1;
-    	}
-
-    	/* (4) record scn, c_scn and processing timestamps */
-    	olr_client_set_scns(scn, c_scn, c_idx);
-    	* sendconfirm = true;
-
-    	if (islast)
-    	{
-			myBatchStats->genstats.stats_last_src_ts = olrdml->src_ts_ms;
-			gettimeofday(&tv, NULL);
-			myBatchStats->genstats.stats_last_pg_ts = (tv.tv_sec * 1000) + (tv.tv_usec / 1000);
-    	}
-
-    	if (isfirst)
-    	{
-			myBatchStats->genstats.stats_first_src_ts = olrdml->src_ts_ms;
-			gettimeofday(&tv, NULL);
-			myBatchStats->genstats.stats_first_pg_ts = (tv.tv_sec * 1000) + (tv.tv_usec / 1000);
-    	}
-
-       	/* (5) clean up */
-    	set_shm_connector_state(myConnectorId, STATE_SYNCING);
-    	destroyOLRDML(olrdml);
-    	destroyPGDML(pgdml);
+		record_event_latency(latency_op_from_char(op[0]), LATENCY_STAGE_PARSE, &eventLatency);
+
+		/* (2) - (5) convert, execute, record scns and clean up */
+		ret = applyOLRDML(olrdml, scn, c_scn, c_idx, myBatchStats, sendconfirm, isfirst, islast);
+		if (ret)
+		{
+			MemoryContextSwitchTo(oldContext);
+			MemoryContextDelete(tempContext);
+			return -1;
+		}
 	}
 	else if (!strcasecmp(op, "ddl"))
 	{
 		/* DDLs */
 		OLR_DDL * olrddl = NULL;
-		PG_DDL * pgddl = NULL;
 		orascn scn = 0, c_scn = 0, c_idx = 0;
 
 		/* increment batch statistics */
 		increment_connector_statistics(myBatchStats, STATS_DDL, 1);
 
 		/* (1) make sure oracle parser is ready to use - todo move earlier */
-		if (synchdb_oracle_raw_parser == NULL)
-		{
-			char * oralib_path = NULL, * error = NULL;
-
-			oralib_path = psprintf("%s/%s", pkglib_path, ORACLE_RAW_PARSER_LIB);
-
-			/* Load the shared library */
-			handle = dlopen(oralib_path, RTLD_NOW | RTLD_GLOBAL);
-			if (!handle)
-			{
-				set_shm_connector_errmsg(myConnectorId, "failed to load oracle_parser.so");
-				ereport(ERROR,
-						(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
-						 errmsg("failed to load oracle_parser.so at %s", oralib_path),
-						 errhint("%s",  dlerror())));
-
-			}
-			pfree(oralib_path);
-
-			synchdb_oracle_raw_parser = (oracle_raw_parser_fn) dlsym(handle, "synchdb_oracle_raw_parser");
-			if ((error = dlerror()) != NULL)
-			{
-				set_shm_connector_errmsg(myConnectorId, "failed to load synchdb_oracle_raw_parser symbol");
-				ereport(ERROR,
-						(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
-						 errmsg("failed to load synchdb_oracle_raw_parser function symbol"),
-						 errhint("make sure synchdb_oracle_raw_parser() function in libsynchdb_oracle_parser.so is "
-								 "publicly accessible ")));
-			}
-		}
+		load_oracle_parser();
 
 		/* (2) parse */
 		set_shm_connector_state(myConnectorId, STATE_PARSING);
@@ -2242,58 +2397,17 @@ fc_processOLRChangeEvent(void * event, SynchdbStatistics * myBatchStats,
 			return -1;
 		}
 
-    	/* (3) convert */
-    	set_shm_connector_state(myConnectorId, STATE_CONVERTING);
-    	pgddl = convert2PGDDL(olrddl, TYPE_OLR);
-    	if (!pgddl)
-    	{
-    		set_shm_connector_state(myConnectorId, STATE_SYNCING);
-    		increment_connector_statistics(myBatchStats, STATS_BAD_CHANGE_EVENT, 1);
-    		destroyOLRDDL(olrddl);
-    		MemoryContextSwitchTo(oldContext);
-    		MemoryContextDelete(tempContext);
-    		return -1;
-    	}
-
-    	/* (4) execute */
-    	set_shm_connector_state(myConnectorId, STATE_EXECUTING);
-    	ret = ra_executePGDDL(pgddl, TYPE_OLR);
-    	if(ret)
-    	{
-    		set_shm_connector_state(myConnectorId, STATE_SYNCING);
-    		increment_connector_statistics(myBatchStats, STATS_BAD_CHANGE_EVENT, 1);
-    		destroyOLRDDL(olrddl);
-    		destroyPGDDL(pgddl);
-    		MemoryContextSwitchTo(oldContext);
-    		MemoryContextDelete(tempContext);
-    		return -1;
-    	}
-
-    	/* (5) record scn, c_scn and processing timestmaps */
-    	olr_client_set_scns(scn, c_scn, c_idx);
-    	* sendconfirm = true;
-
-    	if (islast)
-    	{
-			myBatchStats->genstats.stats_last_src_ts = olrddl->src_ts_ms;
-			gettimeofday(&tv, NULL);
-			myBatchStats->genstats.stats_last_pg_ts = (tv.tv_sec * 1000) + (tv.tv_usec / 1000);
-    	}
-
-    	if (isfirst)
-    	{
-			myBatchStats->genstats.stats_first_src_ts = olrddl->src_ts_ms;
-			gettimeofday(&tv, NULL);
-			myBatchStats->genstats.stats_first_pg_ts = (tv.tv_sec * 1000) + (tv.tv_usec / 1000);
-    	}
-
-		/* (6) update attribute map table */
-    	updateSynchdbAttribute(olrddl, pgddl, TYPE_OLR, name);
-
-    	/* (7) clean up */
-    	set_shm_connector_state(myConnectorId, STATE_SYNCING);
-		destroyOLRDDL(olrddl);
-		destroyPGDDL(pgddl);
+		record_event_latency(LATENCY_OP_DDL, LATENCY_STAGE_PARSE, &eventLatency);
+
+		/* (3) - (7) convert, execute, record scns and clean up */
+		ret = applyOLRDDL(olrddl, scn, c_scn, c_idx, name, myBatchStats, sendconfirm,
+				isfirst, islast);
+		if (ret)
+		{
+			MemoryContextSwitchTo(oldContext);
+			MemoryContextDelete(tempContext);
+			return -1;
+		}
 	}
 	else
 	{
@@ -2305,6 +2419,379 @@ fc_processOLRChangeEvent(void * event, SynchdbStatistics * myBatchStats,
 	return 0;
 }
 
+/*
+ * getOlrTypeFromColumnType
+ *
+ * Protobuf counterpart of getOlrTypeFromString(): how openlog replicator
+ * represents values of a column of the given type
+ */
+static OlrType
+getOlrTypeFromColumnType(OpenLogReplicator__Pb__ColumnType type)
+{
+	switch (type)
+	{
+		case OPEN_LOG_REPLICATOR__PB__COLUMN_TYPE__NUMBER:
+		case OPEN_LOG_REPLICATOR__PB__COLUMN_TYPE__BINARY_FLOAT:
+		case OPEN_LOG_REPLICATOR__PB__COLUMN_TYPE__BINARY_DOUBLE:
+		case OPEN_LOG_REPLICATOR__PB__COLUMN_TYPE__DATE:
+		case OPEN_LOG_REPLICATOR__PB__COLUMN_TYPE__TIMESTAMP:
+		case OPEN_LOG_REPLICATOR__PB__COLUMN_TYPE__TIMESTAMP_WITH_LOCAL_TZ:
+			return OLRTYPE_NUMBER;
+		case OPEN_LOG_REPLICATOR__PB__COLUMN_TYPE__VARCHAR2:
+		case OPEN_LOG_REPLICATOR__PB__COLUMN_TYPE__CHAR:
+		case OPEN_LOG_REPLICATOR__PB__COLUMN_TYPE__RAW:
+		case OPEN_LOG_REPLICATOR__PB__COLUMN_TYPE__LONG_RAW:
+		case OPEN_LOG_REPLICATOR__PB__COLUMN_TYPE__BLOB:
+		case OPEN_LOG_REPLICATOR__PB__COLUMN_TYPE__CLOB:
+		case OPEN_LOG_REPLICATOR__PB__COLUMN_TYPE__LONG:
+		case OPEN_LOG_REPLICATOR__PB__COLUMN_TYPE__UROWID:
+		case OPEN_LOG_REPLICATOR__PB__COLUMN_TYPE__UNKNOWN:
+		case OPEN_LOG_REPLICATOR__PB__COLUMN_TYPE__INTERVAL_DAY_TO_SECOND:
+		case OPEN_LOG_REPLICATOR__PB__COLUMN_TYPE__INTERVAL_YEAR_TO_MONTH:
+		case OPEN_LOG_REPLICATOR__PB__COLUMN_TYPE__TIMESTAMP_WITH_TZ:
+			return OLRTYPE_STRING;
+		default:
+			break;
+	}
+	elog(DEBUG1, "unexpected olr column type %d - default to numeric type "
+			"representation", type);
+	return OLRTYPE_UNDEF;
+}
+
+/*
+ * build_olr_schema_pbpos_hash
+ *
+ * Protobuf counterpart of build_olr_schema_jsonpos_hash()
+ */
+static HTAB *
+build_olr_schema_pbpos_hash(OpenLogReplicator__Pb__Schema * pbschema)
+{
+	HTAB * jsonposhash;
+	HASHCTL hash_ctl;
+	NameJsonposEntry * entry;
+	bool found = false;
+	int i = 0, j = 0;
+
+	memset(&hash_ctl, 0, sizeof(hash_ctl));
+	hash_ctl.keysize = NAMEDATALEN;
+	hash_ctl.entrysize = sizeof(NameJsonposEntry);
+	hash_ctl.hcxt = TopMemoryContext;
+
+	jsonposhash = hash_create("Name to jsonpos Hash Table",
+							512,
+							&hash_ctl,
+							HASH_ELEM | HASH_STRINGS | HASH_CONTEXT);
+
+	for (i = 0; i < pbschema->n_column; i++)
+	{
+		OpenLogReplicator__Pb__Column * col = pbschema->column[i];
+		char name[NAMEDATALEN] = {0};
+
+		if (!col->name || col->name[0] == '\0')
+		{
+			elog(WARNING, "name is missing from olr column array...");
+			continue;
+		}
+
+		strlcpy(name, col->name, NAMEDATALEN);
+		for (j = 0; j < strlen(name); j++)
+			name[j] = (char) pg_tolower((unsigned char) name[j]);
+
+		entry = (NameJsonposEntry *) hash_search(jsonposhash, name, HASH_ENTER, &found);
+		if (!found)
+		{
+			strlcpy(entry->name, name, NAMEDATALEN);
+			entry->jsonpos = i;
+			entry->dbztype = getOlrTypeFromColumnType(col->type);
+			/* timerep not given from OLR - data processor needs to figure out itself */
+			entry->timerep = 0;
+			entry->scale = col->scale;
+			elog(DEBUG1, "new jsonpos entry name=%s pos=%d dbztype=%d timerep=%d scale=%d",
+					entry->name, entry->jsonpos, entry->dbztype, entry->timerep, entry->scale);
+		}
+	}
+	return jsonposhash;
+}
+
+/*
+ * olrValueToString
+ *
+ * Function to render a typed protobuf column value the way openlog replicator
+ * would have written it in a JSON change event, which is what the data
+ * converter expects. A value without datum is a NULL column and becomes
+ * "NULL", like a JSON null does in parseOLRDML(); an empty value_string
+ * stays an empty string, like an empty JSON string.
+ */
+static char *
+olrValueToString(OpenLogReplicator__Pb__Value * value)
+{
+	char buf[128];
+
+	switch (value->datum_case)
+	{
+		case OPEN_LOG_REPLICATOR__PB__VALUE__DATUM_VALUE_INT:
+			snprintf(buf, sizeof(buf), INT64_FORMAT, (int64) value->value_int);
+			return pstrdup(buf);
+		case OPEN_LOG_REPLICATOR__PB__VALUE__DATUM_VALUE_FLOAT:
+			float_to_shortest_decimal_buf(value->value_float, buf);
+			return pstrdup(buf);
+		case OPEN_LOG_REPLICATOR__PB__VALUE__DATUM_VALUE_DOUBLE:
+			double_to_shortest_decimal_buf(value->value_double, buf);
+			return pstrdup(buf);
+		case OPEN_LOG_REPLICATOR__PB__VALUE__DATUM_VALUE_STRING:
+			return pstrdup(value->value_string);
+		case OPEN_LOG_REPLICATOR__PB__VALUE__DATUM_VALUE_BYTES:
+		{
+			/* raw values are hex encoded like in JSON */
+			char * out = palloc(value->value_bytes.len * 2 + 1);
+
+			hex_encode((const char *) value->value_bytes.data, value->value_bytes.len, out);
+			out[value->value_bytes.len * 2] = '\0';
+			return out;
+		}
+		case OPEN_LOG_REPLICATOR__PB__VALUE__DATUM__NOT_SET:
+		default:
+			return pstrdup("NULL");
+	}
+}
+
+/*
+ * parseOLRDMLProtobuf
+ *
+ * Protobuf counterpart of parseOLRDML()
+ */
+static OLR_DML *
+parseOLRDMLProtobuf(OpenLogReplicator__Pb__RedoResponse * response,
+		OpenLogReplicator__Pb__Payload * payload, char op, bool isfirst, bool islast)
+{
+	OLR_DML * olrdml = NULL;
+	StringInfoData objid;
+	DataCacheEntry * cacheentry;
+	int i = 0;
+
+	if (!response->db || response->db[0] == '\0')
+	{
+		elog(WARNING, "malformed change request - no db value");
+		return NULL;
+	}
+
+	if (!payload->schema || !payload->schema->name)
+	{
+		elog(WARNING, "malformed change request - no payload.schema.table value");
+		return NULL;
+	}
+
+	initStringInfo(&objid);
+	olrdml = initOLRDML(op, response->db,
+			payload->schema->owner[0] != '\0' ? payload->schema->owner : NULL,
+			payload->schema->name, &objid, &cacheentry);
+	if (!olrdml)
+		goto end;
+
+	/* tm - only at first and last record within a batch */
+	if ((isfirst || islast) &&
+		response->tm_val_case == OPEN_LOG_REPLICATOR__PB__REDO_RESPONSE__TM_VAL_TM)
+		olrdml->src_ts_ms = response->tm / 1000 / 1000;
+
+	/* column schema is only looked at once per table */
+	if (!cacheentry->namejsonposhash)
+		cacheentry->namejsonposhash = build_olr_schema_pbpos_hash(payload->schema);
+
+	if (op == 'u' || op == 'd')
+	{
+		for (i = 0; i < payload->n_before; i++)
+		{
+			char * value = olrValueToString(payload->before[i]);
+
+			appendOLRColumnValue(olrdml, objid.data, payload->before[i]->name, value,
+					cacheentry->typeidhash, cacheentry->namejsonposhash, true);
+			pfree(value);
+		}
+	}
+
+	if (op == 'c' || op == 'u')
+	{
+		for (i = 0; i < payload->n_after; i++)
+		{
+			char * value = olrValueToString(payload->after[i]);
+
+			appendOLRColumnValue(olrdml, objid.data, payload->after[i]->name, value,
+					cacheentry->typeidhash, cacheentry->namejsonposhash, false);
+			pfree(value);
+		}
+	}
+
+	/*
+	 * finally, we need to sort dbzdml->columnValuesBefore and dbzdml->columnValuesAfter
+	 * based on position to align with PostgreSQL's attnum
+	 */
+	if (olrdml->columnValuesBefore != NULL)
+		list_sort(olrdml->columnValuesBefore, list_sort_cmp);
+
+	if (olrdml->columnValuesAfter != NULL)
+		list_sort(olrdml->columnValuesAfter, list_sort_cmp);
+
+end:
+	pfree(objid.data);
+	return olrdml;
+}
+
+/*
+ * fc_processOLRProtobufEvent
+ *
+ * Main function to process an Openlog Replicator change event encoded as
+ * protobuf RedoResponse. Typed column values are taken from the message as
+ * is, without going through JSON. Returns 0 if all payloads of the event are
+ * processed, -1 otherwise.
+ */
+int
+fc_processOLRProtobufEvent(void * event, SynchdbStatistics * myBatchStats,
+		const char * name, bool * sendconfirm, bool isfirst, bool islast)
+{
+	OpenLogReplicator__Pb__RedoResponse * response = (OpenLogReplicator__Pb__RedoResponse *) event;
+	MemoryContext tempContext, oldContext;
+	orascn scn = 0;
+	uint64 src_ts_ms = 0;
+	int i = 0, ret = 0;
+
+	if (response->code != OPEN_LOG_REPLICATOR__PB__RESPONSE_CODE__PAYLOAD)
+	{
+		elog(DEBUG1, "skip olr response with code %d", response->code);
+		return 0;
+	}
+
+	if (response->scn_val_case == OPEN_LOG_REPLICATOR__PB__REDO_RESPONSE__SCN_VAL_SCN)
+		scn = response->scn;
+	else if (response->scn_val_case == OPEN_LOG_REPLICATOR__PB__REDO_RESPONSE__SCN_VAL_SCNS)
+		scn = strtoull(response->scns, NULL, 0);
+	else
+	{
+		elog(WARNING, "malformed change request - no scn value");
+		increment_connector_statistics(myBatchStats, STATS_BAD_CHANGE_EVENT, 1);
+		return -1;
+	}
+
+	if (response->tm_val_case == OPEN_LOG_REPLICATOR__PB__REDO_RESPONSE__TM_VAL_TM)
+		src_ts_ms = response->tm / 1000 / 1000;
+
+	/* update stage if needed */
+	if (get_shm_connector_stage_enum(myConnectorId) != STAGE_CHANGE_DATA_CAPTURE)
+		set_shm_connector_stage(myConnectorId, STAGE_CHANGE_DATA_CAPTURE);
+
+	tempContext = AllocSetContextCreate(TopMemoryContext,
+										"FORMAT_CONVERTER",
+										ALLOCSET_DEFAULT_SIZES);
+
+	for (i = 0; i < response->n_payload; i++)
+	{
+		OpenLogReplicator__Pb__Payload * payload = response->payload[i];
+		bool first = isfirst && i == 0;
+		bool last = islast && i == response->n_payload - 1;
+
+		oldContext = MemoryContextSwitchTo(tempContext);
+		start_connector_latency(&eventLatency);
+
+		elog(DEBUG1, "scn %llu c_scn %llu op is %d", scn, (orascn) response->c_scn, payload->op);
+		switch (payload->op)
+		{
+			case OPEN_LOG_REPLICATOR__PB__OP__BEGIN:
+			case OPEN_LOG_REPLICATOR__PB__OP__COMMIT:
+			{
+				applyOLRTxBoundary(payload->op == OPEN_LOG_REPLICATOR__PB__OP__BEGIN,
+						scn, response->c_scn, response->c_idx, (first || last) ? src_ts_ms : 0,
+						myBatchStats, sendconfirm, first, last);
+				break;
+			}
+			case OPEN_LOG_REPLICATOR__PB__OP__INSERT:
+			case OPEN_LOG_REPLICATOR__PB__OP__UPDATE:
+			case OPEN_LOG_REPLICATOR__PB__OP__DELETE:
+			{
+				OLR_DML * olrdml = NULL;
+				char op = payload->op == OPEN_LOG_REPLICATOR__PB__OP__INSERT ? 'c' :
+						  payload->op == OPEN_LOG_REPLICATOR__PB__OP__UPDATE ? 'u' : 'd';
+
+				/* increment batch statistics */
+				increment_connector_statistics(myBatchStats, STATS_DML, 1);
+
+				if (!IsTransactionState())
+				{
+					elog(WARNING, "not in transaction state. Skip change events");
+					ret = -1;
+					break;
+				}
+
+				/* (1) parse */
+				set_shm_connector_state(myConnectorId, STATE_PARSING);
+				olrdml = parseOLRDMLProtobuf(response, payload, op, first, last);
+				if (!olrdml)
+				{
+					set_shm_connector_state(myConnectorId, STATE_SYNCING);
+					increment_connector_statistics(myBatchStats, STATS_BAD_CHANGE_EVENT, 1);
+					ret = -1;
+					break;
+				}
+
+				record_event_latency(latency_op_from_char(op), LATENCY_STAGE_PARSE, &eventLatency);
+
+				/* (2) - (5) convert, execute, record scns and clean up */
+				if (applyOLRDML(olrdml, scn, response->c_scn, response->c_idx,
+						myBatchStats, sendconfirm, first, last))
+					ret = -1;
+				break;
+			}
+			case OPEN_LOG_REPLICATOR__PB__OP__DDL:
+			{
+				OLR_DDL * olrddl = NULL;
+				OpenLogReplicator__Pb__Schema * pbschema = payload->schema;
+
+				/* increment batch statistics */
+				increment_connector_statistics(myBatchStats, STATS_DDL, 1);
+
+				/* (1) make sure oracle parser is ready to use */
+				load_oracle_parser();
+
+				/* (2) parse */
+				set_shm_connector_state(myConnectorId, STATE_PARSING);
+				if (response->db && pbschema && pbschema->name && payload->ddl)
+					olrddl = buildOLRDDL(response->db,
+							pbschema->owner[0] != '\0' ? pbschema->owner : NULL,
+							pbschema->name, payload->ddl, (first || last) ? src_ts_ms : 0);
+				else
+					elog(WARNING, "malformed change request - incomplete ddl payload");
+
+				if (!olrddl)
+				{
+					set_shm_connector_state(myConnectorId, STATE_SYNCING);
+					increment_connector_statistics(myBatchStats, STATS_BAD_CHANGE_EVENT, 1);
+
+					/* move forward with scn and c_scn, see fc_processOLRChangeEvent */
+					olr_client_set_scns(scn, response->c_scn, response->c_idx);
+					* sendconfirm = true;
+					ret = -1;
+					break;
+				}
+
+				record_event_latency(LATENCY_OP_DDL, LATENCY_STAGE_PARSE, &eventLatency);
+
+				/* (3) - (7) convert, execute, record scns and clean up */
+				if (applyOLRDDL(olrddl, scn, response->c_scn, response->c_idx, name,
+						myBatchStats, sendconfirm, first, last))
+					ret = -1;
+				break;
+			}
+			default:
+				elog(WARNING, "unsupported op %d", payload->op);
+				break;
+		}
+
+		MemoryContextSwitchTo(oldContext);
+		MemoryContextReset(tempContext);
+	}
+
+	MemoryContextDelete(tempContext);
+	return ret;
+}
+
 void
 unload_oracle_parser(void)
 {
@@ -14,8 +14,12 @@ import java.util.concurrent.TimeUnit;
 import java.util.concurrent.TimeoutException;
 import java.util.concurrent.Future;
 import java.util.concurrent.ExecutionException;
+import java.util.concurrent.ArrayBlockingQueue;
+import java.util.concurrent.Semaphore;
+import java.util.concurrent.atomic.AtomicLong;
 import java.util.LinkedList;
 import java.util.Queue;
+import java.lang.reflect.Method;
 import java.io.IOException;
 import java.io.File;
 import java.nio.ByteBuffer;
@@ -32,9 +36,12 @@ import org.apache.log4j.*;
 import java.lang.management.ManagementFactory;
 import java.lang.management.MemoryMXBean;
 import java.lang.management.MemoryUsage;
+import javax.management.MBeanServer;
+import javax.management.ObjectName;
 import com.fasterxml.jackson.databind.JsonNode;
 import com.fasterxml.jackson.databind.ObjectMapper;
 import com.fasterxml.jackson.databind.node.ArrayNode;
+import org.apache.kafka.connect.source.SourceRecord;
 
 public class DebeziumRunner {
 	private static Logger logger = Logger.getRootLogger();
@@ -46,13 +53,23 @@ public class DebeziumRunner {
 	private boolean lastDbzSuccess;
 	private Throwable lastDbzError;
 	private HashMap<Integer, ChangeRecordBatch> activeBatchHash = new HashMap<>();
-	private BatchManager batchManager = new BatchManager();
+	private long queueMaxBytes = DEFAULT_QUEUE_MAX_BYTES;
+	private BatchManager batchManager = new BatchManager(queueMaxBytes);
+	private ObjectName batchQueueMBeanName;
+	private long spillThresholdBytes = 0;
+	private ChangeRecordBatch partialBatch;	/* batch handed to synchdb in parts */
+	private volatile int maxBatchRecords = 0;	/* records applied per transaction, 0: whole batch */
+	private Method sourceRecordMethod;
+	/* static: the runner is created with AllocObject, so instance initializers never run */
+	private static final ObjectMapper offsetMapper = new ObjectMapper();
 
 	final int TYPE_MYSQL = 1;
 	final int TYPE_ORACLE = 2;
 	final int TYPE_SQLSERVER = 3;
 	final int TYPE_OPENLOG_REPLICATOR = 4;
-	final int BATCH_QUEUE_SIZE = 5;
+	final int BATCH_QUEUE_CAPACITY = 1024;
+	static final long DEFAULT_QUEUE_MAX_BYTES = 256L * 1024 * 1024;
+	static final int RECORD_OVERHEAD_BYTES = 64;
 	
 	final int LOG_LEVEL_UNDEF = 0;
 	final int LOG_LEVEL_ALL = 1;
@@ -108,6 +125,9 @@ public class DebeziumRunner {
 		private int ispnMemorySize;
 		private String logminerStreamMode;
 		private int cdcDelay;
+		private int recordProcessingThreads;
+		private long queueMaxBytes;
+		private long spillThresholdBytes;
 
 		/* constructor requires all required parameters for a connector to work */
 		public MyParameters(String connectorName, int connectorType, String hostname, int port, String user, String password, String database, String table, String snapshottable,String snapshotMode, String dstdb)
@@ -238,6 +258,21 @@ public class DebeziumRunner {
             this.cdcDelay = cdcDelay;
             return this;
         }
+		public MyParameters setRecordProcessingThreads(int recordProcessingThreads)
+		{
+			this.recordProcessingThreads = recordProcessingThreads;
+			return this;
+		}
+		public MyParameters setQueueMaxBytes(long queueMaxBytes)
+		{
+			this.queueMaxBytes = queueMaxBytes;
+			return this;
+		}
+		public MyParameters setSpillThresholdBytes(long spillThresholdBytes)
+		{
+			this.spillThresholdBytes = spillThresholdBytes;
+			return this;
+		}
 
 		/* add more setters here to incrementally set parameters */
 		public void print()
@@ -273,6 +308,9 @@ public class DebeziumRunner {
 			logger.warn("snapshottable = " + this.snapshottable);
 			logger.warn("logminerStreamMode = " + this.logminerStreamMode);
 			logger.warn("cdcDelay = " + this.cdcDelay);
+			logger.warn("recordProcessingThreads = " + this.recordProcessingThreads);
+			logger.warn("queueMaxBytes = " + this.queueMaxBytes);
+			logger.warn("spillThresholdBytes = " + this.spillThresholdBytes);
 			
 			logger.warn("olrHost = " + this.olrHost);
 			logger.warn("olrPort = " + this.olrPort);
@@ -284,76 +322,201 @@ public class DebeziumRunner {
 		}
 
 	}
-	/* BatchMaanger represents a Batch request queue */
-	public class BatchManager
+	/* BatchQueueMXBean exposes the batch queue of a connector through JMX */
+	public interface BatchQueueMXBean
+	{
+		long getQueuedBytes();
+		int getQueuedBatches();
+		long getMaxQueuedBytes();
+	}
+
+	/*
+	 * BatchManager represents a Batch request queue. The queue is bounded by the
+	 * estimated size of the queued batches rather than their number: Debezium's
+	 * thread blocks in addBatch until synchdb has taken enough batches to make
+	 * room. A batch larger than the whole budget is admitted once the queue is
+	 * empty. The budget is kept in kB as semaphore permits.
+	 */
+	public class BatchManager implements BatchQueueMXBean
 	{
-		private Queue<ChangeRecordBatch> batchQueue;
+		private final ArrayBlockingQueue<ChangeRecordBatch> batchQueue;
+		private final BudgetSemaphore budget;
+		private volatile int budgetKb;
+		private final AtomicLong queuedBytes;
 		private int batchid;
-		private boolean isShutdown;
+		private volatile boolean isShutdown;
 
-		public BatchManager()
+		public BatchManager(long maxBytes)
 		{
-			this.batchQueue = new LinkedList<>();
+			this.budgetKb = (int) Math.max(1, Math.min(Integer.MAX_VALUE, maxBytes / 1024));
+			this.budget = new BudgetSemaphore(this.budgetKb);
+			this.batchQueue = new ArrayBlockingQueue<>(BATCH_QUEUE_CAPACITY);
+			this.queuedBytes = new AtomicLong(0);
 			this.batchid = 0;
 			this.isShutdown = false;
 		}
 
-		public synchronized int getQueueSize()
+		public int getQueueSize()
 		{
 			return batchQueue.size();
 		}
-		public synchronized void addBatch(ChangeRecordBatch batch) throws InterruptedException
+
+		/* called by the single Debezium handler thread only */
+		public void addBatch(ChangeRecordBatch batch) throws InterruptedException
 		{
-			while (batchQueue.size() >= BATCH_QUEUE_SIZE && !this.isShutdown)
+			batch.permits = (int) Math.min(budgetKb, Math.max(1, (batch.bytes + 1023) / 1024));
+			while (!budget.tryAcquire(batch.permits, 100, TimeUnit.MILLISECONDS))
 			{
-				wait();
+				if (this.isShutdown)
+				{
+					logger.warn("BatchManager has been shutdown...");
+					return;
+				}
 			}
 
-			if (this.isShutdown)
+			batch.batchid = this.batchid;
+			queuedBytes.addAndGet(batch.bytes);
+			while (!batchQueue.offer(batch, 100, TimeUnit.MILLISECONDS))
 			{
-				logger.warn("BatchManager has been shutdown...");
-				return;
+				if (this.isShutdown)
+				{
+					logger.warn("BatchManager has been shutdown...");
+					queuedBytes.addAndGet(-batch.bytes);
+					budget.release(batch.permits);
+					return;
+				}
 			}
-
-			batch.batchid = this.batchid;
-			batchQueue.offer(batch);
 			this.batchid++;
-			logger.info("added a batch task: id = " + batch.batchid + " size = " + batch.records.size());
-			notifyAll();
+			logger.info("added a batch task: id = " + batch.batchid + " size = " + batch.records.size() +
+					" bytes = " + batch.bytes + " queued bytes = " + queuedBytes.get());
 		}
 
-		public synchronized ChangeRecordBatch getNextBatch()
+		public ChangeRecordBatch getNextBatch()
 		{
 			ChangeRecordBatch batch = batchQueue.poll();
 			if (batch != null)
 			{
-            	notifyAll();
-        	}
+				queuedBytes.addAndGet(-batch.bytes);
+				budget.release(batch.permits);
+			}
 			return batch;
 		}
 
-		public synchronized void shutdown()
+		public void shutdown()
 		{
 			this.isShutdown = true;
-			notifyAll();
+		}
+
+		/*
+		 * change the budget at runtime. Shrinking it below what queued batches
+		 * hold makes addBatch wait until enough of them have been taken
+		 */
+		public synchronized void resize(long maxBytes)
+		{
+			int newKb = (int) Math.max(1, Math.min(Integer.MAX_VALUE, maxBytes / 1024));
+
+			if (newKb > budgetKb)
+				budget.release(newKb - budgetKb);
+			else if (newKb < budgetKb)
+				budget.shrink(budgetKb - newKb);
+			budgetKb = newKb;
+		}
+
+		@Override
+		public long getQueuedBytes()
+		{
+			return queuedBytes.get();
+		}
+
+		@Override
+		public int getQueuedBatches()
+		{
+			return batchQueue.size();
+		}
+
+		@Override
+		public long getMaxQueuedBytes()
+		{
+			return (long) budgetKb * 1024;
 		}
 	}
 	
+	/* a semaphore whose number of permits can also be reduced */
+	static class BudgetSemaphore extends Semaphore
+	{
+		BudgetSemaphore(int permits)
+		{
+			super(permits);
+		}
+
+		void shrink(int reduction)
+		{
+			reducePermits(reduction);
+		}
+	}
+
 	/* ChangeRecordBatch represents a batch with our own identifier 'batchid' added to it */
 	public class ChangeRecordBatch
 	{
 		public int batchid;
 		public List<ChangeEvent<String, String>> records;
 		public DebeziumEngine.RecordCommitter committer;
+		public long bytes;		/* estimated payload size */
+		public int permits;		/* queue budget held while queued, in kB */
+		public int next;		/* first record not handed to synchdb yet */
+		public int sliceEnd;	/* end of the slice being handed to synchdb */
+		public int doneEnd;		/* end of the last slice fully handed to synchdb */
 
 		public ChangeRecordBatch(List<ChangeEvent<String, String>> records, DebeziumEngine.RecordCommitter committer) 
 		{
 			//this.records = new ArrayList<>(records);
 			this.records = records;
 			this.committer = committer;
+			for (ChangeEvent<String, String> record : records)
+			{
+				String val = record.value();
+				String key = record.key();
+				this.bytes += RECORD_OVERHEAD_BYTES + (val != null ? val.length() : 0) +
+						(key != null ? key.length() : 0);
+			}
+		}
+	}
+
+	/* expose the batch queue as com.example:type=BatchQueue,connector=<name> */
+	private void registerBatchQueueMBean(String connectorName)
+	{
+		try
+		{
+			MBeanServer server = ManagementFactory.getPlatformMBeanServer();
+
+			unregisterBatchQueueMBean();
+			batchQueueMBeanName = new ObjectName("com.example:type=BatchQueue,connector=" +
+					ObjectName.quote(connectorName));
+			server.registerMBean(batchManager, batchQueueMBeanName);
+		}
+		catch (Exception e)
+		{
+			logger.warn("failed to register batch queue MBean: " + e.getMessage());
+			batchQueueMBeanName = null;
 		}
 	}
 
+	private void unregisterBatchQueueMBean()
+	{
+		if (batchQueueMBeanName == null)
+			return;
+
+		try
+		{
+			ManagementFactory.getPlatformMBeanServer().unregisterMBean(batchQueueMBeanName);
+		}
+		catch (Exception e)
+		{
+			logger.warn("failed to unregister batch queue MBean: " + e.getMessage());
+		}
+		batchQueueMBeanName = null;
+	}
+
 	public void checkMemoryStatus()
 	{
 		MemoryMXBean memoryMXBean = ManagementFactory.getMemoryMXBean();
@@ -808,6 +971,15 @@ public class DebeziumRunner {
 
 		logger.info("Hello from DebeziumRunner class!");
 
+		/* field initializers do not run for a runner created with AllocObject */
+		queueMaxBytes = myParameters.queueMaxBytes > 0 ?
+				myParameters.queueMaxBytes : DEFAULT_QUEUE_MAX_BYTES;
+		batchManager = new BatchManager(queueMaxBytes);
+		spillThresholdBytes = myParameters.spillThresholdBytes;
+		partialBatch = null;
+		maxBatchRecords = 0;
+		registerBatchQueueMBean(myParameters.connectorName);
+
 		DebeziumEngine.CompletionCallback completionCallback = (success, message, error) ->
 		{
 			lastDbzMessage = message.replace("\n", " ").replace("\r", " ");
@@ -815,34 +987,54 @@ public class DebeziumRunner {
 			lastDbzError = error;
 		};
 		
-		engine = DebeziumEngine.create(Json.class)
-		//engine = DebeziumEngine.create(KeyValueHeaderChangeEventFormat.of(Json.class, Json.class, Json.class),
-        //        "io.debezium.embedded.async.ConvertingAsyncEngineBuilderFactory")
-                .using(props)
-				.using(completionCallback)
-				.notifying((records, committer) -> {
-					synchronized (this)
-					{
-						if (batchManager == null)
-						{
-							batchManager = new BatchManager();
-						}
-						if (activeBatchHash == null)
-						{
-							activeBatchHash = new HashMap<>();
-						}
+		DebeziumEngine.ChangeConsumer<ChangeEvent<String, String>> batchHandler = (records, committer) ->
+		{
+			synchronized (this)
+			{
+				if (batchManager == null)
+				{
+					batchManager = new BatchManager(queueMaxBytes);
+				}
+				if (activeBatchHash == null)
+				{
+					activeBatchHash = new HashMap<>();
+				}
 
-						try
-						{
-							batchManager.addBatch(new ChangeRecordBatch(records, committer));
-						}
-						catch (InterruptedException e)
-						{
-							Thread.currentThread().interrupt();
-							logger.error("Interrupted while adding batch", e);
-						}
-					}
-				})
+				try
+				{
+					batchManager.addBatch(new ChangeRecordBatch(records, committer));
+				}
+				catch (InterruptedException e)
+				{
+					Thread.currentThread().interrupt();
+					logger.error("Interrupted while adding batch", e);
+				}
+			}
+		};
+
+		DebeziumEngine.Builder<ChangeEvent<String, String>> builder;
+		if (myParameters.recordProcessingThreads > 0)
+		{
+			/*
+			 * async engine: records of a batch are converted to JSON by a pool of threads,
+			 * while whole batches are still handed to batchHandler one at a time and in
+			 * source order, so batch ids and offset commits keep their ordering.
+			 */
+			props.setProperty("record.processing.threads", String.valueOf(myParameters.recordProcessingThreads));
+			props.setProperty("record.processing.order", "ORDERED");
+			logger.warn("using async engine with " + myParameters.recordProcessingThreads + " record processing threads");
+			builder = DebeziumEngine.create(KeyValueHeaderChangeEventFormat.of(Json.class, Json.class, Json.class),
+					"io.debezium.embedded.async.ConvertingAsyncEngineBuilderFactory");
+		}
+		else
+		{
+			builder = DebeziumEngine.create(Json.class);
+		}
+
+		engine = builder
+				.using(props)
+				.using(completionCallback)
+				.notifying(batchHandler)
 				.build();
 
 		if (myParameters.snapshotThreadNum > 1)
@@ -874,6 +1066,8 @@ public class DebeziumRunner {
 			batchManager.shutdown();
 			batchManager = null;
 		}
+		unregisterBatchQueueMBean();
+		partialBatch = null;
 		if (engine != null)
 		{
 			logger.warn("closing Debezium engine...");
@@ -907,55 +1101,86 @@ public class DebeziumRunner {
 		}
 		if (batchManager == null)
 		{
-			batchManager = new BatchManager();
+			batchManager = new BatchManager(queueMaxBytes);
 		}
 
 		ByteBuffer buffer = null;
         if (!future.isDone())
 		{
 			int i = 0;
+			int from = 0;
 			ChangeRecordBatch myNextBatch;
-			myNextBatch = batchManager.getNextBatch();
+
+			/* finish handing out a batch before taking a new one */
+			if (partialBatch != null)
+				myNextBatch = partialBatch;
+			else
+				myNextBatch = batchManager.getNextBatch();
+
 			if (myNextBatch != null)
 			{
-				int totalSize = 0;
-				int numskipped = 0;
+				long totalSize = 0;
 		        int headerSize = 1 + 4 + 4; //B followed by batchid and num batches
-				logger.info("Debezium -> Synchdb: sent batchid(" + myNextBatch.batchid + ") with size(" + myNextBatch.records.size() + ")");
+				List<byte[]> part = new ArrayList<>();
+
+				from = myNextBatch.next;
+				if (from == 0)
+					logger.info("Debezium -> Synchdb: sent batchid(" + myNextBatch.batchid + ") with size(" + myNextBatch.records.size() + ")");
+
+				/*
+				 * a batch is applied by synchdb in slices of at most maxBatchRecords
+				 * records, one transaction each. Start the next slice if the previous
+				 * one has been handed out completely
+				 */
+				if (from == myNextBatch.sliceEnd)
+				{
+					int limit = maxBatchRecords;
 
-				/* first for loop to calculate total size */
-				for (i = 0; i < myNextBatch.records.size(); i++)
+					myNextBatch.sliceEnd = (limit > 0) ?
+						Math.min(myNextBatch.records.size(), from + limit) :
+						myNextBatch.records.size();
+				}
+
+				/*
+				 * first for loop to encode the events and calculate total size. With a
+				 * spill threshold, stop once the buffer would exceed it and hand out
+				 * the rest of the batch in later calls, so neither side ever holds a
+				 * direct buffer much larger than the threshold
+				 */
+				for (i = from; i < myNextBatch.sliceEnd; i++)
 				{
 					String val = myNextBatch.records.get(i).value();
 					if (val == null)
-					{
-						numskipped += 1;
 						continue;
-					}
+
 					byte[] bytes = val.getBytes(StandardCharsets.UTF_8);
+					if (spillThresholdBytes > 0 && !part.isEmpty() &&
+						totalSize + 4 + bytes.length + 1 > spillThresholdBytes)
+						break;
+
+					part.add(bytes);
 					totalSize += 4 + bytes.length + 1; /* 4 byte size + 1 null terminator */
 				}
 				totalSize += headerSize;
 				logger.info("total direct buffer size " + totalSize);
 
 				/* second for loop to fill the buffer */
-				buffer = ByteBuffer.allocateDirect(totalSize);
+				buffer = ByteBuffer.allocateDirect((int) totalSize);
 
-				/* marker - 1 byte */
-				buffer.put((byte) 'B');
+				/*
+				 * marker - 1 byte. 'S' marks a part of a slice that has more to come,
+				 * 'B' the last (or only) part of it
+				 */
+				buffer.put((byte) (i < myNextBatch.sliceEnd ? 'S' : 'B'));
 
 				/* batch id - 4 bytes */
 				buffer.putInt(myNextBatch.batchid);
 
 				/* num batches - 4 bytes */
-				buffer.putInt(myNextBatch.records.size() - numskipped);
+				buffer.putInt(part.size());
 
-				for (i = 0; i < myNextBatch.records.size(); i++)
+				for (byte[] bytes : part)
 				{
-					String val = myNextBatch.records.get(i).value();
-					if (val == null)
-						continue;
-					byte[] bytes = val.getBytes(StandardCharsets.UTF_8);
 					/* json length - 4 bytes */
 					buffer.putInt(bytes.length + 1);
 
@@ -966,8 +1191,15 @@ public class DebeziumRunner {
 					buffer.put((byte) 0);
 				}
 				buffer.flip();
+
+				myNextBatch.next = i;
+				if (i == myNextBatch.sliceEnd)
+					myNextBatch.doneEnd = i;
+				partialBatch = (i < myNextBatch.records.size()) ? myNextBatch : null;
+
 				/* save this batch in active batch hash struct */
-				activeBatchHash.put(myNextBatch.batchid, myNextBatch);
+				if (from == 0)
+					activeBatchHash.put(myNextBatch.batchid, myNextBatch);
 			}
 		}
 		else
@@ -1027,6 +1259,17 @@ public class DebeziumRunner {
 			return;
 		}
 		
+		if (markall && myBatch.doneEnd > 0 && myBatch.doneEnd < myBatch.records.size())
+		{
+			/*
+			 * a slice of a larger batch was applied. Mark the records handed out so
+			 * far and keep the batch until its last slice is done
+			 */
+			myBatch.committer.markProcessed(myBatch.records.get(myBatch.doneEnd - 1));
+			logger.info("debezium marked " + myBatch.doneEnd + " records in batchid(" + batchid + ") as processed");
+			return;
+		}
+
 		if (markall)
 		{
 			logger.info("debezium marked all records in batchid(" + batchid + ") as processed");
@@ -1079,6 +1322,76 @@ public class DebeziumRunner {
 		System.gc();
 	}
 	
+	/*
+	 * Adjusts, while the engine runs, the number of records synchdb applies per
+	 * transaction and the memory budget of the batch queue. A batch Debezium
+	 * delivers with more records than maxRecords is handed out in slices.
+	 * maxRecords of 0 hands out whole batches, queueMaxBytes of 0 keeps the
+	 * current budget.
+	 */
+	public void setBatchLimits(int maxRecords, long queueMaxBytes)
+	{
+		maxBatchRecords = Math.max(0, maxRecords);
+		if (queueMaxBytes > 0 && batchManager != null)
+			batchManager.resize(queueMaxBytes);
+		logger.info("batch limits set: maxRecords = " + maxRecords + " queueMaxBytes = " + queueMaxBytes);
+	}
+
+	/*
+	 * Returns the source offset of the last change event handed out from the
+	 * given batch, which is its last slice if it is applied in slices, as the
+	 * JSON text Debezium stores in its offset file, or null if it cannot be
+	 * determined. The caller records it in the transaction that applies the
+	 * batch so that the applied changes and their offset commit together.
+	 */
+	public String getBatchOffset(int batchid)
+	{
+		ChangeRecordBatch myBatch;
+		Object record;
+		Object srcRecord;
+		Map<String, ?> offset;
+
+		if (activeBatchHash == null)
+			return null;
+
+		myBatch = activeBatchHash.get(batchid);
+		if (myBatch == null || myBatch.records == null || myBatch.records.isEmpty())
+			return null;
+
+		/* the offset reached by the slice just handed out, if sliced */
+		if (myBatch.doneEnd > 0)
+			record = myBatch.records.get(myBatch.doneEnd - 1);
+		else
+			record = myBatch.records.get(myBatch.records.size() - 1);
+		try
+		{
+			/*
+			 * converted change events keep their originating SourceRecord but
+			 * do not expose it through the public ChangeEvent interface
+			 */
+			if (sourceRecordMethod == null ||
+				!sourceRecordMethod.getDeclaringClass().isInstance(record))
+			{
+				sourceRecordMethod = record.getClass().getDeclaredMethod("sourceRecord");
+				sourceRecordMethod.setAccessible(true);
+			}
+			srcRecord = sourceRecordMethod.invoke(record);
+			if (!(srcRecord instanceof SourceRecord))
+				return null;
+
+			offset = ((SourceRecord) srcRecord).sourceOffset();
+			if (offset == null)
+				return null;
+
+			return offsetMapper.writeValueAsString(offset);
+		}
+		catch (Exception e)
+		{
+			logger.warn("unable to get source offset of batchid(" + batchid + "): " + e);
+			return null;
+		}
+	}
+
 	public String getConnectorOffset(int connectorType, String db, String name, String dstdb)
 	{
 		File inputFile = null;
@@ -1253,8 +1566,74 @@ public class DebeziumRunner {
 	{
 		checkMemoryStatus();
 	}
+	/*
+	 * Loads the classes a connector worker needs while starting up so that a
+	 * JVM run with -XX:ArchiveClassesAtExit can dump them into a class data
+	 * sharing archive. Engines are built for every connector but never run.
+	 */
+	public static void cdsTraining()
+	{
+		String[] connectors = {
+			"io.debezium.connector.mysql.MySqlConnector",
+			"io.debezium.connector.oracle.OracleConnector",
+			"io.debezium.connector.sqlserver.SqlServerConnector"
+		};
+
+		logger.setLevel(Level.WARN);
+		for (String connector : connectors)
+		{
+			for (int async = 0; async < 2; async++)
+			{
+				Properties props = new Properties();
+				DebeziumEngine.Builder<ChangeEvent<String, String>> builder;
+
+				props.setProperty("name", "cds-training");
+				props.setProperty("connector.class", connector);
+				props.setProperty("offset.storage", "org.apache.kafka.connect.storage.MemoryOffsetBackingStore");
+				props.setProperty("schema.history.internal", "io.debezium.relational.history.MemorySchemaHistory");
+				props.setProperty("topic.prefix", "synchdb-connector");
+
+				if (async == 1)
+					builder = DebeziumEngine.create(KeyValueHeaderChangeEventFormat.of(Json.class, Json.class, Json.class),
+							"io.debezium.embedded.async.ConvertingAsyncEngineBuilderFactory");
+				else
+					builder = DebeziumEngine.create(Json.class);
+
+				try
+				{
+					DebeziumEngine<ChangeEvent<String, String>> engine = builder
+							.using(props)
+							.notifying((records, committer) -> {})
+							.build();
+					engine.close();
+				}
+				catch (Throwable e)
+				{
+					logger.warn("cds training for " + connector + " failed: " + e.getMessage());
+				}
+			}
+		}
+
+		/* classes used when passing batches to synchdb */
+		try
+		{
+			new ObjectMapper().readTree("{\"payload\":{\"op\":\"c\"}}");
+		}
+		catch (IOException e)
+		{
+			logger.warn("cds training failed: " + e.getMessage());
+		}
+		ByteBuffer.allocateDirect(64).put("cds".getBytes(StandardCharsets.UTF_8));
+		new DebeziumRunner();
+	}
+
 	public static void main(String[] args)
 	{
+		if (args.length > 0 && args[0].equals("--cds-training"))
+		{
+			cdsTraining();
+			return;
+		}
 		/* testing code can be put here */
     }
 }
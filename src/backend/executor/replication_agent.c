@@ -18,12 +18,16 @@
 #include "executor/spi.h"
 #include "access/xact.h"
 #include "utils/snapmgr.h"
+#include "utils/portal.h"
+#include "utils/varlena.h"
 #include "access/table.h"
 #include "executor/tuptable.h"
 #include "utils/rel.h"
 #include "utils/lsyscache.h"
 #include "access/tableam.h"
 #include "executor/executor.h"
+#include "executor/execPartition.h"
+#include "access/tupconvert.h"
 #include "utils/snapmgr.h"
 #include "parser/parse_relation.h"
 #include "replication/logicalrelation.h"
@@ -32,6 +36,17 @@
 #include "utils/jsonb.h"
 #include "storage/ipc.h"
 #include "utils/datum.h"
+#include "utils/hsearch.h"
+#include "utils/memutils.h"
+#include "common/hashfn.h"
+#include "storage/bufmgr.h"
+#include "access/heapam.h"
+#include "utils/plancache.h"
+#include "postmaster/interrupt.h"
+#include "utils/guc.h"
+
+/* number of source rows fetched and inserted together during frozen bulk load */
+#define FROZEN_LOAD_BATCH_SIZE 1000
 
 /* external global variables */
 extern bool synchdb_dml_use_spi;
@@ -40,6 +55,11 @@ extern int myConnectorId;
 extern int synchdb_error_strategy;
 extern bool synchdb_log_event_on_error;
 extern char * g_eventStr;
+extern int synchdb_tuple_locator_mem;
+extern bool synchdb_snapshot_defer_index_build;
+extern bool synchdb_snapshot_frozen_load;
+extern int synchdb_fdw_snapshot_workers;
+extern int synchdb_fdw_snapshot_split_size;
 
 /*
  * swap_tokens
@@ -312,6 +332,1036 @@ spi_execute(const char * query, ConnectorType type)
 	return ret;
 }
 
+/*
+ * Tuple locator for target tables without replica identity or primary key
+ * index.
+ *
+ * Without such index, UPDATE and DELETE have to find the old tuple with
+ * RelationFindReplTupleSeq, which is a full sequential scan per change event.
+ * When synchdb.tuple_locator_mem is set, we instead maintain a per-table hash
+ * of full row fingerprint to ctid(s), built lazily by one sequential scan at
+ * first use and kept up to date by the apply path below. A located ctid is
+ * always re-fetched and compared column by column before it is used, so a
+ * stale or colliding entry only results in a fallback to sequential scan.
+ */
+typedef struct locatorRowEntry
+{
+	uint64		fingerprint;	/* hash key: fingerprint of full row */
+	int			ntids;			/* number of tuples having this fingerprint */
+	ItemPointerData tid;		/* first tuple */
+	ItemPointerData *moretids;	/* rest of the tuples, for duplicate rows */
+	int			maxmoretids;
+} LocatorRowEntry;
+
+typedef struct locatorTableEntry
+{
+	Oid			relid;			/* hash key */
+	RelFileNumber relnumber;	/* relfilenumber the ctids belong to */
+	int			natts;			/* natts the fingerprints are computed with */
+	bool		overflow;		/* memory budget exceeded, locator disabled */
+	MemoryContext cxt;			/* holds rows and everything under it */
+	HTAB	   *rows;			/* LocatorRowEntry hashed by fingerprint */
+} LocatorTableEntry;
+
+static HTAB * locatorHash = NULL;
+static MemoryContext locatorContext = NULL;
+
+/*
+ * locator_fingerprint
+ *
+ * compute a fingerprint over the binary image of all non-dropped and
+ * non-generated columns of the given slot
+ */
+static uint64
+locator_fingerprint(TupleTableSlot * slot)
+{
+	TupleDesc	desc = slot->tts_tupleDescriptor;
+	uint64		fp = 0;
+	int			i;
+
+	slot_getallattrs(slot);
+
+	for (i = 0; i < desc->natts; i++)
+	{
+		Form_pg_attribute att = TupleDescAttr(desc, i);
+		uint64		h;
+
+		if (att->attisdropped || att->attgenerated)
+			continue;
+
+		if (slot->tts_isnull[i])
+			h = hash_bytes_uint32_extended((uint32) i, UINT64CONST(0x5ca1ab1e));
+		else if (att->attbyval)
+			h = hash_bytes_extended((const unsigned char *) &slot->tts_values[i],
+									sizeof(Datum), i);
+		else if (att->attlen == -1)
+		{
+			struct varlena *val = PG_DETOAST_DATUM_PACKED(slot->tts_values[i]);
+
+			h = hash_bytes_extended((const unsigned char *) VARDATA_ANY(val),
+									VARSIZE_ANY_EXHDR(val), i);
+			if ((Pointer) val != DatumGetPointer(slot->tts_values[i]))
+				pfree(val);
+		}
+		else if (att->attlen == -2)
+		{
+			char	   *str = DatumGetCString(slot->tts_values[i]);
+
+			h = hash_bytes_extended((const unsigned char *) str, strlen(str), i);
+		}
+		else
+			h = hash_bytes_extended((const unsigned char *) DatumGetPointer(slot->tts_values[i]),
+									att->attlen, i);
+
+		fp = hash_combine64(fp, h);
+	}
+	return fp;
+}
+
+/*
+ * locator_tuples_equal
+ *
+ * binary comparison of all non-dropped and non-generated columns of two slots
+ */
+static bool
+locator_tuples_equal(TupleTableSlot * slot1, TupleTableSlot * slot2)
+{
+	TupleDesc	desc = slot1->tts_tupleDescriptor;
+	int			i;
+
+	slot_getallattrs(slot1);
+	slot_getallattrs(slot2);
+
+	for (i = 0; i < desc->natts; i++)
+	{
+		Form_pg_attribute att = TupleDescAttr(desc, i);
+
+		if (att->attisdropped || att->attgenerated)
+			continue;
+
+		if (slot1->tts_isnull[i] != slot2->tts_isnull[i])
+			return false;
+
+		if (slot1->tts_isnull[i])
+			continue;
+
+		if (!datum_image_eq(slot1->tts_values[i], slot2->tts_values[i],
+							att->attbyval, att->attlen))
+			return false;
+	}
+	return true;
+}
+
+/*
+ * locator_remember
+ *
+ * add a fingerprint to ctid entry to the locator. Returns false if the memory
+ * budget has been exceeded, in which case the caller disables the locator.
+ */
+static bool
+locator_remember(LocatorTableEntry * entry, uint64 fingerprint, ItemPointer tid)
+{
+	LocatorRowEntry * row;
+	MemoryContext oldctx;
+	bool found;
+
+	row = (LocatorRowEntry *) hash_search(entry->rows, &fingerprint, HASH_ENTER, &found);
+	if (!found)
+	{
+		row->ntids = 1;
+		ItemPointerCopy(tid, &row->tid);
+		row->moretids = NULL;
+		row->maxmoretids = 0;
+	}
+	else
+	{
+		oldctx = MemoryContextSwitchTo(entry->cxt);
+		if (row->moretids == NULL)
+		{
+			row->maxmoretids = 4;
+			row->moretids = palloc(sizeof(ItemPointerData) * row->maxmoretids);
+		}
+		else if (row->ntids - 1 >= row->maxmoretids)
+		{
+			row->maxmoretids *= 2;
+			row->moretids = repalloc(row->moretids,
+									 sizeof(ItemPointerData) * row->maxmoretids);
+		}
+		ItemPointerCopy(tid, &row->moretids[row->ntids - 1]);
+		row->ntids++;
+		MemoryContextSwitchTo(oldctx);
+	}
+
+	return MemoryContextMemAllocated(locatorContext, true) <=
+		(Size) synchdb_tuple_locator_mem * 1024;
+}
+
+/*
+ * locator_forget
+ *
+ * remove a fingerprint to ctid entry from the locator, if present
+ */
+static void
+locator_forget(LocatorTableEntry * entry, uint64 fingerprint, ItemPointer tid)
+{
+	LocatorRowEntry * row;
+	int i;
+
+	row = (LocatorRowEntry *) hash_search(entry->rows, &fingerprint, HASH_FIND, NULL);
+	if (!row)
+		return;
+
+	if (ItemPointerEquals(&row->tid, tid))
+	{
+		if (row->ntids == 1)
+		{
+			if (row->moretids)
+				pfree(row->moretids);
+			hash_search(entry->rows, &fingerprint, HASH_REMOVE, NULL);
+			return;
+		}
+		/* move the last one to the first slot */
+		ItemPointerCopy(&row->moretids[row->ntids - 2], &row->tid);
+		row->ntids--;
+		return;
+	}
+
+	for (i = 0; i < row->ntids - 1; i++)
+	{
+		if (ItemPointerEquals(&row->moretids[i], tid))
+		{
+			ItemPointerCopy(&row->moretids[row->ntids - 2], &row->moretids[i]);
+			row->ntids--;
+			return;
+		}
+	}
+}
+
+/*
+ * locator_disable
+ *
+ * release the memory of a table's locator and stop using it for this table
+ */
+static void
+locator_disable(LocatorTableEntry * entry, Relation rel)
+{
+	elog(LOG, "tuple locator for table %s exceeds synchdb.tuple_locator_mem (%d kB). "
+		 "Falling back to sequential scan to locate old tuples",
+		 RelationGetRelationName(rel), synchdb_tuple_locator_mem);
+
+	if (entry->cxt)
+		MemoryContextDelete(entry->cxt);
+	entry->cxt = NULL;
+	entry->rows = NULL;
+	entry->overflow = true;
+}
+
+/*
+ * locator_get
+ *
+ * returns the tuple locator of given relation, or NULL if the locator is not
+ * enabled or not usable for this relation. If build is true, a missing or
+ * outdated locator is (re)built by scanning the relation once.
+ */
+static LocatorTableEntry *
+locator_get(Relation rel, bool build)
+{
+	LocatorTableEntry * entry;
+	HASHCTL		ctl;
+	bool		found;
+	Oid			relid = RelationGetRelid(rel);
+	TableScanDesc scan;
+	TupleTableSlot *scanslot;
+	Snapshot	snap;
+
+	if (synchdb_tuple_locator_mem <= 0)
+		return NULL;
+
+	if (locatorHash == NULL)
+	{
+		locatorContext = AllocSetContextCreate(TopMemoryContext,
+											   "synchdb tuple locator",
+											   ALLOCSET_DEFAULT_SIZES);
+		memset(&ctl, 0, sizeof(ctl));
+		ctl.keysize = sizeof(Oid);
+		ctl.entrysize = sizeof(LocatorTableEntry);
+		ctl.hcxt = locatorContext;
+		locatorHash = hash_create("synchdb tuple locator tables", 64, &ctl,
+								  HASH_ELEM | HASH_BLOBS | HASH_CONTEXT);
+	}
+
+	entry = (LocatorTableEntry *) hash_search(locatorHash, &relid,
+											  build ? HASH_ENTER : HASH_FIND, &found);
+	if (!entry)
+		return NULL;
+
+	if (!found)
+	{
+		entry->relnumber = InvalidRelFileNumber;
+		entry->natts = 0;
+		entry->overflow = false;
+		entry->cxt = NULL;
+		entry->rows = NULL;
+	}
+
+	/* relation rewritten or altered since we built it: ctids or fingerprints are no good */
+	if (entry->relnumber != rel->rd_locator.relNumber ||
+		entry->natts != RelationGetDescr(rel)->natts)
+	{
+		if (entry->cxt)
+			MemoryContextDelete(entry->cxt);
+		entry->cxt = NULL;
+		entry->rows = NULL;
+		entry->overflow = false;
+	}
+
+	if (entry->overflow)
+		return NULL;
+
+	if (entry->rows)
+		return entry;
+
+	if (!build)
+		return NULL;
+
+	entry->relnumber = rel->rd_locator.relNumber;
+	entry->natts = RelationGetDescr(rel)->natts;
+	entry->cxt = AllocSetContextCreate(locatorContext,
+									   "synchdb tuple locator rows",
+									   ALLOCSET_DEFAULT_SIZES);
+	memset(&ctl, 0, sizeof(ctl));
+	ctl.keysize = sizeof(uint64);
+	ctl.entrysize = sizeof(LocatorRowEntry);
+	ctl.hcxt = entry->cxt;
+	entry->rows = hash_create("synchdb tuple locator rows", 1024, &ctl,
+							  HASH_ELEM | HASH_BLOBS | HASH_CONTEXT);
+
+	elog(DEBUG1, "building tuple locator for table %s", RelationGetRelationName(rel));
+
+	snap = RegisterSnapshot(GetLatestSnapshot());
+	scan = table_beginscan(rel, snap, 0, NULL);
+	scanslot = table_slot_create(rel, NULL);
+
+	while (table_scan_getnextslot(scan, ForwardScanDirection, scanslot))
+	{
+		if (!locator_remember(entry, locator_fingerprint(scanslot), &scanslot->tts_tid))
+		{
+			locator_disable(entry, rel);
+			break;
+		}
+	}
+
+	ExecDropSingleTupleTableSlot(scanslot);
+	table_endscan(scan);
+	UnregisterSnapshot(snap);
+
+	return entry->overflow ? NULL : entry;
+}
+
+/*
+ * locator_find_tuple
+ *
+ * locate the tuple matching searchslot using the tuple locator and lock it
+ * into outslot. Returns false if not found, in which case the caller should
+ * fall back to sequential scan.
+ */
+static bool
+locator_find_tuple(LocatorTableEntry * entry, Relation rel, LockTupleMode lockmode,
+		TupleTableSlot * searchslot, TupleTableSlot * outslot)
+{
+	LocatorRowEntry * row;
+	uint64		fingerprint = locator_fingerprint(searchslot);
+	BlockNumber nblocks;
+	int			i;
+
+	row = (LocatorRowEntry *) hash_search(entry->rows, &fingerprint, HASH_FIND, NULL);
+	if (!row)
+		return false;
+
+	nblocks = RelationGetNumberOfBlocks(rel);
+	for (i = 0; i < row->ntids; i++)
+	{
+		ItemPointerData tid;
+		TM_FailureData tmfd;
+		TM_Result	res;
+
+		ItemPointerCopy(i == 0 ? &row->tid : &row->moretids[i - 1], &tid);
+
+		/* stale entry pointing past the end of relation */
+		if (ItemPointerGetBlockNumber(&tid) >= nblocks)
+			continue;
+
+		if (!table_tuple_fetch_row_version(rel, &tid, GetLatestSnapshot(), outslot))
+			continue;
+
+		/* verify, as the entry may be stale or a fingerprint collision */
+		if (!locator_tuples_equal(searchslot, outslot))
+			continue;
+
+		PushActiveSnapshot(GetLatestSnapshot());
+		res = table_tuple_lock(rel, &tid, GetLatestSnapshot(), outslot,
+							   GetCurrentCommandId(false), lockmode,
+							   LockWaitBlock, 0, &tmfd);
+		PopActiveSnapshot();
+
+		if (res == TM_Ok)
+			return true;
+	}
+	return false;
+}
+
+/*
+ * find_old_tuple
+ *
+ * locate and lock the local tuple an UPDATE or DELETE change event refers to.
+ * remoteslot carries the key columns if rel has a replica identity or primary
+ * key index, otherwise the full old row. If rel has a tuple locator, it is
+ * returned in *locator so the caller can keep it up to date.
+ */
+static bool
+find_old_tuple(Relation rel, TupleTableSlot * remoteslot, TupleTableSlot * localslot,
+		SynchdbStatistics * myBatchStats, LocatorTableEntry ** locator)
+{
+	Oid			idxoid = GetRelationIdentityOrPK(rel);
+	bool		found = false;
+
+	*locator = NULL;
+	if (OidIsValid(idxoid))
+	{
+		elog(DEBUG1, "attempt to find old tuple by index");
+		return RelationFindReplTupleByIndex(rel, idxoid, LockTupleExclusive,
+											remoteslot, localslot);
+	}
+
+	*locator = locator_get(rel, true);
+	if (*locator)
+	{
+		elog(DEBUG1, "attempt to find old tuple by tuple locator");
+		found = locator_find_tuple(*locator, rel, LockTupleExclusive,
+								   remoteslot, localslot);
+		increment_connector_statistics(myBatchStats,
+				found ? STATS_LOCATOR_HIT : STATS_LOCATOR_MISS, 1);
+	}
+
+	if (!found)
+	{
+		elog(DEBUG1, "attempt to find old tuple by seq scan");
+		found = RelationFindReplTupleSeq(rel, LockTupleExclusive,
+										 remoteslot, localslot);
+	}
+	return found;
+}
+
+/*
+ * ra_canInsertFrozen
+ *
+ * Checks if tuples can be inserted into the given relation already frozen.
+ * Like COPY FREEZE, this is only safe when the relation was created or got
+ * a new relfilenode in the current subtransaction, so no other transaction
+ * can see the tuples before they are committed and an abort discards them
+ * together with the relfilenode. Like COPY FREEZE, it also requires that no
+ * older snapshot is registered and no portal is open, for example when called
+ * from a loop in a PL/pgSQL function, because such a snapshot would see the
+ * frozen tuples. Relations with triggers or generated columns go through the
+ * regular insert path.
+ */
+bool
+ra_canInsertFrozen(Relation rel)
+{
+	SubTransactionId mysubid = GetCurrentSubTransactionId();
+
+	if (rel->rd_rel->relkind != RELKIND_RELATION)
+		return false;
+
+	if (rel->trigdesc != NULL)
+		return false;
+
+	if (rel->rd_att->constr && rel->rd_att->constr->has_generated_stored)
+		return false;
+
+#if SYNCHDB_PG_MAJOR_VERSION >= 1800
+	if (rel->rd_att->constr && rel->rd_att->constr->has_generated_virtual)
+		return false;
+#endif
+
+	if (rel->rd_createSubid != mysubid &&
+		rel->rd_newRelfilelocatorSubid != mysubid)
+		return false;
+
+	/* COPY FREEZE raises an error here, we use the regular insert instead */
+	if (!ThereAreNoPriorRegisteredSnapshots() || !ThereAreNoReadyPortals())
+	{
+		elog(DEBUG1, "an older snapshot or open portal prevents frozen insert into %s",
+				RelationGetRelationName(rel));
+		return false;
+	}
+	return true;
+}
+
+/*
+ * Partition routing for partitioned target tables.
+ *
+ * A change event names the partitioned table, which has no storage of its
+ * own, so each row is routed to its leaf partition with ExecFindPartition.
+ * The routing state of a table, which includes the ResultRelInfo, indexes and
+ * conversion maps of every partition rows were routed to, is kept until the
+ * transaction applying the batch ends, so it is set up only once per table
+ * and batch. DDL applied within the batch discards it, as it may change the
+ * partitions.
+ */
+typedef struct PartRouteEntry
+{
+	Oid			relid;			/* hash key */
+	Relation	rel;			/* the partitioned table */
+	EState	   *estate;
+	ResultRelInfo *rootResultRelInfo;
+	ModifyTableState *mtstate;	/* dummy, ExecFindPartition needs one */
+	PartitionTupleRouting *proute;
+	TupleTableSlot *rootslot;	/* change event row in root format */
+	TupleTableSlot *newslot;	/* new row of an UPDATE in root format */
+} PartRouteEntry;
+
+static HTAB * partRouteHash = NULL;
+static bool partRouteCallbackRegistered = false;
+
+/*
+ * partroute_release
+ *
+ * tear down the routing state of one partitioned table
+ */
+static void
+partroute_release(PartRouteEntry * entry)
+{
+	ExecCleanupTupleRouting(entry->mtstate, entry->proute);
+	ExecCloseResultRelations(entry->estate);
+	ExecResetTupleTable(entry->estate->es_tupleTable, false);
+	FreeExecutorState(entry->estate);
+	table_close(entry->rel, NoLock);
+}
+
+/*
+ * partroute_forget
+ *
+ * discard the routing state of the given table, if any
+ */
+static void
+partroute_forget(Oid tableoid)
+{
+	PartRouteEntry * entry;
+
+	if (!partRouteHash)
+		return;
+
+	entry = (PartRouteEntry *) hash_search(partRouteHash, &tableoid, HASH_REMOVE, NULL);
+	if (entry)
+		partroute_release(entry);
+}
+
+/*
+ * partroute_release_all
+ *
+ * discard the routing state of all tables
+ */
+static void
+partroute_release_all(void)
+{
+	HASH_SEQ_STATUS status;
+	PartRouteEntry * entry;
+
+	if (!partRouteHash)
+		return;
+
+	hash_seq_init(&status, partRouteHash);
+	while ((entry = (PartRouteEntry *) hash_seq_search(&status)) != NULL)
+		partroute_release(entry);
+
+	hash_destroy(partRouteHash);
+	partRouteHash = NULL;
+}
+
+/*
+ * partroute_xact_callback
+ *
+ * routing state lives until the end of the transaction applying the batch.
+ * On abort, the resource owner closes the relations and the memory goes
+ * away with TopTransactionContext.
+ */
+static void
+partroute_xact_callback(XactEvent event, void *arg)
+{
+	switch (event)
+	{
+		case XACT_EVENT_PRE_COMMIT:
+			partroute_release_all();
+			break;
+		case XACT_EVENT_ABORT:
+			partRouteHash = NULL;
+			break;
+		default:
+			break;
+	}
+}
+
+/*
+ * partroute_get
+ *
+ * get the routing state of a partitioned table, setting it up at first use
+ * in the current transaction
+ */
+static PartRouteEntry *
+partroute_get(Oid tableoid)
+{
+	PartRouteEntry * entry;
+	PartRouteEntry newentry = {0};
+	HASHCTL		ctl;
+	bool		found;
+	RangeTblEntry *rte;
+	List	   *perminfos = NIL;
+	MemoryContext oldctx;
+
+	if (partRouteHash)
+	{
+		entry = (PartRouteEntry *) hash_search(partRouteHash, &tableoid, HASH_FIND, NULL);
+		if (entry)
+			return entry;
+	}
+
+	oldctx = MemoryContextSwitchTo(TopTransactionContext);
+
+	newentry.relid = tableoid;
+	newentry.rel = table_open(tableoid, AccessShareLock);
+	newentry.estate = CreateExecutorState();
+
+	rte = makeNode(RangeTblEntry);
+	rte->rtekind = RTE_RELATION;
+	rte->relid = tableoid;
+	rte->relkind = newentry.rel->rd_rel->relkind;
+	rte->rellockmode = AccessShareLock;
+
+	addRTEPermissionInfo(&perminfos, rte);
+
+#if SYNCHDB_PG_MAJOR_VERSION >= 1800
+	ExecInitRangeTable(newentry.estate, list_make1(rte), perminfos,
+			bms_make_singleton(1));
+#else
+	ExecInitRangeTable(newentry.estate, list_make1(rte), perminfos);
+#endif
+
+	newentry.rootResultRelInfo = makeNode(ResultRelInfo);
+	InitResultRelInfo(newentry.rootResultRelInfo, newentry.rel, 1, NULL, 0);
+
+	newentry.mtstate = makeNode(ModifyTableState);
+	newentry.mtstate->ps.plan = NULL;
+	newentry.mtstate->ps.state = newentry.estate;
+	newentry.mtstate->operation = CMD_INSERT;
+	newentry.mtstate->resultRelInfo = newentry.rootResultRelInfo;
+
+	newentry.proute = ExecSetupPartitionTupleRouting(newentry.estate, newentry.rel);
+	newentry.rootslot = ExecInitExtraTupleSlot(newentry.estate,
+			RelationGetDescr(newentry.rel), &TTSOpsVirtual);
+	newentry.newslot = ExecInitExtraTupleSlot(newentry.estate,
+			RelationGetDescr(newentry.rel), &TTSOpsVirtual);
+
+	if (!partRouteHash)
+	{
+		if (!partRouteCallbackRegistered)
+		{
+			RegisterXactCallback(partroute_xact_callback, NULL);
+			partRouteCallbackRegistered = true;
+		}
+
+		memset(&ctl, 0, sizeof(ctl));
+		ctl.keysize = sizeof(Oid);
+		ctl.entrysize = sizeof(PartRouteEntry);
+		ctl.hcxt = TopTransactionContext;
+		partRouteHash = hash_create("synchdb partition routing", 16, &ctl,
+									HASH_ELEM | HASH_BLOBS | HASH_CONTEXT);
+	}
+	MemoryContextSwitchTo(oldctx);
+
+	elog(DEBUG1, "set up partition routing for table %s",
+		 RelationGetRelationName(newentry.rel));
+
+	entry = (PartRouteEntry *) hash_search(partRouteHash, &tableoid, HASH_ENTER, &found);
+	*entry = newentry;
+	return entry;
+}
+
+/*
+ * partroute_find
+ *
+ * route a row in root format to its leaf partition and return the partition
+ * with the row converted to its format in *partslot
+ */
+static ResultRelInfo *
+partroute_find(PartRouteEntry * entry, TupleTableSlot * rootslot,
+		TupleTableSlot ** partslot)
+{
+	ResultRelInfo *partrri;
+	TupleConversionMap *map;
+
+	partrri = ExecFindPartition(entry->mtstate, entry->rootResultRelInfo,
+								entry->proute, rootslot, entry->estate);
+
+	if (partrri->ri_RelationDesc->rd_rel->relkind != RELKIND_RELATION)
+		elog(ERROR, "cannot apply change events to partition %s of table %s, "
+			 "which is not a plain table",
+			 RelationGetRelationName(partrri->ri_RelationDesc),
+			 RelationGetRelationName(entry->rel));
+
+	/* a map exists only if the partition's row layout differs from root's */
+	map = ExecGetRootToChildMap(partrri, entry->estate);
+	if (map)
+		*partslot = execute_attr_map_slot(map->attrMap, rootslot,
+										  partrri->ri_PartitionTupleSlot);
+	else
+		*partslot = rootslot;
+
+	return partrri;
+}
+
+/*
+ * fill_slot_values
+ *
+ * convert the column values of a change event into slot attributes
+ */
+static void
+fill_slot_values(TupleTableSlot * slot, List * colvals)
+{
+	ListCell   *cell;
+
+	foreach(cell, colvals)
+	{
+		PG_DML_COLUMN_VALUE * colval = (PG_DML_COLUMN_VALUE *) lfirst(cell);
+		Form_pg_attribute attr = TupleDescAttr(slot->tts_tupleDescriptor, colval->position - 1);
+		Oid			typinput;
+		Oid			typioparam;
+
+		if (colval->isdatum)
+		{
+			slot->tts_values[colval->position - 1] = colval->datum;
+			slot->tts_isnull[colval->position - 1] = false;
+		}
+		else if (!strcasecmp(colval->value, "NULL"))
+			slot->tts_isnull[colval->position - 1] = true;
+		else
+		{
+			getTypeInputInfo(colval->datatype, &typinput, &typioparam);
+			slot->tts_values[colval->position - 1] =
+				OidInputFunctionCall(typinput, colval->value,
+									 typioparam, attr->atttypmod);
+			slot->tts_isnull[colval->position - 1] = false;
+		}
+	}
+}
+
+/*
+ * partroute_store_row
+ *
+ * store a change event row into the root format slot of a routing state
+ */
+static void
+partroute_store_row(PartRouteEntry * entry, List * colvals)
+{
+	TupleTableSlot *slot = entry->rootslot;
+	int			i;
+
+	ExecClearTuple(slot);
+	for (i = 0; i < slot->tts_tupleDescriptor->natts; i++)
+		slot->tts_isnull[i] = true;
+	fill_slot_values(slot, colvals);
+	ExecStoreVirtualTuple(slot);
+}
+
+/*
+ * report_apply_error
+ *
+ * save the error being handled in synchdb's shared memory state so user will
+ * have an idea what is wrong, and log the change event causing it if wanted
+ */
+static void
+report_apply_error(void)
+{
+	MemoryContext oldctx = MemoryContextSwitchTo(TopMemoryContext);
+	ErrorData  *errdata = CopyErrorData();
+	if (errdata)
+	{
+		char * msg = palloc0(SYNCHDB_ERRMSG_SIZE);
+		snprintf(msg, SYNCHDB_ERRMSG_SIZE, "%s.%s: %s | %s",
+				errdata->schema_name == NULL ? "" : errdata->schema_name,
+				errdata->table_name == NULL ? "" : errdata->table_name,
+				errdata->message,
+				errdata->detail == NULL ? "" : errdata->detail);
+		set_shm_connector_errmsg(myConnectorId, msg);
+		pfree(msg);
+	}
+	FreeErrorData(errdata);
+	MemoryContextSwitchTo(oldctx);
+
+	/* dump the JSON change event as additional detail if available */
+	if (synchdb_log_event_on_error && g_eventStr != NULL)
+		elog(LOG, "%s", g_eventStr);
+}
+
+/*
+ * synchdb_handle_routed_insert - INSERT into a partitioned table
+ */
+static int
+synchdb_handle_routed_insert(List * colval, Oid tableoid)
+{
+	PartRouteEntry * entry;
+	ResultRelInfo *partrri;
+	TupleTableSlot *partslot;
+	LocatorTableEntry * locator = NULL;
+
+	PG_TRY();
+	{
+		entry = partroute_get(tableoid);
+		entry->estate->es_output_cid = GetCurrentCommandId(true);
+		entry->mtstate->operation = CMD_INSERT;
+
+		partroute_store_row(entry, colval);
+		partrri = partroute_find(entry, entry->rootslot, &partslot);
+
+		ExecSimpleRelationInsert(partrri, entry->estate, partslot);
+
+		/* keep tuple locator up to date if this partition has one */
+		locator = locator_get(partrri->ri_RelationDesc, false);
+		if (locator && !locator_remember(locator, locator_fingerprint(partslot),
+										 &partslot->tts_tid))
+			locator_disable(locator, partrri->ri_RelationDesc);
+
+		ResetPerTupleExprContext(entry->estate);
+
+		/* increment command ID */
+		CommandCounterIncrement();
+	}
+	PG_CATCH();
+	{
+		report_apply_error();
+
+		if (synchdb_error_strategy == STRAT_SKIP_ON_ERROR)
+		{
+			partroute_forget(tableoid);
+			FlushErrorState();
+			return -1;
+		}
+		PG_RE_THROW();
+	}
+	PG_END_TRY();
+	return 0;
+}
+
+/*
+ * synchdb_handle_routed_update - UPDATE of a partitioned table
+ *
+ * The old row is looked up in the partition its key routes to. If the new
+ * row no longer satisfies that partition's constraint, it is moved: deleted
+ * from the old partition and inserted into the one it routes to now.
+ */
+static int
+synchdb_handle_routed_update(List * colvalbefore, List * colvalafter, Oid tableoid,
+		SynchdbStatistics * myBatchStats)
+{
+	PartRouteEntry * entry;
+	ResultRelInfo *partrri, *newpartrri;
+	Relation	partrel;
+	TupleTableSlot *keyslot, *newslot, *partslot;
+	TupleTableSlot *localslot = NULL;
+	TupleConversionMap *map;
+	EPQState	epqstate;
+	bool		epqinit = false;
+	LocatorTableEntry * locator = NULL;
+	LocatorTableEntry * newlocator = NULL;
+	uint64		oldfingerprint = 0;
+	ItemPointerData oldtid;
+
+	PG_TRY();
+	{
+		entry = partroute_get(tableoid);
+		entry->estate->es_output_cid = GetCurrentCommandId(true);
+		entry->mtstate->operation = CMD_UPDATE;
+
+		partroute_store_row(entry, colvalbefore);
+		partrri = partroute_find(entry, entry->rootslot, &keyslot);
+		partrel = partrri->ri_RelationDesc;
+
+		localslot = table_slot_create(partrel, NULL);
+		EvalPlanQualInit(&epqstate, entry->estate, NULL, NIL, -1, NIL);
+		epqinit = true;
+
+		if (!find_old_tuple(partrel, keyslot, localslot, myBatchStats, &locator))
+			elog(ERROR, "tuple to update not found");
+
+		if (locator)
+		{
+			oldfingerprint = locator_fingerprint(localslot);
+			ItemPointerCopy(&localslot->tts_tid, &oldtid);
+		}
+
+		/*
+		 * build the new row in root format from the local row, as colvalafter
+		 * carries root attribute numbers and only the changed columns
+		 */
+		newslot = entry->newslot;
+		map = ExecGetChildToRootMap(partrri);
+		if (map)
+			newslot = execute_attr_map_slot(map->attrMap, localslot, newslot);
+		else
+		{
+			ExecClearTuple(newslot);
+			slot_getallattrs(localslot);
+			memcpy(newslot->tts_values, localslot->tts_values,
+				   sizeof(Datum) * newslot->tts_tupleDescriptor->natts);
+			memcpy(newslot->tts_isnull, localslot->tts_isnull,
+				   sizeof(bool) * newslot->tts_tupleDescriptor->natts);
+			ExecStoreVirtualTuple(newslot);
+		}
+		fill_slot_values(newslot, colvalafter);
+
+		map = ExecGetRootToChildMap(partrri, entry->estate);
+		if (map)
+			partslot = execute_attr_map_slot(map->attrMap, newslot,
+											 partrri->ri_PartitionTupleSlot);
+		else
+			partslot = newslot;
+
+		if (!partrel->rd_rel->relispartition ||
+			ExecPartitionCheck(partrri, partslot, entry->estate, false))
+		{
+			/* the row stays in its partition */
+			EvalPlanQualSetSlot(&epqstate, partslot);
+			ExecSimpleRelationUpdate(partrri, entry->estate, &epqstate, localslot,
+									 partslot);
+
+			if (locator)
+			{
+				locator_forget(locator, oldfingerprint, &oldtid);
+				if (!locator_remember(locator, locator_fingerprint(partslot),
+									  &partslot->tts_tid))
+					locator_disable(locator, partrel);
+			}
+		}
+		else
+		{
+			/* the row moves to another partition */
+			elog(DEBUG1, "moving updated row out of partition %s",
+				 RelationGetRelationName(partrel));
+
+			EvalPlanQualSetSlot(&epqstate, localslot);
+			ExecSimpleRelationDelete(partrri, entry->estate, &epqstate, localslot);
+			if (locator)
+				locator_forget(locator, oldfingerprint, &oldtid);
+
+			newpartrri = partroute_find(entry, newslot, &partslot);
+			ExecSimpleRelationInsert(newpartrri, entry->estate, partslot);
+
+			newlocator = locator_get(newpartrri->ri_RelationDesc, false);
+			if (newlocator && !locator_remember(newlocator, locator_fingerprint(partslot),
+												&partslot->tts_tid))
+				locator_disable(newlocator, newpartrri->ri_RelationDesc);
+		}
+
+		EvalPlanQualEnd(&epqstate);
+		ExecDropSingleTupleTableSlot(localslot);
+		ResetPerTupleExprContext(entry->estate);
+
+		/* increment command ID */
+		CommandCounterIncrement();
+	}
+	PG_CATCH();
+	{
+		report_apply_error();
+
+		if (synchdb_error_strategy == STRAT_SKIP_ON_ERROR)
+		{
+			if (epqinit)
+				EvalPlanQualEnd(&epqstate);
+			if (localslot)
+				ExecDropSingleTupleTableSlot(localslot);
+			partroute_forget(tableoid);
+			FlushErrorState();
+			return -1;
+		}
+		PG_RE_THROW();
+	}
+	PG_END_TRY();
+	return 0;
+}
+
+/*
+ * synchdb_handle_routed_delete - DELETE from a partitioned table
+ */
+static int
+synchdb_handle_routed_delete(List * colvalbefore, Oid tableoid,
+		SynchdbStatistics * myBatchStats)
+{
+	PartRouteEntry * entry;
+	ResultRelInfo *partrri;
+	TupleTableSlot *keyslot;
+	TupleTableSlot *localslot = NULL;
+	EPQState	epqstate;
+	bool		epqinit = false;
+	LocatorTableEntry * locator = NULL;
+	uint64		oldfingerprint = 0;
+	ItemPointerData oldtid;
+
+	PG_TRY();
+	{
+		entry = partroute_get(tableoid);
+		entry->estate->es_output_cid = GetCurrentCommandId(true);
+		entry->mtstate->operation = CMD_DELETE;
+
+		partroute_store_row(entry, colvalbefore);
+		partrri = partroute_find(entry, entry->rootslot, &keyslot);
+
+		localslot = table_slot_create(partrri->ri_RelationDesc, NULL);
+		EvalPlanQualInit(&epqstate, entry->estate, NULL, NIL, -1, NIL);
+		epqinit = true;
+
+		if (!find_old_tuple(partrri->ri_RelationDesc, keyslot, localslot,
+							myBatchStats, &locator))
+			elog(ERROR, "tuple to delete not found");
+
+		if (locator)
+		{
+			oldfingerprint = locator_fingerprint(localslot);
+			ItemPointerCopy(&localslot->tts_tid, &oldtid);
+		}
+
+		EvalPlanQualSetSlot(&epqstate, localslot);
+		ExecSimpleRelationDelete(partrri, entry->estate, &epqstate, localslot);
+
+		if (locator)
+			locator_forget(locator, oldfingerprint, &oldtid);
+
+		EvalPlanQualEnd(&epqstate);
+		ExecDropSingleTupleTableSlot(localslot);
+		ResetPerTupleExprContext(entry->estate);
+
+		/* increment command ID */
+		CommandCounterIncrement();
+	}
+	PG_CATCH();
+	{
+		report_apply_error();
+
+		if (synchdb_error_strategy == STRAT_SKIP_ON_ERROR)
+		{
+			if (epqinit)
+				EvalPlanQualEnd(&epqstate);
+			if (localslot)
+				ExecDropSingleTupleTableSlot(localslot);
+			partroute_forget(tableoid);
+			FlushErrorState();
+			return -1;
+		}
+		PG_RE_THROW();
+	}
+	PG_END_TRY();
+	return 0;
+}
+
 /*
  * synchdb_handle_insert - Custom handler for INSERT operations
  *
@@ -319,7 +1369,8 @@ spi_execute(const char * query, ConnectorType type)
  * It creates a tuple from the provided column values and inserts it into the table.
  */
 static int
-synchdb_handle_insert(List * colval, Oid tableoid, ConnectorType type, int natts)
+synchdb_handle_insert(List * colval, Oid tableoid, ConnectorType type, int natts,
+		bool snapshot)
 {
 	Relation rel = NULL;
 	TupleTableSlot *slot;
@@ -329,6 +1380,11 @@ synchdb_handle_insert(List * colval, Oid tableoid, ConnectorType type, int natts
 	ResultRelInfo *resultRelInfo = NULL;
 	ListCell * cell;
 	int i = 0;
+	LocatorTableEntry * locator = NULL;
+
+	/* partitioned tables have no storage, each row goes to its partition */
+	if (get_rel_relkind(tableoid) == RELKIND_PARTITIONED_TABLE)
+		return synchdb_handle_routed_insert(colval, tableoid);
 
 	/*
 	 * we put in TRY and CATCH block to capture potential exceptions raised
@@ -380,7 +1436,12 @@ synchdb_handle_insert(List * colval, Oid tableoid, ConnectorType type, int natts
 			Oid			typinput;
 			Oid			typioparam;
 
-			if (!strcasecmp(colval->value, "NULL"))
+			if (colval->isdatum)
+			{
+				slot->tts_values[colval->position - 1] = colval->datum;
+				slot->tts_isnull[colval->position - 1] = false;
+			}
+			else if (!strcasecmp(colval->value, "NULL"))
 				slot->tts_isnull[colval->position - 1] = true;
 			else
 			{
@@ -397,7 +1458,27 @@ synchdb_handle_insert(List * colval, Oid tableoid, ConnectorType type, int natts
 		ExecOpenIndices(resultRelInfo, false);
 
 		/* Do the insert. */
-		ExecSimpleRelationInsert(resultRelInfo, estate, slot);
+		if (snapshot && synchdb_snapshot_frozen_load && ra_canInsertFrozen(rel))
+		{
+			List	   *recheckIndexes = NIL;
+
+			if (rel->rd_att->constr)
+				ExecConstraints(resultRelInfo, slot, estate);
+
+			table_tuple_insert(rel, slot, estate->es_output_cid, TABLE_INSERT_FROZEN, NULL);
+
+			if (resultRelInfo->ri_NumIndices > 0)
+				recheckIndexes = ExecInsertIndexTuples(resultRelInfo, slot, estate,
+													   false, false, NULL, NIL, false);
+			list_free(recheckIndexes);
+		}
+		else
+			ExecSimpleRelationInsert(resultRelInfo, estate, slot);
+
+		/* keep tuple locator up to date if this table has one */
+		locator = locator_get(rel, false);
+		if (locator && !locator_remember(locator, locator_fingerprint(slot), &slot->tts_tid))
+			locator_disable(locator, rel);
 
 		/* increment command ID */
 		CommandCounterIncrement();
@@ -455,7 +1536,8 @@ synchdb_handle_insert(List * colval, Oid tableoid, ConnectorType type, int natts
  * and replaces the old tuple with the new one.
  */
 static int
-synchdb_handle_update(List * colvalbefore, List * colvalafter, Oid tableoid, ConnectorType type, int natts)
+synchdb_handle_update(List * colvalbefore, List * colvalafter, Oid tableoid, ConnectorType type, int natts,
+		SynchdbStatistics * myBatchStats)
 {
 	Relation rel = NULL;
 	TupleTableSlot * remoteslot, * localslot;
@@ -467,7 +1549,14 @@ synchdb_handle_update(List * colvalbefore, List * colvalafter, Oid tableoid, Con
 	int ret = 0, i = 0;
 	EPQState	epqstate;
 	bool found;
-	Oid idxoid = InvalidOid;
+	LocatorTableEntry * locator = NULL;
+	uint64 oldfingerprint = 0;
+	ItemPointerData oldtid;
+
+	/* partitioned tables have no storage, each row goes to its partition */
+	if (get_rel_relkind(tableoid) == RELKIND_PARTITIONED_TABLE)
+		return synchdb_handle_routed_update(colvalbefore, colvalafter, tableoid,
+				myBatchStats);
 
 	/*
 	 * we put in TRY and CATCH block to capture potential exceptions raised
@@ -512,7 +1601,11 @@ synchdb_handle_update(List * colvalbefore, List * colvalafter, Oid tableoid, Con
 		for (i = 0; i < natts; i++)
 			remoteslot->tts_isnull[i] = true;
 
-		/* then we fill valid data to slot */
+		/*
+		 * then we fill valid data to slot. colvalbefore only carries the key
+		 * columns if target has a replica identity or primary key index, which
+		 * is all RelationFindReplTupleByIndex needs. The rest stay null.
+		 */
 		foreach(cell, colvalbefore)
 		{
 			PG_DML_COLUMN_VALUE * colval = (PG_DML_COLUMN_VALUE *) lfirst(cell);
@@ -520,7 +1613,12 @@ synchdb_handle_update(List * colvalbefore, List * colvalafter, Oid tableoid, Con
 			Oid			typinput;
 			Oid			typioparam;
 
-			if (!strcasecmp(colval->value, "NULL"))
+			if (colval->isdatum)
+			{
+				remoteslot->tts_values[colval->position - 1] = colval->datum;
+				remoteslot->tts_isnull[colval->position - 1] = false;
+			}
+			else if (!strcasecmp(colval->value, "NULL"))
 				remoteslot->tts_isnull[colval->position - 1] = true;
 			else
 			{
@@ -536,19 +1634,12 @@ synchdb_handle_update(List * colvalbefore, List * colvalafter, Oid tableoid, Con
 
 		/* We must open indexes here. */
 		ExecOpenIndices(resultRelInfo, false);
-		idxoid = GetRelationIdentityOrPK(rel);
-		if (OidIsValid(idxoid))
-		{
-			elog(DEBUG1, "attempt to find old tuple by index");
-			found = RelationFindReplTupleByIndex(rel, idxoid,
-												 LockTupleExclusive,
-												 remoteslot, localslot);
-		}
-		else
+		found = find_old_tuple(rel, remoteslot, localslot, myBatchStats, &locator);
+
+		if (found && locator)
 		{
-			elog(DEBUG1, "attempt to find old tuple by seq scan");
-			found = RelationFindReplTupleSeq(rel, LockTupleExclusive,
-											 remoteslot, localslot);
+			oldfingerprint = locator_fingerprint(localslot);
+			ItemPointerCopy(&localslot->tts_tid, &oldtid);
 		}
 
 		/*
@@ -557,14 +1648,22 @@ synchdb_handle_update(List * colvalbefore, List * colvalafter, Oid tableoid, Con
 		 */
 		if (found)
 		{
-			/* turn colvalafter into TupleTableSlot */
+			TupleDesc	desc = remoteslot->tts_tupleDescriptor;
+
+			/*
+			 * build the new tuple from the located local tuple. colvalafter
+			 * only carries the columns whose values have changed, so these are
+			 * the only attributes we replace. Unchanged attributes keep their
+			 * exact local representation, which keeps HOT updates possible.
+			 */
 			ExecClearTuple(remoteslot);
+			slot_getallattrs(localslot);
+			memcpy(remoteslot->tts_values, localslot->tts_values,
+				   sizeof(Datum) * desc->natts);
+			memcpy(remoteslot->tts_isnull, localslot->tts_isnull,
+				   sizeof(bool) * desc->natts);
 
-			/* initialize all values in slot to null */
-			for (i = 0; i < natts; i++)
-				remoteslot->tts_isnull[i] = true;
-
-			/* then we fill valid data to slot */
+			/* then we fill changed data to slot */
 			foreach(cell, colvalafter)
 			{
 				PG_DML_COLUMN_VALUE * colval = (PG_DML_COLUMN_VALUE *) lfirst(cell);
@@ -572,7 +1671,12 @@ synchdb_handle_update(List * colvalbefore, List * colvalafter, Oid tableoid, Con
 				Oid			typinput;
 				Oid			typioparam;
 
-				if (!strcasecmp(colval->value, "NULL"))
+				if (colval->isdatum)
+				{
+					remoteslot->tts_values[colval->position - 1] = colval->datum;
+					remoteslot->tts_isnull[colval->position - 1] = false;
+				}
+				else if (!strcasecmp(colval->value, "NULL"))
 					remoteslot->tts_isnull[colval->position - 1] = true;
 				else
 				{
@@ -587,6 +1691,14 @@ synchdb_handle_update(List * colvalbefore, List * colvalafter, Oid tableoid, Con
 			EvalPlanQualSetSlot(&epqstate, remoteslot);
 			ExecSimpleRelationUpdate(resultRelInfo, estate, &epqstate, localslot,
 									 remoteslot);
+
+			if (locator)
+			{
+				locator_forget(locator, oldfingerprint, &oldtid);
+				if (!locator_remember(locator, locator_fingerprint(remoteslot),
+									  &remoteslot->tts_tid))
+					locator_disable(locator, rel);
+			}
 		}
 		else
 		{
@@ -648,7 +1760,8 @@ synchdb_handle_update(List * colvalbefore, List * colvalafter, Oid tableoid, Con
  * It locates the existing tuple based on the provided column values and deletes it.
  */
 static int
-synchdb_handle_delete(List * colvalbefore, Oid tableoid, ConnectorType type, int natts)
+synchdb_handle_delete(List * colvalbefore, Oid tableoid, ConnectorType type, int natts,
+		SynchdbStatistics * myBatchStats)
 {
 	Relation rel = NULL;
 	TupleTableSlot * remoteslot, * localslot;
@@ -660,7 +1773,13 @@ synchdb_handle_delete(List * colvalbefore, Oid tableoid, ConnectorType type, int
 	int ret = 0, i = 0;
 	EPQState	epqstate;
 	bool found;
-	Oid idxoid = InvalidOid;
+	LocatorTableEntry * locator = NULL;
+	uint64 oldfingerprint = 0;
+	ItemPointerData oldtid;
+
+	/* partitioned tables have no storage, each row goes to its partition */
+	if (get_rel_relkind(tableoid) == RELKIND_PARTITIONED_TABLE)
+		return synchdb_handle_routed_delete(colvalbefore, tableoid, myBatchStats);
 
 	/*
 	 * we put in TRY and CATCH block to capture potential exceptions raised
@@ -705,7 +1824,11 @@ synchdb_handle_delete(List * colvalbefore, Oid tableoid, ConnectorType type, int
 		for (i = 0; i < natts; i++)
 			remoteslot->tts_isnull[i] = true;
 
-		/* then we fill valid data to slot */
+		/*
+		 * then we fill valid data to slot. colvalbefore only carries the key
+		 * columns if target has a replica identity or primary key index, which
+		 * is all RelationFindReplTupleByIndex needs. The rest stay null.
+		 */
 		foreach(cell, colvalbefore)
 		{
 			PG_DML_COLUMN_VALUE * colval = (PG_DML_COLUMN_VALUE *) lfirst(cell);
@@ -713,7 +1836,12 @@ synchdb_handle_delete(List * colvalbefore, Oid tableoid, ConnectorType type, int
 			Oid			typinput;
 			Oid			typioparam;
 
-			if (!strcasecmp(colval->value, "NULL"))
+			if (colval->isdatum)
+			{
+				remoteslot->tts_values[colval->position - 1] = colval->datum;
+				remoteslot->tts_isnull[colval->position - 1] = false;
+			}
+			else if (!strcasecmp(colval->value, "NULL"))
 				remoteslot->tts_isnull[colval->position - 1] = true;
 			else
 			{
@@ -729,19 +1857,12 @@ synchdb_handle_delete(List * colvalbefore, Oid tableoid, ConnectorType type, int
 
 		/* We must open indexes here. */
 		ExecOpenIndices(resultRelInfo, false);
-		idxoid = GetRelationIdentityOrPK(rel);
-		if (OidIsValid(idxoid))
-		{
-			elog(DEBUG1, "attempt to find old tuple by index");
-			found = RelationFindReplTupleByIndex(rel, idxoid,
-												 LockTupleExclusive,
-												 remoteslot, localslot);
-		}
-		else
+		found = find_old_tuple(rel, remoteslot, localslot, myBatchStats, &locator);
+
+		if (found && locator)
 		{
-			elog(DEBUG1, "attempt to find old tuple by seq scan");
-			found = RelationFindReplTupleSeq(rel, LockTupleExclusive,
-											 remoteslot, localslot);
+			oldfingerprint = locator_fingerprint(localslot);
+			ItemPointerCopy(&localslot->tts_tid, &oldtid);
 		}
 
 		/*
@@ -752,6 +1873,9 @@ synchdb_handle_delete(List * colvalbefore, Oid tableoid, ConnectorType type, int
 		{
 			EvalPlanQualSetSlot(&epqstate, localslot);
 			ExecSimpleRelationDelete(resultRelInfo, estate, &epqstate, localslot);
+
+			if (locator)
+				locator_forget(locator, oldfingerprint, &oldtid);
 		}
 		else
 		{
@@ -820,6 +1944,10 @@ ra_executePGDDL(PG_DDL * pgddl, ConnectorType type)
         elog(WARNING, "Invalid DDL query");
         return -1;
     }
+
+	/* DDL may change the partitions rows are routed to */
+	partroute_release_all();
+
 	return spi_execute(pgddl->ddlquery, type);
 }
 
@@ -848,7 +1976,8 @@ ra_executePGDML(PG_DML * pgdml, ConnectorType type, SynchdbStatistics * myBatchS
 			if (synchdb_dml_use_spi)
 				ret = spi_execute(pgdml->dmlquery, type);
 			else
-				ret = synchdb_handle_insert(pgdml->columnValuesAfter, pgdml->tableoid, type, pgdml->natts);
+				ret = synchdb_handle_insert(pgdml->columnValuesAfter, pgdml->tableoid, type, pgdml->natts,
+						isInSnapshot);
 
 			increment_connector_statistics(myBatchStats, STATS_ROWS, 1);
 			break;
@@ -858,7 +1987,8 @@ ra_executePGDML(PG_DML * pgdml, ConnectorType type, SynchdbStatistics * myBatchS
 			if (synchdb_dml_use_spi)
 				ret = spi_execute(pgdml->dmlquery, type);
 			else
-				ret = synchdb_handle_insert(pgdml->columnValuesAfter, pgdml->tableoid, type, pgdml->natts);
+				ret = synchdb_handle_insert(pgdml->columnValuesAfter, pgdml->tableoid, type, pgdml->natts,
+						false);
 
 			if (!isInSnapshot)
 				increment_connector_statistics(myBatchStats, STATS_CREATE, 1);
@@ -872,7 +2002,8 @@ ra_executePGDML(PG_DML * pgdml, ConnectorType type, SynchdbStatistics * myBatchS
 				ret = synchdb_handle_update(pgdml->columnValuesBefore,
 											 pgdml->columnValuesAfter,
 											 pgdml->tableoid,
-											 type, pgdml->natts);
+											 type, pgdml->natts,
+											 myBatchStats);
 			if (!isInSnapshot)
 				increment_connector_statistics(myBatchStats, STATS_UPDATE, 1);
 			break;
@@ -882,7 +2013,8 @@ ra_executePGDML(PG_DML * pgdml, ConnectorType type, SynchdbStatistics * myBatchS
 			if (synchdb_dml_use_spi)
 				ret = spi_execute(pgdml->dmlquery, type);
 			else
-				ret = synchdb_handle_delete(pgdml->columnValuesBefore, pgdml->tableoid, type, pgdml->natts);
+				ret = synchdb_handle_delete(pgdml->columnValuesBefore, pgdml->tableoid, type, pgdml->natts,
+						myBatchStats);
 
 			if (!isInSnapshot)
 				increment_connector_statistics(myBatchStats, STATS_DELETE, 1);
@@ -1117,6 +2249,116 @@ end:
 	return ret;
 }
 
+/*
+ * ra_saveOffset
+ *
+ * This function records the source offset of a connector in synchdb_offsets.
+ * When called inside the transaction that applies a batch, the offset becomes
+ * durable together with the changes it describes.
+ */
+int
+ra_saveOffset(const char * name, const char * offset)
+{
+	int ret = -1;
+	bool skiptx = false;
+	Oid argtypes[2] = {TEXTOID, TEXTOID};
+	Datum values[2];
+
+	if (!name || !offset)
+		return -1;
+
+	if (IsTransactionOrTransactionBlock())
+		skiptx = true;
+
+	if (!skiptx)
+	{
+		StartTransactionCommand();
+		PushActiveSnapshot(GetTransactionSnapshot());
+	}
+
+	values[0] = CStringGetTextDatum(name);
+	values[1] = CStringGetTextDatum(offset);
+
+	if (SPI_connect() != SPI_OK_CONNECT)
+		elog(ERROR, "SPI_connect failed");
+
+	ret = SPI_execute_with_args("INSERT INTO " SYNCHDB_OFFSETS_TABLE " (name, data) "
+								"VALUES ($1, $2) ON CONFLICT (name) DO UPDATE "
+								"SET data = EXCLUDED.data, updated = now()",
+								2, argtypes, values, NULL, false, 0);
+	if (ret != SPI_OK_INSERT)
+	{
+		SPI_finish();
+		elog(ERROR, "failed to save offset of connector %s: ret = %d",
+				name, ret);
+	}
+	SPI_finish();
+
+	if (!skiptx)
+	{
+		PopActiveSnapshot();
+		CommitTransactionCommand();
+	}
+	return 0;
+}
+
+/*
+ * ra_getOffset
+ *
+ * This function returns the source offset recorded in synchdb_offsets for
+ * the given connector, allocated in the caller's memory context, or NULL if
+ * no offset has been recorded yet.
+ */
+char *
+ra_getOffset(const char * name)
+{
+	int ret = -1;
+	bool skiptx = false;
+	char * value;
+	char * offset = NULL;
+	Oid argtypes[1] = {TEXTOID};
+	Datum values[1];
+	MemoryContext oldcontext = CurrentMemoryContext;
+
+	if (IsTransactionOrTransactionBlock())
+		skiptx = true;
+
+	if (!skiptx)
+	{
+		StartTransactionCommand();
+		PushActiveSnapshot(GetTransactionSnapshot());
+	}
+
+	values[0] = CStringGetTextDatum(name);
+
+	if (SPI_connect() != SPI_OK_CONNECT)
+		elog(ERROR, "SPI_connect failed");
+
+	ret = SPI_execute_with_args("SELECT data FROM " SYNCHDB_OFFSETS_TABLE " WHERE name = $1",
+								1, argtypes, values, NULL, true, 1);
+	if (ret != SPI_OK_SELECT)
+	{
+		SPI_finish();
+		elog(ERROR, "failed to read offset of connector %s: ret = %d",
+				name, ret);
+	}
+
+	if (SPI_processed > 0)
+	{
+		value = SPI_getvalue(SPI_tuptable->vals[0], SPI_tuptable->tupdesc, 1);
+		if (value)
+			offset = MemoryContextStrdup(oldcontext, value);
+	}
+	SPI_finish();
+
+	if (!skiptx)
+	{
+		PopActiveSnapshot();
+		CommitTransactionCommand();
+	}
+	return offset;
+}
+
 /*
  * ra_transformDataExpression
  *
@@ -1336,6 +2578,65 @@ end:
 	return ret;
 }
 
+/*
+ * ra_findGroupObjmapConflict
+ *
+ * This function checks the object mapping rules of connectors that are to
+ * share one group worker, and so one set of object mapping, transform and
+ * data type hashes. Data type rules are keyed by type name only and apply
+ * to every member, so they must be the same for all of them; and no two
+ * members may map tables to the same destination table. Returns a palloc'd
+ * description of the first conflicting rule, or NULL if there is none.
+ */
+char *
+ra_findGroupObjmapConflict(char ** names, int nnames)
+{
+	int ret = -1, i = 0;
+	StringInfoData strinfo;
+	StringInfoData namelist;
+	char * value = NULL;
+	char * conflict = NULL;
+	MemoryContext oldcontext = CurrentMemoryContext;
+
+	initStringInfo(&namelist);
+	for (i = 0; i < nnames; i++)
+		appendStringInfo(&namelist, "%s%s", i > 0 ? ", " : "", quote_literal_cstr(names[i]));
+
+	initStringInfo(&strinfo);
+	appendStringInfo(&strinfo, "SELECT 'data type rule ' || srcobj || ' is not set for every member' "
+			"FROM %s WHERE name IN (%s) AND objtype = 'datatype' AND enabled "
+			"GROUP BY srcobj, dstobj HAVING count(DISTINCT name) < %d "
+			"UNION ALL "
+			"SELECT 'more than one member maps tables to ' || lower(dstobj) "
+			"FROM %s WHERE name IN (%s) AND objtype = 'table' AND enabled "
+			"GROUP BY lower(dstobj) HAVING count(DISTINCT name) > 1 "
+			"LIMIT 1",
+			SYNCHDB_OBJECT_MAPPING_TABLE, namelist.data, nnames,
+			SYNCHDB_OBJECT_MAPPING_TABLE, namelist.data);
+
+	if (SPI_connect() != SPI_OK_CONNECT)
+		elog(ERROR, "SPI_connect failed");
+
+	ret = SPI_execute(strinfo.data, true, 1);
+	if (ret != SPI_OK_SELECT)
+	{
+		SPI_finish();
+		elog(ERROR, "failed to check object mapping rules of connector group: ret = %d", ret);
+	}
+
+	if (SPI_processed == 1)
+	{
+		value = SPI_getvalue(SPI_tuptable->vals[0], SPI_tuptable->tupdesc, 1);
+		if (value)
+			conflict = MemoryContextStrdup(oldcontext, value);
+	}
+	SPI_finish();
+
+	pfree(strinfo.data);
+	pfree(namelist.data);
+	return conflict;
+}
+
 /*
  * destroyPGDDL
  *
@@ -1396,9 +2697,20 @@ ra_run_orafdw_initial_snapshot_spi(ConnectionInfo * conninfo, int flag,
 	bool skiptx = false;
 	char dstdb[SYNCHDB_CONNINFO_DB_NAME_SIZE] = {0};
 	char scn_buf[64] = {0};
+	bool schemaonly = (flag & CONNFLAG_SCHEMA_SYNC_MODE) ||
+			!strcasecmp(snapshotMode, "no_data");
+
+	/*
+	 * tables are loaded by snapshot workers when requested. This requires
+	 * per-table subtransaction mode and our own transaction, which must be
+	 * committed before the workers can see the queued tables
+	 */
+	bool parallel = !schemaonly && synchdb_fdw_snapshot_workers > 0 &&
+			fdw_use_subtx && !IsTransactionOrTransactionBlock();
 
-	const char *sql = (flag & CONNFLAG_SCHEMA_SYNC_MODE) ||
-			!strcasecmp(snapshotMode, "no_data")?
+	/* schema sync takes 13 arguments, initial snapshot takes 3 more load options */
+	int nargs = schemaonly ? 13 : 16;
+	const char *sql = schemaonly ?
 			"SELECT synchdb_do_schema_sync("
 			"  $1::name,$2::text,$3::name,$4::name,$5::name,"
 			"  $6::text,$7::name,$8::bool,$9::text,$10::numeric,"
@@ -1406,14 +2718,15 @@ ra_run_orafdw_initial_snapshot_spi(ConnectionInfo * conninfo, int flag,
 			"SELECT synchdb_do_initial_snapshot("
 			"  $1::name,$2::text,$3::name,$4::name,$5::name,"
 			"  $6::text,$7::name,$8::bool,$9::text,$10::numeric,"
-			"  $11::text,$12::bool,$13::bool)";
-	Oid   argtypes[13] = {
+			"  $11::text,$12::bool,$13::bool,$14::bool,$15::bool,$16::bool)";
+	Oid   argtypes[16] = {
 		NAMEOID, TEXTOID, NAMEOID, NAMEOID, NAMEOID,
 		TEXTOID, NAMEOID, BOOLOID, TEXTOID, NUMERICOID,
-		TEXTOID, BOOLOID, BOOLOID
+		TEXTOID, BOOLOID, BOOLOID, BOOLOID, BOOLOID,
+		BOOLOID
 	};
-	Datum values[13];
-	char  nulls[13] = {' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' '};
+	Datum values[16];
+	char  nulls[16] = {' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' '};
 
 	/* compute scn */
 	if (scn_req > 0)
@@ -1462,22 +2775,187 @@ ra_run_orafdw_initial_snapshot_spi(ConnectionInfo * conninfo, int flag,
 
 		values[11] = BoolGetDatum(fdw_use_subtx);
 		values[12] = BoolGetDatum(write_schema_hist);
+		values[13] = BoolGetDatum(synchdb_snapshot_defer_index_build);
+		values[14] = BoolGetDatum(synchdb_snapshot_frozen_load);
+		values[15] = BoolGetDatum(parallel);
+
+		if (SPI_connect() != SPI_OK_CONNECT)
+			elog(ERROR, "SPI_connect failed");
+
+		ret = SPI_execute_with_args(sql, nargs, argtypes, values, nulls, false, 1);
+		if (ret != SPI_OK_SELECT || SPI_processed != 1 || SPI_tuptable == NULL)
+		{
+			SPI_finish();
+			elog(ERROR, "snapshot call failed with ret = %d", ret);
+		}
+
+		d = SPI_getbinval(SPI_tuptable->vals[0], SPI_tuptable->tupdesc, 1, &isnull);
+		if (isnull)
+		{
+			SPI_finish();
+			elog(ERROR, "snapshot function returned NULL");
+		}
+
+		s = DatumGetCString(DirectFunctionCall1(numeric_out, d));
+		errno = 0;
+		scn_res = strtoull(s, NULL, 10);
+		if (errno != 0)
+		{
+			SPI_finish();
+			elog(ERROR, "failed to parse SCN '%s' as unsigned long long", s);
+		}
+
+		SPI_finish();
+
+		if (!skiptx)
+		{
+			/* Commit the transaction */
+			PopActiveSnapshot();
+			CommitTransactionCommand();
+		}
+	}
+	PG_CATCH();
+	{
+		MemoryContext oldctx = MemoryContextSwitchTo(TopMemoryContext);
+		ErrorData  *errdata = CopyErrorData();
+
+		if (errdata)
+			set_shm_connector_errmsg(myConnectorId, errdata->message);
+
+		FreeErrorData(errdata);
+		MemoryContextSwitchTo(oldctx);
+		SPI_finish();
+		scn_res = 0;
+		PG_RE_THROW();
+	}
+	PG_END_TRY();
+
+	if (parallel && scn_res > 0)
+	{
+		/* tables are queued and committed, load them concurrently then finish up */
+		if (synchdb_fdw_snapshot_split_size > 0)
+			ra_split_orafdw_snapshot_tables(conninfo);
+		synchdb_run_fdw_snapshot_workers(conninfo, synchdb_fdw_snapshot_workers);
+		scn_res = ra_finish_orafdw_parallel_snapshot(conninfo);
+	}
+
+	elog(WARNING, "scn to resume cdc %llu", scn_res);
+	return scn_res;
+}
+
+/*
+ * ra_split_orafdw_snapshot_tables
+ *
+ * This function splits the large tables queued for a parallel FDW based
+ * initial snapshot into Oracle ROWID ranges of about
+ * synchdb.fdw_snapshot_split_size, so that snapshot workers can load one
+ * table concurrently. A table is never split into more than 4 ranges per
+ * worker. Returns the number of tables split; a failure here is not fatal
+ * and leaves every table to be loaded as a whole.
+ */
+int
+ra_split_orafdw_snapshot_tables(ConnectionInfo * conninfo)
+{
+	int ret = -1;
+	int nsplit = 0;
+	bool isnull = false;
+	Datum d;
+	Oid argtypes[3] = {NAMEOID, INT8OID, INT4OID};
+	Datum values[3];
+	MemoryContext oldctx = CurrentMemoryContext;
+
+	PG_TRY();
+	{
+		StartTransactionCommand();
+		PushActiveSnapshot(GetTransactionSnapshot());
+
+		values[0] = DirectFunctionCall1(namein, CStringGetDatum(conninfo->name));
+		values[1] = Int64GetDatum((int64) synchdb_fdw_snapshot_split_size * 1024 * 1024);
+		values[2] = Int32GetDatum(Max(synchdb_fdw_snapshot_workers, 1) * 4);
+
+		if (SPI_connect() != SPI_OK_CONNECT)
+			elog(ERROR, "SPI_connect failed");
+
+		ret = SPI_execute_with_args("SELECT synchdb_fdw_snapshot_split_tables($1, $2, $3)",
+									3, argtypes, values, NULL, false, 1);
+		if (ret != SPI_OK_SELECT || SPI_processed != 1 || SPI_tuptable == NULL)
+		{
+			SPI_finish();
+			elog(ERROR, "snapshot split call failed with ret = %d", ret);
+		}
+
+		d = SPI_getbinval(SPI_tuptable->vals[0], SPI_tuptable->tupdesc, 1, &isnull);
+		if (!isnull)
+			nsplit = DatumGetInt32(d);
+
+		SPI_finish();
+		PopActiveSnapshot();
+		CommitTransactionCommand();
+	}
+	PG_CATCH();
+	{
+		ErrorData  *errdata;
+
+		MemoryContextSwitchTo(oldctx);
+		errdata = CopyErrorData();
+		FlushErrorState();
+		SPI_finish();
+		AbortCurrentTransaction();
+
+		elog(WARNING, "failed to split tables for parallel snapshot, loading them whole: %s",
+			 errdata->message);
+		FreeErrorData(errdata);
+		nsplit = 0;
+	}
+	PG_END_TRY();
+
+	elog(LOG, "split %d tables into ROWID ranges for parallel snapshot", nsplit);
+	return nsplit;
+}
+
+/*
+ * ra_finish_orafdw_parallel_snapshot
+ *
+ * This function completes a FDW based initial snapshot whose tables have
+ * been loaded by snapshot workers: failed or abandoned tables are recorded
+ * in the error table and the remaining snapshot steps are run. Returns the
+ * snapshot SCN or 0 on failure.
+ */
+orascn
+ra_finish_orafdw_parallel_snapshot(ConnectionInfo * conninfo)
+{
+	int ret = -1;
+	bool isnull = false;
+	Datum d;
+	char *s = NULL;
+	orascn scn_res = 0;
+	Oid argtypes[2] = {NAMEOID, BOOLOID};
+	Datum values[2];
+
+	PG_TRY();
+	{
+		StartTransactionCommand();
+		PushActiveSnapshot(GetTransactionSnapshot());
+
+		values[0] = DirectFunctionCall1(namein, CStringGetDatum(conninfo->name));
+		values[1] = BoolGetDatum(synchdb_snapshot_defer_index_build);
 
 		if (SPI_connect() != SPI_OK_CONNECT)
 			elog(ERROR, "SPI_connect failed");
 
-		ret = SPI_execute_with_args(sql, 13, argtypes, values, nulls, false, 1);
+		ret = SPI_execute_with_args("SELECT synchdb_fdw_snapshot_finish_parallel($1, $2)",
+									2, argtypes, values, NULL, false, 1);
 		if (ret != SPI_OK_SELECT || SPI_processed != 1 || SPI_tuptable == NULL)
 		{
 			SPI_finish();
-			elog(ERROR, "snapshot call failed with ret = %d", ret);
+			elog(ERROR, "snapshot finish call failed with ret = %d", ret);
 		}
 
 		d = SPI_getbinval(SPI_tuptable->vals[0], SPI_tuptable->tupdesc, 1, &isnull);
 		if (isnull)
 		{
 			SPI_finish();
-			elog(ERROR, "snapshot function returned NULL");
+			elog(ERROR, "snapshot finish function returned NULL");
 		}
 
 		s = DatumGetCString(DirectFunctionCall1(numeric_out, d));
@@ -1490,13 +2968,8 @@ ra_run_orafdw_initial_snapshot_spi(ConnectionInfo * conninfo, int flag,
 		}
 
 		SPI_finish();
-
-		if (!skiptx)
-		{
-			/* Commit the transaction */
-			PopActiveSnapshot();
-			CommitTransactionCommand();
-		}
+		PopActiveSnapshot();
+		CommitTransactionCommand();
 	}
 	PG_CATCH();
 	{
@@ -1509,15 +2982,109 @@ ra_run_orafdw_initial_snapshot_spi(ConnectionInfo * conninfo, int flag,
 		FreeErrorData(errdata);
 		MemoryContextSwitchTo(oldctx);
 		SPI_finish();
-		scn_res = 0;
 		PG_RE_THROW();
 	}
 	PG_END_TRY();
 
-	elog(WARNING, "scn to resume cdc %llu", scn_res);
 	return scn_res;
 }
 
+/*
+ * ra_fdwSnapshotWorkerLoop
+ *
+ * Main loop of a FDW snapshot worker. Each queued table, or ROWID range of a
+ * split table, is claimed in its own transaction, so that other workers and
+ * synchdb_fdw_snapshot_tables readers see it running, and then loaded in
+ * another one. Returns the number of tables or ranges loaded by this worker.
+ */
+int
+ra_fdwSnapshotWorkerLoop(const char * name)
+{
+	int ret = -1;
+	int nloaded = 0;
+	int range_no = 0;
+	bool isnull = false;
+	char * tbl = NULL;
+	Datum d;
+	Oid argtypes[3] = {NAMEOID, NAMEOID, INT4OID};
+	Datum values[3];
+
+	while (!ShutdownRequestPending)
+	{
+		CHECK_FOR_INTERRUPTS();
+
+		if (ConfigReloadPending)
+		{
+			ConfigReloadPending = false;
+			ProcessConfigFile(PGC_SIGHUP);
+		}
+
+		/* (1) claim next table */
+		StartTransactionCommand();
+		PushActiveSnapshot(GetTransactionSnapshot());
+
+		values[0] = DirectFunctionCall1(namein, CStringGetDatum(name));
+		if (SPI_connect() != SPI_OK_CONNECT)
+			elog(ERROR, "SPI_connect failed");
+
+		ret = SPI_execute_with_args("SELECT tbl, range_no FROM synchdb_fdw_snapshot_claim_table($1)",
+									1, argtypes, values, NULL, false, 1);
+		if (ret != SPI_OK_SELECT || SPI_tuptable == NULL)
+		{
+			SPI_finish();
+			elog(ERROR, "failed to claim a table for snapshot: ret = %d", ret);
+		}
+
+		/* nothing left to claim */
+		isnull = true;
+		if (SPI_processed == 1)
+		{
+			d = SPI_getbinval(SPI_tuptable->vals[0], SPI_tuptable->tupdesc, 1, &isnull);
+			if (!isnull)
+				tbl = MemoryContextStrdup(TopMemoryContext, NameStr(*DatumGetName(d)));
+
+			d = SPI_getbinval(SPI_tuptable->vals[0], SPI_tuptable->tupdesc, 2, &isnull);
+			range_no = isnull ? 0 : DatumGetInt32(d);
+			isnull = (tbl == NULL);
+		}
+
+		SPI_finish();
+		PopActiveSnapshot();
+		CommitTransactionCommand();
+
+		if (isnull)
+			break;
+
+		/* (2) load it, errors are recorded per table by the load function */
+		StartTransactionCommand();
+		PushActiveSnapshot(GetTransactionSnapshot());
+
+		values[1] = DirectFunctionCall1(namein, CStringGetDatum(tbl));
+		values[2] = Int32GetDatum(range_no);
+		if (SPI_connect() != SPI_OK_CONNECT)
+			elog(ERROR, "SPI_connect failed");
+
+		ret = SPI_execute_with_args("SELECT synchdb_fdw_snapshot_load_table($1, $2, $3)",
+									3, argtypes, values, NULL, false, 1);
+		if (ret != SPI_OK_SELECT)
+		{
+			SPI_finish();
+			elog(ERROR, "failed to load table %s range %d for snapshot: ret = %d",
+					tbl, range_no, ret);
+		}
+
+		SPI_finish();
+		PopActiveSnapshot();
+		CommitTransactionCommand();
+
+		elog(DEBUG1, "fdw snapshot worker loaded table %s range %d", tbl, range_no);
+		pfree(tbl);
+		tbl = NULL;
+		nloaded++;
+	}
+	return nloaded;
+}
+
 /*
  * ra_get_fdw_snapshot_err_table_list
  *
@@ -1628,6 +3195,424 @@ cleanup_tx:
 	return ret;
 }
 
+/*
+ * ra_bulkInsertFrozen
+ *
+ * This function runs the given SELECT query and inserts its result into the
+ * given table as pre-frozen tuples, in batches, the same way COPY FREEZE
+ * does. The result columns of the query must match the columns named in
+ * dstlist in number and type, and table columns left out of dstlist must not
+ * have a default or be an identity column. Otherwise or when the table cannot take
+ * frozen tuples (see ra_canInsertFrozen), this function falls back to a
+ * regular INSERT INTO table (dstlist) query. Returns the number of rows
+ * inserted.
+ */
+int64
+ra_bulkInsertFrozen(Oid tableoid, const char * dstlist, const char * query)
+{
+	Relation rel = NULL;
+	TupleDesc reldesc;
+	TupleDesc srcdesc;
+	EState	   *estate = NULL;
+	RangeTblEntry *rte;
+	List	   *perminfos = NIL;
+	ResultRelInfo *resultRelInfo = NULL;
+	SPIPlanPtr plan;
+	CachedPlanSource *plansource;
+	Portal portal;
+	TupleTableSlot **slots = NULL;
+	BulkInsertState bistate;
+	AttrNumber *attmap;
+	MemoryContext oldctx;
+	StringInfoData strinfo;
+	int nattrs = 0;
+	int i = 0, j = 0;
+	int64 nrows = 0;
+	bool frozen = false;
+
+	rel = table_open(tableoid, RowExclusiveLock);
+	reldesc = RelationGetDescr(rel);
+	frozen = ra_canInsertFrozen(rel);
+
+	/* initialize estate, outside of SPI memory context */
+	estate = CreateExecutorState();
+
+	rte = makeNode(RangeTblEntry);
+	rte->rtekind = RTE_RELATION;
+	rte->relid = RelationGetRelid(rel);
+	rte->relkind = rel->rd_rel->relkind;
+	rte->rellockmode = RowExclusiveLock;
+
+	addRTEPermissionInfo(&perminfos, rte);
+
+#if SYNCHDB_PG_MAJOR_VERSION >= 1800
+	ExecInitRangeTable(estate, list_make1(rte), perminfos,
+			bms_make_singleton(1));
+#else
+	ExecInitRangeTable(estate, list_make1(rte), perminfos);
+#endif
+	estate->es_output_cid = GetCurrentCommandId(true);
+
+	resultRelInfo = makeNode(ResultRelInfo);
+	InitResultRelInfo(resultRelInfo, rel, 1, NULL, 0);
+
+	/* map source result columns to the table attributes named in dstlist */
+	attmap = palloc0(sizeof(AttrNumber) * reldesc->natts);
+	if (frozen)
+	{
+		char * rawlist = pstrdup(dstlist);
+		List * colnames = NIL;
+		ListCell * lc;
+		bool * listed = palloc0(sizeof(bool) * reldesc->natts);
+
+		if (!SplitIdentifierString(rawlist, ',', &colnames) ||
+			list_length(colnames) > reldesc->natts)
+			frozen = false;
+
+		foreach(lc, colnames)
+		{
+			AttrNumber attnum;
+
+			if (!frozen)
+				break;
+
+			attnum = attnameAttNum(rel, (char *) lfirst(lc), false);
+			if (attnum <= 0 || listed[attnum - 1])
+			{
+				frozen = false;
+				break;
+			}
+			listed[attnum - 1] = true;
+			attmap[nattrs++] = attnum - 1;
+		}
+
+		/* left out columns would take their default in a regular insert */
+		for (i = 0; frozen && i < reldesc->natts; i++)
+		{
+			Form_pg_attribute attr = TupleDescAttr(reldesc, i);
+
+			if (!listed[i] && !attr->attisdropped &&
+				(attr->atthasdef || attr->attidentity))
+				frozen = false;
+		}
+
+		list_free(colnames);
+		pfree(listed);
+		pfree(rawlist);
+	}
+
+	if (SPI_connect() != SPI_OK_CONNECT)
+		elog(ERROR, "SPI_connect failed");
+
+	plan = SPI_prepare(query, 0, NULL);
+	if (plan == NULL)
+		elog(ERROR, "SPI_prepare failed: %s", SPI_result_code_string(SPI_result));
+
+	plansource = (CachedPlanSource *) linitial(SPI_plan_get_plan_sources(plan));
+	srcdesc = plansource->resultDesc;
+	if (frozen && (srcdesc == NULL || srcdesc->natts != nattrs))
+		frozen = false;
+
+	for (j = 0; frozen && j < nattrs; j++)
+	{
+		Form_pg_attribute dst = TupleDescAttr(reldesc, attmap[j]);
+		Form_pg_attribute src = TupleDescAttr(srcdesc, j);
+
+		/* no coercion is done here, leave that to the regular insert path */
+		if (src->atttypid != dst->atttypid ||
+			(dst->atttypmod >= 0 && src->atttypmod != dst->atttypmod))
+			frozen = false;
+	}
+
+	if (!frozen)
+	{
+		elog(DEBUG1, "table %s cannot take frozen tuples, using regular insert",
+				RelationGetRelationName(rel));
+
+		initStringInfo(&strinfo);
+		appendStringInfo(&strinfo, "INSERT INTO %s (%s) %s",
+				quote_qualified_identifier(get_namespace_name(RelationGetNamespace(rel)),
+										   RelationGetRelationName(rel)),
+				dstlist, query);
+
+		if (SPI_execute(strinfo.data, false, 0) != SPI_OK_INSERT)
+			elog(ERROR, "failed to insert into %s", RelationGetRelationName(rel));
+
+		nrows = SPI_processed;
+		SPI_finish();
+		pfree(strinfo.data);
+	}
+	else
+	{
+		oldctx = MemoryContextSwitchTo(estate->es_query_cxt);
+		slots = palloc(sizeof(TupleTableSlot *) * FROZEN_LOAD_BATCH_SIZE);
+		for (i = 0; i < FROZEN_LOAD_BATCH_SIZE; i++)
+			slots[i] = table_slot_create(rel, &estate->es_tupleTable);
+		MemoryContextSwitchTo(oldctx);
+
+		ExecOpenIndices(resultRelInfo, false);
+		bistate = GetBulkInsertState();
+
+		portal = SPI_cursor_open(NULL, plan, NULL, NULL, true);
+		for (;;)
+		{
+			uint64 nfetched;
+
+			SPI_cursor_fetch(portal, true, FROZEN_LOAD_BATCH_SIZE);
+			nfetched = SPI_processed;
+			if (nfetched == 0)
+				break;
+
+			for (i = 0; i < (int) nfetched; i++)
+			{
+				TupleTableSlot *slot = slots[i];
+
+				ExecClearTuple(slot);
+				for (j = 0; j < reldesc->natts; j++)
+				{
+					slot->tts_values[j] = (Datum) 0;
+					slot->tts_isnull[j] = true;
+				}
+
+				for (j = 0; j < nattrs; j++)
+					slot->tts_values[attmap[j]] =
+						SPI_getbinval(SPI_tuptable->vals[i], SPI_tuptable->tupdesc,
+									  j + 1, &slot->tts_isnull[attmap[j]]);
+				ExecStoreVirtualTuple(slot);
+
+				if (rel->rd_att->constr)
+					ExecConstraints(resultRelInfo, slot, estate);
+			}
+
+			/* tuples are materialized into the slots by table AM */
+			table_multi_insert(rel, slots, nfetched, estate->es_output_cid,
+							   TABLE_INSERT_FROZEN, bistate);
+
+			if (resultRelInfo->ri_NumIndices > 0)
+			{
+				for (i = 0; i < (int) nfetched; i++)
+				{
+					List *recheckIndexes;
+
+					recheckIndexes = ExecInsertIndexTuples(resultRelInfo, slots[i], estate,
+														   false, false, NULL, NIL, false);
+					list_free(recheckIndexes);
+				}
+			}
+
+			nrows += nfetched;
+			ResetPerTupleExprContext(estate);
+			SPI_freetuptable(SPI_tuptable);
+		}
+		SPI_cursor_close(portal);
+		SPI_finish();
+
+		FreeBulkInsertState(bistate);
+		table_finish_bulk_insert(rel, TABLE_INSERT_FROZEN);
+		ExecCloseIndices(resultRelInfo);
+
+		elog(DEBUG1, "inserted " INT64_FORMAT " frozen tuples into %s",
+				nrows, RelationGetRelationName(rel));
+	}
+
+	CommandCounterIncrement();
+
+	pfree(attmap);
+	ExecResetTupleTable(estate->es_tupleTable, false);
+	FreeExecutorState(estate);
+	table_close(rel, NoLock);
+	return nrows;
+}
+
+/* tables whose secondary indexes have already been deferred by this worker */
+static HTAB * deferredIndexHash = NULL;
+static bool deferredIndexCallbackRegistered = false;
+
+/* connector whose deferred indexes are built once the current transaction commits */
+static char pendingIndexBuild[NAMEDATALEN] = {0};
+
+/*
+ * deferred_index_xact_callback
+ *
+ * indexes dropped by an aborted transaction are back, so forget what has
+ * been deferred. Tables deferred by earlier transactions have no secondary
+ * indexes left and are simply processed again at no cost.
+ */
+static void
+deferred_index_xact_callback(XactEvent event, void *arg)
+{
+	if (event != XACT_EVENT_ABORT)
+		return;
+
+	if (deferredIndexHash)
+	{
+		hash_destroy(deferredIndexHash);
+		deferredIndexHash = NULL;
+	}
+	pendingIndexBuild[0] = '\0';
+}
+
+/*
+ * ra_deferSecondaryIndexes
+ *
+ * This function drops the plain secondary indexes of the given table and
+ * records their definitions in synchdb_deferred_index so that they can be
+ * built in one pass by ra_buildDeferredIndexes() after the initial snapshot.
+ * Each table is processed only once per worker.
+ */
+int
+ra_deferSecondaryIndexes(const char * name, Oid tableoid)
+{
+	int ret = -1;
+	bool found = false;
+	bool skiptx = false;
+	Oid argtypes[2] = {NAMEOID, OIDOID};
+	Datum values[2];
+
+	if (deferredIndexHash == NULL)
+	{
+		HASHCTL ctl;
+
+		if (!deferredIndexCallbackRegistered)
+		{
+			RegisterXactCallback(deferred_index_xact_callback, NULL);
+			deferredIndexCallbackRegistered = true;
+		}
+
+		memset(&ctl, 0, sizeof(ctl));
+		ctl.keysize = sizeof(Oid);
+		ctl.entrysize = sizeof(Oid);
+		deferredIndexHash = hash_create("synchdb deferred index hash",
+										64, &ctl, HASH_ELEM | HASH_BLOBS);
+	}
+
+	hash_search(deferredIndexHash, &tableoid, HASH_FIND, &found);
+	if (found)
+		return 0;
+
+	if (IsTransactionOrTransactionBlock())
+		skiptx = true;
+
+	if (!skiptx)
+	{
+		StartTransactionCommand();
+		PushActiveSnapshot(GetTransactionSnapshot());
+	}
+
+	values[0] = DirectFunctionCall1(namein, CStringGetDatum(name));
+	values[1] = ObjectIdGetDatum(tableoid);
+
+	if (SPI_connect() != SPI_OK_CONNECT)
+		elog(ERROR, "SPI_connect failed");
+
+	ret = SPI_execute_with_args("SELECT synchdb_defer_secondary_indexes($1, $2)",
+								2, argtypes, values, NULL, false, 1);
+	if (ret != SPI_OK_SELECT)
+	{
+		SPI_finish();
+		elog(ERROR, "failed to defer secondary indexes of table %u: ret = %d",
+				tableoid, ret);
+	}
+	SPI_finish();
+
+	if (!skiptx)
+	{
+		PopActiveSnapshot();
+		CommitTransactionCommand();
+	}
+
+	hash_search(deferredIndexHash, &tableoid, HASH_ENTER, NULL);
+	return 0;
+}
+
+/*
+ * ra_buildDeferredIndexes
+ *
+ * This function builds all indexes recorded in synchdb_deferred_index for the
+ * given connector. It is called when initial snapshot completes and once when
+ * a worker enters change data capture stage, in case a previous snapshot was
+ * interrupted before its deferred indexes could be built.
+ *
+ * Index builds can take long and must not make the batch being applied fail,
+ * so when called inside a transaction the build is only scheduled and done in
+ * a transaction of its own by ra_buildPendingDeferredIndexes() after commit.
+ */
+int
+ra_buildDeferredIndexes(const char * name)
+{
+	int ret = -1;
+	int numbuilt = 0;
+	bool isnull = false;
+	Oid argtypes[1] = {NAMEOID};
+	Datum values[1];
+	Datum d;
+
+	if (IsTransactionOrTransactionBlock())
+	{
+		if (!deferredIndexCallbackRegistered)
+		{
+			RegisterXactCallback(deferred_index_xact_callback, NULL);
+			deferredIndexCallbackRegistered = true;
+		}
+		strlcpy(pendingIndexBuild, name, NAMEDATALEN);
+		return 0;
+	}
+
+	StartTransactionCommand();
+	PushActiveSnapshot(GetTransactionSnapshot());
+
+	values[0] = DirectFunctionCall1(namein, CStringGetDatum(name));
+
+	if (SPI_connect() != SPI_OK_CONNECT)
+		elog(ERROR, "SPI_connect failed");
+
+	ret = SPI_execute_with_args("SELECT synchdb_build_deferred_indexes($1)",
+								1, argtypes, values, NULL, false, 1);
+	if (ret != SPI_OK_SELECT || SPI_processed != 1 || SPI_tuptable == NULL)
+	{
+		SPI_finish();
+		elog(ERROR, "failed to build deferred indexes: ret = %d", ret);
+	}
+
+	d = SPI_getbinval(SPI_tuptable->vals[0], SPI_tuptable->tupdesc, 1, &isnull);
+	if (!isnull)
+		numbuilt = DatumGetInt32(d);
+	SPI_finish();
+
+	PopActiveSnapshot();
+	CommitTransactionCommand();
+
+	if (numbuilt > 0)
+		elog(LOG, "built %d deferred indexes for connector %s", numbuilt, name);
+
+	/* tables may be snapshotted again later, forget what has been deferred */
+	if (deferredIndexHash)
+	{
+		hash_destroy(deferredIndexHash);
+		deferredIndexHash = NULL;
+	}
+	return numbuilt;
+}
+
+/*
+ * ra_buildPendingDeferredIndexes
+ *
+ * build the deferred indexes scheduled by ra_buildDeferredIndexes() while a
+ * transaction was in progress. Must be called outside of a transaction.
+ */
+int
+ra_buildPendingDeferredIndexes(void)
+{
+	char name[NAMEDATALEN];
+
+	if (pendingIndexBuild[0] == '\0')
+		return 0;
+
+	strlcpy(name, pendingIndexBuild, NAMEDATALEN);
+	pendingIndexBuild[0] = '\0';
+	return ra_buildDeferredIndexes(name);
+}
+
 int
 dump_schema_history_to_file(const char * connector_name, const char *out_path)
 {
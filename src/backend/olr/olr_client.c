@@ -16,15 +16,20 @@
 #include "access/xact.h"
 #include "utils/snapmgr.h"
 #include "utils/builtins.h"
+#include "port/pg_bswap.h"
+#include "executor/replication_agent.h"
 
 /* extern globals */
 extern int myConnectorId;
 extern int dbz_offset_flush_interval_ms;
+extern bool synchdb_transactional_offsets;
 extern bool synchdb_log_event_on_error;
 extern char * g_eventStr;
 extern int olr_read_buffer_size;
 extern int olr_connect_timeout_ms;
 extern int olr_read_timeout_ms;
+extern int olr_payload_format;
+extern char * synchdb_event_capture_dir;
 
 /* static globals */
 static NetioContext g_netioCtx = {0};
@@ -34,11 +39,35 @@ static orascn g_c_idx = 0;
 static StringInfoData g_strinfo;
 static int g_offset = 0;
 static int g_read_buffer_size = 64 * 1024 * 1024;
+static int g_payload_format = OLR_PAYLOAD_JSON;
+static uint32 g_capture_batchid = 0;
+
+static void * olr_pb_alloc(void * allocator_data, size_t size);
+static void olr_pb_free(void * allocator_data, void * pointer);
+
+/* protobuf-c allocator on top of palloc so decoded messages never outlive an error */
+static ProtobufCAllocator g_pballocator = {olr_pb_alloc, olr_pb_free, NULL};
+
+static void *
+olr_pb_alloc(void * allocator_data, size_t size)
+{
+	return palloc_extended(size, MCXT_ALLOC_HUGE | MCXT_ALLOC_NO_OOM);
+}
+
+static void
+olr_pb_free(void * allocator_data, void * pointer)
+{
+	if (pointer)
+		pfree(pointer);
+}
 
 int
 olr_client_init(const char * hostname, unsigned int port)
 {
 	g_read_buffer_size = olr_read_buffer_size * 1024 * 1024;
+
+	/* payload format is fixed for the lifetime of a connection */
+	g_payload_format = olr_payload_format;
 	netio_set_timeouts(olr_connect_timeout_ms, olr_read_timeout_ms);
 	initStringInfo(&g_strinfo);
 	if (netio_connect(&g_netioCtx, hostname, port))
@@ -132,6 +161,9 @@ olr_client_get_change(int myConnectorId, bool * dbzExitSignal, SynchdbStatistics
 	int ret = -1, curr = 0;
 	int next_offset = 0;
 	bool isfirst = false, islast = false;
+	bool capture = false;
+	StringInfoData capbuf;
+	instr_time lat;
 
 	if (!g_netioCtx.is_connected)
 	{
@@ -139,78 +171,150 @@ olr_client_get_change(int myConnectorId, bool * dbzExitSignal, SynchdbStatistics
 		return -2;
 	}
 
+	start_connector_latency(&lat);
 	nbytes = netio_read(&g_netioCtx, &g_strinfo, g_read_buffer_size);
 	if (nbytes > 0)
 	{
 		elog(DEBUG1, "%ld bytes read", nbytes);
+		record_batch_latency(LATENCY_STAGE_FETCH, &lat);
+
+		/*
+		 * re-frame the events of this read as a 'B' batch, the same layout Debezium
+		 * batches use, if they are to be captured for offline replay
+		 */
+		capture = synchdb_event_capture_dir && strlen(synchdb_event_capture_dir) > 0;
+		if (capture)
+		{
+			uint32 placeholder = 0;
+
+			initStringInfo(&capbuf);
+			appendStringInfoChar(&capbuf, 'B');
+			appendBinaryStringInfo(&capbuf, (char *) &placeholder, 4);
+			appendBinaryStringInfo(&capbuf, (char *) &placeholder, 4);
+		}
 
 		StartTransactionCommand();
 		PushActiveSnapshot(GetTransactionSnapshot());
 
 		while (g_offset + 4 <= g_strinfo.len)
 		{
-			int json_len = 0;
-#if SYNCHDB_PG_MAJOR_VERSION >= 1700
-			text  * json_payload;
-#else
-			char * json_payload;
-#endif
-			memcpy(&json_len, g_strinfo.data + g_offset, 4);
+			int msg_len = 0;
+			char * msg = NULL;
 
-			elog(DEBUG1, "json len %d", json_len);
+			memcpy(&msg_len, g_strinfo.data + g_offset, 4);
 
-			if (g_offset + 4 + json_len > g_strinfo.len)
+			elog(DEBUG1, "message len %d", msg_len);
+
+			if (g_offset + 4 + msg_len > g_strinfo.len)
 			{
 				/*
 				 * not enough payload data, exit for now. More data is expected
 				 * to be read in the next call
 				 */
-				elog(DEBUG1, "json_len is %d, but only %ld bytes left in buffer %ld/%d",
-						json_len, (long)(g_strinfo.len - g_offset - 4), (long)g_offset,
+				elog(DEBUG1, "msg_len is %d, but only %ld bytes left in buffer %ld/%d",
+						msg_len, (long)(g_strinfo.len - g_offset - 4), (long)g_offset,
 						g_strinfo.len);
 				break;
 			}
 
 			/* determine if this is the first or the last event in the batch */
-			next_offset = g_offset + 4 + json_len;
+			next_offset = g_offset + 4 + msg_len;
 			isfirst = (curr == 0);
 			islast = (next_offset == g_strinfo.len) || (next_offset + 4 > g_strinfo.len);
+			msg = g_strinfo.data + g_offset + 4;
+
+			if (capture)
+			{
+				/* event length in a 'B' batch includes a null terminator */
+				uint32 netlen = pg_hton32(msg_len + 1);
+
+				appendBinaryStringInfo(&capbuf, (char *) &netlen, 4);
+				appendBinaryStringInfo(&capbuf, msg, msg_len);
+				appendStringInfoChar(&capbuf, '\0');
+			}
 
-			/*
-			 * payload is not null-terminated so we try to turn it to a text * if supported.
-			 * Otherwise, we make a copy of it as a null-terminated string
-			 */
+			if (g_payload_format == OLR_PAYLOAD_PROTOBUF)
+			{
+				OpenLogReplicator__Pb__RedoResponse * response =
+					open_log_replicator__pb__redo_response__unpack(&g_pballocator, msg_len,
+							(unsigned char *) msg);
+
+				if (response)
+				{
+					/* there is no text form of a protobuf event to log on error */
+					ret = fc_processOLRProtobufEvent(response, myBatchStats,
+							get_shm_connector_name_by_id(myConnectorId), sendconfirm,
+							isfirst, islast);
+					open_log_replicator__pb__redo_response__free_unpacked(response, &g_pballocator);
+				}
+				else
+				{
+					elog(WARNING,"malformed protobuf message - NULL response");
+					increment_connector_statistics(myBatchStats, STATS_BAD_CHANGE_EVENT, 1);
+					ret = -1;
+				}
+			}
+			else
+			{
+#if SYNCHDB_PG_MAJOR_VERSION >= 1700
+				text  * json_payload;
+#else
+				char * json_payload;
+#endif
+				/*
+				 * payload is not null-terminated so we try to turn it to a text * if supported.
+				 * Otherwise, we make a copy of it as a null-terminated string
+				 */
 #if SYNCHDB_PG_MAJOR_VERSION >= 1700
-			json_payload = cstring_to_text_with_len(g_strinfo.data + g_offset + 4, json_len);
+				json_payload = cstring_to_text_with_len(msg, msg_len);
 #else
-			json_payload = pnstrdup(g_strinfo.data + g_offset + 4, json_len);
+				json_payload = pnstrdup(msg, msg_len);
 #endif
 
-			if (synchdb_log_event_on_error)
+				if (synchdb_log_event_on_error)
 #if SYNCHDB_PG_MAJOR_VERSION >= 1700
-				g_eventStr = text_to_cstring(json_payload);
+					g_eventStr = text_to_cstring(json_payload);
 #else
-				g_eventStr = json_payload;
+					g_eventStr = json_payload;
 #endif
-			/* process it */
-			ret = fc_processOLRChangeEvent(json_payload, myBatchStats,
-					get_shm_connector_name_by_id(myConnectorId), sendconfirm,
-					isfirst, islast);
+				/* process it */
+				ret = fc_processOLRChangeEvent(json_payload, myBatchStats,
+						get_shm_connector_name_by_id(myConnectorId), sendconfirm,
+						isfirst, islast);
 
-			pfree(json_payload);
+				pfree(json_payload);
 
-			if (synchdb_log_event_on_error)
-				g_eventStr = NULL;
+				if (synchdb_log_event_on_error)
+					g_eventStr = NULL;
+			}
 
-			g_offset += 4 + json_len;
+			g_offset += 4 + msg_len;
 			curr++;
 		}
 
+		/* commit the scns reached so far together with the changes applied */
+		if (curr > 0 && synchdb_transactional_offsets)
+			olr_client_save_scn_state(get_shm_connector_name_by_id(myConnectorId));
+
+		start_connector_latency(&lat);
 		PopActiveSnapshot();
 		CommitTransactionCommand();
+		record_batch_latency(LATENCY_STAGE_COMMIT, &lat);
 
 		elog(DEBUG1, "there are %d records processed in this batch", curr);
 
+		if (capture)
+		{
+			uint32 netid = pg_hton32(++g_capture_batchid);
+			uint32 netsize = pg_hton32(curr);
+
+			memcpy(capbuf.data + 1, &netid, 4);
+			memcpy(capbuf.data + 5, &netsize, 4);
+			if (curr > 0)
+				synchdb_capture_batch(myConnectorId, 'B', capbuf.data + 1, capbuf.len - 1);
+			pfree(capbuf.data);
+		}
+
 		/* compact or reuse the buffer if available */
 		if (g_offset >= g_strinfo.len)
 		{
@@ -356,6 +460,20 @@ olr_client_write_scn_state(ConnectorType type, const char * name, const char * d
 	return true;
 }
 
+void
+olr_client_save_scn_state(const char * name)
+{
+	char offset[SYNCHDB_OFFSET_SIZE];
+
+	if (g_scn == 0 && g_c_scn == 0)
+		return;
+
+	/* same form as the offset shown in synchdb_state_view */
+	snprintf(offset, sizeof(offset), "{\"scn\":%llu, \"c_scn\":%llu, \"c_idx\":%llu}",
+			g_scn, g_c_scn, g_c_idx);
+	ra_saveOffset(name, offset);
+}
+
 bool
 olr_client_init_scn_state(ConnectorType type, const char * name, const char * dstdb)
 {
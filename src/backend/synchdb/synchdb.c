@@ -22,6 +22,10 @@
 #include <jni.h>
 #include <unistd.h>
 #include <arpa/inet.h>
+#include <netdb.h>
+#include <sys/socket.h>
+#include <sys/resource.h>
+#include <math.h>
 #include <dlfcn.h>
 
 /* synchdb includes */
@@ -29,8 +33,11 @@
 #include "converter/debezium_event_handler.h"
 #include "synchdb/synchdb.h"
 #include "executor/replication_agent.h"
+#include "utils/codec_utils.h"
 #ifdef WITH_OLR
+#include "olr/OraProtoBuf.pb-c.h"
 #include "olr/olr_client.h"
+#include "converter/olr_event_handler.h"
 #endif
 
 /* postgresql includes */
@@ -42,6 +49,8 @@
 #include "storage/proc.h"
 #include "storage/ipc.h"
 #include "storage/fd.h"
+#include "storage/buffile.h"
+#include "tcop/tcopprot.h"
 #include "miscadmin.h"
 #include "utils/wait_event.h"
 #include "utils/guc.h"
@@ -51,6 +60,13 @@
 #include "utils/snapmgr.h"
 #include "utils/builtins.h"
 #include "commands/dbcommands.h"
+#include "catalog/pg_authid.h"
+#include "utils/acl.h"
+#include "port/pg_bitutils.h"
+#include "utils/array.h"
+#include "utils/tuplestore.h"
+#include "catalog/pg_type.h"
+#include "common/base64.h"
 
 PG_MODULE_MAGIC;
 
@@ -58,6 +74,7 @@ PG_MODULE_MAGIC;
 PG_FUNCTION_INFO_V1(synchdb_stop_engine_bgw);
 PG_FUNCTION_INFO_V1(synchdb_start_engine_bgw);
 PG_FUNCTION_INFO_V1(synchdb_start_engine_bgw_snapshot_mode);
+PG_FUNCTION_INFO_V1(synchdb_start_engine_group);
 PG_FUNCTION_INFO_V1(synchdb_get_state);
 PG_FUNCTION_INFO_V1(synchdb_pause_engine);
 PG_FUNCTION_INFO_V1(synchdb_resume_engine);
@@ -83,6 +100,10 @@ PG_FUNCTION_INFO_V1(synchdb_add_infinispan);
 PG_FUNCTION_INFO_V1(synchdb_del_infinispan);
 PG_FUNCTION_INFO_V1(synchdb_translate_datatype);
 PG_FUNCTION_INFO_V1(synchdb_set_snapstats);
+PG_FUNCTION_INFO_V1(synchdb_insert_frozen);
+PG_FUNCTION_INFO_V1(synchdb_replay_events);
+PG_FUNCTION_INFO_V1(synchdb_get_latency_stats);
+PG_FUNCTION_INFO_V1(synchdb_codec_benchmark);
 
 /* Global variables */
 SynchdbSharedState *sdb_state = NULL; /* Pointer to shared-memory state. */
@@ -99,6 +120,12 @@ char * dbz_skipped_operations = "t";
 int dbz_connect_timeout_ms = 30000;
 int dbz_query_timeout_ms = 600000;
 int jvm_max_heap_size = 1024;
+int jvm_max_batch_queue_memory = 0;	/* in MB, 0: a quarter of jvm_max_heap_size */
+int synchdb_batch_spill_threshold = 64;	/* in MB, 0: never spill */
+bool dbz_autotune = false;
+int dbz_autotune_min_batch_size = 64;
+int dbz_autotune_min_queue_memory = 16;	/* in MB */
+int dbz_autotune_target_ms = 1000;
 int jvm_max_direct_buffer_size = 1024;
 int dbz_snapshot_thread_num = 2;
 int dbz_snapshot_fetch_size = 0; /* 0: auto */
@@ -115,9 +142,22 @@ int olr_read_buffer_size = 128;	/* in MB */
 int dbz_logminer_stream_mode = LOGMINER_MODE_UNCOMMITTED;
 int olr_connect_timeout_ms = 5000;
 int olr_read_timeout_ms = 5000;
+int olr_payload_format = OLR_PAYLOAD_JSON;
 int synchdb_snapshot_engine = ENGINE_DEBEZIUM;
 int cdc_start_delay_ms = 0;
+int dbz_record_processing_threads = 0;	/* 0: synchronous engine */
 bool synchdb_fdw_use_subtx = true;
+int synchdb_tuple_locator_mem = 0;	/* in kB, 0: disabled */
+bool synchdb_snapshot_defer_index_build = false;
+bool synchdb_snapshot_frozen_load = false;
+int synchdb_fdw_snapshot_workers = 0;	/* 0: serial FDW snapshot */
+int synchdb_fdw_snapshot_split_size = 0;	/* in MB, 0: never split a table */
+char * synchdb_event_capture_dir = "";	/* empty: batch capture disabled */
+bool synchdb_track_latency = true;
+int synchdb_launcher_max_concurrency = 4;
+int synchdb_metrics_port = 0;	/* 0: metrics exporter disabled */
+char * synchdb_metrics_listen_address = "localhost";
+bool synchdb_transactional_offsets = true;
 
 static const struct config_enum_entry error_strategies[] =
 {
@@ -154,6 +194,13 @@ static const struct config_enum_entry snapshot_engines[] =
 	{NULL, 0, false}
 };
 
+static const struct config_enum_entry olr_payload_formats[] =
+{
+	{"json", OLR_PAYLOAD_JSON, false},
+	{"protobuf", OLR_PAYLOAD_PROTOBUF, false},
+	{NULL, 0, false}
+};
+
 /* JNI-related objects */
 static JavaVM *jvm = NULL; /* represents java vm instance */
 static JNIEnv *env = NULL; /* represents JNI run-time environment */
@@ -162,10 +209,114 @@ static jobject obj;		   /* represents debezium runner java class object */
 static jmethodID getChangeEvents;
 static jmethodID markBatchComplete;
 static jmethodID getoffsets;
+static jmethodID getBatchOffset;
+static jmethodID setBatchLimits;
+
+/*
+ * DbzBatchSpill - parts of a change event batch received so far
+ *
+ * A batch larger than synchdb.batch_spill_threshold is handed over by
+ * Debezium runner in 'S' framed parts followed by a final 'B' framed one.
+ * The parts are appended to a temporary file, one per connector since a
+ * group worker interleaves the batches of its members, and streamed back
+ * when the final part arrives.
+ */
+typedef struct DbzBatchSpill
+{
+	BufFile	   *file;		/* entries of the spilled parts, as framed */
+	int			batchId;	/* batch the parts belong to */
+	int			nevents;	/* change events spilled so far */
+	uint64		nbytes;		/* bytes spilled so far */
+} DbzBatchSpill;
+
+static DbzBatchSpill * dbzBatchSpills = NULL;	/* indexed by connector id */
+
+/*
+ * BatchTuner - runtime batch and queue sizing of a connector
+ *
+ * With synchdb.dbz_autotune on, the number of change events applied per
+ * transaction and the memory budget of the Debezium batch queue are adjusted
+ * after every batch from its apply time, commit time and replication lag.
+ */
+typedef struct BatchTuner
+{
+	int			batchSize;		/* change events per transaction */
+	int64		queueBytes;		/* batch queue budget */
+	double		eventBytes;		/* moving average size of a change event */
+	TimestampTz	lastChange;		/* when the sizes were last changed */
+} BatchTuner;
+
+static BatchTuner * batchTuners = NULL;	/* indexed by connector id */
+
+/*
+ * replay benchmark accounting - while synchdb_replay_events() runs, the CPU
+ * time spent between two connector state changes is charged to the state
+ * being left, which breaks the pipeline down into parse, convert and execute
+ */
+static bool replayTiming = false;
+static ConnectorState replayState = STATE_UNDEF;
+static struct rusage replayLastUsage;
+static double replayStateCpuMs[STATE_RELOAD_OBJMAP + 1];
+
+/* object mappings loaded by the synchdb_replay_events() call in progress */
+static MemoryContext replayObjmapContext = NULL;
+
+/* latency samples taken by this worker since they were last added to shared memory */
+static LatencyStatistics myLatencyStats;
+static bool myLatencyPending = false;
+
+/*
+ * metrics exporter: throughput computed between two samples of a connector,
+ * indexed by connector slot id and looked up by connector name and destination
+ * database when rendered, as names are only unique within a database
+ */
+typedef struct MetricsRate
+{
+	char		name[SYNCHDB_CONNINFO_NAME_SIZE];
+	char		dstdb[SYNCHDB_CONNINFO_DB_NAME_SIZE];
+	uint64		events;
+	uint64		dmls;
+	double		events_per_sec;
+	double		dmls_per_sec;
+} MetricsRate;
+
+static MetricsRate * metricsRates = NULL;
+
+/* when this connector worker started, until it has finished initializing */
+static instr_time workerStartTime;
+
+/* a connector started by the auto launcher */
+typedef struct LauncherEntry
+{
+	char	   *name;
+	int			connectorId;
+	BackgroundWorkerHandle *handle;
+	TimestampTz launched;
+	long		elapsed_ms;		/* from launch to ready, -1 if it never got ready */
+	bool		inflight;
+} LauncherEntry;
+
+/* a connector hosted by a connector group worker */
+typedef struct GroupMember
+{
+	int			connectorId;
+	ConnectorType type;
+	ConnectionInfo connInfo;
+	char	   *snapshotMode;
+	jobject		obj;			/* this connector's DebeziumRunner instance */
+	bool		dbzExitSignal;
+	bool		active;
+} GroupMember;
+
+static GroupMember * groupMembers = NULL;
+static int groupSize = 0;
 
 /* Function declarations */
 PGDLLEXPORT void synchdb_engine_main(Datum main_arg);
 PGDLLEXPORT void synchdb_auto_launcher_main(Datum main_arg);
+PGDLLEXPORT void synchdb_fdw_snapshot_worker_main(Datum main_arg);
+PGDLLEXPORT void synchdb_metrics_main(Datum main_arg);
+PGDLLEXPORT void synchdb_engine_group_main(Datum main_arg);
 
 /* Static function prototypes */
 static int dbz_engine_stop(void);
@@ -175,11 +326,23 @@ static int dbz_engine_get_change(JavaVM *jvm, JNIEnv *env, jclass *cls, jobject
 static int dbz_engine_start(const ConnectionInfo *connInfo, ConnectorType connectorType, const char * snapshotMode);
 static char *dbz_engine_get_offset(int connectorId);
 static int dbz_mark_batch_complete(int batchid);
+static void dbz_autotune_reset(int connectorId);
+static void dbz_autotune(int connectorId, const BatchInfo * batchinfo,
+		const SynchdbStatistics * myBatchStats);
 static TupleDesc synchdb_state_tupdesc(void);
 static TupleDesc synchdb_stats_tupdesc(void);
 static void synchdb_detach_shmem(int code, Datum arg);
 static void prepare_bgw(BackgroundWorker *worker, const ConnectionInfo *connInfo, const char *connector, int connectorid, const char * snapshotMode);
+static int start_connector_worker(const char * name, BackgroundWorkerHandle ** handlep);
+static void stop_connector_worker(int connectorId, const char * name, pid_t pid);
+static void save_shm_conninfo(const ConnectionInfo *connInfo, ConnectorType type, int connectorid, const char * snapshotMode);
+static void replay_charge_state(ConnectorState next);
+static void replay_release_connector(int code, Datum arg);
+static bool replay_read_uint32(FILE * fp, uint32 * val);
+static void replay_process_event(ConnectorType type, const ConnectionInfo * connInfo, char * event,
+		int len, SynchdbStatistics * myBatchStats, bool isfirst, bool islast);
 static const char *connectorStateAsString(ConnectorState state);
+static const char *connectorStageAsString(ConnectorStage stage);
 static void reset_shm_request_state(int connectorId);
 static int dbz_engine_set_offset(ConnectorType connectorType, char *db, char *offset, char *file);
 static void processRequestInterrupt(ConnectionInfo *connInfo, ConnectorType type, int connectorId);
@@ -192,6 +355,8 @@ static void set_extra_dbz_parameters(jobject myParametersObj, jclass myParameter
 		const ExtraConnectionInfo * extraConnInfo, const OLRConnectionInfo * olrConnInfo,
 		const IspnInfo * ispnInfo);
 static void set_shm_connector_statistics(int connectorId, SynchdbStatistics * stats);
+static void set_shm_connector_latency(int connectorId);
+static void add_latency_sample(LatencyHistogram * hist, instr_time * since);
 static void is_snapshot_cdc_needed(const char* snapshotMode, bool isSnapshotDone, bool * snapshot, bool * cdc);
 #ifdef WITH_OLR
 static void try_reconnect_olr(ConnectionInfo * connInfo);
@@ -220,6 +385,21 @@ count_active_connectors(void)
 	}
 	return i;
 }
+
+/*
+ * dbz_queue_max_bytes - Configured memory budget of the Debezium batch queue
+ *
+ * @return: budget in bytes
+ */
+static int64
+dbz_queue_max_bytes(void)
+{
+	int64 queuemb = jvm_max_batch_queue_memory > 0 ?
+			jvm_max_batch_queue_memory : Max(jvm_max_heap_size / 4, 1);
+
+	return queuemb * 1024 * 1024;
+}
+
 /*
  * set_extra_dbz_parameters - configures extra paramters for Debezium runner
  *
@@ -237,6 +417,7 @@ static void set_extra_dbz_parameters(jobject myParametersObj, jclass myParameter
 	jmethodID setOffsetFlushIntervalMs, setCaptureOnlySelectedTableDDL;
 	jmethodID setSslmode, setSslKeystore, setSslKeystorePass, setSslTruststore, setSslTruststorePass;
 	jmethodID setLogLevel, setOlr, setIspn, setLogminerStreamMode, setCdcDelay;
+	jmethodID setRecordProcessingThreads, setQueueMaxBytes, setSpillThresholdBytes;
 	jstring jdbz_skipped_operations, jdbz_watermarking_strategy;
 	jstring jdbz_sslmode, jdbz_sslkeystore, jdbz_sslkeystorepass, jdbz_ssltruststore, jdbz_ssltruststorepass;
 	jstring jolrHost, jolrSource;
@@ -644,6 +825,48 @@ static void set_extra_dbz_parameters(jobject myParametersObj, jclass myParameter
 	}
 	else
 		elog(WARNING, "failed to find setCdcDelay method");
+
+	setRecordProcessingThreads = (*env)->GetMethodID(env, myParametersClass, "setRecordProcessingThreads",
+			"(I)Lcom/example/DebeziumRunner$MyParameters;");
+	if (setRecordProcessingThreads)
+	{
+		myParametersObj = (*env)->CallObjectMethod(env, myParametersObj, setRecordProcessingThreads,
+				dbz_record_processing_threads);
+		if (!myParametersObj)
+		{
+			elog(WARNING, "failed to call setRecordProcessingThreads method");
+		}
+	}
+	else
+		elog(WARNING, "failed to find setRecordProcessingThreads method");
+
+	setQueueMaxBytes = (*env)->GetMethodID(env, myParametersClass, "setQueueMaxBytes",
+			"(J)Lcom/example/DebeziumRunner$MyParameters;");
+	if (setQueueMaxBytes)
+	{
+		myParametersObj = (*env)->CallObjectMethod(env, myParametersObj, setQueueMaxBytes,
+				(jlong) dbz_queue_max_bytes());
+		if (!myParametersObj)
+		{
+			elog(WARNING, "failed to call setQueueMaxBytes method");
+		}
+	}
+	else
+		elog(WARNING, "failed to find setQueueMaxBytes method");
+
+	setSpillThresholdBytes = (*env)->GetMethodID(env, myParametersClass, "setSpillThresholdBytes",
+			"(J)Lcom/example/DebeziumRunner$MyParameters;");
+	if (setSpillThresholdBytes)
+	{
+		myParametersObj = (*env)->CallObjectMethod(env, myParametersObj, setSpillThresholdBytes,
+				(jlong) synchdb_batch_spill_threshold * 1024 * 1024);
+		if (!myParametersObj)
+		{
+			elog(WARNING, "failed to call setSpillThresholdBytes method");
+		}
+	}
+	else
+		elog(WARNING, "failed to find setSpillThresholdBytes method");
 	/*
 	 * additional parameters that we want to pass to Debezium on the java side
 	 * will be added here, Make sure to add the matching methods in the MyParameters
@@ -750,6 +973,189 @@ dbz_engine_init(JNIEnv *env, jclass *cls, jobject *obj)
 	return 0;
 }
 
+/*
+ * dbz_engine_get_batch_offset - Get the source offset reached by a batch
+ *
+ * This function asks Debezium runner for the source offset of the last change
+ * event in the given batch, in the same JSON form Debezium keeps in its offset
+ * file.
+ *
+ * @param batchid: The batch ID of interest
+ *
+ * @return: palloc'ed offset string, or NULL if it is not available
+ */
+static char *
+dbz_engine_get_batch_offset(jclass cls, jobject obj, int batchid)
+{
+	jstring jresult;
+	const char * resultStr;
+	char * offset = NULL;
+
+	if (!getBatchOffset)
+	{
+		getBatchOffset = (*env)->GetMethodID(env, cls, "getBatchOffset",
+											 "(I)Ljava/lang/String;");
+		if (getBatchOffset == NULL)
+		{
+			elog(WARNING, "Failed to find getBatchOffset method");
+			return NULL;
+		}
+	}
+
+	jresult = (jstring) (*env)->CallObjectMethod(env, obj, getBatchOffset, batchid);
+	if ((*env)->ExceptionCheck(env))
+	{
+		(*env)->ExceptionDescribe(env);
+		(*env)->ExceptionClear(env);
+		elog(WARNING, "Exception occurred while calling getBatchOffset");
+		return NULL;
+	}
+	if (jresult == NULL)
+		return NULL;
+
+	resultStr = (*env)->GetStringUTFChars(env, jresult, NULL);
+	if (resultStr)
+	{
+		offset = pstrdup(resultStr);
+		(*env)->ReleaseStringUTFChars(env, jresult, resultStr);
+	}
+	(*env)->DeleteLocalRef(env, jresult);
+	return offset;
+}
+
+/*
+ * dbz_spill_discard - Drop the spilled parts of a connector's batch
+ *
+ * @param spill: The spill state to reset
+ */
+static void
+dbz_spill_discard(DbzBatchSpill * spill)
+{
+	if (spill->file)
+		BufFileClose(spill->file);
+	spill->file = NULL;
+	spill->batchId = SYNCHDB_INVALID_BATCH_ID;
+	spill->nevents = 0;
+	spill->nbytes = 0;
+}
+
+/*
+ * dbz_spill_get - Get the spill state of a connector
+ *
+ * @param myConnectorId: The connector ID of interest
+ * @param batchId: The batch being received
+ *
+ * @return: The spill state. Parts left over from a different batch, which
+ * was abandoned by an engine restart, are discarded.
+ */
+static DbzBatchSpill *
+dbz_spill_get(int myConnectorId, int batchId)
+{
+	DbzBatchSpill * spill;
+
+	if (!dbzBatchSpills)
+		dbzBatchSpills = MemoryContextAllocZero(TopMemoryContext,
+				sizeof(DbzBatchSpill) * synchdb_max_connector_workers);
+
+	spill = &dbzBatchSpills[myConnectorId];
+	if (spill->file && spill->batchId != batchId)
+	{
+		elog(WARNING, "discarding %d spilled change events of incomplete batch %d",
+				spill->nevents, spill->batchId);
+		dbz_spill_discard(spill);
+	}
+	return spill;
+}
+
+/*
+ * dbz_spill_batch_part - Append a part of a batch to the connector's spill file
+ *
+ * @param spill: The spill state of the connector
+ * @param batchId: The batch the part belongs to
+ * @param entries: The framed change events of the part
+ * @param len: Length of entries in bytes
+ * @param nevents: Number of change events in entries
+ */
+static void
+dbz_spill_batch_part(DbzBatchSpill * spill, int batchId, const unsigned char * entries,
+		Size len, int nevents)
+{
+	if (!spill->file)
+	{
+		MemoryContext oldcontext = MemoryContextSwitchTo(TopMemoryContext);
+
+		/* not tied to a transaction, parts arrive between transactions */
+		spill->file = BufFileCreateTemp(true);
+		MemoryContextSwitchTo(oldcontext);
+		spill->batchId = batchId;
+	}
+
+	BufFileWrite(spill->file, entries, len);
+	spill->nevents += nevents;
+	spill->nbytes += len;
+
+	elog(DEBUG1, "spilled %d change events (%zu bytes) of batch %d, %d so far",
+			nevents, len, batchId, spill->nevents);
+}
+
+/*
+ * dbz_spill_apply - Apply the spilled change events of a batch
+ *
+ * The events are read back one at a time into a reusable buffer, so memory
+ * use does not depend on the size of the batch. Called inside the transaction
+ * that applies the whole batch.
+ *
+ * @param spill: The spill state of the connector
+ * @param myConnectorId: The connector ID of interest
+ * @param myBatchStats: update connector statistics to this struct
+ * @param flag: flags passed on to the change event processing
+ * @param hasmore: whether the final part has change events following these
+ *
+ * @return: The number of change events applied
+ */
+static int
+dbz_spill_apply(DbzBatchSpill * spill, int myConnectorId, SynchdbStatistics * myBatchStats,
+		int flag, bool hasmore)
+{
+	StringInfoData event;
+	int curr = 0;
+
+	if (BufFileSeek(spill->file, 0, 0, SEEK_SET) != 0)
+		ereport(ERROR,
+				(errcode_for_file_access(),
+				 errmsg("could not rewind spill file of batch %d: %m", spill->batchId)));
+
+	initStringInfo(&event);
+	for (curr = 0; curr < spill->nevents; curr++)
+	{
+		uint32 json_len = 0;
+
+		BufFileReadExact(spill->file, &json_len, 4);
+		json_len = ntohl(json_len);
+
+		/* json_len includes the null terminator */
+		if (json_len == 0)
+			continue;
+
+		resetStringInfo(&event);
+		enlargeStringInfo(&event, json_len);
+		BufFileReadExact(spill->file, event.data, json_len);
+		event.len = json_len - 1;
+
+		if (synchdb_log_event_on_error)
+			g_eventStr = event.data;
+
+		fc_processDBZChangeEvent(event.data, myBatchStats, flag,
+				get_shm_connector_name_by_id(myConnectorId),
+				(curr == 0), (!hasmore && curr == spill->nevents - 1));
+	}
+	pfree(event.data);
+
+	increment_connector_statistics(myBatchStats, STATS_SPILL_COUNT, 1);
+	myBatchStats->genstats.stats_spill_bytes += spill->nbytes;
+	return curr;
+}
+
 /*
  * dbz_engine_get_change - Retrieve and process change events from the Debezium engine
  *
@@ -775,6 +1181,10 @@ dbz_engine_get_change(JavaVM *jvm, JNIEnv *env, jclass *cls, jobject *obj, int m
 	int offset = 0;
 	unsigned char * data;
 	jsize datalen = 0;
+	instr_time lat;
+	instr_time batchstart, commitstart, batchend;
+
+	INSTR_TIME_SET_CURRENT(batchstart);
 
 	/* Validate input parameters */
 	if (!jvm || !env || !cls || !obj)
@@ -795,6 +1205,7 @@ dbz_engine_get_change(JavaVM *jvm, JNIEnv *env, jclass *cls, jobject *obj, int m
 	}
 
 	/* Call getChangeEvents method */
+	start_connector_latency(&lat);
 	jbytebuffer = (*env)->CallObjectMethod(env, *obj, getChangeEvents);
 	if ((*env)->ExceptionCheck(env))
 	{
@@ -813,10 +1224,48 @@ dbz_engine_get_change(JavaVM *jvm, JNIEnv *env, jclass *cls, jobject *obj, int m
 
 	elog(DEBUG1, "datalen %d", datalen);
 
-	if (data[0] == 'B')
+	if (data[0] == 'S')
+	{
+		int batchid = 0;
+		int partsize = 0;
+		DbzBatchSpill * spill;
+
+		record_batch_latency(LATENCY_STAGE_FETCH, &lat);
+
+		offset += 1;
+		memcpy(&batchid, data + offset, 4);
+		batchid = ntohl(batchid);
+		offset += 4;
+
+		memcpy(&partsize, data + offset, 4);
+		partsize = ntohl(partsize);
+		offset += 4;
+
+		/*
+		 * a spilled part replays as a batch of its own. data is the Java
+		 * direct buffer, so the marker is swapped in the capture file only
+		 */
+		if (synchdb_event_capture_dir && strlen(synchdb_event_capture_dir) > 0)
+			synchdb_capture_batch(myConnectorId, 'B', (const char *) data + 1, datalen - 1);
+
+		spill = dbz_spill_get(myConnectorId, batchid);
+		dbz_spill_batch_part(spill, batchid, data + offset, datalen - offset, partsize);
+
+		/*
+		 * the batch is not complete yet, there is nothing to mark done. Fall
+		 * through to release the buffer's local ref, otherwise the direct
+		 * buffer behind every part stays reachable until the worker exits.
+		 */
+		batchinfo->batchId = SYNCHDB_INVALID_BATCH_ID;
+	}
+	else if (data[0] == 'B')
 	{
 		int batchsize = 0;
 		int curr = 0;
+		int nspilled = 0;
+		DbzBatchSpill * spill;
+
+		record_batch_latency(LATENCY_STAGE_FETCH, &lat);
 
 		offset += 1;
 		memcpy(&(batchinfo->batchId), data + offset, 4);
@@ -828,10 +1277,24 @@ dbz_engine_get_change(JavaVM *jvm, JNIEnv *env, jclass *cls, jobject *obj, int m
 		offset += 4;
 
 		elog(DEBUG1, "batch id %d contains %d change events", batchinfo->batchId, batchsize);
-		
+
+		/* keep a verbatim copy of the batch for offline replay if requested */
+		if (synchdb_event_capture_dir && strlen(synchdb_event_capture_dir) > 0)
+			synchdb_capture_batch(myConnectorId, 'B', (const char *) data + 1, datalen - 1);
+
 		StartTransactionCommand();
 		PushActiveSnapshot(GetTransactionSnapshot());
 
+		/* earlier parts of this batch were spilled, apply them first */
+		spill = dbz_spill_get(myConnectorId, batchinfo->batchId);
+		if (spill->file)
+		{
+			nspilled = dbz_spill_apply(spill, myConnectorId, myBatchStats, flag,
+					batchsize > 0);
+			batchinfo->batchBytes += spill->nbytes;
+			dbz_spill_discard(spill);
+		}
+
 		while (offset + 4 <= datalen && curr < batchsize)
 		{
 			int json_len = 0;
@@ -862,15 +1325,49 @@ dbz_engine_get_change(JavaVM *jvm, JNIEnv *env, jclass *cls, jobject *obj, int m
 
 			fc_processDBZChangeEvent((char *)(data + offset), myBatchStats, flag,
 					get_shm_connector_name_by_id(myConnectorId),
-					(curr == 0), (curr == batchsize - 1));
+					(nspilled == 0 && curr == 0), (curr == batchsize - 1));
 
 			offset += json_len;
 			curr++;
 		}
 
+		/*
+		 * record the offset this batch reaches in the transaction that applies
+		 * it, so a restart resumes exactly after the last committed batch no
+		 * matter when Debezium last flushed its offset file. An OLR connector
+		 * only uses Debezium for its initial snapshot and keeps its own offset.
+		 */
+		if (synchdb_transactional_offsets &&
+			sdb_state->connectors[myConnectorId].type != TYPE_OLR)
+		{
+			char * batchoffset = dbz_engine_get_batch_offset(*cls, *obj, batchinfo->batchId);
+
+			if (batchoffset)
+			{
+				ra_saveOffset(get_shm_connector_name_by_id(myConnectorId), batchoffset);
+				pfree(batchoffset);
+			}
+		}
+
+		start_connector_latency(&lat);
+		INSTR_TIME_SET_CURRENT(commitstart);
 		PopActiveSnapshot();
 		CommitTransactionCommand();
-		increment_connector_statistics(myBatchStats, STATS_TOTAL_CHANGE_EVENT, batchsize);
+		record_batch_latency(LATENCY_STAGE_COMMIT, &lat);
+		increment_connector_statistics(myBatchStats, STATS_TOTAL_CHANGE_EVENT,
+				batchsize + nspilled);
+
+		/* measurements for batch size tuning */
+		batchinfo->batchSize = batchsize + nspilled;
+		batchinfo->batchBytes += offset;
+		INSTR_TIME_SET_CURRENT(batchend);
+		batchinfo->elapsedMs = INSTR_TIME_GET_MILLISEC(batchend) -
+			INSTR_TIME_GET_MILLISEC(batchstart);
+		batchinfo->commitMs = INSTR_TIME_GET_MILLISEC(batchend) -
+			INSTR_TIME_GET_MILLISEC(commitstart);
+
+		/* indexes deferred during the snapshot are built in their own transaction */
+		ra_buildPendingDeferredIndexes();
 	}
 	else if (data[0] == 'K')
 	{
@@ -1018,6 +1515,9 @@ dbz_engine_start(const ConnectionInfo *connInfo, ConnectorType connectorType, co
 
 	elog(LOG, "Debezium engine started successfully for %s connector", connectorTypeToString(connectorType));
 
+	/* a new engine starts from the configured batch and queue sizes */
+	dbz_autotune_reset(myConnectorId);
+
 cleanup:
 	/* Clean up local references */
 	if (jHostname)
@@ -1194,7 +1694,7 @@ static TupleDesc
 synchdb_state_tupdesc(void)
 {
 	TupleDesc tupdesc;
-	AttrNumber attrnum = 7;
+	AttrNumber attrnum = 12;
 	AttrNumber a = 0;
 
 	tupdesc = CreateTemplateTupleDesc(attrnum);
@@ -1207,6 +1707,11 @@ synchdb_state_tupdesc(void)
 	TupleDescInitEntry(tupdesc, ++a, "state", TEXTOID, -1, 0);
 	TupleDescInitEntry(tupdesc, ++a, "err", TEXTOID, -1, 0);
 	TupleDescInitEntry(tupdesc, ++a, "last_dbz_offset", TEXTOID, -1, 0);
+	TupleDescInitEntry(tupdesc, ++a, "jvm_startup_ms", INT4OID, -1, 0);
+	TupleDescInitEntry(tupdesc, ++a, "startup_ms", INT4OID, -1, 0);
+	TupleDescInitEntry(tupdesc, ++a, "batch_size", INT4OID, -1, 0);
+	TupleDescInitEntry(tupdesc, ++a, "queue_kb", INT4OID, -1, 0);
+	TupleDescInitEntry(tupdesc, ++a, "tune_reason", TEXTOID, -1, 0);
 
 	return BlessTupleDesc(tupdesc);
 }
@@ -1224,7 +1729,7 @@ static TupleDesc
 synchdb_stats_tupdesc(void)
 {
 	TupleDesc tupdesc;
-	AttrNumber attrnum = 20;
+	AttrNumber attrnum = 24;
 	AttrNumber a = 0;
 
 	tupdesc = CreateTemplateTupleDesc(attrnum);
@@ -1257,6 +1762,14 @@ synchdb_stats_tupdesc(void)
 	TupleDescInitEntry(tupdesc, ++a, "snapshot_begin_ts", INT8OID, -1, 0);
 	TupleDescInitEntry(tupdesc, ++a, "snapshot_end_ts", INT8OID, -1, 0);
 
+	/* tuple locator stats */
+	TupleDescInitEntry(tupdesc, ++a, "locator_hits", INT8OID, -1, 0);
+	TupleDescInitEntry(tupdesc, ++a, "locator_misses", INT8OID, -1, 0);
+
+	/* spill stats */
+	TupleDescInitEntry(tupdesc, ++a, "spilled_batches", INT8OID, -1, 0);
+	TupleDescInitEntry(tupdesc, ++a, "spilled_bytes", INT8OID, -1, 0);
+
 	return BlessTupleDesc(tupdesc);
 }
 
@@ -1280,6 +1793,7 @@ synchdb_init_shmem(void)
 	{
 		/* First time through ... */
 		LWLockInitialize(&sdb_state->lock, LWLockNewTrancheId());
+		sdb_state->last_group_id = 0;
 	}
 	sdb_state->connectors =
 			ShmemInitStruct("synchdb_connectors",
@@ -1342,7 +1856,6 @@ static void
 prepare_bgw(BackgroundWorker *worker, const ConnectionInfo *connInfo, const char *connector, int connectorid, const char * snapshotMode)
 
 {
-	const char * val = NULL;
 	ConnectorType type = fc_get_connector_type(connector);
 
 	worker->bgw_main_arg = UInt32GetDatum(connectorid);
@@ -1353,14 +1866,30 @@ prepare_bgw(BackgroundWorker *worker, const ConnectionInfo *connInfo, const char
 	strcat(worker->bgw_name, " -> ");
 	strcat(worker->bgw_name, connInfo->dstdb);
 
-	/* [ivorysql] check if we are running under ivorysql's oracle compatible mode */
-	val = GetConfigOption("ivorysql.compatible_mode", true, false);
-
 	/*
 	 * save connInfo to synchdb shared memory at index[connectorid]. When the connector
 	 * worker starts, it will obtain the same connInfo from shared memory from the same
 	 * index location
 	 */
+	save_shm_conninfo(connInfo, type, connectorid, snapshotMode);
+}
+
+/*
+ * save_shm_conninfo - Save connector information to synchdb shared memory
+ *
+ * @param connInfo: Pointer to the ConnectionInfo structure containing connection details
+ * @param type: The connector type
+ * @param connectorid: Connector ID of interest
+ * @param snapshotMode: Snapshot mode to use to start Debezium engine
+ */
+static void
+save_shm_conninfo(const ConnectionInfo *connInfo, ConnectorType type, int connectorid, const char * snapshotMode)
+{
+	const char * val = NULL;
+
+	/* [ivorysql] check if we are running under ivorysql's oracle compatible mode */
+	val = GetConfigOption("ivorysql.compatible_mode", true, false);
+
 	LWLockAcquire(&sdb_state->lock, LW_EXCLUSIVE);
 	sdb_state->connectors[connectorid].type = type;
 	memset(sdb_state->connectors[connectorid].snapshotMode, 0, SYNCHDB_SNAPSHOT_MODE_SIZE);
@@ -1370,6 +1899,13 @@ prepare_bgw(BackgroundWorker *worker, const ConnectionInfo *connInfo, const char
 	memcpy(&(sdb_state->connectors[connectorid].conninfo), connInfo, sizeof(ConnectionInfo));
 	if (val && !strcasecmp(val, "oracle"))
 		sdb_state->connectors[connectorid].conninfo.isOraCompat = true;
+	sdb_state->connectors[connectorid].jvm_startup_ms = 0;
+	sdb_state->connectors[connectorid].startup_ms = 0;
+	sdb_state->connectors[connectorid].shared_jvm = false;
+	sdb_state->connectors[connectorid].group_id = 0;
+	sdb_state->connectors[connectorid].batch_size = 0;
+	sdb_state->connectors[connectorid].queue_kb = 0;
+	memset(sdb_state->connectors[connectorid].tune_reason, 0, SYNCHDB_TUNE_REASON_SIZE);
 	LWLockRelease(&sdb_state->lock);
 }
 
@@ -1505,6 +2041,84 @@ dbz_engine_set_offset(ConnectorType connectorType, char *db, char *offset, char
 	return 0;
 }
 
+/*
+ * dbz_engine_restore_offset - Rebuild the offset file from synchdb_offsets
+ *
+ * The offset recorded in synchdb_offsets is committed together with the
+ * changes it covers, while the offset file is only flushed periodically by
+ * Debezium. Before the engine starts, the file is rewritten from the table so
+ * that Debezium resumes right after the last applied batch.
+ *
+ * @param connectorType: The type of connector
+ * @param connInfo: Connection information of the connector
+ *
+ * @return: 0 on success or if there is nothing to restore, -1 on failure
+ */
+static int
+dbz_engine_restore_offset(ConnectorType connectorType, const ConnectionInfo * connInfo)
+{
+	jmethodID createoffsets;
+	jstring joffsetstr, jdb, jfile;
+	jthrowable exception;
+	char * offset = NULL;
+	char * offsetfile = NULL;
+
+	if (!synchdb_transactional_offsets)
+		return 0;
+
+	if (connectorType != TYPE_MYSQL && connectorType != TYPE_ORACLE &&
+		connectorType != TYPE_SQLSERVER)
+		return 0;
+
+	if (!jvm || !env)
+	{
+		elog(WARNING, "jvm not initialized");
+		return -1;
+	}
+
+	offset = ra_getOffset(connInfo->name);
+	if (!offset)
+		return 0;
+
+	createoffsets = (*env)->GetMethodID(env, cls, "createOffsetFile",
+									 "(Ljava/lang/String;ILjava/lang/String;Ljava/lang/String;)V");
+	if (createoffsets == NULL)
+	{
+		elog(WARNING, "Failed to find createOffsetFile method");
+		pfree(offset);
+		return -1;
+	}
+
+	offsetfile = psprintf(SYNCHDB_OFFSET_FILE_PATTERN,
+			get_shm_connector_name(connectorType), connInfo->name, connInfo->dstdb);
+	joffsetstr = (*env)->NewStringUTF(env, offset);
+	jdb = (*env)->NewStringUTF(env, connInfo->srcdb);
+	jfile = (*env)->NewStringUTF(env, offsetfile);
+
+	(*env)->CallVoidMethod(env, obj, createoffsets, jfile, (int)connectorType, jdb, joffsetstr);
+
+	exception = (*env)->ExceptionOccurred(env);
+	if (exception)
+	{
+		(*env)->ExceptionDescribe(env);
+		(*env)->ExceptionClear(env);
+		elog(WARNING, "Exception occurred while restoring connector offset");
+		pfree(offset);
+		pfree(offsetfile);
+		return -1;
+	}
+
+	(*env)->DeleteLocalRef(env, joffsetstr);
+	(*env)->DeleteLocalRef(env, jdb);
+	(*env)->DeleteLocalRef(env, jfile);
+
+	elog(LOG, "restored offset of connector %s from %s: %s",
+			connInfo->name, SYNCHDB_OFFSETS_TABLE, offset);
+	pfree(offset);
+	pfree(offsetfile);
+	return 0;
+}
+
 /*
  * processRequestInterrupt - Handles state transition requests for SynchDB connectors
  *
@@ -1673,6 +2287,10 @@ processRequestInterrupt(ConnectionInfo *connInfo, ConnectorType type, int connec
 				return;
 			}
 
+			/* the offset table is what a restart resumes from, keep it in line */
+			if (synchdb_transactional_offsets)
+				ra_saveOffset(connInfo->name, reqcopy->reqdata);
+
 			/* after new offset is set, change state back to STATE_PAUSED */
 			set_shm_connector_state(connectorId, STATE_PAUSED);
 
@@ -1698,6 +2316,10 @@ processRequestInterrupt(ConnectionInfo *connInfo, ConnectorType type, int connec
 				return;
 			}
 
+			/* the offset table is what a restart resumes from, keep it in line */
+			if (synchdb_transactional_offsets)
+				ra_saveOffset(connInfo->name, reqcopy->reqdata);
+
 			/* after new offset is set, change state back to STATE_PAUSED */
 			set_shm_connector_state(connectorId, STATE_PAUSED);
 
@@ -1868,7 +2490,9 @@ setup_environment(ConnectorType * connectorType, ConnectionInfo *conninfo, char
  * initialize_jvm - Initialize the Java Virtual Machine and Debezium engine
  *
  * This function sets up the Java environment, locates the Debezium engine JAR file,
- * creates a Java VM, and initializes the Debezium engine.
+ * creates a Java VM, and initializes the Debezium engine. If the class data sharing
+ * archive made by "make install_dbz_cds" sits next to the JAR file, the JVM maps the
+ * pre-parsed engine classes from it instead of loading them from the JAR.
  */
 static void
 initialize_jvm(JMXConnectionInfo * jmx)
@@ -1876,15 +2500,25 @@ initialize_jvm(JMXConnectionInfo * jmx)
 	JavaVMInitArgs vm_args;
 	JavaVMOption options[30];	/* ensure we do not exceed this max number of java options */
 	char jar_path[MAX_PATH_LENGTH] = {0};
+	char cds_path[MAX_PATH_LENGTH] = {0};
 	const char *dbzpath = getenv("DBZ_ENGINE_DIR");
 	MemoryContext jvmContext, oldContext;
 	int ret, optcount = 0, i = 0;
+	instr_time starttime, duration;
 
-	/* Determine the path to the Debezium engine JAR file */
+	INSTR_TIME_SET_CURRENT(starttime);
+
+	/* Determine the path to the Debezium engine JAR file and its CDS archive */
 	if (dbzpath)
+	{
 		snprintf(jar_path, sizeof(jar_path), "%s/%s", dbzpath, DBZ_ENGINE_JAR_FILE);
+		snprintf(cds_path, sizeof(cds_path), "%s/%s", dbzpath, DBZ_ENGINE_CDS_FILE);
+	}
 	else
+	{
 		snprintf(jar_path, sizeof(jar_path), "%s/dbz_engine/%s", pkglib_path, DBZ_ENGINE_JAR_FILE);
+		snprintf(cds_path, sizeof(cds_path), "%s/dbz_engine/%s", pkglib_path, DBZ_ENGINE_CDS_FILE);
+	}
 
 	/* Check if the JAR file exists */
 	if (access(jar_path, F_OK) == -1)
@@ -1902,7 +2536,17 @@ initialize_jvm(JMXConnectionInfo * jmx)
 	options[optcount++].optionString = psprintf("-Xmx%dm", jvm_max_heap_size);
 	options[optcount++].optionString = psprintf("-XX:MaxDirectMemorySize=%dm", jvm_max_direct_buffer_size);
 
-	/* jmx parameters if enabled */
+	/*
+	 * use the CDS archive if present. -Xshare:auto makes the JVM fall back to
+	 * loading classes from the JAR should the archive not match this JVM
+	 */
+	if (access(cds_path, R_OK) == 0)
+	{
+		options[optcount++].optionString = psprintf("-XX:SharedArchiveFile=%s", cds_path);
+		options[optcount++].optionString = "-Xshare:auto";
+	}
+
+	/* jmx parameters if enabled */
 	if (jmx && strcasecmp(jmx->jmx_listenaddr, "null") &&
 			strcasecmp(jmx->jmx_rmiserveraddr, "null"))
 	{
@@ -1978,6 +2622,17 @@ initialize_jvm(JMXConnectionInfo * jmx)
 
 	elog(INFO, "Debezium engine initialized successfully");
 
+	INSTR_TIME_SET_CURRENT(duration);
+	INSTR_TIME_SUBTRACT(duration, starttime);
+	if (sdb_state)
+	{
+		LWLockAcquire(&sdb_state->lock, LW_EXCLUSIVE);
+		sdb_state->connectors[myConnectorId].jvm_startup_ms =
+				(uint32) INSTR_TIME_GET_MILLISEC(duration);
+		LWLockRelease(&sdb_state->lock);
+	}
+	elog(LOG, "JVM startup took %.0f ms", INSTR_TIME_GET_MILLISEC(duration));
+
 	MemoryContextSwitchTo(oldContext);
 	MemoryContextDelete(jvmContext);
 }
@@ -2080,6 +2735,10 @@ populate_debezium_metadata(const char * name, ConnectorType connectorType,
 		goto end;
 	}
 
+	/* a restart must resume from this offset, not from an older recorded one */
+	if (synchdb_transactional_offsets)
+		ra_saveOffset(name, offsetstr);
+
 	/* populate schema history file */
 	ret = dump_schema_history_to_file(name, schemahistoryfile);
 	if (ret)
@@ -2333,8 +2992,8 @@ main_loop(ConnectorType connectorType, ConnectionInfo *connInfo, char * snapshot
 					{
 						/* Debezium based snapshot, schema and CDC processing logics here */
 
+						memset(&myBatchInfo, 0, sizeof(myBatchInfo));
 						myBatchInfo.batchId = SYNCHDB_INVALID_BATCH_ID;
-						myBatchInfo.batchSize = 0;
 						memset(&myBatchStats, 0, sizeof(myBatchStats));
 
 						dbz_engine_get_change(jvm, env, &cls, &obj, myConnectorId, &dbzExitSignal,
@@ -2358,6 +3017,9 @@ main_loop(ConnectorType connectorType, ConnectionInfo *connInfo, char * snapshot
 
 							/* update offset for displaying to user */
 							set_shm_dbz_offset(myConnectorId);
+
+							/* adjust batch size and queue budget to the measured load */
+							dbz_autotune(myConnectorId, &myBatchInfo, &myBatchStats);
 						}
 					}
 				}
@@ -2372,8 +3034,8 @@ main_loop(ConnectorType connectorType, ConnectionInfo *connInfo, char * snapshot
 						if (connInfo->snapengine == ENGINE_DEBEZIUM)
 						{
 							/* continuously poll changes from debezium engine */
+							memset(&myBatchInfo, 0, sizeof(myBatchInfo));
 							myBatchInfo.batchId = SYNCHDB_INVALID_BATCH_ID;
-							myBatchInfo.batchSize = 0;
 							memset(&myBatchStats, 0, sizeof(myBatchStats));
 
 							dbz_engine_get_change(jvm, env, &cls, &obj, myConnectorId, &dbzExitSignal,
@@ -2393,6 +3055,9 @@ main_loop(ConnectorType connectorType, ConnectionInfo *connInfo, char * snapshot
 
 								/* update the batch statistics to shared memory */
 								set_shm_connector_statistics(myConnectorId, &myBatchStats);
+
+								/* adjust batch size and queue budget to the measured load */
+								dbz_autotune(myConnectorId, &myBatchInfo, &myBatchStats);
 							}
 						}
 						else if (connInfo->snapengine == ENGINE_FDW)
@@ -2608,6 +3273,10 @@ main_loop(ConnectorType connectorType, ConnectionInfo *connInfo, char * snapshot
 						elog(WARNING, "failed to write snapshot state...");
 					}
 
+					/* CDC resumes from the snapshot scn, replacing any older recorded offset */
+					if (synchdb_transactional_offsets)
+						olr_client_save_scn_state(connInfo->name);
+
 					/* shutdown debezium only if we use debezium engine for snapshot */
 					if (connInfo->snapengine == ENGINE_DEBEZIUM)
 					{
@@ -2912,6 +3581,215 @@ dbz_mark_batch_complete(int batchid)
 	return 0;
 }
 
+/*
+ * dbz_engine_set_batch_limits - Change batch limits of a running engine
+ *
+ * @param maxRecords: Change events handed out per batch, 0 for whole
+ * Debezium batches
+ * @param queueBytes: Memory budget of the batch queue, 0 to keep it
+ *
+ * @return: 0 on success, -1 on failure
+ */
+static int
+dbz_engine_set_batch_limits(int maxRecords, int64 queueBytes)
+{
+	jthrowable exception;
+
+	if (!jvm || !env)
+	{
+		elog(WARNING, "jvm not initialized");
+		return -1;
+	}
+
+	if (!setBatchLimits)
+	{
+		setBatchLimits = (*env)->GetMethodID(env, cls, "setBatchLimits", "(IJ)V");
+		if (setBatchLimits == NULL)
+		{
+			elog(WARNING, "Failed to find setBatchLimits method");
+			return -1;
+		}
+	}
+
+	(*env)->CallVoidMethod(env, obj, setBatchLimits, (jint) maxRecords, (jlong) queueBytes);
+
+	exception = (*env)->ExceptionOccurred(env);
+	if (exception)
+	{
+		(*env)->ExceptionDescribe(env);
+		(*env)->ExceptionClear(env);
+		elog(WARNING, "Exception occurred while calling setBatchLimits");
+		return -1;
+	}
+	return 0;
+}
+
+/*
+ * dbz_autotune_get - Get the batch tuner of a connector
+ */
+static BatchTuner *
+dbz_autotune_get(int connectorId)
+{
+	if (!batchTuners)
+		batchTuners = MemoryContextAllocZero(TopMemoryContext,
+				sizeof(BatchTuner) * synchdb_max_connector_workers);
+
+	return &batchTuners[connectorId];
+}
+
+/*
+ * dbz_autotune_publish - Show the effective batch limits in the state view
+ */
+static void
+dbz_autotune_publish(int connectorId, const BatchTuner * tuner, const char * reason)
+{
+	if (!sdb_state)
+		return;
+
+	LWLockAcquire(&sdb_state->lock, LW_EXCLUSIVE);
+	sdb_state->connectors[connectorId].batch_size = tuner->batchSize;
+	sdb_state->connectors[connectorId].queue_kb = (int32) (tuner->queueBytes / 1024);
+	strlcpy(sdb_state->connectors[connectorId].tune_reason, reason,
+			SYNCHDB_TUNE_REASON_SIZE);
+	LWLockRelease(&sdb_state->lock);
+}
+
+/*
+ * dbz_autotune_reset - Start a connector's batch tuning from configuration
+ *
+ * Called after the engine has started, with the configured batch size and
+ * queue budget in effect.
+ *
+ * @param connectorId: Connector ID of interest
+ */
+static void
+dbz_autotune_reset(int connectorId)
+{
+	BatchTuner * tuner = dbz_autotune_get(connectorId);
+
+	tuner->batchSize = dbz_batch_size;
+	tuner->queueBytes = dbz_queue_max_bytes();
+	tuner->eventBytes = 0;
+	tuner->lastChange = GetCurrentTimestamp();
+
+	dbz_autotune_publish(connectorId, tuner, dbz_autotune ? "configured" : "");
+}
+
+/*
+ * dbz_autotune - Adjust batch size and queue budget after a batch
+ *
+ * The number of change events applied per transaction is halved as soon as
+ * a batch takes longer than synchdb.dbz_autotune_target_ms to apply, and
+ * doubled while full batches are applied well within the target but the
+ * connector lags behind the source, or while commits dominate apply time.
+ * The batch queue is sized to hold a few batches of the average event size.
+ * Both stay between the synchdb.dbz_autotune_min_* settings and the
+ * configured synchdb.dbz_batch_size and batch queue memory. Except for
+ * shrinking, the sizes change at most once per second.
+ *
+ * @param connectorId: Connector ID of interest
+ * @param batchinfo: Measurements of the batch just applied
+ * @param myBatchStats: Statistics of the batch just applied
+ */
+static void
+dbz_autotune(int connectorId, const BatchInfo * batchinfo,
+		const SynchdbStatistics * myBatchStats)
+{
+	BatchTuner * tuner;
+	int			newsize;
+	int64		newqueue, maxqueue, minqueue, wantqueue;
+	int64		lagms = 0;
+	double		target = dbz_autotune_target_ms;
+	char		reason[SYNCHDB_TUNE_REASON_SIZE] = {0};
+	TimestampTz now;
+
+	if (!dbz_autotune || batchinfo->batchSize <= 0)
+		return;
+
+	tuner = dbz_autotune_get(connectorId);
+	newsize = tuner->batchSize;
+	maxqueue = dbz_queue_max_bytes();
+	minqueue = Min((int64) dbz_autotune_min_queue_memory * 1024 * 1024, maxqueue);
+
+	/* moving average size of a change event */
+	if (tuner->eventBytes == 0)
+		tuner->eventBytes = (double) batchinfo->batchBytes / batchinfo->batchSize;
+	else
+		tuner->eventBytes = 0.8 * tuner->eventBytes +
+			0.2 * ((double) batchinfo->batchBytes / batchinfo->batchSize);
+
+	if (myBatchStats->genstats.stats_last_pg_ts > myBatchStats->genstats.stats_last_src_ts &&
+		myBatchStats->genstats.stats_last_src_ts > 0)
+		lagms = myBatchStats->genstats.stats_last_pg_ts -
+			myBatchStats->genstats.stats_last_src_ts;
+
+	if (get_shm_connector_stage_enum(connectorId) != STAGE_CHANGE_DATA_CAPTURE)
+	{
+		/* snapshots are throughput bound, use the configured maximum */
+		newsize = dbz_batch_size;
+		snprintf(reason, sizeof(reason), "snapshot in progress");
+	}
+	else if (batchinfo->elapsedMs > target &&
+			 tuner->batchSize > dbz_autotune_min_batch_size)
+	{
+		newsize = Max(tuner->batchSize / 2, dbz_autotune_min_batch_size);
+		snprintf(reason, sizeof(reason), "apply time %.0f ms above target %.0f ms",
+				batchinfo->elapsedMs, target);
+	}
+	else if (batchinfo->batchSize >= tuner->batchSize &&
+			 tuner->batchSize < dbz_batch_size &&
+			 batchinfo->elapsedMs < target / 2)
+	{
+		if (lagms > target)
+		{
+			newsize = Min(tuner->batchSize * 2, dbz_batch_size);
+			snprintf(reason, sizeof(reason), "lag %lld ms with apply time %.0f ms",
+					(long long) lagms, batchinfo->elapsedMs);
+		}
+		else if (batchinfo->commitMs > batchinfo->elapsedMs / 2)
+		{
+			newsize = Min(tuner->batchSize * 2, dbz_batch_size);
+			snprintf(reason, sizeof(reason), "commit time %.0f ms of apply time %.0f ms",
+					batchinfo->commitMs, batchinfo->elapsedMs);
+		}
+	}
+
+	/* room for a few batches of the current size */
+	wantqueue = (int64) (4 * newsize * tuner->eventBytes);
+	wantqueue = Max(Min(wantqueue, maxqueue), minqueue);
+	newqueue = tuner->queueBytes;
+	if (wantqueue > tuner->queueBytes * 5 / 4 || wantqueue < tuner->queueBytes * 3 / 4)
+	{
+		newqueue = wantqueue;
+		if (reason[0] == '\0')
+			snprintf(reason, sizeof(reason), "average change event size %.0f bytes",
+					tuner->eventBytes);
+	}
+
+	if (newsize == tuner->batchSize && newqueue == tuner->queueBytes)
+		return;
+
+	now = GetCurrentTimestamp();
+	if (newsize >= tuner->batchSize &&
+		!TimestampDifferenceExceeds(tuner->lastChange, now, 1000))
+		return;
+
+	if (dbz_engine_set_batch_limits(newsize < dbz_batch_size ? newsize : 0,
+			newqueue != tuner->queueBytes ? newqueue : 0))
+		return;
+
+	elog(LOG, "connector %s: batch size %d -> %d, queue %lld kB -> %lld kB: %s",
+			get_shm_connector_name_by_id(connectorId),
+			tuner->batchSize, newsize,
+			(long long) (tuner->queueBytes / 1024), (long long) (newqueue / 1024),
+			reason);
+
+	tuner->batchSize = newsize;
+	tuner->queueBytes = newqueue;
+	tuner->lastChange = now;
+	dbz_autotune_publish(connectorId, tuner, reason);
+}
+
 static void
 remove_dbz_metadata_files(const char * name)
 {
@@ -2944,6 +3822,107 @@ remove_dbz_metadata_files(const char * name)
 	closedir(dir);
 }
 
+/*
+ * launch_connector - start a connector on behalf of the auto launcher
+ *
+ * A connector that fails to launch is reported and skipped so the remaining
+ * connectors still get started.
+ *
+ * @param entry: The connector to launch
+ *
+ * @return: true if the connector worker was started
+ */
+static bool
+launch_connector(LauncherEntry * entry)
+{
+	MemoryContext oldcontext = CurrentMemoryContext;
+	volatile bool launched = false;
+
+	elog(LOG, "launching %s...", entry->name);
+	StartTransactionCommand();
+	PushActiveSnapshot(GetTransactionSnapshot());
+	PG_TRY();
+	{
+		/* the worker handle must outlive the transaction */
+		MemoryContextSwitchTo(oldcontext);
+		entry->connectorId = start_connector_worker(entry->name, &entry->handle);
+		PopActiveSnapshot();
+		CommitTransactionCommand();
+		launched = true;
+	}
+	PG_CATCH();
+	{
+		MemoryContextSwitchTo(oldcontext);
+		EmitErrorReport();
+		FlushErrorState();
+		AbortCurrentTransaction();
+		elog(WARNING, "failed to launch connector %s", entry->name);
+	}
+	PG_END_TRY();
+	MemoryContextSwitchTo(oldcontext);
+
+	entry->launched = GetCurrentTimestamp();
+	entry->inflight = launched;
+	return launched;
+}
+
+/*
+ * check_launched_connector - check if a launched connector has become ready
+ *
+ * @param entry: The connector to check
+ *
+ * @return: true if the connector is no longer starting up, either because it
+ * is ready, it exited or it has been starting for too long
+ */
+static bool
+check_launched_connector(LauncherEntry * entry)
+{
+	uint32 startup_ms = 0, jvm_startup_ms = 0;
+	pid_t pid;
+
+	LWLockAcquire(&sdb_state->lock, LW_SHARED);
+	startup_ms = sdb_state->connectors[entry->connectorId].startup_ms;
+	jvm_startup_ms = sdb_state->connectors[entry->connectorId].jvm_startup_ms;
+	LWLockRelease(&sdb_state->lock);
+
+	if (startup_ms > 0)
+	{
+		long secs;
+		int usecs;
+
+		TimestampDifference(entry->launched, GetCurrentTimestamp(), &secs, &usecs);
+		entry->elapsed_ms = secs * 1000 + usecs / 1000;
+		elog(LOG, "connector %s is ready: %ld ms since launch, %u ms to initialize, "
+			 "%u ms to start its JVM", entry->name, entry->elapsed_ms, startup_ms,
+			 jvm_startup_ms);
+	}
+	else if (GetBackgroundWorkerPid(entry->handle, &pid) == BGWH_STOPPED)
+		elog(WARNING, "connector %s exited before it was ready", entry->name);
+	else if (TimestampDifferenceExceeds(entry->launched, GetCurrentTimestamp(),
+										SYNCHDB_LAUNCHER_READY_TIMEOUT_MS))
+		elog(WARNING, "connector %s is not ready after %d ms, launching the next one",
+			 entry->name, SYNCHDB_LAUNCHER_READY_TIMEOUT_MS);
+	else
+		return false;
+
+	entry->inflight = false;
+	return true;
+}
+
+/*
+ * launcher_entry_cmp - qsort comparator putting the slowest connectors first
+ */
+static int
+launcher_entry_cmp(const void * a, const void * b)
+{
+	const LauncherEntry * ea = (const LauncherEntry *) a;
+	const LauncherEntry * eb = (const LauncherEntry *) b;
+
+	if (ea->elapsed_ms == eb->elapsed_ms)
+		return 0;
+	return ea->elapsed_ms > eb->elapsed_ms ? -1 : 1;
+}
+
 /*
  * synchdb_auto_launcher_main - auto connector launcher main routine
  *
@@ -2954,8 +3933,9 @@ remove_dbz_metadata_files(const char * name)
 void
 synchdb_auto_launcher_main(Datum main_arg)
 {
-	int ret = -1, numout = 0, i = 0;
+	int ret = -1, numout = 0, i = 0, next = 0, inflight = 0;
 	char ** out;
+	LauncherEntry * entries = NULL;
 
 	/* Establish signal handlers; once that's done, unblock signals. */
 	pqsignal(SIGTERM, SignalHandlerForShutdownRequest);
@@ -2979,19 +3959,59 @@ synchdb_auto_launcher_main(Datum main_arg)
 	ret = ra_listConnInfoNames(out, &numout);
 	if (ret == 0)
 	{
-		for (i = 0; i < (numout > synchdb_max_connector_workers ?
-				synchdb_max_connector_workers : numout); i++)
+		numout = Min(numout, synchdb_max_connector_workers);
+		entries = palloc0(sizeof(LauncherEntry) * Max(numout, 1));
+
+		/*
+		 * start up to synchdb.launcher_max_concurrency connectors at a time
+		 * and launch the next one as soon as one of them is ready, which the
+		 * connector worker signals by recording its startup time
+		 */
+		while (!ShutdownRequestPending && (next < numout || inflight > 0))
 		{
-			elog(WARNING, "launching %s...", out[i]);
-			StartTransactionCommand();
-			PushActiveSnapshot(GetTransactionSnapshot());
+			while (next < numout && inflight < synchdb_launcher_max_concurrency)
+			{
+				LauncherEntry * entry = &entries[next];
+
+				entry->name = out[next++];
+				entry->elapsed_ms = -1;
+				if (launch_connector(entry))
+					inflight++;
+			}
 
-			DirectFunctionCall1(synchdb_start_engine_bgw, CStringGetTextDatum(out[i]));
+			for (i = 0; i < next; i++)
+			{
+				if (entries[i].inflight && check_launched_connector(&entries[i]))
+					inflight--;
+			}
+
+			if (inflight == 0)
+				continue;
+
+			(void) WaitLatch(MyLatch,
+							 WL_LATCH_SET | WL_TIMEOUT | WL_EXIT_ON_PM_DEATH,
+							 SYNCHDB_LAUNCHER_POLL_MS,
+							 PG_WAIT_EXTENSION);
+			ResetLatch(MyLatch);
+			CHECK_FOR_INTERRUPTS();
+
+			if (ConfigReloadPending)
+			{
+				ConfigReloadPending = false;
+				ProcessConfigFile(PGC_SIGHUP);
+			}
+		}
 
-			PopActiveSnapshot();
-			CommitTransactionCommand();
-			sleep(2);
+		/* report the slowest connectors */
+		qsort(entries, next, sizeof(LauncherEntry), launcher_entry_cmp);
+		for (i = 0; i < Min(next, SYNCHDB_LAUNCHER_REPORT_SLOWEST); i++)
+		{
+			if (entries[i].elapsed_ms < 0)
+				break;
+			elog(LOG, "connector %s was ready %ld ms after its launch",
+				 entries[i].name, entries[i].elapsed_ms);
 		}
+		pfree(entries);
 	}
 	pfree(out);
 	elog(DEBUG1, "stop synchdb_auto_launcher_main");
@@ -3021,790 +4041,1687 @@ synchdb_start_leader_worker(void)
 }
 
 /*
- * connectorTypeToString
+ * metrics_append_labels - append the labels identifying a connector
  *
- * This function converts connector type from enum to string
- *
- * @param type: Connector type in enum
+ * Label values are escaped as required by the OpenMetrics text format.
  *
- * @return connector type in string
+ * @param buf: The buffer to append to
+ * @param conn: The connector
  */
-const char *
-connectorTypeToString(ConnectorType type)
+static void
+metrics_append_labels(StringInfo buf, const ActiveConnectors * conn)
 {
-	switch (type)
+	const char * values[3] = {conn->conninfo.name, connectorTypeToString(conn->type),
+			conn->conninfo.dstdb};
+	const char * keys[3] = {"connector", "type", "dstdb"};
+	int i = 0;
+	const char * p;
+
+	for (i = 0; i < 3; i++)
 	{
-	case TYPE_UNDEF:
-		return "UNDEFINED";
-	case TYPE_MYSQL:
-		return "MYSQL";
-	case TYPE_ORACLE:
-		return "ORACLE";
-	case TYPE_SQLSERVER:
-		return "SQLSERVER";
-	case TYPE_OLR:
-		return "OLR";
-	default:
-		return "UNKNOWN";
+		appendStringInfo(buf, "%s%s=\"", i == 0 ? "" : ",", keys[i]);
+		for (p = values[i]; *p; p++)
+		{
+			if (*p == '\\' || *p == '"')
+				appendStringInfoChar(buf, '\\');
+			if (*p == '\n')
+				appendStringInfoString(buf, "\\n");
+			else
+				appendStringInfoChar(buf, *p);
+		}
+		appendStringInfoChar(buf, '"');
 	}
 }
 
 /*
- * stringToConnectorType
- *
- * This function converts string to connector type
- *
- * @param type: connector type in string
- *
- * @return connector type enum
+ * metrics_append_family - append one metric family with a sample per connector
+ *
+ * @param buf: The buffer to append to
+ * @param conns: Copy of the connector slots in use
+ * @param nconns: Number of connectors in conns
+ * @param name: Metric family name
+ * @param type: "counter" or "gauge"
+ * @param help: Help text of the family
+ * @param value: Callback returning the value of a connector, or a negative
+ * value if the connector has no sample
  */
-ConnectorType
-stringToConnectorType(const char * type)
+static void
+metrics_append_family(StringInfo buf, const ActiveConnectors * conns, int nconns,
+		const char * name, const char * type, const char * help,
+		double (*value) (const ActiveConnectors * conn, int idx))
 {
-	if (!strcasecmp(type, "mysql"))
-		return TYPE_MYSQL;
-	else if(!strcasecmp(type, "sqlserver"))
-		return TYPE_SQLSERVER;
-	else if(!strcasecmp(type, "oracle"))
-		return TYPE_ORACLE;
-	else if(!strcasecmp(type, "olr"))
-		return TYPE_OLR;
-	else
-		return TYPE_UNDEF;
+	int i = 0;
+	bool counter = !strcmp(type, "counter");
+
+	appendStringInfo(buf, "# TYPE %s %s\n# HELP %s %s\n", name, type, name, help);
+	for (i = 0; i < nconns; i++)
+	{
+		double v = value(&conns[i], i);
+
+		if (v < 0)
+			continue;
+
+		appendStringInfo(buf, "%s%s{", name, counter ? "_total" : "");
+		metrics_append_labels(buf, &conns[i]);
+		appendStringInfo(buf, "} %.17g\n", v);
+	}
+}
+
+/* per connector values of the plain metric families */
+static double metrics_up(const ActiveConnectors * c, int i) { return c->pid != InvalidPid ? 1 : 0; }
+static double metrics_events(const ActiveConnectors * c, int i) { return c->stats.genstats.stats_total_change_event; }
+static double metrics_bad_events(const ActiveConnectors * c, int i) { return c->stats.genstats.stats_bad_change_event; }
+static double metrics_batches(const ActiveConnectors * c, int i) { return c->stats.genstats.stats_batch_completion; }
+static double metrics_ddls(const ActiveConnectors * c, int i) { return c->stats.cdcstats.stats_ddl; }
+static double metrics_dmls(const ActiveConnectors * c, int i) { return c->stats.cdcstats.stats_dml; }
+static double metrics_txs(const ActiveConnectors * c, int i) { return c->stats.cdcstats.stats_tx; }
+static double metrics_snapshot_tables(const ActiveConnectors * c, int i) { return c->stats.snapstats.snapstats_tables; }
+static double metrics_snapshot_rows(const ActiveConnectors * c, int i) { return c->stats.snapstats.snapstats_rows; }
+static double metrics_spilled_batches(const ActiveConnectors * c, int i) { return c->stats.genstats.stats_spill_count; }
+static double metrics_spilled_bytes(const ActiveConnectors * c, int i) { return c->stats.genstats.stats_spill_bytes; }
+
+static double
+metrics_average_batch_size(const ActiveConnectors * c, int i)
+{
+	if (c->stats.genstats.stats_batch_completion == 0)
+		return 0;
+	return (double) c->stats.genstats.stats_total_change_event /
+			c->stats.genstats.stats_batch_completion;
+}
+
+static double
+metrics_lag(const ActiveConnectors * c, int i)
+{
+	if (c->stats.genstats.stats_last_src_ts == 0 || c->stats.genstats.stats_last_pg_ts == 0)
+		return -1;
+	return Max(0, ((double) c->stats.genstats.stats_last_pg_ts -
+			(double) c->stats.genstats.stats_last_src_ts) / 1000.0);
+}
+
+static double
+metrics_last_src_ts(const ActiveConnectors * c, int i)
+{
+	if (c->stats.genstats.stats_last_src_ts == 0)
+		return -1;
+	return c->stats.genstats.stats_last_src_ts / 1000.0;
+}
+
+static double
+metrics_last_pg_ts(const ActiveConnectors * c, int i)
+{
+	if (c->stats.genstats.stats_last_pg_ts == 0)
+		return -1;
+	return c->stats.genstats.stats_last_pg_ts / 1000.0;
 }
 
 /*
- * get_shm_connector_name
+ * metrics_find_rate - find the throughput sample of a connector
  *
- * This function converts connector type from enum to string in lowercase
- *
- * @param type: Connector type in enum
+ * @param c: The connector to look up by name and destination database
  *
- * @return connector type in string
- * todo: potential duplicate
+ * @return: the sample, or NULL if the connector has not been sampled yet
  */
-const char *
-get_shm_connector_name(ConnectorType type)
+static const MetricsRate *
+metrics_find_rate(const ActiveConnectors * c)
 {
-	switch (type)
+	int i = 0;
+
+	for (i = 0; i < synchdb_max_connector_workers; i++)
 	{
-	case TYPE_MYSQL:
-		return "mysql";
-	case TYPE_ORACLE:
-		return "oracle";
-	case TYPE_SQLSERVER:
-		return "sqlserver";
-	case TYPE_OLR:
-		return "olr";
-	/* todo: support more dbz connector types here */
-	default:
-		return "null";
+		if (strlen(metricsRates[i].name) > 0 &&
+			!strcmp(metricsRates[i].name, c->conninfo.name) &&
+			!strcmp(metricsRates[i].dstdb, c->conninfo.dstdb))
+			return &metricsRates[i];
 	}
+	return NULL;
 }
 
-/*
- * get_shm_connector_pid
- *
- * This function gets pid of the given connectorID
- *
- * @param connectorId: Connector ID of interest
- *
- * @return pid of the connector, -1 if connector is not running
- */
-pid_t
-get_shm_connector_pid(int connectorId)
+static double
+metrics_throughput(const ActiveConnectors * c, int i)
 {
-	if (!sdb_state)
-		return InvalidPid;
+	const MetricsRate * rate = metrics_find_rate(c);
 
-	return sdb_state->connectors[connectorId].pid;
+	return rate ? rate->events_per_sec : -1;
 }
 
-/*
- * set_shm_connector_pid
- *
- * This function sets pid of the given connectorID
- *
- * @param connectorId: Connector ID of interest
- * @param pid: New pid value
- */
-void
-set_shm_connector_pid(int connectorId, pid_t pid)
+static double
+metrics_dml_throughput(const ActiveConnectors * c, int i)
 {
-	if (!sdb_state)
-		return;
+	const MetricsRate * rate = metrics_find_rate(c);
 
-	LWLockAcquire(&sdb_state->lock, LW_EXCLUSIVE);
-	sdb_state->connectors[connectorId].pid = pid;
-	LWLockRelease(&sdb_state->lock);
+	return rate ? rate->dmls_per_sec : -1;
 }
 
 /*
- * get_shm_connector_errmsg
+ * metrics_snapshot_connectors - copy the connector slots in use from shared memory
  *
- * This function gets the last error message of the given connectorID
- *
- * @param connectorId: Connector ID of interest
+ * @param nconns: set to the number of connectors copied
+ * @param slots: if not NULL, set to the slot id of each connector copied
  *
- * @return the error message in string
+ * @return: palloc'd array of connectors
  */
-const char *
-get_shm_connector_errmsg(int connectorId)
+static ActiveConnectors *
+metrics_snapshot_connectors(int * nconns, int * slots)
 {
-	if (!sdb_state)
-		return "no error";
+	ActiveConnectors * conns = palloc0(sizeof(ActiveConnectors) * synchdb_max_connector_workers);
+	int i = 0;
 
-	return (sdb_state->connectors[connectorId].errmsg[0] != '\0') ?
-			sdb_state->connectors[connectorId].errmsg : "no error";
+	*nconns = 0;
+	LWLockAcquire(&sdb_state->lock, LW_SHARED);
+	for (i = 0; i < synchdb_max_connector_workers; i++)
+	{
+		if (strlen(sdb_state->connectors[i].conninfo.name) == 0)
+			continue;
+		memcpy(&conns[*nconns], &sdb_state->connectors[i], sizeof(ActiveConnectors));
+		if (slots)
+			slots[*nconns] = i;
+		(*nconns)++;
+	}
+	LWLockRelease(&sdb_state->lock);
+	return conns;
 }
 
 /*
- * set_shm_connector_errmsg - Set the error message for a specific connector in shared memory
- *
- * This function sets the error message for a given connector type in the shared
- * memory state. It ensures thread-safety by using a lock when accessing shared memory.
+ * metrics_sample_throughput - update the throughput gauges
  *
- * @param connectorId: Connector ID of interest
- * @param err: The error message to set. If NULL, an empty string will be set.
+ * Called periodically by the metrics worker. The rates are computed from the
+ * change of the event counters since the previous sample.
  */
-void
-set_shm_connector_errmsg(int connectorId, const char *err)
+static void
+metrics_sample_throughput(void)
 {
-	if (!sdb_state)
+	static TimestampTz lastsample = 0;
+	TimestampTz now = GetCurrentTimestamp();
+	ActiveConnectors * conns = NULL;
+	int * slots = NULL;
+	int nconns = 0, i = 0;
+	double secs = 0;
+	bool * sampled = NULL;
+
+	if (lastsample != 0 &&
+		!TimestampDifferenceExceeds(lastsample, now, SYNCHDB_METRICS_SAMPLE_MS))
 		return;
 
-	LWLockAcquire(&sdb_state->lock, LW_EXCLUSIVE);
-	strlcpy(sdb_state->connectors[connectorId].errmsg, err ? err : "", SYNCHDB_ERRMSG_SIZE);
-	LWLockRelease(&sdb_state->lock);
+	secs = lastsample == 0 ? 0 : (now - lastsample) / 1000000.0;
+	lastsample = now;
+
+	slots = palloc0(sizeof(int) * synchdb_max_connector_workers);
+	sampled = palloc0(sizeof(bool) * synchdb_max_connector_workers);
+	conns = metrics_snapshot_connectors(&nconns, slots);
+	for (i = 0; i < nconns; i++)
+	{
+		MetricsRate * rate = &metricsRates[slots[i]];
+		uint64 events = conns[i].stats.genstats.stats_total_change_event;
+		uint64 dmls = conns[i].stats.cdcstats.stats_dml;
+
+		/* a different connector took this slot, or its stats were reset */
+		if (strcmp(rate->name, conns[i].conninfo.name) != 0 ||
+			strcmp(rate->dstdb, conns[i].conninfo.dstdb) != 0 ||
+			events < rate->events || dmls < rate->dmls)
+		{
+			strlcpy(rate->name, conns[i].conninfo.name, SYNCHDB_CONNINFO_NAME_SIZE);
+			strlcpy(rate->dstdb, conns[i].conninfo.dstdb, SYNCHDB_CONNINFO_DB_NAME_SIZE);
+			rate->events_per_sec = 0;
+			rate->dmls_per_sec = 0;
+		}
+		else if (secs > 0)
+		{
+			rate->events_per_sec = (events - rate->events) / secs;
+			rate->dmls_per_sec = (dmls - rate->dmls) / secs;
+		}
+		rate->events = events;
+		rate->dmls = dmls;
+		sampled[slots[i]] = true;
+	}
+
+	/* forget the samples of slots that are no longer in use */
+	for (i = 0; i < synchdb_max_connector_workers; i++)
+	{
+		if (!sampled[i])
+			memset(&metricsRates[i], 0, sizeof(MetricsRate));
+	}
+	pfree(conns);
+	pfree(slots);
+	pfree(sampled);
 }
 
 /*
- * get_shm_connector_stage - Get the current connector stage
+ * metrics_append_latency - append the stage latency histograms
  *
- * This function gets current connector stage based on the change request received.
- *
- * @param connectorId: Connector ID of interest
- *
- * @return connector stage in string
+ * @param buf: The buffer to append to
+ * @param conns: Copy of the connector slots in use
+ * @param nconns: Number of connectors in conns
  */
-static const char *
-get_shm_connector_stage(int connectorId)
+static void
+metrics_append_latency(StringInfo buf, const ActiveConnectors * conns, int nconns)
 {
-	ConnectorStage stage;
-
-	if (!sdb_state)
-		return "unknown";
-
-	/*
-	 * We're only reading, so shared lock is sufficient.
-	 * This ensures thread-safety without blocking other readers.
-	 */
-	LWLockAcquire(&sdb_state->lock, LW_SHARED);
-	stage = sdb_state->connectors[connectorId].stage;
-	LWLockRelease(&sdb_state->lock);
+	static const char * opnames[LATENCY_OP_NUM] =
+		{"insert", "update", "delete", "truncate", "snapshot", "ddl"};
+	static const char * stagenames[LATENCY_EVENT_STAGE_NUM] =
+		{"parse", "convert", "execute"};
+	int i = 0, op = 0, stage = 0, j = 0;
 
-	switch(stage)
+	appendStringInfoString(buf, "# TYPE synchdb_stage_latency_seconds histogram\n"
+			"# HELP synchdb_stage_latency_seconds Latency of the change event pipeline stages\n");
+	for (i = 0; i < nconns; i++)
 	{
-		case STAGE_INITIAL_SNAPSHOT:
-		{
-			return "initial snapshot";
-			break;
-		}
-		case STAGE_CHANGE_DATA_CAPTURE:
-		{
-			return "change data capture";
-			break;
-		}
-		case STAGE_SCHEMA_SYNC:
+		for (op = 0; op <= LATENCY_OP_NUM; op++)
 		{
-			return "schema sync";
-			break;
+			for (stage = 0; stage < LATENCY_EVENT_STAGE_NUM; stage++)
+			{
+				const LatencyHistogram * hist = NULL;
+				const char * opname = "batch";
+				const char * stagename = NULL;
+				uint64 cumulative = 0;
+				StringInfoData labels;
+
+				if (op < LATENCY_OP_NUM)
+				{
+					hist = &conns[i].latency.events[op][stage];
+					opname = opnames[op];
+					stagename = stagenames[stage];
+				}
+				else if (stage == 0)
+				{
+					hist = &conns[i].latency.fetch;
+					stagename = "fetch";
+				}
+				else if (stage == 1)
+				{
+					hist = &conns[i].latency.commit;
+					stagename = "commit";
+				}
+				else
+					break;
+
+				if (hist->count == 0)
+					continue;
+
+				initStringInfo(&labels);
+				metrics_append_labels(&labels, &conns[i]);
+				appendStringInfo(&labels, ",op=\"%s\",stage=\"%s\"", opname, stagename);
+
+				/* the last bucket has no upper bound and is only counted in +Inf */
+				for (j = 0; j < SYNCHDB_LATENCY_BUCKETS - 1; j++)
+				{
+					cumulative += hist->buckets[j];
+					appendStringInfo(buf, "synchdb_stage_latency_seconds_bucket{%s,le=\"%g\"} "
+							UINT64_FORMAT "\n", labels.data, (double) (UINT64CONST(1) << j) / 1000000.0,
+							cumulative);
+				}
+				appendStringInfo(buf, "synchdb_stage_latency_seconds_bucket{%s,le=\"+Inf\"} "
+						UINT64_FORMAT "\n", labels.data, hist->count);
+				appendStringInfo(buf, "synchdb_stage_latency_seconds_count{%s} " UINT64_FORMAT "\n",
+						labels.data, hist->count);
+				appendStringInfo(buf, "synchdb_stage_latency_seconds_sum{%s} %.6f\n",
+						labels.data, hist->total_us / 1000000.0);
+				pfree(labels.data);
+			}
 		}
-		case STAGE_UNDEF:
-		default:
+	}
+}
+
+/*
+ * metrics_build - build the OpenMetrics exposition of all connectors
+ *
+ * @param buf: The buffer to build the exposition in
+ */
+static void
+metrics_build(StringInfo buf)
+{
+	ActiveConnectors * conns = NULL;
+	int nconns = 0, i = 0;
+
+	conns = metrics_snapshot_connectors(&nconns, NULL);
+
+	appendStringInfoString(buf, "# TYPE synchdb_connector_info gauge\n"
+			"# HELP synchdb_connector_info Connector state and stage\n");
+	for (i = 0; i < nconns; i++)
+	{
+		appendStringInfoString(buf, "synchdb_connector_info{");
+		metrics_append_labels(buf, &conns[i]);
+		appendStringInfo(buf, ",state=\"%s\",stage=\"%s\"} 1\n",
+				connectorStateAsString(conns[i].state),
+				connectorStageAsString(conns[i].stage));
+	}
+
+	metrics_append_family(buf, conns, nconns, "synchdb_connector_up", "gauge",
+			"Whether the connector worker is running", metrics_up);
+	metrics_append_family(buf, conns, nconns, "synchdb_change_events", "counter",
+			"Change events received", metrics_events);
+	metrics_append_family(buf, conns, nconns, "synchdb_bad_change_events", "counter",
+			"Change events that failed to be applied", metrics_bad_events);
+	metrics_append_family(buf, conns, nconns, "synchdb_batches", "counter",
+			"Batches completed", metrics_batches);
+	metrics_append_family(buf, conns, nconns, "synchdb_ddl_events", "counter",
+			"DDL events applied during change data capture", metrics_ddls);
+	metrics_append_family(buf, conns, nconns, "synchdb_dml_events", "counter",
+			"DML events applied during change data capture", metrics_dmls);
+	metrics_append_family(buf, conns, nconns, "synchdb_transactions", "counter",
+			"Transaction boundary events received", metrics_txs);
+	metrics_append_family(buf, conns, nconns, "synchdb_snapshot_tables", "counter",
+			"Tables created by the initial snapshot", metrics_snapshot_tables);
+	metrics_append_family(buf, conns, nconns, "synchdb_snapshot_rows", "counter",
+			"Rows loaded by the initial snapshot", metrics_snapshot_rows);
+	metrics_append_family(buf, conns, nconns, "synchdb_spilled_batches", "counter",
+			"Batches spilled to a temporary file before being applied", metrics_spilled_batches);
+	metrics_append_family(buf, conns, nconns, "synchdb_spilled_bytes", "counter",
+			"Change event bytes spilled to a temporary file", metrics_spilled_bytes);
+
+	appendStringInfoString(buf, "# TYPE synchdb_dml_operations counter\n"
+			"# HELP synchdb_dml_operations DML events applied by operation\n");
+	for (i = 0; i < nconns; i++)
+	{
+		const char * ops[4] = {"insert", "update", "delete", "truncate"};
+		uint64 counts[4] = {conns[i].stats.cdcstats.stats_create,
+				conns[i].stats.cdcstats.stats_update,
+				conns[i].stats.cdcstats.stats_delete,
+				conns[i].stats.cdcstats.stats_truncate};
+		int j = 0;
+
+		for (j = 0; j < 4; j++)
 		{
-			break;
+			appendStringInfoString(buf, "synchdb_dml_operations_total{");
+			metrics_append_labels(buf, &conns[i]);
+			appendStringInfo(buf, ",op=\"%s\"} " UINT64_FORMAT "\n", ops[j], counts[j]);
 		}
 	}
-	return "unknown";
+
+	metrics_append_family(buf, conns, nconns, "synchdb_average_batch_size", "gauge",
+			"Average number of change events per batch", metrics_average_batch_size);
+	metrics_append_family(buf, conns, nconns, "synchdb_replication_lag_seconds", "gauge",
+			"Delay between the last change event in the source and its application",
+			metrics_lag);
+	metrics_append_family(buf, conns, nconns, "synchdb_last_source_timestamp_seconds", "gauge",
+			"Source timestamp of the last applied change event", metrics_last_src_ts);
+	metrics_append_family(buf, conns, nconns, "synchdb_last_apply_timestamp_seconds", "gauge",
+			"Time the last change event was applied", metrics_last_pg_ts);
+	metrics_append_family(buf, conns, nconns, "synchdb_throughput_events_per_second", "gauge",
+			"Change events received per second over the last sampling interval",
+			metrics_throughput);
+	metrics_append_family(buf, conns, nconns, "synchdb_throughput_dml_per_second", "gauge",
+			"DML events applied per second over the last sampling interval",
+			metrics_dml_throughput);
+
+	metrics_append_latency(buf, conns, nconns);
+
+	appendStringInfoString(buf, "# EOF\n");
+	pfree(conns);
 }
 
 /*
- * set_shm_connector_statistics - adds the give stats
+ * metrics_listen - open the listening socket of the metrics endpoint
  *
- * This function adds the given stats info to the one in shared memory so user
- * can see updated stats
+ * @param address: Host name or address to listen on, "*" for all
+ * @param port: TCP port to listen on
  *
- * @param connectorId: Connector ID of interest
- * @param stats: connector statistics struct
+ * @return: the listening socket
  */
-static void
-set_shm_connector_statistics(int connectorId, SynchdbStatistics * stats)
+static pgsocket
+metrics_listen(const char * address, int port)
 {
-	LWLockAcquire(&sdb_state->lock, LW_EXCLUSIVE);
-	/* CDC stats */
-	sdb_state->connectors[connectorId].stats.cdcstats.stats_ddl +=
-			stats->cdcstats.stats_ddl;
-	sdb_state->connectors[connectorId].stats.cdcstats.stats_dml +=
-			stats->cdcstats.stats_dml;
-	sdb_state->connectors[connectorId].stats.cdcstats.stats_create +=
-			stats->cdcstats.stats_create;
-	sdb_state->connectors[connectorId].stats.cdcstats.stats_update +=
-			stats->cdcstats.stats_update;
-	sdb_state->connectors[connectorId].stats.cdcstats.stats_delete +=
-			stats->cdcstats.stats_delete;
-	sdb_state->connectors[connectorId].stats.cdcstats.stats_tx +=
-			stats->cdcstats.stats_tx;
-	sdb_state->connectors[connectorId].stats.cdcstats.stats_truncate +=
-			stats->cdcstats.stats_truncate;
+	struct addrinfo hints = {0};
+	struct addrinfo * addrs = NULL;
+	char portstr[16] = {0};
+	pgsocket fd = PGINVALID_SOCKET;
+	int one = 1;
+	int ret = -1;
 
-	/* General stats */
-	sdb_state->connectors[connectorId].stats.genstats.stats_bad_change_event +=
-			stats->genstats.stats_bad_change_event;
-	sdb_state->connectors[connectorId].stats.genstats.stats_total_change_event +=
-			stats->genstats.stats_total_change_event;
-	sdb_state->connectors[connectorId].stats.genstats.stats_batch_completion +=
-			stats->genstats.stats_batch_completion;
-	/* the following should be overwritten \n */
-	sdb_state->connectors[connectorId].stats.genstats.stats_first_src_ts =
-			stats->genstats.stats_first_src_ts;
-	sdb_state->connectors[connectorId].stats.genstats.stats_first_pg_ts =
-			stats->genstats.stats_first_pg_ts;
-	sdb_state->connectors[connectorId].stats.genstats.stats_last_src_ts =
-			stats->genstats.stats_last_src_ts;
-	sdb_state->connectors[connectorId].stats.genstats.stats_last_pg_ts =
-			stats->genstats.stats_last_pg_ts;
+	hints.ai_family = AF_UNSPEC;
+	hints.ai_socktype = SOCK_STREAM;
+	hints.ai_flags = AI_PASSIVE;
+	snprintf(portstr, sizeof(portstr), "%d", port);
 
-	/* Snapshot stats */
-	sdb_state->connectors[connectorId].stats.snapstats.snapstats_tables +=
-			stats->snapstats.snapstats_tables;
-	sdb_state->connectors[connectorId].stats.snapstats.snapstats_rows +=
-			stats->snapstats.snapstats_rows;
+	ret = getaddrinfo(strcmp(address, "*") == 0 ? NULL : address, portstr, &hints, &addrs);
+	if (ret != 0 || addrs == NULL)
+		ereport(ERROR,
+				(errmsg("could not resolve metrics listen address \"%s\": %s",
+						address, gai_strerror(ret))));
 
-	/* the following should be overwritten \n */
-	if (stats->snapstats.snapstats_begintime_ts > 0)
+	fd = socket(addrs->ai_family, SOCK_STREAM, 0);
+	if (fd == PGINVALID_SOCKET)
 	{
-		sdb_state->connectors[connectorId].stats.snapstats.snapstats_begintime_ts =
-				stats->snapstats.snapstats_begintime_ts;
-		/*
-		 * when begintime_ts is set, we assume it is the beginning of a snapshot, so
-		 * we set endtime_ts to 0 to indicate a fresh start.
-		 */
-		sdb_state->connectors[connectorId].stats.snapstats.snapstats_endtime_ts = 0;
+		freeaddrinfo(addrs);
+		ereport(ERROR,
+				(errcode_for_socket_access(),
+				 errmsg("could not create metrics socket: %m")));
 	}
-	if (stats->snapstats.snapstats_endtime_ts > 0)
-		sdb_state->connectors[connectorId].stats.snapstats.snapstats_endtime_ts =
-				stats->snapstats.snapstats_endtime_ts;
-	LWLockRelease(&sdb_state->lock);
+
+	setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, (char *) &one, sizeof(one));
+	if (bind(fd, addrs->ai_addr, addrs->ai_addrlen) < 0 || listen(fd, 16) < 0)
+	{
+		closesocket(fd);
+		freeaddrinfo(addrs);
+		ereport(ERROR,
+				(errcode_for_socket_access(),
+				 errmsg("could not listen on %s:%d for metrics: %m", address, port)));
+	}
+	freeaddrinfo(addrs);
+
+	if (!pg_set_noblock(fd))
+	{
+		closesocket(fd);
+		ereport(ERROR,
+				(errcode_for_socket_access(),
+				 errmsg("could not set metrics socket to nonblocking mode: %m")));
+	}
+	return fd;
 }
 
-static void
-set_shm_connector_snapshot_statistics(int connectorId, SnapshotStatistics * snapstats)
+/*
+ * metrics_send_all - write a buffer fully to a client
+ *
+ * @return: true on success, false if the client went away
+ */
+static bool
+metrics_send_all(pgsocket fd, const char * data, int len)
 {
-	LWLockAcquire(&sdb_state->lock, LW_EXCLUSIVE);
-	sdb_state->connectors[connectorId].stats.snapstats.snapstats_tables +=
-				snapstats->snapstats_tables;
-	sdb_state->connectors[connectorId].stats.snapstats.snapstats_rows +=
-				snapstats->snapstats_rows;
-	if (snapstats->snapstats_begintime_ts > 0)
+	while (len > 0)
 	{
-		sdb_state->connectors[connectorId].stats.snapstats.snapstats_begintime_ts =
-				snapstats->snapstats_begintime_ts;
-		/*
-		 * when begintime_ts is set, we assume it is the beginning of a snapshot, so
-		 * we set endtime_ts to 0 to indicate a fresh start.
-		 */
-		sdb_state->connectors[connectorId].stats.snapstats.snapstats_endtime_ts = 0;
+		ssize_t n = send(fd, data, len, 0);
+
+		if (n < 0 && errno == EINTR)
+			continue;
+		if (n <= 0)
+			return false;
+		data += n;
+		len -= n;
 	}
-	if (snapstats->snapstats_endtime_ts > 0)
-		sdb_state->connectors[connectorId].stats.snapstats.snapstats_endtime_ts =
-				snapstats->snapstats_endtime_ts;
-	LWLockRelease(&sdb_state->lock);
+	return true;
 }
 
+/*
+ * metrics_serve_client - accept and answer one scrape request
+ *
+ * Only "GET /metrics" is served. Clients get a short timeout so a stalled
+ * scraper cannot hold up the worker.
+ *
+ * @param listenfd: The listening socket
+ */
 static void
-is_snapshot_cdc_needed(const char* snapshotMode, bool isSnapshotDone, bool * snapshot, bool * cdc)
+metrics_serve_client(pgsocket listenfd)
 {
-	if (!strcasecmp(snapshotMode, "initial"))
+	pgsocket fd;
+	char req[SYNCHDB_METRICS_REQUEST_SIZE] = {0};
+	int len = 0;
+	struct timeval tv = {2, 0};
+	StringInfoData body;
+	StringInfoData resp;
+
+	fd = accept(listenfd, NULL, NULL);
+	if (fd == PGINVALID_SOCKET)
+		return;
+
+	setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, (char *) &tv, sizeof(tv));
+	setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, (char *) &tv, sizeof(tv));
+
+	/* read the request line and headers, the body of a GET is ignored */
+	while (len < sizeof(req) - 1 && strstr(req, "\r\n\r\n") == NULL)
 	{
-		*snapshot = isSnapshotDone ? false : true;
-		*cdc = true;
+		ssize_t n = recv(fd, req + len, sizeof(req) - 1 - len, 0);
+
+		if (n < 0 && errno == EINTR)
+			continue;
+		if (n <= 0)
+			break;
+		len += n;
 	}
-	else if (!strcasecmp(snapshotMode, "initial_only"))
+
+	initStringInfo(&body);
+	initStringInfo(&resp);
+	if (strncmp(req, "GET /metrics", 12) == 0 &&
+		(req[12] == ' ' || req[12] == '?'))
 	{
-		*snapshot = isSnapshotDone ? false : true;
-		*cdc = false;
+		metrics_build(&body);
+		appendStringInfo(&resp, "HTTP/1.1 200 OK\r\n"
+				"Content-Type: application/openmetrics-text; version=1.0.0; charset=utf-8\r\n"
+				"Content-Length: %d\r\nConnection: close\r\n\r\n", body.len);
 	}
-	else if (!strcasecmp(snapshotMode, "no_data"))
+	else
 	{
-		*snapshot = isSnapshotDone ? false : true;
-		*cdc = true;
-	}
-	else if (!strcasecmp(snapshotMode, "always"))
-	{
-		*snapshot = true;
-		*cdc = true;
-	}
-	else if (!strcasecmp(snapshotMode, "never"))
-	{
-		*snapshot = false;
-		*cdc = true;
-	}
-	else
-	{
-		elog(WARNING, "snapshot mode %s not handled for OLR connector. Default to initial",
-				snapshotMode);
-		*snapshot = isSnapshotDone ? false : true;
-		*cdc = true;
+		appendStringInfoString(&body, "not found\n");
+		appendStringInfo(&resp, "HTTP/1.1 404 Not Found\r\n"
+				"Content-Type: text/plain\r\n"
+				"Content-Length: %d\r\nConnection: close\r\n\r\n", body.len);
 	}
+
+	if (metrics_send_all(fd, resp.data, resp.len))
+		metrics_send_all(fd, body.data, body.len);
+
+	closesocket(fd);
+	pfree(body.data);
+	pfree(resp.data);
 }
-#ifdef WITH_OLR
-static void
-try_reconnect_olr(ConnectionInfo * connInfo)
+
+/*
+ * synchdb_metrics_main - metrics exporter main routine
+ *
+ * Serves the statistics of all connectors in OpenMetrics format on
+ * synchdb.metrics_port. It only reads synchdb shared memory and does not
+ * connect to any database.
+ *
+ * @param main_arg: not used
+ */
+void
+synchdb_metrics_main(Datum main_arg)
 {
-	int ret = -1;
+	pgsocket listenfd;
+	MemoryContext scrapeContext;
 
-	if (olr_client_get_connect_status())
-	{
-		elog(WARNING, "already connected.");
-		return;
-	}
+	pqsignal(SIGTERM, SignalHandlerForShutdownRequest);
+	pqsignal(SIGHUP, SignalHandlerForConfigReload);
+	BackgroundWorkerUnblockSignals();
 
-	elog(WARNING, "reconnecting...");
-	if (olr_client_init(connInfo->olr.olr_host, connInfo->olr.olr_port))
-		elog(DEBUG1, "failed to reconnect");
-	else
+	synchdb_init_shmem();
+	metricsRates = palloc0(sizeof(MetricsRate) * synchdb_max_connector_workers);
+	scrapeContext = AllocSetContextCreate(TopMemoryContext,
+										  "SYNCHDB_METRICS",
+										  ALLOCSET_DEFAULT_SIZES);
+
+	listenfd = metrics_listen(synchdb_metrics_listen_address, synchdb_metrics_port);
+	elog(LOG, "synchdb metrics exporter listening on %s:%d",
+			synchdb_metrics_listen_address, synchdb_metrics_port);
+
+	while (!ShutdownRequestPending)
 	{
-		elog(WARNING, "reconnected, request replication...");
+		int rc;
+		MemoryContext oldContext;
 
-		/* connInfo.srcdb is used as data source for OLR */
-		ret = olr_client_start_or_cont_replication(connInfo->olr.olr_source, true);
-		if (ret == -1)
-		{
-			set_shm_connector_errmsg(myConnectorId, "failed to start replication with olr server");
-			elog(ERROR, "failed to start replication with olr server");
-		}
+		rc = WaitLatchOrSocket(MyLatch,
+							   WL_LATCH_SET | WL_SOCKET_READABLE | WL_TIMEOUT | WL_EXIT_ON_PM_DEATH,
+							   listenfd,
+							   SYNCHDB_METRICS_SAMPLE_MS,
+							   PG_WAIT_EXTENSION);
 
-		if (ret == RES_ALREADY_STARTED || ret == RES_STARTING)
+		if (rc & WL_LATCH_SET)
 		{
-			elog(WARNING, "replication already started or starting - sending continue");
-			ret = olr_client_start_or_cont_replication(connInfo->olr.olr_source, false);
-			if (ret == -1)
-			{
-				set_shm_connector_errmsg(myConnectorId, "failed to start replication with olr server");
-				elog(ERROR, "failed to start replication with olr server");
-			}
+			ResetLatch(MyLatch);
+			CHECK_FOR_INTERRUPTS();
 		}
-		if (ret == RES_REPLICATE)
-			elog(WARNING, "replication requested...");
-		else
+
+		if (ConfigReloadPending)
 		{
-			set_shm_connector_errmsg(myConnectorId, "openlog replicator is not ready to replicate after reconnection");
-			elog(ERROR, "openlog replicator is not ready to replicate, response code = %d", ret);
+			ConfigReloadPending = false;
+			ProcessConfigFile(PGC_SIGHUP);
 		}
-	}
-}
-
-static int
-olr_set_offset_from_raw(char * offsetdata)
-{
-	orascn scn = 0, c_scn = 0, c_idx = 0;
-	const char *scn_pos = strstr(offsetdata, "\"scn\":");
-	const char *c_scn_pos = strstr(offsetdata, "\"c_scn\":");
-	const char *c_idx_pos = strstr(offsetdata, "\"c_idx\":");
 
-	if (scn_pos)
-	{
-		sscanf(scn_pos, "\"scn\":%llu", &scn);
-	}
-	else
-	{
-		elog(WARNING, "bad offset string: scn missing...");
-		return -1;
-	}
-	if (c_scn_pos)
-	{
-		sscanf(c_scn_pos, "\"c_scn\":%llu", &c_scn);
-	}
-	else
-	{
-		elog(WARNING, "bad offset string: c_scn missing...");
-		return -1;
-	}
-	if (c_idx_pos)
-	{
-		sscanf(c_scn_pos, "\"c_idx\":%llu", &c_idx);
-	}
-	else
-	{
-		elog(WARNING, "bad offset string: c_idx missing...");
-		return -1;
+		oldContext = MemoryContextSwitchTo(scrapeContext);
+		metrics_sample_throughput();
+		if (rc & WL_SOCKET_READABLE)
+			metrics_serve_client(listenfd);
+		MemoryContextSwitchTo(oldContext);
+		MemoryContextReset(scrapeContext);
 	}
-	elog(WARNING, "new offset: scn:%llu c_scn:%llu c_idx:%llu",
-			scn, c_scn, c_idx);
-	olr_client_set_scns(scn, c_scn, c_idx);
-	return 0;
-}
-#endif
 
+	closesocket(listenfd);
+}
 
 /*
- * increment_connector_statistics - increment statistics
- *
- * This function increments statistic counter for specified type
+ * synchdb_start_metrics_worker
  *
- * @param which: type of statistic to increment
+ * Helper function to start the metrics exporter background worker
  */
-void
-increment_connector_statistics(SynchdbStatistics * myStats, ConnectorStatistics which, int incby)
+static void
+synchdb_start_metrics_worker(void)
 {
-	if (!myStats)
-		return;
-
-	switch(which)
-	{
-		/* CDC stats */
-		case STATS_DDL:
-			myStats->cdcstats.stats_ddl += incby;
-			break;
-		case STATS_DML:
-			myStats->cdcstats.stats_dml += incby;
-			break;
-		case STATS_CREATE:
-			myStats->cdcstats.stats_create += incby;
-			break;
-		case STATS_UPDATE:
-			myStats->cdcstats.stats_update += incby;
-			break;
-		case STATS_DELETE:
-			myStats->cdcstats.stats_delete += incby;
-			break;
-		case STATS_TRUNCATE:
-			myStats->cdcstats.stats_truncate += incby;
-			break;
-		case STATS_TX:
-			myStats->cdcstats.stats_tx += incby;
-			break;
+	BackgroundWorker worker;
 
-		/* snapshot stats */
-		case STATS_TABLES:
-			myStats->snapstats.snapstats_tables += incby;
-			break;
-		case STATS_ROWS:
-			myStats->snapstats.snapstats_rows += incby;
-			break;
+	MemSet(&worker, 0, sizeof(BackgroundWorker));
+	worker.bgw_flags = BGWORKER_SHMEM_ACCESS;
+	worker.bgw_start_time = BgWorkerStart_ConsistentState;
+	worker.bgw_restart_time = 10;
+	strcpy(worker.bgw_library_name, "synchdb");
+	strcpy(worker.bgw_function_name, "synchdb_metrics_main");
+	strcpy(worker.bgw_name, "synchdb metrics exporter");
+	strcpy(worker.bgw_type, "synchdb metrics exporter");
 
-		/* general stats */
-		case STATS_BAD_CHANGE_EVENT:
-			myStats->genstats.stats_bad_change_event += incby;
-			break;
-		case STATS_TOTAL_CHANGE_EVENT:
-			myStats->genstats.stats_total_change_event += incby;
-			break;
-		case STATS_BATCH_COMPLETION:
-			myStats->genstats.stats_batch_completion += incby;
-			break;
-		default:
-			break;
-	}
+	RegisterBackgroundWorker(&worker);
 }
 
-/*
- * get_shm_connector_type - Get the connector type in enum
- *
- * This function gets specified connector type.
- *
- * @param connectorId: Connector ID of interest
- *
- * @return ConnectorType enum
- */
-ConnectorType
-get_shm_connector_type_enum(int connectorId)
+/* arguments passed to a FDW snapshot worker through bgw_extra */
+typedef struct FdwSnapshotWorkerArgs
 {
-	ConnectorType type;
-
-	if (!sdb_state)
-		return TYPE_UNDEF;
+	Oid			dboid;
+	bool		isOraCompat;
+	char		name[NAMEDATALEN];
+} FdwSnapshotWorkerArgs;
 
-	/*
-	 * We're only reading, so shared lock is sufficient.
-	 * This ensures thread-safety without blocking other readers.
-	 */
-	LWLockAcquire(&sdb_state->lock, LW_SHARED);
-	type = sdb_state->connectors[connectorId].type;
-	LWLockRelease(&sdb_state->lock);
+StaticAssertDecl(sizeof(FdwSnapshotWorkerArgs) <= BGW_EXTRALEN,
+				 "FdwSnapshotWorkerArgs does not fit in bgw_extra");
 
-	return type;
-}
+/* handles of the FDW snapshot workers launched by this connector, if any */
+static BackgroundWorkerHandle **fdwSnapshotHandles = NULL;
+static int fdwSnapshotNumHandles = 0;
 
 /*
- * get_shm_connector_stage_enum - Get the current connector stage in enum
- *
- * This function gets current connector stage based on the change request received.
+ * synchdb_fdw_snapshot_worker_main
  *
- * @param connectorId: Connector ID of interest
+ * Main entry point of a FDW snapshot worker. It connects to the database of
+ * the connector that launched it and loads queued tables one by one until
+ * none is left.
  *
- * @return connector stage in enum
+ * @param main_arg: connector ID of the launching connector
  */
-ConnectorStage
-get_shm_connector_stage_enum(int connectorId)
+void
+synchdb_fdw_snapshot_worker_main(Datum main_arg)
 {
-	ConnectorStage stage;
+	FdwSnapshotWorkerArgs args;
 
-	if (!sdb_state)
-		return STAGE_UNDEF;
+	memcpy(&args, MyBgworkerEntry->bgw_extra, sizeof(FdwSnapshotWorkerArgs));
 
-	/*
-	 * We're only reading, so shared lock is sufficient.
-	 * This ensures thread-safety without blocking other readers.
-	 */
-	LWLockAcquire(&sdb_state->lock, LW_SHARED);
-	stage = sdb_state->connectors[connectorId].stage;
-	LWLockRelease(&sdb_state->lock);
+	/* errors are reported against the launching connector */
+	myConnectorId = DatumGetUInt32(main_arg);
 
-	return stage;
+	/* a table load may run for a long time, let SIGTERM cancel it like other backends */
+	pqsignal(SIGTERM, die);
+	pqsignal(SIGHUP, SignalHandlerForConfigReload);
+	pqsignal(SIGUSR1, procsignal_sigusr1_handler);
+	BackgroundWorkerUnblockSignals();
+
+	BackgroundWorkerInitializeConnectionByOid(args.dboid, InvalidOid, 0);
+
+	/* same as the launching connector, fdw snapshot scripts need pg mode */
+	if (args.isOraCompat)
+		SetConfigOption("ivorysql.compatible_mode", "pg", PGC_USERSET, PGC_S_OVERRIDE);
+
+	elog(LOG, "synchdb fdw snapshot worker started for connector %s", args.name);
+	ra_fdwSnapshotWorkerLoop(args.name);
+	elog(LOG, "synchdb fdw snapshot worker stopped for connector %s", args.name);
 }
 
 /*
- * set_shm_connector_stage - Set the current connector stage in enum
+ * synchdb_terminate_fdw_snapshot_workers
  *
- * This function sets current connector stage
- *
- * @param connectorId: Connector ID of interest
- * @param stage: new connector stage
+ * This function asks every FDW snapshot worker launched by this connector to
+ * terminate. It is also registered as a before_shmem_exit callback so that
+ * the workers do not outlive a connector that is stopped or exits on error.
  */
-void
-set_shm_connector_stage(int connectorId, ConnectorStage stage)
+static void
+synchdb_terminate_fdw_snapshot_workers(int code, Datum arg)
 {
-	if (!sdb_state)
-		return;
+	int i = 0;
 
-	LWLockAcquire(&sdb_state->lock, LW_EXCLUSIVE);
-	sdb_state->connectors[connectorId].stage = stage;
-	LWLockRelease(&sdb_state->lock);
+	for (i = 0; i < fdwSnapshotNumHandles; i++)
+		TerminateBackgroundWorker(fdwSnapshotHandles[i]);
 }
 
 /*
- * get_shm_connector_state - Get the current state of a specific connector from shared memory
+ * synchdb_run_fdw_snapshot_workers
  *
- * This function retrieves the current state of a given connector type from the shared
- * memory state. It returns the state as a string representation.
+ * This function launches up to nworkers FDW snapshot workers for the given
+ * connector and waits for all of them to exit. If no worker can be launched,
+ * the queued tables are loaded by the calling process instead. If the
+ * connector is requested to shut down while waiting, the workers are
+ * terminated and an error is raised so the snapshot is not finished.
  *
- * @param connectorId: Connector ID of interest
+ * @param connInfo: connection info of the calling connector
+ * @param nworkers: number of workers to launch
  *
- * @return: A string representation of the connector's state. If the shared memory
- *          is not initialized or the connector type is unknown, it returns "stopped"
- *          or "undefined" respectively.
+ * @return number of workers launched
  */
-const char *
-get_shm_connector_state(int connectorId)
+int
+synchdb_run_fdw_snapshot_workers(const ConnectionInfo * connInfo, int nworkers)
 {
-	ConnectorState state;
+	static bool exit_cb_registered = false;
+	BackgroundWorker worker;
+	BackgroundWorkerHandle **handles;
+	FdwSnapshotWorkerArgs args = {0};
+	int nlaunched = 0, nalive = 0, i = 0;
+	bool terminating = false;
+	pid_t pid;
 
-	if (!sdb_state)
-		return "stopped";
+	args.dboid = MyDatabaseId;
+	args.isOraCompat = connInfo->isOraCompat;
+	strlcpy(args.name, connInfo->name, NAMEDATALEN);
 
-	/*
-	 * We're only reading, so shared lock is sufficient.
-	 * This ensures thread-safety without blocking other readers.
-	 */
-	LWLockAcquire(&sdb_state->lock, LW_SHARED);
-	state = sdb_state->connectors[connectorId].state;
-	LWLockRelease(&sdb_state->lock);
+	if (!exit_cb_registered)
+	{
+		before_shmem_exit(synchdb_terminate_fdw_snapshot_workers, (Datum) 0);
+		exit_cb_registered = true;
+	}
 
-	return connectorStateAsString(state);
+	/* kept in TopMemoryContext so the exit callback can still reach them */
+	handles = MemoryContextAllocZero(TopMemoryContext,
+			sizeof(BackgroundWorkerHandle *) * nworkers);
+	fdwSnapshotHandles = handles;
+	fdwSnapshotNumHandles = 0;
+	for (i = 0; i < nworkers; i++)
+	{
+		MemSet(&worker, 0, sizeof(BackgroundWorker));
+		worker.bgw_flags = BGWORKER_SHMEM_ACCESS |
+				BGWORKER_BACKEND_DATABASE_CONNECTION;
+		worker.bgw_start_time = BgWorkerStart_ConsistentState;
+		worker.bgw_restart_time = BGW_NEVER_RESTART;
+		worker.bgw_notify_pid = MyProcPid;
+		worker.bgw_main_arg = UInt32GetDatum(myConnectorId);
+		strcpy(worker.bgw_library_name, "synchdb");
+		strcpy(worker.bgw_function_name, "synchdb_fdw_snapshot_worker_main");
+		snprintf(worker.bgw_name, BGW_MAXLEN, "synchdb fdw snapshot worker %d: %s",
+				i, connInfo->name);
+		snprintf(worker.bgw_type, BGW_MAXLEN, "synchdb fdw snapshot worker");
+		memcpy(worker.bgw_extra, &args, sizeof(FdwSnapshotWorkerArgs));
+
+		if (!RegisterDynamicBackgroundWorker(&worker, &handles[nlaunched]))
+		{
+			elog(WARNING, "could only launch %d of %d fdw snapshot workers, "
+					"you may need to increase max_worker_processes", nlaunched, nworkers);
+			break;
+		}
+		nlaunched++;
+		fdwSnapshotNumHandles = nlaunched;
+	}
+
+	if (nlaunched == 0)
+	{
+		/* no worker available, do the work ourselves */
+		ra_fdwSnapshotWorkerLoop(connInfo->name);
+		terminating = ShutdownRequestPending;
+	}
+
+	/* workers notify us on exit, poll them until all are gone */
+	for (;;)
+	{
+		nalive = 0;
+		for (i = 0; i < nlaunched; i++)
+		{
+			BgwHandleStatus status = GetBackgroundWorkerPid(handles[i], &pid);
+
+			if (status == BGWH_POSTMASTER_DIED)
+				proc_exit(1);
+			if (status != BGWH_STOPPED)
+				nalive++;
+		}
+
+		if (nalive == 0)
+			break;
+
+		if (ShutdownRequestPending && !terminating)
+		{
+			elog(LOG, "terminating %d fdw snapshot workers of connector %s",
+					nalive, connInfo->name);
+			synchdb_terminate_fdw_snapshot_workers(0, (Datum) 0);
+			terminating = true;
+		}
+
+		(void) WaitLatch(MyLatch,
+						 WL_LATCH_SET | WL_TIMEOUT | WL_EXIT_ON_PM_DEATH,
+						 1000L,
+						 PG_WAIT_EXTENSION);
+		ResetLatch(MyLatch);
+		CHECK_FOR_INTERRUPTS();
+	}
+
+	fdwSnapshotHandles = NULL;
+	fdwSnapshotNumHandles = 0;
+	pfree(handles);
+
+	if (terminating)
+		elog(ERROR, "fdw snapshot of connector %s was interrupted by a shutdown request",
+				connInfo->name);
+
+	elog(LOG, "%d fdw snapshot workers of connector %s have finished",
+			nlaunched, connInfo->name);
+	return nlaunched;
 }
 
 /*
- * get_shm_connector_state_enum - Get the current state enum of a specific connector from shared memory
+ * connectorTypeToString
  *
- * This function retrieves the current state of a given connector type from the shared
- * memory state as a ConnectorState enum value.
+ * This function converts connector type from enum to string
  *
- * @param connectorId: Connector ID of interest
+ * @param type: Connector type in enum
  *
- * @return: A ConnectorState enum representing the connector's state. If the shared memory
- *          is not initialized or the connector type is unknown, it returns STATE_UNDEF.
+ * @return connector type in string
  */
-ConnectorState
-get_shm_connector_state_enum(int connectorId)
+const char *
+connectorTypeToString(ConnectorType type)
 {
-	ConnectorState state;
-
-	if (!sdb_state)
-		return STATE_UNDEF;
-
-	/*
-	 * We're only reading, so shared lock is sufficient.
-	 * This ensures thread-safety without blocking other readers.
-	 */
-	LWLockAcquire(&sdb_state->lock, LW_SHARED);
-	state = sdb_state->connectors[connectorId].state;
-	LWLockRelease(&sdb_state->lock);
-
-	return state;
+	switch (type)
+	{
+	case TYPE_UNDEF:
+		return "UNDEFINED";
+	case TYPE_MYSQL:
+		return "MYSQL";
+	case TYPE_ORACLE:
+		return "ORACLE";
+	case TYPE_SQLSERVER:
+		return "SQLSERVER";
+	case TYPE_OLR:
+		return "OLR";
+	default:
+		return "UNKNOWN";
+	}
 }
 
 /*
- * set_shm_connector_state - Set the state of a specific connector in shared memory
+ * stringToConnectorType
  *
- * This function sets the state of a given connector type in the shared memory.
- * It ensures thread-safety by using an exclusive lock when accessing shared memory.
+ * This function converts string to connector type
  *
- * @param connectorId: Connector ID of interest
- * @param state: The new state to set for the connector
+ * @param type: connector type in string
+ *
+ * @return connector type enum
  */
-void
-set_shm_connector_state(int connectorId, ConnectorState state)
+ConnectorType
+stringToConnectorType(const char * type)
 {
-	if (!sdb_state)
-		return;
-
-	LWLockAcquire(&sdb_state->lock, LW_EXCLUSIVE);
-	sdb_state->connectors[connectorId].state = state;
-	LWLockRelease(&sdb_state->lock);
+	if (!strcasecmp(type, "mysql"))
+		return TYPE_MYSQL;
+	else if(!strcasecmp(type, "sqlserver"))
+		return TYPE_SQLSERVER;
+	else if(!strcasecmp(type, "oracle"))
+		return TYPE_ORACLE;
+	else if(!strcasecmp(type, "olr"))
+		return TYPE_OLR;
+	else
+		return TYPE_UNDEF;
 }
 
 /*
- * set_shm_dbz_offset - Set the offset of a paused connector
+ * get_shm_connector_name
  *
- * This method reads from dbz's offset file per connector type, which does not
- * reflect the real-time offset of dbz engine. If we were to resume from this point
- * due to an error, there may be duplicate values after the resume in which we must
- * handle. In the future, we will need to explore a more accurate way to find out
- * the offset managed within dbz so we could freely resume from any reference not
- * just at the flushed locations. todo
+ * This function converts connector type from enum to string in lowercase
  *
- * @param connectorId: Connector ID of interest
+ * @param type: Connector type in enum
+ *
+ * @return connector type in string
+ * todo: potential duplicate
  */
-void
-set_shm_dbz_offset(int connectorId)
+const char *
+get_shm_connector_name(ConnectorType type)
 {
-	char *offset;
-
-	if (!sdb_state)
-		return;
-
-#ifdef WITH_OLR
-	if (sdb_state->connectors[connectorId].type == TYPE_OLR)
-	{
-		offset = psprintf("{\"scn\":%llu, \"c_scn\":%llu, \"c_idx\":%llu}",
-				olr_client_get_scn(), olr_client_get_c_scn(),
-				olr_client_get_c_idx());
-	}
-	else
-#endif
+	switch (type)
 	{
-		offset = dbz_engine_get_offset(connectorId);
-		if (!offset)
-			return;
+	case TYPE_MYSQL:
+		return "mysql";
+	case TYPE_ORACLE:
+		return "oracle";
+	case TYPE_SQLSERVER:
+		return "sqlserver";
+	case TYPE_OLR:
+		return "olr";
+	/* todo: support more dbz connector types here */
+	default:
+		return "null";
 	}
-
-	LWLockAcquire(&sdb_state->lock, LW_EXCLUSIVE);
-	strlcpy(sdb_state->connectors[connectorId].dbzoffset, offset, SYNCHDB_ERRMSG_SIZE);
-	LWLockRelease(&sdb_state->lock);
-
-	pfree(offset);
 }
 
 /*
- * get_shm_dbz_offset - Get the offset from a connector
+ * get_shm_connector_pid
  *
- * This method gets the offset value of the given connector from shared memory
+ * This function gets pid of the given connectorID
  *
  * @param connectorId: Connector ID of interest
+ *
+ * @return pid of the connector, -1 if connector is not running
  */
-const char *
-get_shm_dbz_offset(int connectorId)
+pid_t
+get_shm_connector_pid(int connectorId)
 {
 	if (!sdb_state)
-		return "n/a";
+		return InvalidPid;
 
-	return (sdb_state->connectors[connectorId].dbzoffset[0] != '\0') ?
-			sdb_state->connectors[connectorId].dbzoffset : "no offset";
+	return sdb_state->connectors[connectorId].pid;
 }
 
 /*
- * get_shm_connector_name - Get the unique connector name based on connectorId
+ * set_shm_connector_pid
  *
- * This method gets the name value of the given connector from shared memory
+ * This function sets pid of the given connectorID
  *
  * @param connectorId: Connector ID of interest
+ * @param pid: New pid value
  */
-const char *
-get_shm_connector_name_by_id(int connectorId)
+void
+set_shm_connector_pid(int connectorId, pid_t pid)
 {
 	if (!sdb_state)
-		return "n/a";
+		return;
 
-	return (sdb_state->connectors[connectorId].conninfo.name[0] != '\0') ?
-			sdb_state->connectors[connectorId].conninfo.name : "no name";
+	LWLockAcquire(&sdb_state->lock, LW_EXCLUSIVE);
+	sdb_state->connectors[connectorId].pid = pid;
+	LWLockRelease(&sdb_state->lock);
 }
 
 /*
- * get_shm_conn_user_by_id - Get the username associated with connector id
+ * get_shm_connector_errmsg
  *
- * This method gets the username value of the given connector from shared memory
+ * This function gets the last error message of the given connectorID
  *
  * @param connectorId: Connector ID of interest
+ *
+ * @return the error message in string
  */
 const char *
-get_shm_connector_user_by_id(int connectorId)
+get_shm_connector_errmsg(int connectorId)
 {
 	if (!sdb_state)
-		return "n/a";
+		return "no error";
 
-	return (sdb_state->connectors[connectorId].conninfo.user[0] != '\0') ?
-			sdb_state->connectors[connectorId].conninfo.user : "no user";
+	return (sdb_state->connectors[connectorId].errmsg[0] != '\0') ?
+			sdb_state->connectors[connectorId].errmsg : "no error";
 }
 
 /*
- * get_shm_ora_compat - check if we are running against oracle compatible ivorysql
+ * set_shm_connector_errmsg - Set the error message for a specific connector in shared memory
  *
- * This method returns true if we are in oracle compatible mode, false otherwise
+ * This function sets the error message for a given connector type in the shared
+ * memory state. It ensures thread-safety by using a lock when accessing shared memory.
  *
  * @param connectorId: Connector ID of interest
+ * @param err: The error message to set. If NULL, an empty string will be set.
  */
-bool
-get_shm_ora_compat(int connectorId)
+void
+set_shm_connector_errmsg(int connectorId, const char *err)
 {
 	if (!sdb_state)
-		return false;
+		return;
 
-	return sdb_state->connectors[connectorId].conninfo.isOraCompat;
+	LWLockAcquire(&sdb_state->lock, LW_EXCLUSIVE);
+	strlcpy(sdb_state->connectors[connectorId].errmsg, err ? err : "", SYNCHDB_ERRMSG_SIZE);
+	LWLockRelease(&sdb_state->lock);
 }
 
 /*
- * _PG_init - Initialize the SynchDB extension
+ * get_shm_connector_stage - Get the current connector stage
+ *
+ * This function gets current connector stage based on the change request received.
+ *
+ * @param connectorId: Connector ID of interest
+ *
+ * @return connector stage in string
  */
-void
-_PG_init(void)
+static const char *
+get_shm_connector_stage(int connectorId)
 {
-	DefineCustomIntVariable("synchdb.naptime",
-							"Duration between each data polling (in milliseconds).",
-							NULL,
-							&synchdb_worker_naptime,
-							10,
-							1,
-							30000,
-							PGC_SIGHUP,
-							0,
-							NULL, NULL, NULL);
+	ConnectorStage stage;
 
-	DefineCustomBoolVariable("synchdb.dml_use_spi",
-							 "option to use SPI to handle DML operations. Default false",
-							 NULL,
-							 &synchdb_dml_use_spi,
-							 false,
-							 PGC_SIGHUP,
-							 0,
-							 NULL, NULL, NULL);
+	if (!sdb_state)
+		return "unknown";
 
-	DefineCustomIntVariable("synchdb.dbz_batch_size",
-							"the maximum number of change events in a batch",
-							NULL,
-							&dbz_batch_size,
-							2048,
+	/*
+	 * We're only reading, so shared lock is sufficient.
+	 * This ensures thread-safety without blocking other readers.
+	 */
+	LWLockAcquire(&sdb_state->lock, LW_SHARED);
+	stage = sdb_state->connectors[connectorId].stage;
+	LWLockRelease(&sdb_state->lock);
+
+	return connectorStageAsString(stage);
+}
+
+/*
+ * connectorStageAsString
+ *
+ * This function converts connector stage from enum to string
+ *
+ * @param stage: Connector stage enum
+ *
+ * @return connector stage in string
+ */
+static const char *
+connectorStageAsString(ConnectorStage stage)
+{
+	switch(stage)
+	{
+		case STAGE_INITIAL_SNAPSHOT:
+		{
+			return "initial snapshot";
+			break;
+		}
+		case STAGE_CHANGE_DATA_CAPTURE:
+		{
+			return "change data capture";
+			break;
+		}
+		case STAGE_SCHEMA_SYNC:
+		{
+			return "schema sync";
+			break;
+		}
+		case STAGE_UNDEF:
+		default:
+		{
+			break;
+		}
+	}
+	return "unknown";
+}
+
+/*
+ * set_shm_connector_statistics - adds the give stats
+ *
+ * This function adds the given stats info to the one in shared memory so user
+ * can see updated stats
+ *
+ * @param connectorId: Connector ID of interest
+ * @param stats: connector statistics struct
+ */
+static void
+set_shm_connector_statistics(int connectorId, SynchdbStatistics * stats)
+{
+	LWLockAcquire(&sdb_state->lock, LW_EXCLUSIVE);
+	/* CDC stats */
+	sdb_state->connectors[connectorId].stats.cdcstats.stats_ddl +=
+			stats->cdcstats.stats_ddl;
+	sdb_state->connectors[connectorId].stats.cdcstats.stats_dml +=
+			stats->cdcstats.stats_dml;
+	sdb_state->connectors[connectorId].stats.cdcstats.stats_create +=
+			stats->cdcstats.stats_create;
+	sdb_state->connectors[connectorId].stats.cdcstats.stats_update +=
+			stats->cdcstats.stats_update;
+	sdb_state->connectors[connectorId].stats.cdcstats.stats_delete +=
+			stats->cdcstats.stats_delete;
+	sdb_state->connectors[connectorId].stats.cdcstats.stats_tx +=
+			stats->cdcstats.stats_tx;
+	sdb_state->connectors[connectorId].stats.cdcstats.stats_truncate +=
+			stats->cdcstats.stats_truncate;
+	sdb_state->connectors[connectorId].stats.cdcstats.stats_locator_hit +=
+			stats->cdcstats.stats_locator_hit;
+	sdb_state->connectors[connectorId].stats.cdcstats.stats_locator_miss +=
+			stats->cdcstats.stats_locator_miss;
+
+	/* General stats */
+	sdb_state->connectors[connectorId].stats.genstats.stats_bad_change_event +=
+			stats->genstats.stats_bad_change_event;
+	sdb_state->connectors[connectorId].stats.genstats.stats_total_change_event +=
+			stats->genstats.stats_total_change_event;
+	sdb_state->connectors[connectorId].stats.genstats.stats_batch_completion +=
+			stats->genstats.stats_batch_completion;
+	sdb_state->connectors[connectorId].stats.genstats.stats_spill_count +=
+			stats->genstats.stats_spill_count;
+	sdb_state->connectors[connectorId].stats.genstats.stats_spill_bytes +=
+			stats->genstats.stats_spill_bytes;
+	/* the following should be overwritten \n */
+	sdb_state->connectors[connectorId].stats.genstats.stats_first_src_ts =
+			stats->genstats.stats_first_src_ts;
+	sdb_state->connectors[connectorId].stats.genstats.stats_first_pg_ts =
+			stats->genstats.stats_first_pg_ts;
+	sdb_state->connectors[connectorId].stats.genstats.stats_last_src_ts =
+			stats->genstats.stats_last_src_ts;
+	sdb_state->connectors[connectorId].stats.genstats.stats_last_pg_ts =
+			stats->genstats.stats_last_pg_ts;
+
+	/* Snapshot stats */
+	sdb_state->connectors[connectorId].stats.snapstats.snapstats_tables +=
+			stats->snapstats.snapstats_tables;
+	sdb_state->connectors[connectorId].stats.snapstats.snapstats_rows +=
+			stats->snapstats.snapstats_rows;
+
+	/* the following should be overwritten \n */
+	if (stats->snapstats.snapstats_begintime_ts > 0)
+	{
+		sdb_state->connectors[connectorId].stats.snapstats.snapstats_begintime_ts =
+				stats->snapstats.snapstats_begintime_ts;
+		/*
+		 * when begintime_ts is set, we assume it is the beginning of a snapshot, so
+		 * we set endtime_ts to 0 to indicate a fresh start.
+		 */
+		sdb_state->connectors[connectorId].stats.snapstats.snapstats_endtime_ts = 0;
+	}
+	if (stats->snapstats.snapstats_endtime_ts > 0)
+		sdb_state->connectors[connectorId].stats.snapstats.snapstats_endtime_ts =
+				stats->snapstats.snapstats_endtime_ts;
+	LWLockRelease(&sdb_state->lock);
+
+	/* latency histograms are published at the same batch boundaries */
+	set_shm_connector_latency(connectorId);
+}
+
+static void
+set_shm_connector_snapshot_statistics(int connectorId, SnapshotStatistics * snapstats)
+{
+	LWLockAcquire(&sdb_state->lock, LW_EXCLUSIVE);
+	sdb_state->connectors[connectorId].stats.snapstats.snapstats_tables +=
+				snapstats->snapstats_tables;
+	sdb_state->connectors[connectorId].stats.snapstats.snapstats_rows +=
+				snapstats->snapstats_rows;
+	if (snapstats->snapstats_begintime_ts > 0)
+	{
+		sdb_state->connectors[connectorId].stats.snapstats.snapstats_begintime_ts =
+				snapstats->snapstats_begintime_ts;
+		/*
+		 * when begintime_ts is set, we assume it is the beginning of a snapshot, so
+		 * we set endtime_ts to 0 to indicate a fresh start.
+		 */
+		sdb_state->connectors[connectorId].stats.snapstats.snapstats_endtime_ts = 0;
+	}
+	if (snapstats->snapstats_endtime_ts > 0)
+		sdb_state->connectors[connectorId].stats.snapstats.snapstats_endtime_ts =
+				snapstats->snapstats_endtime_ts;
+	LWLockRelease(&sdb_state->lock);
+}
+
+static void
+is_snapshot_cdc_needed(const char* snapshotMode, bool isSnapshotDone, bool * snapshot, bool * cdc)
+{
+	if (!strcasecmp(snapshotMode, "initial"))
+	{
+		*snapshot = isSnapshotDone ? false : true;
+		*cdc = true;
+	}
+	else if (!strcasecmp(snapshotMode, "initial_only"))
+	{
+		*snapshot = isSnapshotDone ? false : true;
+		*cdc = false;
+	}
+	else if (!strcasecmp(snapshotMode, "no_data"))
+	{
+		*snapshot = isSnapshotDone ? false : true;
+		*cdc = true;
+	}
+	else if (!strcasecmp(snapshotMode, "always"))
+	{
+		*snapshot = true;
+		*cdc = true;
+	}
+	else if (!strcasecmp(snapshotMode, "never"))
+	{
+		*snapshot = false;
+		*cdc = true;
+	}
+	else
+	{
+		elog(WARNING, "snapshot mode %s not handled for OLR connector. Default to initial",
+				snapshotMode);
+		*snapshot = isSnapshotDone ? false : true;
+		*cdc = true;
+	}
+}
+#ifdef WITH_OLR
+static void
+try_reconnect_olr(ConnectionInfo * connInfo)
+{
+	int ret = -1;
+
+	if (olr_client_get_connect_status())
+	{
+		elog(WARNING, "already connected.");
+		return;
+	}
+
+	elog(WARNING, "reconnecting...");
+	if (olr_client_init(connInfo->olr.olr_host, connInfo->olr.olr_port))
+		elog(DEBUG1, "failed to reconnect");
+	else
+	{
+		elog(WARNING, "reconnected, request replication...");
+
+		/* connInfo.srcdb is used as data source for OLR */
+		ret = olr_client_start_or_cont_replication(connInfo->olr.olr_source, true);
+		if (ret == -1)
+		{
+			set_shm_connector_errmsg(myConnectorId, "failed to start replication with olr server");
+			elog(ERROR, "failed to start replication with olr server");
+		}
+
+		if (ret == RES_ALREADY_STARTED || ret == RES_STARTING)
+		{
+			elog(WARNING, "replication already started or starting - sending continue");
+			ret = olr_client_start_or_cont_replication(connInfo->olr.olr_source, false);
+			if (ret == -1)
+			{
+				set_shm_connector_errmsg(myConnectorId, "failed to start replication with olr server");
+				elog(ERROR, "failed to start replication with olr server");
+			}
+		}
+		if (ret == RES_REPLICATE)
+			elog(WARNING, "replication requested...");
+		else
+		{
+			set_shm_connector_errmsg(myConnectorId, "openlog replicator is not ready to replicate after reconnection");
+			elog(ERROR, "openlog replicator is not ready to replicate, response code = %d", ret);
+		}
+	}
+}
+
+static int
+olr_set_offset_from_raw(char * offsetdata)
+{
+	orascn scn = 0, c_scn = 0, c_idx = 0;
+	const char *scn_pos = strstr(offsetdata, "\"scn\":");
+	const char *c_scn_pos = strstr(offsetdata, "\"c_scn\":");
+	const char *c_idx_pos = strstr(offsetdata, "\"c_idx\":");
+
+	if (scn_pos)
+	{
+		sscanf(scn_pos, "\"scn\":%llu", &scn);
+	}
+	else
+	{
+		elog(WARNING, "bad offset string: scn missing...");
+		return -1;
+	}
+	if (c_scn_pos)
+	{
+		sscanf(c_scn_pos, "\"c_scn\":%llu", &c_scn);
+	}
+	else
+	{
+		elog(WARNING, "bad offset string: c_scn missing...");
+		return -1;
+	}
+	if (c_idx_pos)
+	{
+		sscanf(c_idx_pos, "\"c_idx\":%llu", &c_idx);
+	}
+	else
+	{
+		elog(WARNING, "bad offset string: c_idx missing...");
+		return -1;
+	}
+	elog(WARNING, "new offset: scn:%llu c_scn:%llu c_idx:%llu",
+			scn, c_scn, c_idx);
+	olr_client_set_scns(scn, c_scn, c_idx);
+	return 0;
+}
+
+/*
+ * olr_restore_offset - Initialize resume scns from synchdb_offsets
+ *
+ * @param name: The name of the connector
+ *
+ * @return: true if an offset was recorded and restored, false otherwise
+ */
+static bool
+olr_restore_offset(const char * name)
+{
+	char * offset = ra_getOffset(name);
+	bool restored = false;
+
+	if (offset)
+	{
+		restored = (olr_set_offset_from_raw(offset) == 0);
+		pfree(offset);
+	}
+	return restored;
+}
+#endif
+
+
+/*
+ * increment_connector_statistics - increment statistics
+ *
+ * This function increments statistic counter for specified type
+ *
+ * @param which: type of statistic to increment
+ */
+void
+increment_connector_statistics(SynchdbStatistics * myStats, ConnectorStatistics which, int incby)
+{
+	if (!myStats)
+		return;
+
+	switch(which)
+	{
+		/* CDC stats */
+		case STATS_DDL:
+			myStats->cdcstats.stats_ddl += incby;
+			break;
+		case STATS_DML:
+			myStats->cdcstats.stats_dml += incby;
+			break;
+		case STATS_CREATE:
+			myStats->cdcstats.stats_create += incby;
+			break;
+		case STATS_UPDATE:
+			myStats->cdcstats.stats_update += incby;
+			break;
+		case STATS_DELETE:
+			myStats->cdcstats.stats_delete += incby;
+			break;
+		case STATS_TRUNCATE:
+			myStats->cdcstats.stats_truncate += incby;
+			break;
+		case STATS_TX:
+			myStats->cdcstats.stats_tx += incby;
+			break;
+		case STATS_LOCATOR_HIT:
+			myStats->cdcstats.stats_locator_hit += incby;
+			break;
+		case STATS_LOCATOR_MISS:
+			myStats->cdcstats.stats_locator_miss += incby;
+			break;
+
+		/* snapshot stats */
+		case STATS_TABLES:
+			myStats->snapstats.snapstats_tables += incby;
+			break;
+		case STATS_ROWS:
+			myStats->snapstats.snapstats_rows += incby;
+			break;
+
+		/* general stats */
+		case STATS_BAD_CHANGE_EVENT:
+			myStats->genstats.stats_bad_change_event += incby;
+			break;
+		case STATS_TOTAL_CHANGE_EVENT:
+			myStats->genstats.stats_total_change_event += incby;
+			break;
+		case STATS_BATCH_COMPLETION:
+			myStats->genstats.stats_batch_completion += incby;
+			break;
+		case STATS_SPILL_COUNT:
+			myStats->genstats.stats_spill_count += incby;
+			break;
+		default:
+			break;
+	}
+}
+
+/*
+ * get_shm_connector_type - Get the connector type in enum
+ *
+ * This function gets specified connector type.
+ *
+ * @param connectorId: Connector ID of interest
+ *
+ * @return ConnectorType enum
+ */
+ConnectorType
+get_shm_connector_type_enum(int connectorId)
+{
+	ConnectorType type;
+
+	if (!sdb_state)
+		return TYPE_UNDEF;
+
+	/*
+	 * We're only reading, so shared lock is sufficient.
+	 * This ensures thread-safety without blocking other readers.
+	 */
+	LWLockAcquire(&sdb_state->lock, LW_SHARED);
+	type = sdb_state->connectors[connectorId].type;
+	LWLockRelease(&sdb_state->lock);
+
+	return type;
+}
+
+/*
+ * get_shm_connector_stage_enum - Get the current connector stage in enum
+ *
+ * This function gets current connector stage based on the change request received.
+ *
+ * @param connectorId: Connector ID of interest
+ *
+ * @return connector stage in enum
+ */
+ConnectorStage
+get_shm_connector_stage_enum(int connectorId)
+{
+	ConnectorStage stage;
+
+	if (!sdb_state)
+		return STAGE_UNDEF;
+
+	/*
+	 * We're only reading, so shared lock is sufficient.
+	 * This ensures thread-safety without blocking other readers.
+	 */
+	LWLockAcquire(&sdb_state->lock, LW_SHARED);
+	stage = sdb_state->connectors[connectorId].stage;
+	LWLockRelease(&sdb_state->lock);
+
+	return stage;
+}
+
+/*
+ * set_shm_connector_stage - Set the current connector stage in enum
+ *
+ * This function sets current connector stage
+ *
+ * @param connectorId: Connector ID of interest
+ * @param stage: new connector stage
+ */
+void
+set_shm_connector_stage(int connectorId, ConnectorStage stage)
+{
+	if (!sdb_state)
+		return;
+
+	LWLockAcquire(&sdb_state->lock, LW_EXCLUSIVE);
+	sdb_state->connectors[connectorId].stage = stage;
+	LWLockRelease(&sdb_state->lock);
+}
+
+/*
+ * get_shm_connector_state - Get the current state of a specific connector from shared memory
+ *
+ * This function retrieves the current state of a given connector type from the shared
+ * memory state. It returns the state as a string representation.
+ *
+ * @param connectorId: Connector ID of interest
+ *
+ * @return: A string representation of the connector's state. If the shared memory
+ *          is not initialized or the connector type is unknown, it returns "stopped"
+ *          or "undefined" respectively.
+ */
+const char *
+get_shm_connector_state(int connectorId)
+{
+	ConnectorState state;
+
+	if (!sdb_state)
+		return "stopped";
+
+	/*
+	 * We're only reading, so shared lock is sufficient.
+	 * This ensures thread-safety without blocking other readers.
+	 */
+	LWLockAcquire(&sdb_state->lock, LW_SHARED);
+	state = sdb_state->connectors[connectorId].state;
+	LWLockRelease(&sdb_state->lock);
+
+	return connectorStateAsString(state);
+}
+
+/*
+ * get_shm_connector_state_enum - Get the current state enum of a specific connector from shared memory
+ *
+ * This function retrieves the current state of a given connector type from the shared
+ * memory state as a ConnectorState enum value.
+ *
+ * @param connectorId: Connector ID of interest
+ *
+ * @return: A ConnectorState enum representing the connector's state. If the shared memory
+ *          is not initialized or the connector type is unknown, it returns STATE_UNDEF.
+ */
+ConnectorState
+get_shm_connector_state_enum(int connectorId)
+{
+	ConnectorState state;
+
+	if (!sdb_state)
+		return STATE_UNDEF;
+
+	/*
+	 * We're only reading, so shared lock is sufficient.
+	 * This ensures thread-safety without blocking other readers.
+	 */
+	LWLockAcquire(&sdb_state->lock, LW_SHARED);
+	state = sdb_state->connectors[connectorId].state;
+	LWLockRelease(&sdb_state->lock);
+
+	return state;
+}
+
+/*
+ * set_shm_connector_state - Set the state of a specific connector in shared memory
+ *
+ * This function sets the state of a given connector type in the shared memory.
+ * It ensures thread-safety by using an exclusive lock when accessing shared memory.
+ *
+ * @param connectorId: Connector ID of interest
+ * @param state: The new state to set for the connector
+ */
+void
+set_shm_connector_state(int connectorId, ConnectorState state)
+{
+	if (!sdb_state)
+		return;
+
+	if (replayTiming && connectorId == myConnectorId)
+		replay_charge_state(state);
+
+	LWLockAcquire(&sdb_state->lock, LW_EXCLUSIVE);
+
+	/* the connector is ready once it leaves the initializing state for the first time */
+	if (connectorId == myConnectorId && !INSTR_TIME_IS_ZERO(workerStartTime) &&
+		sdb_state->connectors[connectorId].startup_ms == 0 &&
+		sdb_state->connectors[connectorId].state == STATE_INITIALIZING &&
+		state != STATE_INITIALIZING)
+	{
+		instr_time	duration;
+
+		INSTR_TIME_SET_CURRENT(duration);
+		INSTR_TIME_SUBTRACT(duration, workerStartTime);
+		sdb_state->connectors[connectorId].startup_ms =
+				Max((uint32) INSTR_TIME_GET_MILLISEC(duration), 1);
+	}
+	sdb_state->connectors[connectorId].state = state;
+	LWLockRelease(&sdb_state->lock);
+}
+
+/*
+ * set_shm_dbz_offset - Set the offset of a paused connector
+ *
+ * This method reads from dbz's offset file per connector type, which does not
+ * reflect the real-time offset of dbz engine. If we were to resume from this point
+ * due to an error, there may be duplicate values after the resume in which we must
+ * handle. In the future, we will need to explore a more accurate way to find out
+ * the offset managed within dbz so we could freely resume from any reference not
+ * just at the flushed locations. todo
+ *
+ * @param connectorId: Connector ID of interest
+ */
+void
+set_shm_dbz_offset(int connectorId)
+{
+	char *offset;
+
+	if (!sdb_state)
+		return;
+
+#ifdef WITH_OLR
+	if (sdb_state->connectors[connectorId].type == TYPE_OLR)
+	{
+		offset = psprintf("{\"scn\":%llu, \"c_scn\":%llu, \"c_idx\":%llu}",
+				olr_client_get_scn(), olr_client_get_c_scn(),
+				olr_client_get_c_idx());
+	}
+	else
+#endif
+	{
+		offset = dbz_engine_get_offset(connectorId);
+		if (!offset)
+			return;
+	}
+
+	LWLockAcquire(&sdb_state->lock, LW_EXCLUSIVE);
+	strlcpy(sdb_state->connectors[connectorId].dbzoffset, offset, SYNCHDB_ERRMSG_SIZE);
+	LWLockRelease(&sdb_state->lock);
+
+	pfree(offset);
+}
+
+/*
+ * get_shm_dbz_offset - Get the offset from a connector
+ *
+ * This method gets the offset value of the given connector from shared memory
+ *
+ * @param connectorId: Connector ID of interest
+ */
+const char *
+get_shm_dbz_offset(int connectorId)
+{
+	if (!sdb_state)
+		return "n/a";
+
+	return (sdb_state->connectors[connectorId].dbzoffset[0] != '\0') ?
+			sdb_state->connectors[connectorId].dbzoffset : "no offset";
+}
+
+/*
+ * get_shm_connector_name - Get the unique connector name based on connectorId
+ *
+ * This method gets the name value of the given connector from shared memory
+ *
+ * @param connectorId: Connector ID of interest
+ */
+const char *
+get_shm_connector_name_by_id(int connectorId)
+{
+	if (!sdb_state)
+		return "n/a";
+
+	return (sdb_state->connectors[connectorId].conninfo.name[0] != '\0') ?
+			sdb_state->connectors[connectorId].conninfo.name : "no name";
+}
+
+/*
+ * get_shm_conn_user_by_id - Get the username associated with connector id
+ *
+ * This method gets the username value of the given connector from shared memory
+ *
+ * @param connectorId: Connector ID of interest
+ */
+const char *
+get_shm_connector_user_by_id(int connectorId)
+{
+	if (!sdb_state)
+		return "n/a";
+
+	return (sdb_state->connectors[connectorId].conninfo.user[0] != '\0') ?
+			sdb_state->connectors[connectorId].conninfo.user : "no user";
+}
+
+/*
+ * get_shm_ora_compat - check if we are running against oracle compatible ivorysql
+ *
+ * This method returns true if we are in oracle compatible mode, false otherwise
+ *
+ * @param connectorId: Connector ID of interest
+ */
+bool
+get_shm_ora_compat(int connectorId)
+{
+	if (!sdb_state)
+		return false;
+
+	return sdb_state->connectors[connectorId].conninfo.isOraCompat;
+}
+
+/*
+ * _PG_init - Initialize the SynchDB extension
+ */
+void
+_PG_init(void)
+{
+	DefineCustomIntVariable("synchdb.naptime",
+							"Duration between each data polling (in milliseconds).",
+							NULL,
+							&synchdb_worker_naptime,
+							10,
+							1,
+							30000,
+							PGC_SIGHUP,
+							0,
+							NULL, NULL, NULL);
+
+	DefineCustomBoolVariable("synchdb.dml_use_spi",
+							 "option to use SPI to handle DML operations. Default false",
+							 NULL,
+							 &synchdb_dml_use_spi,
+							 false,
+							 PGC_SIGHUP,
+							 0,
+							 NULL, NULL, NULL);
+
+	DefineCustomIntVariable("synchdb.dbz_batch_size",
+							"the maximum number of change events in a batch",
+							NULL,
+							&dbz_batch_size,
+							2048,
 							1,
 							65535,
 							PGC_SIGHUP,
@@ -3865,6 +5782,77 @@ _PG_init(void)
 							0,
 							NULL, NULL, NULL);
 
+	DefineCustomIntVariable("synchdb.jvm_max_batch_queue_memory",
+							"max estimated size of the change event batches Debezium may queue "
+							"for a connector before it blocks. 0 uses a quarter of jvm_max_heap_size",
+							NULL,
+							&jvm_max_batch_queue_memory,
+							0,
+							0,
+							65536,
+							PGC_SIGHUP,
+							GUC_UNIT_MB,
+							NULL, NULL, NULL);
+
+	DefineCustomIntVariable("synchdb.batch_spill_threshold",
+							"size of the change events a connector receives at once. A larger batch "
+							"is received in parts that are spilled to a temporary file and applied "
+							"in one transaction once complete. 0 disables spilling",
+							NULL,
+							&synchdb_batch_spill_threshold,
+							64,
+							0,
+							1024,
+							PGC_SIGHUP,
+							GUC_UNIT_MB,
+							NULL, NULL, NULL);
+
+	DefineCustomBoolVariable("synchdb.dbz_autotune",
+							 "option to adjust the number of change events applied per transaction "
+							 "and the batch queue memory at runtime from measured apply time, commit "
+							 "time and replication lag. Default false",
+							 NULL,
+							 &dbz_autotune,
+							 false,
+							 PGC_SIGHUP,
+							 0,
+							 NULL, NULL, NULL);
+
+	DefineCustomIntVariable("synchdb.dbz_autotune_min_batch_size",
+							"the smallest number of change events per transaction synchdb.dbz_autotune "
+							"may shrink a batch to. The largest is synchdb.dbz_batch_size",
+							NULL,
+							&dbz_autotune_min_batch_size,
+							64,
+							1,
+							65535,
+							PGC_SIGHUP,
+							0,
+							NULL, NULL, NULL);
+
+	DefineCustomIntVariable("synchdb.dbz_autotune_min_queue_memory",
+							"the smallest batch queue memory synchdb.dbz_autotune may shrink the "
+							"queue to. The largest is synchdb.jvm_max_batch_queue_memory",
+							NULL,
+							&dbz_autotune_min_queue_memory,
+							16,
+							1,
+							65536,
+							PGC_SIGHUP,
+							GUC_UNIT_MB,
+							NULL, NULL, NULL);
+
+	DefineCustomIntVariable("synchdb.dbz_autotune_target_ms",
+							"the time synchdb.dbz_autotune aims to apply one batch in",
+							NULL,
+							&dbz_autotune_target_ms,
+							1000,
+							10,
+							600000,
+							PGC_SIGHUP,
+							GUC_UNIT_MS,
+							NULL, NULL, NULL);
+
 	DefineCustomIntVariable("synchdb.dbz_snapshot_thread_num",
 							"number of threads to perform Debezium initial snapshot",
 							NULL,
@@ -4041,33 +6029,160 @@ _PG_init(void)
 							0,
 							NULL, NULL, NULL);
 
-	DefineCustomEnumVariable("synchdb.snapshot_engine",
-							"engine used to complete initial snapshot for OLR connector",
+	DefineCustomEnumVariable("synchdb.olr_payload_format",
+							"format of change events sent by openlog replicator. It must match "
+							"the format type configured in openlog replicator and takes effect "
+							"when the connector connects",
+							 NULL,
+							 &olr_payload_format,
+							 OLR_PAYLOAD_JSON,
+							 olr_payload_formats,
+							 PGC_SIGHUP,
+							 0,
+							 NULL,
+							 NULL,
+							 NULL);
+
+	DefineCustomEnumVariable("synchdb.snapshot_engine",
+							"engine used to complete initial snapshot for OLR connector",
+							 NULL,
+							 &synchdb_snapshot_engine,
+							 ENGINE_DEBEZIUM,
+							 snapshot_engines,
+							 PGC_SIGHUP,
+							 0,
+							 NULL,
+							 NULL,
+							 NULL);
+
+	DefineCustomIntVariable("synchdb.dbz_record_processing_threads",
+							"number of threads Debezium uses to convert change records to JSON. "
+							"A value greater than 0 runs the asynchronous embedded engine, 0 runs "
+							"the synchronous engine that converts records on a single thread",
+							NULL,
+							&dbz_record_processing_threads,
+							0,
+							0,
+							256,
+							PGC_SIGHUP,
+							0,
+							NULL, NULL, NULL);
+
+	DefineCustomIntVariable("synchdb.cdc_start_delay_ms",
+							"a delay after initial snapshot completes and before cdc begins",
+							NULL,
+							&cdc_start_delay_ms,
+							0,
+							0,
+							65536,
+							PGC_SIGHUP,
+							0,
+							NULL, NULL, NULL);
+
+	DefineCustomBoolVariable("synchdb.fdw_migrate_with_subtx",
+							 "whether or not to use subtransaction for per table migration",
+							 NULL,
+							 &synchdb_fdw_use_subtx,
+							 true,
+							 PGC_SIGHUP,
+							 0,
+							 NULL,
+							 NULL,
+							 NULL);
+
+	DefineCustomIntVariable("synchdb.tuple_locator_mem",
+							"memory budget of the hash based tuple locator used to find old tuples "
+							"on tables without replica identity or primary key index. 0 disables it",
+							NULL,
+							&synchdb_tuple_locator_mem,
+							0,
+							0,
+							MAX_KILOBYTES,
+							PGC_SIGHUP,
+							GUC_UNIT_KB,
+							NULL, NULL, NULL);
+
+	DefineCustomBoolVariable("synchdb.snapshot_defer_index_build",
+							 "drop secondary indexes of target tables during initial snapshot "
+							 "and build them once the snapshot completes",
+							 NULL,
+							 &synchdb_snapshot_defer_index_build,
+							 false,
+							 PGC_SIGHUP,
+							 0,
+							 NULL,
+							 NULL,
+							 NULL);
+
+	DefineCustomBoolVariable("synchdb.snapshot_frozen_load",
+							 "insert initial snapshot rows as pre-frozen tuples into tables that "
+							 "are created or truncated in the same transaction. Combined with "
+							 "wal_level = minimal, such loads also skip WAL",
+							 NULL,
+							 &synchdb_snapshot_frozen_load,
+							 false,
+							 PGC_SIGHUP,
+							 0,
+							 NULL,
+							 NULL,
+							 NULL);
+
+	DefineCustomIntVariable("synchdb.fdw_snapshot_workers",
+							"number of background workers that load tables concurrently during "
+							"oracle_fdw based initial snapshot. 0 loads tables serially",
+							NULL,
+							&synchdb_fdw_snapshot_workers,
+							0,
+							0,
+							1024,
+							PGC_SIGHUP,
+							0,
+							NULL, NULL, NULL);
+
+	DefineCustomIntVariable("synchdb.fdw_snapshot_split_size",
+							"size of the ROWID ranges that large Oracle tables are split into so "
+							"that several snapshot workers can load one table. Only effective "
+							"when synchdb.fdw_snapshot_workers is set. 0 never splits a table",
+							NULL,
+							&synchdb_fdw_snapshot_split_size,
+							0,
+							0,
+							INT_MAX,
+							PGC_SIGHUP,
+							GUC_UNIT_MB,
+							NULL, NULL, NULL);
+
+	DefineCustomIntVariable("synchdb.launcher_max_concurrency",
+							"max number of connectors the auto launcher starts at the same time "
+							"at server start",
+							NULL,
+							&synchdb_launcher_max_concurrency,
+							4,
+							1,
+							1024,
+							PGC_SIGHUP,
+							0,
+							NULL, NULL, NULL);
+
+	DefineCustomBoolVariable("synchdb.track_latency",
+							 "collect per connector latency histograms of the parse, convert "
+							 "and execute stages of each change event and of batch fetch and "
+							 "commit, shown in synchdb_latency_stats",
 							 NULL,
-							 &synchdb_snapshot_engine,
-							 ENGINE_DEBEZIUM,
-							 snapshot_engines,
+							 &synchdb_track_latency,
+							 true,
 							 PGC_SIGHUP,
 							 0,
 							 NULL,
 							 NULL,
 							 NULL);
 
-	DefineCustomIntVariable("synchdb.cdc_start_delay_ms",
-							"a delay after initial snapshot completes and before cdc begins",
-							NULL,
-							&cdc_start_delay_ms,
-							0,
-							0,
-							65536,
-							PGC_SIGHUP,
-							0,
-							NULL, NULL, NULL);
-
-	DefineCustomBoolVariable("synchdb.fdw_migrate_with_subtx",
-							 "whether or not to use subtransaction for per table migration",
+	DefineCustomBoolVariable("synchdb.transactional_offsets",
+							 "record the source offset reached by each applied batch in "
+							 "synchdb_offsets within the same transaction, and resume from it "
+							 "when a connector restarts",
 							 NULL,
-							 &synchdb_fdw_use_subtx,
+							 &synchdb_transactional_offsets,
 							 true,
 							 PGC_SIGHUP,
 							 0,
@@ -4075,6 +6190,17 @@ _PG_init(void)
 							 NULL,
 							 NULL);
 
+	DefineCustomStringVariable("synchdb.event_capture_dir",
+							   "directory where connector workers append every change event batch "
+							   "they receive, one file per connector, for offline replay with "
+							   "synchdb_replay_events(). Empty disables the capture",
+							   NULL,
+							   &synchdb_event_capture_dir,
+							   "",
+							   PGC_SIGHUP,
+							   0,
+							   NULL, NULL, NULL);
+
 	/* initialize data type mapping engine for all connectors */
 	fc_initFormatConverter(TYPE_MYSQL);
 	fc_initFormatConverter(TYPE_SQLSERVER);
@@ -4094,6 +6220,27 @@ _PG_init(void)
 								 NULL,
 								 NULL,
 								 NULL);
+
+		DefineCustomIntVariable("synchdb.metrics_port",
+								"TCP port on which a background worker serves the statistics of all "
+								"connectors in OpenMetrics format at /metrics. 0 disables the worker",
+								NULL,
+								&synchdb_metrics_port,
+								0,
+								0,
+								65535,
+								PGC_POSTMASTER,
+								0,
+								NULL, NULL, NULL);
+
+		DefineCustomStringVariable("synchdb.metrics_listen_address",
+								   "host name or IP address the metrics worker listens on, '*' for all",
+								   NULL,
+								   &synchdb_metrics_listen_address,
+								   "localhost",
+								   PGC_POSTMASTER,
+								   0,
+								   NULL, NULL, NULL);
 	}
 
 	MarkGUCPrefixReserved("synchdb");
@@ -4119,6 +6266,12 @@ _PG_init(void)
 	{
 		synchdb_start_leader_worker();
 	}
+
+	/* Register synchdb metrics exporter, if enabled. */
+	if (synchdb_metrics_port > 0 && process_shared_preload_libraries_in_progress)
+	{
+		synchdb_start_metrics_worker();
+	}
 }
 
 /*
@@ -4131,6 +6284,8 @@ synchdb_engine_main(Datum main_arg)
 	ConnectionInfo connInfo = {0};
 	char * snapshotMode = NULL;
 
+	INSTR_TIME_SET_CURRENT(workerStartTime);
+
 	/* extract connectorId from main_arg */
 	myConnectorId = DatumGetUInt32(main_arg);
 
@@ -4159,6 +6314,11 @@ synchdb_engine_main(Datum main_arg)
 		/* Initialize JVM */
 		initialize_jvm(&connInfo.jmx);
 
+		/* resume from the offset committed with the last applied batch */
+		if (dbz_engine_restore_offset(connectorType, &connInfo))
+			elog(WARNING, "failed to restore offset from %s, using offset file",
+					SYNCHDB_OFFSETS_TABLE);
+
 		/* read current offset and update shm */
 		memset(sdb_state->connectors[myConnectorId].dbzoffset, 0, SYNCHDB_ERRMSG_SIZE);
 		set_shm_dbz_offset(myConnectorId);
@@ -4292,8 +6452,12 @@ synchdb_engine_main(Datum main_arg)
 				set_shm_connector_errmsg(myConnectorId, "CDC not requested");
 				proc_exit(0);
 			}
-			/* read resume scn if exists */
-			if (!olr_client_init_scn_state(connectorType, connInfo.name, connInfo.dstdb))
+			/*
+			 * read resume scn if exists, preferring the one committed with the last
+			 * applied batch over the periodically flushed scn file
+			 */
+			if (!(synchdb_transactional_offsets && olr_restore_offset(connInfo.name)) &&
+				!olr_client_init_scn_state(connectorType, connInfo.name, connInfo.dstdb))
 				elog(WARNING, "scn file not flushed yet");
 			else
 			{
@@ -4366,12 +6530,514 @@ synchdb_engine_main(Datum main_arg)
 		set_shm_connector_errmsg(myConnectorId, "OLR connector is not enabled in this synchdb build.");
 		elog(ERROR, "OLR connector is not enabled in this synchdb build.");
 	}
-#endif
-	if (snapshotMode)
-		pfree(snapshotMode);
+#endif
+	if (snapshotMode)
+		pfree(snapshotMode);
+
+	elog(LOG, "synchdb worker shutting down .... ");
+	proc_exit(0);
+}
+
+/* arguments passed to a connector group worker through bgw_extra */
+typedef struct GroupWorkerArgs
+{
+	uint32		groupId;
+	int			nconnectors;
+	int			connectorIds[SYNCHDB_GROUP_MAX_CONNECTORS];
+} GroupWorkerArgs;
+
+StaticAssertDecl(sizeof(GroupWorkerArgs) <= BGW_EXTRALEN,
+				 "GroupWorkerArgs does not fit in bgw_extra");
+
+/*
+ * group_switch_to - make a group member the connector this worker acts for
+ *
+ * The functions shared with single connector workers operate on
+ * myConnectorId and the global DebeziumRunner object, so both are pointed
+ * to the member before any of them is called.
+ *
+ * @param member: The member to switch to
+ */
+static void
+group_switch_to(GroupMember * member)
+{
+	myConnectorId = member->connectorId;
+	obj = member->obj;
+}
+
+/*
+ * group_stop_member - stop the engine of one group member
+ *
+ * The member is removed from the rotation and its connector slot released
+ * so it can be started again, alone or in another group. The slot also
+ * leaves the group, so a restart of the group worker does not take it back.
+ *
+ * @param member: The member to stop, must be the current one
+ * @param state: State to leave the connector in
+ */
+static void
+group_stop_member(GroupMember * member, ConnectorState state)
+{
+	elog(WARNING, "stopping connector %s hosted by group worker", member->connInfo.name);
+
+	if (dbz_engine_stop())
+		elog(WARNING, "failed to stop dbz engine of connector %s", member->connInfo.name);
+
+	LWLockAcquire(&sdb_state->lock, LW_EXCLUSIVE);
+	sdb_state->connectors[member->connectorId].pid = InvalidPid;
+	sdb_state->connectors[member->connectorId].state = state;
+	sdb_state->connectors[member->connectorId].shared_jvm = false;
+	sdb_state->connectors[member->connectorId].group_id = 0;
+	sdb_state->connectors[member->connectorId].req.reqstate = STATE_UNDEF;
+	LWLockRelease(&sdb_state->lock);
+
+	member->active = false;
+}
+
+/*
+ * group_detach_shmem - release the connector slots of a group worker at exit
+ *
+ * The slots keep their group id, so the members are resumed if the worker is
+ * restarted after an error.
+ *
+ * @param code: exit code
+ * @param arg: not used
+ */
+static void
+group_detach_shmem(int code, Datum arg)
+{
+	int i = 0;
+
+	elog(LOG, "synchdb group worker detach shm ... code %d", code);
+
+	for (i = 0; i < groupSize; i++)
+	{
+		GroupMember * member = &groupMembers[i];
+
+		if (get_shm_connector_pid(member->connectorId) != MyProcPid)
+			continue;
+
+		group_switch_to(member);
+		if (member->obj && dbz_engine_stop())
+			elog(DEBUG1, "Failed to call dbz engine stop method");
+
+		LWLockAcquire(&sdb_state->lock, LW_EXCLUSIVE);
+		sdb_state->connectors[member->connectorId].pid = InvalidPid;
+		sdb_state->connectors[member->connectorId].state = STATE_UNDEF;
+		sdb_state->connectors[member->connectorId].shared_jvm = false;
+		LWLockRelease(&sdb_state->lock);
+	}
+
+	if (jvm != NULL)
+	{
+		(*jvm)->DestroyJavaVM(jvm);
+		jvm = NULL;
+		env = NULL;
+	}
+	if (groupSize > 0)
+		fc_deinitFormatConverter(groupMembers[0].type);
+	fc_deinitDataCache();
+}
+
+/*
+ * group_main_loop - serve the change events of all group members
+ *
+ * Each round gives every running member one getChangeEvents call, so a busy
+ * connector cannot starve the others of more than one batch. The worker only
+ * sleeps when a whole round found no batch.
+ */
+static void
+group_main_loop(void)
+{
+	int nactive = groupSize;
+	int i = 0;
+
+	while (!ShutdownRequestPending && nactive > 0)
+	{
+		bool gotbatch = false;
+
+		if (ConfigReloadPending)
+		{
+			ConfigReloadPending = false;
+			ProcessConfigFile(PGC_SIGHUP);
+		}
+
+		CHECK_FOR_INTERRUPTS();
+
+		for (i = 0; i < groupSize; i++)
+		{
+			GroupMember * member = &groupMembers[i];
+			ConnectionInfo * connInfo = &member->connInfo;
+			BatchInfo myBatchInfo = {0};
+			SynchdbStatistics myBatchStats = {0};
+
+			if (!member->active)
+				continue;
+
+			group_switch_to(member);
+
+			/* stop requests are sent to group members instead of terminating the worker */
+			if (sdb_state->connectors[myConnectorId].req.reqstate == STATE_STOPPED)
+			{
+				group_stop_member(member, STATE_UNDEF);
+				nactive--;
+				continue;
+			}
+
+			processRequestInterrupt(connInfo, member->type, myConnectorId);
+
+			switch (get_shm_connector_state_enum(myConnectorId))
+			{
+				case STATE_SYNCING:
+				{
+					myBatchInfo.batchId = SYNCHDB_INVALID_BATCH_ID;
+					dbz_engine_get_change(jvm, env, &cls, &member->obj, myConnectorId,
+							&member->dbzExitSignal, &myBatchInfo, &myBatchStats,
+							connInfo->flag);
+
+					if (myBatchInfo.batchId != SYNCHDB_INVALID_BATCH_ID)
+					{
+						dbz_mark_batch_complete(myBatchInfo.batchId);
+						increment_connector_statistics(&myBatchStats, STATS_BATCH_COMPLETION, 1);
+						set_shm_connector_statistics(myConnectorId, &myBatchStats);
+						set_shm_dbz_offset(myConnectorId);
+						dbz_autotune(myConnectorId, &myBatchInfo, &myBatchStats);
+						gotbatch = true;
+					}
+
+					if (member->dbzExitSignal)
+					{
+						elog(WARNING, "dbz shutdown signal received for connector %s",
+								connInfo->name);
+						group_stop_member(member, STATE_STOPPED);
+						nactive--;
+					}
+					break;
+				}
+				case STATE_SCHEMA_SYNC_DONE:
+				{
+					/* same transitions as main_loop for Debezium based snapshots */
+					if ((connInfo->flag & CONNFLAG_SCHEMA_SYNC_MODE))
+					{
+						connInfo->flag &= ~CONNFLAG_SCHEMA_SYNC_MODE;
+						connInfo->flag &= ~CONNFLAG_INITIAL_SNAPSHOT_MODE;
+						set_shm_connector_state(myConnectorId, STATE_PAUSED);
+						if (dbz_engine_stop())
+							elog(WARNING, "failed to stop dbz engine...");
+					}
+					else if ((connInfo->flag & CONNFLAG_INITIAL_SNAPSHOT_MODE))
+					{
+						connInfo->flag &= ~CONNFLAG_INITIAL_SNAPSHOT_MODE;
+						set_shm_connector_state(myConnectorId, STATE_SYNCING);
+					}
+					set_shm_connector_stage(myConnectorId, STAGE_CHANGE_DATA_CAPTURE);
+					break;
+				}
+				default:
+					break;
+			}
+		}
+
+		if (gotbatch)
+			continue;
+
+		(void) WaitLatch(MyLatch,
+						 WL_LATCH_SET | WL_TIMEOUT | WL_EXIT_ON_PM_DEATH,
+						 synchdb_worker_naptime,
+						 PG_WAIT_EXTENSION);
+		ResetLatch(MyLatch);
+	}
+	elog(LOG, "group worker has no running connectors left");
+}
+
+/*
+ * synchdb_engine_group_main - main routine of a connector group worker
+ *
+ * A group worker hosts several Debezium based connectors of the same type
+ * and destination database in one JVM, with one DebeziumRunner instance per
+ * connector. Each connector keeps its own slot in shared memory, so state,
+ * statistics and offsets are reported separately.
+ *
+ * @param main_arg: connector ID of the first member
+ */
+void
+synchdb_engine_group_main(Datum main_arg)
+{
+	GroupWorkerArgs args;
+	int i = 0;
+
+	INSTR_TIME_SET_CURRENT(workerStartTime);
+	memcpy(&args, MyBgworkerEntry->bgw_extra, sizeof(GroupWorkerArgs));
+
+	pqsignal(SIGTERM, SignalHandlerForShutdownRequest);
+	pqsignal(SIGHUP, SignalHandlerForConfigReload);
+	pqsignal(SIGUSR1, procsignal_sigusr1_handler);
+	BackgroundWorkerUnblockSignals();
+
+	synchdb_init_shmem();
+
+	groupMembers = MemoryContextAllocZero(TopMemoryContext,
+			sizeof(GroupMember) * args.nconnectors);
+	on_shmem_exit(group_detach_shmem, (Datum) 0);
+
+	for (i = 0; i < args.nconnectors; i++)
+	{
+		GroupMember * member = &groupMembers[groupSize];
+		int connectorId = args.connectorIds[i];
+		ActiveConnectors * slot = &sdb_state->connectors[connectorId];
+		pid_t pid = InvalidPid;
+
+		/*
+		 * when restarted, the slots are looked at again. Members stopped on
+		 * their own, and slots freed or given to other connectors since the
+		 * group was started, no longer carry the group id and are skipped.
+		 */
+		LWLockAcquire(&sdb_state->lock, LW_EXCLUSIVE);
+		if (strlen(slot->conninfo.name) == 0 || slot->group_id != args.groupId)
+		{
+			LWLockRelease(&sdb_state->lock);
+			elog(LOG, "connector slot %d has left the group, skipping it", connectorId);
+			continue;
+		}
+		pid = slot->pid;
+		if (pid == InvalidPid)
+		{
+			slot->pid = MyProcPid;
+			slot->shared_jvm = true;
+		}
+		LWLockRelease(&sdb_state->lock);
+
+		if (pid != InvalidPid)
+			ereport(ERROR,
+					(errmsg("synchdb connector %s is already running under PID %d",
+							slot->conninfo.name, (int) pid)));
+
+		member->connectorId = connectorId;
+		member->type = sdb_state->connectors[connectorId].type;
+		member->snapshotMode = MemoryContextStrdup(TopMemoryContext,
+				sdb_state->connectors[connectorId].snapshotMode);
+		memcpy(&member->connInfo, &sdb_state->connectors[connectorId].conninfo,
+				sizeof(ConnectionInfo));
+		member->connInfo.snapengine = ENGINE_DEBEZIUM;
+		member->active = true;
+		groupSize++;
+	}
+
+	/* exit without error so the worker is not restarted again */
+	if (groupSize == 0)
+	{
+		elog(LOG, "synchdb group worker has no connectors left to run");
+		proc_exit(0);
+	}
+
+	BackgroundWorkerInitializeConnection(groupMembers[0].connInfo.dstdb, NULL, 0);
+
+	fc_initFormatConverter(groupMembers[0].type);
+	fc_initDataCache();
+
+	for (i = 0; i < groupSize; i++)
+	{
+		group_switch_to(&groupMembers[i]);
+		set_shm_connector_state(myConnectorId, STATE_INITIALIZING);
+		set_shm_connector_stage(myConnectorId, STAGE_CHANGE_DATA_CAPTURE);
+		set_shm_connector_errmsg(myConnectorId, NULL);
+
+		/*
+		 * object mappings of all members share one hash, keyed by source object.
+		 * start_connector_group() only groups connectors whose rules cannot collide
+		 */
+		fc_load_objmap(groupMembers[i].connInfo.name, groupMembers[i].type);
+	}
+
+	/* one JVM for all members, JMX settings are taken from the first one */
+	myConnectorId = groupMembers[0].connectorId;
+	initialize_jvm(&groupMembers[0].connInfo.jmx);
+	groupMembers[0].obj = obj;
+
+	for (i = 0; i < groupSize; i++)
+	{
+		GroupMember * member = &groupMembers[i];
+
+		if (i > 0 && dbz_engine_init(env, &cls, &member->obj) < 0)
+		{
+			set_shm_connector_errmsg(member->connectorId, "Failed to initialize Debezium engine");
+			elog(ERROR, "Failed to initialize Debezium engine for connector %s",
+					member->connInfo.name);
+		}
+
+		group_switch_to(member);
+		if (dbz_engine_restore_offset(member->type, &member->connInfo))
+			elog(WARNING, "failed to restore offset of connector %s from %s, using offset file",
+					member->connInfo.name, SYNCHDB_OFFSETS_TABLE);
+
+		memset(sdb_state->connectors[myConnectorId].dbzoffset, 0, SYNCHDB_OFFSET_SIZE);
+		set_shm_dbz_offset(myConnectorId);
+		start_debezium_engine(member->type, &member->connInfo, member->snapshotMode);
+	}
+
+	elog(LOG, "group worker started %d %s connectors", groupSize,
+			connectorTypeToString(groupMembers[0].type));
+	group_main_loop();
+}
+
+/*
+ * start_connector_group - start several connectors in one group worker
+ *
+ * All connectors must be Debezium based, of the same type and replicate to
+ * the same database.
+ *
+ * @param names: Names of the connectors to start
+ * @param nnames: Number of names
+ */
+static void
+start_connector_group(char ** names, int nnames)
+{
+	BackgroundWorker worker;
+	BackgroundWorkerHandle *handle;
+	BgwHandleStatus status;
+	GroupWorkerArgs args = {0};
+	int			connectorIds[SYNCHDB_GROUP_MAX_CONNECTORS];
+	ConnectionInfo * connInfos;
+	ConnectorType type = TYPE_UNDEF;
+	char * connector = NULL;
+	char * conflict = NULL;
+	pid_t pid;
+	int i = 0, j = 0;
+	StringInfoData strinfo;
+
+	if (nnames < 1 || nnames > SYNCHDB_GROUP_MAX_CONNECTORS)
+		ereport(ERROR,
+				(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+				 errmsg("a connector group must have between 1 and %d connectors",
+						SYNCHDB_GROUP_MAX_CONNECTORS)));
+
+	connInfos = palloc0(sizeof(ConnectionInfo) * nnames);
+	for (i = 0; i < nnames; i++)
+	{
+		ConnectorType ctype;
+
+		if (ra_getConninfoByName(names[i], &connInfos[i], &connector))
+			ereport(ERROR,
+					(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+					 errmsg("connection name %s does not exist", names[i]),
+					 errhint("use synchdb_add_conninfo to add one first")));
+
+		ctype = fc_get_connector_type(connector);
+		if (ctype == TYPE_OLR || (ctype == TYPE_ORACLE && synchdb_snapshot_engine == ENGINE_FDW))
+			ereport(ERROR,
+					(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+					 errmsg("connector %s cannot run in a connector group", names[i]),
+					 errhint("only connectors using the Debezium engine can share a JVM")));
+
+		if (i == 0)
+			type = ctype;
+		else if (ctype != type ||
+				 strcmp(connInfos[i].dstdb, connInfos[0].dstdb) != 0)
+			ereport(ERROR,
+					(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+					 errmsg("connectors of a group must have the same type and destination database")));
+
+		for (j = 0; j < i; j++)
+		{
+			if (!strcmp(names[i], names[j]))
+				ereport(ERROR,
+						(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+						 errmsg("connector %s is listed more than once", names[i])));
+
+			/*
+			 * members share the object mapping and data caches, which are keyed
+			 * by source objects qualified with the source database
+			 */
+			if (!strcasecmp(connInfos[i].srcdb, connInfos[j].srcdb))
+				ereport(ERROR,
+						(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+						 errmsg("connectors %s and %s replicate the same source database %s",
+								names[j], names[i], connInfos[i].srcdb),
+						 errhint("run them in separate workers with synchdb_start_engine_bgw")));
+		}
+	}
+
+	conflict = ra_findGroupObjmapConflict(names, nnames);
+	if (conflict)
+		ereport(ERROR,
+				(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+				 errmsg("object mapping rules of the group members conflict: %s", conflict),
+				 errhint("group members share one set of object mapping rules")));
+
+	synchdb_init_shmem();
+	if (!sdb_state)
+		ereport(ERROR,
+				(errcode(ERRCODE_INTERNAL_ERROR),
+				 errmsg("failed to init or attach to synchdb shared memory")));
+
+	LWLockAcquire(&sdb_state->lock, LW_EXCLUSIVE);
+	if (++sdb_state->last_group_id == 0)
+		sdb_state->last_group_id = 1;
+	args.groupId = sdb_state->last_group_id;
+	LWLockRelease(&sdb_state->lock);
+
+	for (i = 0; i < nnames; i++)
+	{
+		connectorIds[i] = assign_connector_id(connInfos[i].name, connInfos[i].dstdb);
+		if (connectorIds[i] == -1)
+			ereport(ERROR,
+					(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+					 errmsg("max number of connectors reached"),
+					 errhint("use synchdb_stop_engine_bgw to stop some active connectors")));
+
+		if (get_shm_connector_pid(connectorIds[i]) != InvalidPid)
+			ereport(ERROR,
+					(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+					 errmsg("connector %s is already running", connInfos[i].name),
+					 errhint("use synchdb_stop_engine_bgw to stop it first")));
+
+		/* reserve the slot so the next assign_connector_id() picks another one */
+		save_shm_conninfo(&connInfos[i], type, connectorIds[i], "initial");
+		LWLockAcquire(&sdb_state->lock, LW_EXCLUSIVE);
+		sdb_state->connectors[connectorIds[i]].shared_jvm = true;
+		sdb_state->connectors[connectorIds[i]].group_id = args.groupId;
+		LWLockRelease(&sdb_state->lock);
+
+		args.connectorIds[i] = connectorIds[i];
+	}
+	args.nconnectors = nnames;
 
-	elog(LOG, "synchdb worker shutting down .... ");
-	proc_exit(0);
+	MemSet(&worker, 0, sizeof(BackgroundWorker));
+	worker.bgw_flags = BGWORKER_SHMEM_ACCESS |
+					   BGWORKER_BACKEND_DATABASE_CONNECTION;
+	worker.bgw_start_time = BgWorkerStart_ConsistentState;
+	if (synchdb_error_strategy == STRAT_RETRY_ON_ERROR)
+		worker.bgw_restart_time = 5;
+	else
+		worker.bgw_restart_time = BGW_NEVER_RESTART;
+	worker.bgw_notify_pid = MyProcPid;
+	worker.bgw_main_arg = UInt32GetDatum(connectorIds[0]);
+	strcpy(worker.bgw_library_name, "synchdb");
+	strcpy(worker.bgw_function_name, "synchdb_engine_group_main");
+	snprintf(worker.bgw_name, BGW_MAXLEN, "synchdb engine group: %d %s connectors -> %s",
+			nnames, connectorTypeToString(type), connInfos[0].dstdb);
+	snprintf(worker.bgw_type, BGW_MAXLEN, "synchdb engine group: %s", connectorTypeToString(type));
+	memcpy(worker.bgw_extra, &args, sizeof(GroupWorkerArgs));
+
+	if (!RegisterDynamicBackgroundWorker(&worker, &handle))
+		ereport(ERROR,
+				(errcode(ERRCODE_INSUFFICIENT_RESOURCES),
+				 errmsg("could not register background process"),
+				 errhint("You may need to increase max_worker_processes.")));
+
+	status = WaitForBackgroundWorkerStartup(handle, &pid);
+	if (status != BGWH_STARTED)
+		ereport(ERROR,
+				(errcode(ERRCODE_INSUFFICIENT_RESOURCES),
+				 errmsg("could not start background process"),
+				 errhint("More details may be available in the server log.")));
+
+	/* mark the connectors as active so they resume running at server restarts */
+	initStringInfo(&strinfo);
+	for (i = 0; i < nnames; i++)
+		appendStringInfo(&strinfo, "UPDATE synchdb_conninfo set isactive = true "
+				"WHERE name = '%s';", names[i]);
+	ra_executeCommand(strinfo.data);
 }
 
 /*
@@ -4484,12 +7150,51 @@ synchdb_start_engine_bgw_snapshot_mode(PG_FUNCTION_ARGS)
 }
 
 /*
- * synchdb_start_engine_bgw
+ * synchdb_start_engine_group
  *
- * This function starts a connector with the default initial snapshot mode
+ * This function starts the given connectors in one worker sharing one JVM
  */
 Datum
-synchdb_start_engine_bgw(PG_FUNCTION_ARGS)
+synchdb_start_engine_group(PG_FUNCTION_ARGS)
+{
+	ArrayType  *arr = PG_GETARG_ARRAYTYPE_P(0);
+	Datum	   *elems;
+	bool	   *elemnulls;
+	int			nelems = 0, i = 0;
+	char	  **names;
+
+	deconstruct_array(arr, NAMEOID, NAMEDATALEN, false, TYPALIGN_CHAR,
+					  &elems, &elemnulls, &nelems);
+
+	names = palloc0(sizeof(char *) * Max(nelems, 1));
+	for (i = 0; i < nelems; i++)
+	{
+		if (elemnulls[i])
+			ereport(ERROR,
+					(errcode(ERRCODE_NULL_VALUE_NOT_ALLOWED),
+					 errmsg("connector names must not be null")));
+		names[i] = NameStr(*DatumGetName(elems[i]));
+	}
+
+	start_connector_group(names, nelems);
+
+	PG_RETURN_INT32(0);
+}
+
+/*
+ * start_connector_worker - start a connector with the default initial snapshot mode
+ *
+ * This function registers the connector worker, waits for it to be forked and
+ * marks the connector as active.
+ *
+ * @param name: Name of the connector to start
+ * @param handlep: If not NULL, set to the handle of the started worker,
+ * allocated in the current memory context
+ *
+ * @return: the connector ID assigned to the connector
+ */
+static int
+start_connector_worker(const char * name, BackgroundWorkerHandle ** handlep)
 {
 	BackgroundWorker worker;
 	BackgroundWorkerHandle *handle;
@@ -4502,10 +7207,7 @@ synchdb_start_engine_bgw(PG_FUNCTION_ARGS)
 	/* By default, we use snapshot mode = initial */
 	char * snapshotMode = "initial";
 
-	/* Parse input arguments */
-	Name name = PG_GETARG_NAME(0);
-
-	ret = ra_getConninfoByName(NameStr(*name), &connInfo, &connector);
+	ret = ra_getConninfoByName(name, &connInfo, &connector);
 	if (ret)
 		ereport(ERROR,
 				(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
@@ -4578,13 +7280,83 @@ synchdb_start_engine_bgw(PG_FUNCTION_ARGS)
 	 */
 	initStringInfo(&strinfo);
 	appendStringInfo(&strinfo, "UPDATE synchdb_conninfo set isactive = true "
-			"WHERE name = '%s'", NameStr(*name));
+			"WHERE name = '%s'", name);
 
 	ra_executeCommand(strinfo.data);
 
+	if (handlep)
+		*handlep = handle;
+	return connectorid;
+}
+
+/*
+ * synchdb_start_engine_bgw
+ *
+ * This function starts a connector with the default initial snapshot mode
+ */
+Datum
+synchdb_start_engine_bgw(PG_FUNCTION_ARGS)
+{
+	Name name = PG_GETARG_NAME(0);
+
+	start_connector_worker(NameStr(*name), NULL);
+
 	PG_RETURN_INT32(0);
 }
 
+/*
+ * stop_connector_worker - stop a running connector
+ *
+ * A connector with its own worker is stopped by terminating the worker. A
+ * connector hosted by a group worker is sent a stop request instead, so the
+ * other connectors of the group keep running.
+ *
+ * @param connectorId: Connector ID of the connector to stop
+ * @param name: Name of the connector
+ * @param pid: PID of the worker running the connector
+ */
+static void
+stop_connector_worker(int connectorId, const char * name, pid_t pid)
+{
+	long		waited = 0;
+
+	if (!sdb_state->connectors[connectorId].shared_jvm)
+	{
+		elog(WARNING, "terminating dbz connector (%s) with pid %d. Shutdown timeout: %d ms",
+				name, (int)pid, DEBEZIUM_SHUTDOWN_TIMEOUT_MSEC);
+		DirectFunctionCall2(pg_terminate_backend, UInt32GetDatum(pid), Int64GetDatum(DEBEZIUM_SHUTDOWN_TIMEOUT_MSEC));
+		set_shm_connector_pid(connectorId, InvalidPid);
+		return;
+	}
+
+	elog(WARNING, "stopping dbz connector (%s) in group worker with pid %d. Shutdown timeout: %d ms",
+			name, (int)pid, DEBEZIUM_SHUTDOWN_TIMEOUT_MSEC);
+
+	LWLockAcquire(&sdb_state->lock, LW_EXCLUSIVE);
+	sdb_state->connectors[connectorId].req.reqstate = STATE_STOPPED;
+	LWLockRelease(&sdb_state->lock);
+
+	/* the group worker releases the connector slot once its engine has stopped */
+	while (get_shm_connector_pid(connectorId) == pid &&
+		   waited < DEBEZIUM_SHUTDOWN_TIMEOUT_MSEC)
+	{
+		(void) WaitLatch(MyLatch,
+						 WL_LATCH_SET | WL_TIMEOUT | WL_EXIT_ON_PM_DEATH,
+						 SYNCHDB_LAUNCHER_POLL_MS,
+						 PG_WAIT_EXTENSION);
+		ResetLatch(MyLatch);
+		CHECK_FOR_INTERRUPTS();
+		waited += SYNCHDB_LAUNCHER_POLL_MS;
+	}
+
+	if (get_shm_connector_pid(connectorId) == pid)
+		ereport(ERROR,
+				(errmsg("dbz connector (%s) did not stop within %d ms",
+						name, DEBEZIUM_SHUTDOWN_TIMEOUT_MSEC),
+				 errhint("the group worker with pid %d may be busy, try again later",
+						 (int)pid)));
+}
+
 /*
  * synchdb_stop_engine_bgw
  *
@@ -4595,6 +7367,7 @@ synchdb_stop_engine_bgw(PG_FUNCTION_ARGS)
 {
 	int connectorId;
 	pid_t pid;
+	bool ingroup = false;
 	StringInfoData strinfo;
 
 	/* Parse input arguments */
@@ -4628,15 +7401,29 @@ synchdb_stop_engine_bgw(PG_FUNCTION_ARGS)
 
 	ra_executeCommand(strinfo.data);
 
-	pid = get_shm_connector_pid(connectorId);
+	/*
+	 * a group member that is not running may be waiting for its group worker
+	 * to be restarted. The state is checked under the same lock that group
+	 * workers take to claim their slots, so only such a member leaves its
+	 * group here, and a member claimed in the meantime is stopped instead.
+	 */
+	LWLockAcquire(&sdb_state->lock, LW_EXCLUSIVE);
+	pid = sdb_state->connectors[connectorId].pid;
+	ingroup = sdb_state->connectors[connectorId].group_id != 0;
+	if (pid == InvalidPid && ingroup)
+		sdb_state->connectors[connectorId].group_id = 0;
+	LWLockRelease(&sdb_state->lock);
+
 	if (pid != InvalidPid)
 	{
-		elog(WARNING, "terminating dbz connector (%s) with pid %d. Shutdown timeout: %d ms",
-				NameStr(*name), (int)pid, DEBEZIUM_SHUTDOWN_TIMEOUT_MSEC);
-		DirectFunctionCall2(pg_terminate_backend, UInt32GetDatum(pid), Int64GetDatum(DEBEZIUM_SHUTDOWN_TIMEOUT_MSEC));
-		set_shm_connector_pid(connectorId, InvalidPid);
+		stop_connector_worker(connectorId, NameStr(*name), pid);
 
 	}
+	else if (ingroup)
+	{
+		elog(NOTICE, "dbz connector (%s) will not be resumed by its group worker",
+				NameStr(*name));
+	}
 	else
 	{
 		ereport(ERROR,
@@ -4683,8 +7470,8 @@ synchdb_get_state(PG_FUNCTION_ARGS)
 
 	while (*idx < count_active_connectors())
 	{
-		Datum values[7];
-		bool nulls[7] = {0};
+		Datum values[12];
+		bool nulls[12] = {0};
 		HeapTuple tuple;
 
 		/* we only want to show the connectors created in current database */
@@ -4703,6 +7490,16 @@ synchdb_get_state(PG_FUNCTION_ARGS)
 		values[4] = CStringGetTextDatum(get_shm_connector_state(*idx));
 		values[5] = CStringGetTextDatum(get_shm_connector_errmsg(*idx));
 		values[6] = CStringGetTextDatum(get_shm_dbz_offset(*idx));
+		values[7] = Int32GetDatum((int) sdb_state->connectors[*idx].jvm_startup_ms);
+		nulls[7] = (sdb_state->connectors[*idx].jvm_startup_ms == 0);
+		values[8] = Int32GetDatum((int) sdb_state->connectors[*idx].startup_ms);
+		nulls[8] = (sdb_state->connectors[*idx].startup_ms == 0);
+		values[9] = Int32GetDatum(sdb_state->connectors[*idx].batch_size);
+		nulls[9] = (sdb_state->connectors[*idx].batch_size == 0);
+		values[10] = Int32GetDatum(sdb_state->connectors[*idx].queue_kb);
+		nulls[10] = (sdb_state->connectors[*idx].queue_kb == 0);
+		values[11] = CStringGetTextDatum(sdb_state->connectors[*idx].tune_reason);
+		nulls[11] = (sdb_state->connectors[*idx].tune_reason[0] == '\0');
 		LWLockRelease(&sdb_state->lock);
 
 		*idx += 1;
@@ -4750,8 +7547,8 @@ synchdb_get_stats(PG_FUNCTION_ARGS)
 
 	while (*idx < count_active_connectors())
 	{
-		Datum values[20];
-		bool nulls[20] = {0};
+		Datum values[24];
+		bool nulls[24] = {0};
 		HeapTuple tuple;
 
 		/* we only want to show the connectors created in current database */
@@ -4786,33 +7583,198 @@ synchdb_get_stats(PG_FUNCTION_ARGS)
 		values[14] = Int64GetDatum(sdb_state->connectors[*idx].stats.genstats.stats_last_src_ts);
 		values[15] = Int64GetDatum(sdb_state->connectors[*idx].stats.genstats.stats_last_pg_ts);
 
-		/* snapshot stats */
-		values[16] = Int64GetDatum(sdb_state->connectors[*idx].stats.snapstats.snapstats_tables);
-		values[17] = Int64GetDatum(sdb_state->connectors[*idx].stats.snapstats.snapstats_rows);
-		values[18] = Int64GetDatum(sdb_state->connectors[*idx].stats.snapstats.snapstats_begintime_ts);
-		values[19] = Int64GetDatum(sdb_state->connectors[*idx].stats.snapstats.snapstats_endtime_ts);
-		LWLockRelease(&sdb_state->lock);
+		/* snapshot stats */
+		values[16] = Int64GetDatum(sdb_state->connectors[*idx].stats.snapstats.snapstats_tables);
+		values[17] = Int64GetDatum(sdb_state->connectors[*idx].stats.snapstats.snapstats_rows);
+		values[18] = Int64GetDatum(sdb_state->connectors[*idx].stats.snapstats.snapstats_begintime_ts);
+		values[19] = Int64GetDatum(sdb_state->connectors[*idx].stats.snapstats.snapstats_endtime_ts);
+
+		/* tuple locator stats */
+		values[20] = Int64GetDatum(sdb_state->connectors[*idx].stats.cdcstats.stats_locator_hit);
+		values[21] = Int64GetDatum(sdb_state->connectors[*idx].stats.cdcstats.stats_locator_miss);
+
+		/* spill stats */
+		values[22] = Int64GetDatum(sdb_state->connectors[*idx].stats.genstats.stats_spill_count);
+		values[23] = Int64GetDatum(sdb_state->connectors[*idx].stats.genstats.stats_spill_bytes);
+		LWLockRelease(&sdb_state->lock);
+
+		*idx += 1;
+
+		tuple = heap_form_tuple(funcctx->tuple_desc, values, nulls);
+		SRF_RETURN_NEXT(funcctx, HeapTupleGetDatum(tuple));
+	}
+	SRF_RETURN_DONE(funcctx);
+}
+
+/*
+ * synchdb_reset_stats
+ *
+ * This function resets the statistics information of specified connector
+ */
+Datum
+synchdb_reset_stats(PG_FUNCTION_ARGS)
+{
+	int connectorId;
+
+	/* Parse input arguments */
+	Name name = PG_GETARG_NAME(0);
+
+	/*
+	 * attach or initialize synchdb shared memory area so we know what is
+	 * going on
+	 */
+	synchdb_init_shmem();
+	if (!sdb_state)
+		ereport(ERROR,
+				(errcode(ERRCODE_INTERNAL_ERROR),
+				 errmsg("failed to init or attach to synchdb shared memory")));
+
+	connectorId = get_shm_connector_id_by_name(NameStr(*name), get_database_name(MyDatabaseId));
+	if (connectorId < 0)
+		ereport(ERROR,
+				(errmsg("dbz connector (%s) does not have connector ID assigned",
+						NameStr(*name)),
+				 errhint("use synchdb_start_engine_bgw() to assign one first")));
+
+	LWLockAcquire(&sdb_state->lock, LW_EXCLUSIVE);
+	memset(&sdb_state->connectors[connectorId].stats, 0, sizeof(SynchdbStatistics));
+	memset(&sdb_state->connectors[connectorId].latency, 0, sizeof(LatencyStatistics));
+	LWLockRelease(&sdb_state->lock);
+
+	PG_RETURN_INT32(0);
+}
+
+/*
+ * synchdb_pause_engine
+ *
+ * This function pauses a running connector
+ */
+Datum
+synchdb_pause_engine(PG_FUNCTION_ARGS)
+{
+	int connectorId = -1;
+	pid_t pid;
+	SynchdbRequest *req;
+
+	/* Parse input arguments */
+	Name name = PG_GETARG_NAME(0);
+
+	/*
+	 * attach or initialize synchdb shared memory area so we know what is
+	 * going on
+	 */
+	synchdb_init_shmem();
+	if (!sdb_state)
+		ereport(ERROR,
+				(errcode(ERRCODE_INTERNAL_ERROR),
+				 errmsg("failed to init or attach to synchdb shared memory")));
+
+	connectorId = get_shm_connector_id_by_name(NameStr(*name), get_database_name(MyDatabaseId));
+	if (connectorId < 0)
+		ereport(ERROR,
+				(errmsg("dbz connector (%s) does not have connector ID assigned",
+						NameStr(*name)),
+				 errhint("use synchdb_start_engine_bgw() to assign one first")));
+
+	pid = get_shm_connector_pid(connectorId);
+	if (pid == InvalidPid)
+		ereport(ERROR,
+				(errmsg("dbz connector (%s) is not running", NameStr(*name)),
+				 errhint("use synchdb_start_engine_bgw() to start a worker first")));
+
+	/* point to the right construct based on type */
+	req = &(sdb_state->connectors[connectorId].req);
+
+	/* an active state change request is currently in progress */
+	if (req->reqstate != STATE_UNDEF)
+		ereport(ERROR,
+				(errmsg("an active request is currently active for connector %s",
+						NameStr(*name)),
+				 errhint("wait for it to finish and try again later")));
+
+	LWLockAcquire(&sdb_state->lock, LW_EXCLUSIVE);
+	req->reqstate = STATE_PAUSED;
+	LWLockRelease(&sdb_state->lock);
+
+	elog(WARNING, "sent pause request interrupt to dbz connector %s (%d)",
+			NameStr(*name), connectorId);
+	PG_RETURN_INT32(0);
+}
+
+/*
+ * synchdb_resume_engine
+ *
+ * This function resumes a paused connector
+ */
+Datum
+synchdb_resume_engine(PG_FUNCTION_ARGS)
+{
+	int connectorId = -1;
+	pid_t pid;
+	SynchdbRequest *req;
+
+	/* Parse input arguments */
+	Name name = PG_GETARG_NAME(0);
+
+	/*
+	 * attach or initialize synchdb shared memory area so we know what is
+	 * going on
+	 */
+	synchdb_init_shmem();
+	if (!sdb_state)
+		ereport(ERROR,
+				(errcode(ERRCODE_INTERNAL_ERROR),
+				 errmsg("failed to init or attach to synchdb shared memory")));
+
+	connectorId = get_shm_connector_id_by_name(NameStr(*name), get_database_name(MyDatabaseId));
+	if (connectorId < 0)
+		ereport(ERROR,
+				(errmsg("dbz connector (%s) does not have connector ID assigned",
+						NameStr(*name)),
+				 errhint("use synchdb_start_engine_bgw() to assign one first")));
+
+	pid = get_shm_connector_pid(connectorId);
+	if (pid == InvalidPid)
+		ereport(ERROR,
+				(errmsg("dbz connector id (%s) is not running", NameStr(*name)),
+				 errhint("use synchdb_start_engine_bgw() to start a worker first")));
+
+	/* point to the right construct based on type */
+	req = &(sdb_state->connectors[connectorId].req);
 
-		*idx += 1;
+	/* an active state change request is currently in progress */
+	if (req->reqstate != STATE_UNDEF)
+		ereport(ERROR,
+				(errmsg("an active request is currently active for connector id %s",
+						NameStr(*name)),
+				 errhint("wait for it to finish and try again later")));
 
-		tuple = heap_form_tuple(funcctx->tuple_desc, values, nulls);
-		SRF_RETURN_NEXT(funcctx, HeapTupleGetDatum(tuple));
-	}
-	SRF_RETURN_DONE(funcctx);
+	LWLockAcquire(&sdb_state->lock, LW_EXCLUSIVE);
+	req->reqstate = STATE_SYNCING;
+	LWLockRelease(&sdb_state->lock);
+
+	elog(WARNING, "sent resume request interrupt to dbz connector (%s)",
+			NameStr(*name));
+	PG_RETURN_INT32(0);
 }
 
 /*
- * synchdb_reset_stats
+ * synchdb_set_offset
  *
- * This function resets the statistics information of specified connector
+ * This function sets the given offset to debezium's offset file
  */
 Datum
-synchdb_reset_stats(PG_FUNCTION_ARGS)
+synchdb_set_offset(PG_FUNCTION_ARGS)
 {
-	int connectorId;
+	pid_t pid;
+	int connectorId = -1;
+	char *offsetstr;
+	SynchdbRequest *req;
+	ConnectorState currstate;
 
 	/* Parse input arguments */
 	Name name = PG_GETARG_NAME(0);
+	offsetstr = text_to_cstring(PG_GETARG_TEXT_P(1));
 
 	/*
 	 * attach or initialize synchdb shared memory area so we know what is
@@ -4831,27 +7793,248 @@ synchdb_reset_stats(PG_FUNCTION_ARGS)
 						NameStr(*name)),
 				 errhint("use synchdb_start_engine_bgw() to assign one first")));
 
+	pid = get_shm_connector_pid(connectorId);
+	if (pid == InvalidPid)
+		ereport(ERROR,
+				(errmsg("dbz connector (%s) is not running",
+						NameStr(*name)),
+				 errhint("use synchdb_start_engine_bgw() to start a worker first")));
+
+	currstate = get_shm_connector_state_enum(connectorId);
+	if (currstate != STATE_PAUSED)
+		ereport(ERROR,
+				(errmsg("dbz connector (%s) is not in paused state.",
+						NameStr(*name)),
+				 errhint("use synchdb_pause_engine() to pause the worker first")));
+
+	/* point to the right construct based on type */
+	req = &(sdb_state->connectors[connectorId].req);
+
+	/* an active state change request is currently in progress */
+	if (req->reqstate != STATE_UNDEF)
+		ereport(ERROR,
+				(errmsg("an active request is currently active for connector %s",
+						NameStr(*name)),
+				 errhint("wait for it to finish and try again later")));
+
 	LWLockAcquire(&sdb_state->lock, LW_EXCLUSIVE);
-	memset(&sdb_state->connectors[connectorId].stats, 0, sizeof(SynchdbStatistics));
+	req->reqstate = STATE_OFFSET_UPDATE;
+	strncpy(req->reqdata, offsetstr, SYNCHDB_ERRMSG_SIZE);
 	LWLockRelease(&sdb_state->lock);
 
+	elog(WARNING, "sent update offset request interrupt to dbz connector (%s)",
+			NameStr(*name));
 	PG_RETURN_INT32(0);
 }
 
 /*
- * synchdb_pause_engine
+ * synchdb_add_conninfo
  *
- * This function pauses a running connector
+ * This function adds a connector info to system
  */
 Datum
-synchdb_pause_engine(PG_FUNCTION_ARGS)
+synchdb_add_conninfo(PG_FUNCTION_ARGS)
 {
-	int connectorId = -1;
+	Name name = PG_GETARG_NAME(0);
+	text *hostname_text = PG_GETARG_TEXT_PP(1);
+	unsigned int port = PG_GETARG_UINT32(2);
+	text *user_text = PG_GETARG_TEXT_PP(3);
+	text *pwd_text = PG_GETARG_TEXT_PP(4);
+	text *src_db_text = PG_GETARG_TEXT_PP(5);
+	text *dst_db_text = PG_GETARG_TEXT_PP(6);
+	text *table_text = PG_GETARG_TEXT_PP(7);
+	text *snapshottable_text = PG_GETARG_TEXT_PP(8);
+	text *connector_text = PG_GETARG_TEXT_PP(9);
+	char *connector = NULL;
+
+	ConnectionInfo connInfo = {0};
+	StringInfoData strinfo;
+	initStringInfo(&strinfo);
+
+	strlcpy(connInfo.name, NameStr(*name), SYNCHDB_CONNINFO_NAME_SIZE);
+
+	/* Sanity check on input arguments */
+	if (VARSIZE(hostname_text) - VARHDRSZ == 0 ||
+			VARSIZE(hostname_text) - VARHDRSZ > SYNCHDB_CONNINFO_HOSTNAME_SIZE)
+	{
+		ereport(ERROR,
+				(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+				 errmsg("hostname cannot be empty or longer than %d",
+						 SYNCHDB_CONNINFO_HOSTNAME_SIZE)));
+	}
+	strlcpy(connInfo.hostname, text_to_cstring(hostname_text), SYNCHDB_CONNINFO_HOSTNAME_SIZE);
+
+	connInfo.port = port;
+	if (connInfo.port == 0 || connInfo.port > 65535)
+	{
+		ereport(ERROR,
+				(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+				 errmsg("invalid port number")));
+	}
+
+	if (VARSIZE(user_text) - VARHDRSZ == 0 ||
+			VARSIZE(user_text) - VARHDRSZ > SYNCHDB_CONNINFO_USERNAME_SIZE)
+	{
+		ereport(ERROR,
+				(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+				 errmsg("username cannot be empty or longer than %d",
+						 SYNCHDB_CONNINFO_USERNAME_SIZE)));
+	}
+	strlcpy(connInfo.user, text_to_cstring(user_text), SYNCHDB_CONNINFO_USERNAME_SIZE);
+
+	if (VARSIZE(pwd_text) - VARHDRSZ == 0 ||
+			VARSIZE(pwd_text) - VARHDRSZ > SYNCHDB_CONNINFO_PASSWORD_SIZE)
+	{
+		ereport(ERROR,
+				(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+				 errmsg("password cannot be empty or longer than %d",
+						 SYNCHDB_CONNINFO_PASSWORD_SIZE)));
+	}
+	strlcpy(connInfo.pwd, text_to_cstring(pwd_text), SYNCHDB_CONNINFO_PASSWORD_SIZE);
+
+	/* source database can be empty or NULL */
+	if (VARSIZE(src_db_text) - VARHDRSZ == 0)
+		strlcpy(connInfo.srcdb, "null", SYNCHDB_CONNINFO_DB_NAME_SIZE);
+	else if (VARSIZE(src_db_text) - VARHDRSZ > SYNCHDB_CONNINFO_DB_NAME_SIZE)
+		ereport(ERROR,
+				(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+				 errmsg("source database cannot be longer than %d",
+						 SYNCHDB_CONNINFO_DB_NAME_SIZE)));
+	else
+		strlcpy(connInfo.srcdb, text_to_cstring(src_db_text), SYNCHDB_CONNINFO_DB_NAME_SIZE);
+
+	if (VARSIZE(dst_db_text) - VARHDRSZ == 0 ||
+			VARSIZE(dst_db_text) - VARHDRSZ > SYNCHDB_CONNINFO_DB_NAME_SIZE)
+	{
+		ereport(ERROR,
+				(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+				 errmsg("destination database cannot be empty or longer than %d",
+						 SYNCHDB_CONNINFO_DB_NAME_SIZE)));
+	}
+
+	if (strcasecmp(text_to_cstring(dst_db_text), get_database_name(MyDatabaseId)))
+	{
+		elog(WARNING, "adjusting destination database from %s to the current database %s",
+				text_to_cstring(dst_db_text),
+				get_database_name(MyDatabaseId));
+		strlcpy(connInfo.dstdb, get_database_name(MyDatabaseId), SYNCHDB_CONNINFO_DB_NAME_SIZE);
+	}
+	else
+		strlcpy(connInfo.dstdb, text_to_cstring(dst_db_text), SYNCHDB_CONNINFO_DB_NAME_SIZE);
+
+	/* table can be empty or NULL */
+	if (VARSIZE(table_text) - VARHDRSZ == 0)
+		strlcpy(connInfo.table, "null", SYNCHDB_CONNINFO_TABLELIST_SIZE);
+	else if (VARSIZE(table_text) - VARHDRSZ > SYNCHDB_CONNINFO_TABLELIST_SIZE)
+		ereport(ERROR,
+				(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+				 errmsg("table list cannot be longer than %d",
+						 SYNCHDB_CONNINFO_TABLELIST_SIZE)));
+	else
+		strlcpy(connInfo.table, text_to_cstring(table_text), SYNCHDB_CONNINFO_TABLELIST_SIZE);
+
+	/* snapshot table can be empty or NULL */
+	if (VARSIZE(snapshottable_text) - VARHDRSZ == 0)
+		strlcpy(connInfo.snapshottable, "null", SYNCHDB_CONNINFO_TABLELIST_SIZE);
+	else if (VARSIZE(snapshottable_text) - VARHDRSZ > SYNCHDB_CONNINFO_TABLELIST_SIZE)
+		ereport(ERROR,
+				(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+				 errmsg("snapshot table cannot be longer than %d",
+						 SYNCHDB_CONNINFO_TABLELIST_SIZE)));
+	else
+		strlcpy(connInfo.snapshottable, text_to_cstring(snapshottable_text),
+				SYNCHDB_CONNINFO_TABLELIST_SIZE);
+
+	if (VARSIZE(connector_text) - VARHDRSZ == 0)
+	{
+		ereport(ERROR,
+				(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+				 errmsg("connector type cannot be empty")));
+	}
+	connector = text_to_cstring(connector_text);
+
+#ifdef WITH_OLR
+	if (strcasecmp(connector, "mysql") && strcasecmp(connector, "sqlserver")
+			&& strcasecmp(connector, "oracle") && strcasecmp(connector, "olr"))
+		ereport(ERROR,
+				(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+				 errmsg("unsupported connector")));
+#else
+	if (strcasecmp(connector, "mysql") && strcasecmp(connector, "sqlserver")
+			&& strcasecmp(connector, "oracle"))
+		ereport(ERROR,
+				(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+				 errmsg("unsupported connector")));
+#endif
+
+	appendStringInfo(&strinfo, "INSERT INTO %s (name, isactive, data)"
+			" VALUES ('%s', %s, jsonb_build_object("
+			"'hostname', '%s', "
+			"'port', %d, "
+			"'user', '%s', "
+			"'pwd', pgp_sym_encrypt('%s', '%s'), "
+			"'srcdb', '%s', "
+			"'dstdb', '%s', "
+			"'table', (CASE WHEN '%s' = 'null' THEN null ELSE '%s' END), "
+			"'snapshottable', (CASE WHEN '%s' = 'null' THEN null ELSE '%s' END), "
+			"'connector', '%s'));",
+			SYNCHDB_CONNINFO_TABLE,
+			connInfo.name,
+			"false",
+			connInfo.hostname,
+			connInfo.port,
+			connInfo.user,
+			connInfo.pwd,
+			SYNCHDB_SECRET,
+			connInfo.srcdb,
+			connInfo.dstdb,
+			connInfo.table,
+			connInfo.table,
+			connInfo.snapshottable,
+			connInfo.snapshottable,
+			connector);
+
+	PG_RETURN_INT32(ra_executeCommand(strinfo.data));
+}
+
+/*
+ * synchdb_restart_connector
+ *
+ * This function restarts a connector with given snapshot mode
+ */
+Datum
+synchdb_restart_connector(PG_FUNCTION_ARGS)
+{
+	Name name = PG_GETARG_NAME(0);
+	Name snapshot_mode = PG_GETARG_NAME(1);
+	ConnectionInfo connInfo;
+	int ret = -1, connectorId = -1;
 	pid_t pid;
+	char * _snapshot_mode;
+	char *connector = NULL;
+
 	SynchdbRequest *req;
 
-	/* Parse input arguments */
-	Name name = PG_GETARG_NAME(0);
+	/* Sanity check on input arguments */
+	if (VARSIZE(name_text) - VARHDRSZ == 0)
+	{
+		ereport(ERROR,
+				(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+				 errmsg("connection name cannot be empty")));
+	}
+
+	/* snapshot_mode can be empty or NULL */
+	if (strlen(NameStr(*snapshot_mode)) == 0)
+		_snapshot_mode = "null";
+	else
+		_snapshot_mode = NameStr(*snapshot_mode);
+
+	ret = ra_getConninfoByName(NameStr(*name), &connInfo, &connector);
+	if (ret)
+		ereport(ERROR,
+				(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+				 errmsg("connection name does not exist"),
+				 errhint("use synchdb_add_conninfo to add one first")));
 
 	/*
 	 * attach or initialize synchdb shared memory area so we know what is
@@ -4873,7 +8056,8 @@ synchdb_pause_engine(PG_FUNCTION_ARGS)
 	pid = get_shm_connector_pid(connectorId);
 	if (pid == InvalidPid)
 		ereport(ERROR,
-				(errmsg("dbz connector (%s) is not running", NameStr(*name)),
+				(errmsg("dbz connector (%s) is not running",
+						NameStr(*name)),
 				 errhint("use synchdb_start_engine_bgw() to start a worker first")));
 
 	/* point to the right construct based on type */
@@ -4886,22 +8070,36 @@ synchdb_pause_engine(PG_FUNCTION_ARGS)
 						NameStr(*name)),
 				 errhint("wait for it to finish and try again later")));
 
+	/*
+	 * connector info may have been changed, so let's pass the latest conninfo
+	 * to the connector worker in the same way as synchdb_start_engine_bgw()
+	 */
 	LWLockAcquire(&sdb_state->lock, LW_EXCLUSIVE);
-	req->reqstate = STATE_PAUSED;
+	req->reqstate = STATE_RESTARTING;
+
+	/* reqdata contains snapshot mode */
+	memset(req->reqdata, 0, SYNCHDB_ERRMSG_SIZE);
+	snprintf(req->reqdata, SYNCHDB_ERRMSG_SIZE,"%s", _snapshot_mode);
+
+	/*
+	 * reqconninfo contains a copy of conninfo recently read in case it has been
+	 * changed since connector start
+	 */
+	memcpy(&req->reqconninfo, &connInfo, sizeof(ConnectionInfo));
 	LWLockRelease(&sdb_state->lock);
 
-	elog(WARNING, "sent pause request interrupt to dbz connector %s (%d)",
-			NameStr(*name), connectorId);
+	elog(WARNING, "sent restart request interrupt to dbz connector (%s)",
+			NameStr(*name));
 	PG_RETURN_INT32(0);
 }
 
 /*
- * synchdb_resume_engine
+ * synchdb_log_jvm_meminfo
  *
- * This function resumes a paused connector
+ * This function dumps JVM memory usage info in PostgreSQL log
  */
 Datum
-synchdb_resume_engine(PG_FUNCTION_ARGS)
+synchdb_log_jvm_meminfo(PG_FUNCTION_ARGS)
 {
 	int connectorId = -1;
 	pid_t pid;
@@ -4930,7 +8128,7 @@ synchdb_resume_engine(PG_FUNCTION_ARGS)
 	pid = get_shm_connector_pid(connectorId);
 	if (pid == InvalidPid)
 		ereport(ERROR,
-				(errmsg("dbz connector id (%s) is not running", NameStr(*name)),
+				(errmsg("dbz connector (%s) is not running", NameStr(*name)),
 				 errhint("use synchdb_start_engine_bgw() to start a worker first")));
 
 	/* point to the right construct based on type */
@@ -4939,36 +8137,77 @@ synchdb_resume_engine(PG_FUNCTION_ARGS)
 	/* an active state change request is currently in progress */
 	if (req->reqstate != STATE_UNDEF)
 		ereport(ERROR,
-				(errmsg("an active request is currently active for connector id %s",
+				(errmsg("an active request is currently active for connector %s",
 						NameStr(*name)),
 				 errhint("wait for it to finish and try again later")));
 
 	LWLockAcquire(&sdb_state->lock, LW_EXCLUSIVE);
-	req->reqstate = STATE_SYNCING;
+	req->reqstate = STATE_MEMDUMP;
 	LWLockRelease(&sdb_state->lock);
 
-	elog(WARNING, "sent resume request interrupt to dbz connector (%s)",
-			NameStr(*name));
+	elog(WARNING, "sent memdump request interrupt to dbz connector %s (%d)",
+			NameStr(*name), connectorId);
 	PG_RETURN_INT32(0);
 }
 
+Datum
+synchdb_add_objmap(PG_FUNCTION_ARGS)
+{
+	/* Parse input arguments */
+	Name name = PG_GETARG_NAME(0);
+	Name objtype = PG_GETARG_NAME(1);
+	Name srcobj = PG_GETARG_NAME(2);
+	text * dstobj = PG_GETARG_TEXT_PP(3);
+
+	StringInfoData strinfo;
+	initStringInfo(&strinfo);
+	/*
+	 * attach or initialize synchdb shared memory area so we know what is
+	 * going on
+	 */
+	synchdb_init_shmem();
+	if (!sdb_state)
+		ereport(ERROR,
+				(errcode(ERRCODE_INTERNAL_ERROR),
+				 errmsg("failed to init or attach to synchdb shared memory")));
+
+	if (strcasecmp(NameStr(*objtype), "table") && strcasecmp(NameStr(*objtype), "column") &&
+		strcasecmp(NameStr(*objtype), "datatype") && strcasecmp(NameStr(*objtype), "transform"))
+	{
+		ereport(ERROR,
+				(errcode(ERRCODE_INTERNAL_ERROR),
+				 errmsg("unsupported object type %s", NameStr(*objtype))));
+	}
+	appendStringInfo(&strinfo, "INSERT INTO %s (name, objtype, enabled, srcobj, dstobj)"
+			" VALUES (trim(lower('%s')), trim(lower('%s')), true, trim(lower('%s')), '%s')",
+			SYNCHDB_OBJECT_MAPPING_TABLE,
+			NameStr(*name),
+			NameStr(*objtype),
+			NameStr(*srcobj),
+			escapeSingleQuote(text_to_cstring(dstobj), false));
+
+	appendStringInfo(&strinfo, " ON CONFLICT(name, objtype, srcobj) "
+			"DO UPDATE SET "
+			"enabled = EXCLUDED.enabled,"
+			"dstobj = EXCLUDED.dstobj;");
+
+	PG_RETURN_INT32(ra_executeCommand(strinfo.data));
+}
+
 /*
- * synchdb_set_offset
+ * synchdb_reload_objmap
  *
- * This function sets the given offset to debezium's offset file
+ * This function forces a connector to reload objmap table entries
  */
 Datum
-synchdb_set_offset(PG_FUNCTION_ARGS)
+synchdb_reload_objmap(PG_FUNCTION_ARGS)
 {
-	pid_t pid;
 	int connectorId = -1;
-	char *offsetstr;
+	pid_t pid;
 	SynchdbRequest *req;
-	ConnectorState currstate;
 
 	/* Parse input arguments */
 	Name name = PG_GETARG_NAME(0);
-	offsetstr = text_to_cstring(PG_GETARG_TEXT_P(1));
 
 	/*
 	 * attach or initialize synchdb shared memory area so we know what is
@@ -4990,17 +8229,9 @@ synchdb_set_offset(PG_FUNCTION_ARGS)
 	pid = get_shm_connector_pid(connectorId);
 	if (pid == InvalidPid)
 		ereport(ERROR,
-				(errmsg("dbz connector (%s) is not running",
-						NameStr(*name)),
+				(errmsg("dbz connector (%s) is not running", NameStr(*name)),
 				 errhint("use synchdb_start_engine_bgw() to start a worker first")));
 
-	currstate = get_shm_connector_state_enum(connectorId);
-	if (currstate != STATE_PAUSED)
-		ereport(ERROR,
-				(errmsg("dbz connector (%s) is not in paused state.",
-						NameStr(*name)),
-				 errhint("use synchdb_pause_engine() to pause the worker first")));
-
 	/* point to the right construct based on type */
 	req = &(sdb_state->connectors[connectorId].req);
 
@@ -5012,1228 +8243,1628 @@ synchdb_set_offset(PG_FUNCTION_ARGS)
 				 errhint("wait for it to finish and try again later")));
 
 	LWLockAcquire(&sdb_state->lock, LW_EXCLUSIVE);
-	req->reqstate = STATE_OFFSET_UPDATE;
-	strncpy(req->reqdata, offsetstr, SYNCHDB_ERRMSG_SIZE);
+	req->reqstate = STATE_RELOAD_OBJMAP;
 	LWLockRelease(&sdb_state->lock);
 
-	elog(WARNING, "sent update offset request interrupt to dbz connector (%s)",
-			NameStr(*name));
+	elog(WARNING, "sent reload objmap request interrupt to dbz connector %s (%d)",
+			NameStr(*name), connectorId);
 	PG_RETURN_INT32(0);
 }
 
 /*
- * synchdb_add_conninfo
+ * synchdb_add_extra_conninfo
  *
- * This function adds a connector info to system
+ * This function configures extra connector parameters and stores them to synchdb_conninfo table
  */
 Datum
-synchdb_add_conninfo(PG_FUNCTION_ARGS)
+synchdb_add_extra_conninfo(PG_FUNCTION_ARGS)
 {
 	Name name = PG_GETARG_NAME(0);
-	text *hostname_text = PG_GETARG_TEXT_PP(1);
-	unsigned int port = PG_GETARG_UINT32(2);
-	text *user_text = PG_GETARG_TEXT_PP(3);
-	text *pwd_text = PG_GETARG_TEXT_PP(4);
-	text *src_db_text = PG_GETARG_TEXT_PP(5);
-	text *dst_db_text = PG_GETARG_TEXT_PP(6);
-	text *table_text = PG_GETARG_TEXT_PP(7);
-	text *snapshottable_text = PG_GETARG_TEXT_PP(8);
-	text *connector_text = PG_GETARG_TEXT_PP(9);
-	char *connector = NULL;
+	Name sslmode = PG_GETARG_NAME(1);
+	text * ssl_keystore_text = PG_GETARG_TEXT_PP(2);
+	text * ssl_keystore_pass_text = PG_GETARG_TEXT_PP(3);
+	text * ssl_truststore_text = PG_GETARG_TEXT_PP(4);
+	text * ssl_truststore_pass_text = PG_GETARG_TEXT_PP(5);
+
+	ExtraConnectionInfo extraconninfo = {0};
+	StringInfoData strinfo;
+	initStringInfo(&strinfo);
+
+	strlcpy(extraconninfo.ssl_mode, NameStr(*sslmode), SYNCHDB_CONNINFO_NAME_SIZE);
+
+	if (VARSIZE(ssl_keystore_text) - VARHDRSZ == 0)
+		strlcpy(extraconninfo.ssl_keystore, "null", SYNCHDB_CONNINFO_KEYSTORE_SIZE);
+	else if (VARSIZE(ssl_keystore_text) - VARHDRSZ > SYNCHDB_CONNINFO_KEYSTORE_SIZE)
+		ereport(ERROR,
+				(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+				 errmsg("ssl_keystore cannot be longer than %d",
+						 SYNCHDB_CONNINFO_KEYSTORE_SIZE)));
+	else
+		strlcpy(extraconninfo.ssl_keystore, text_to_cstring(ssl_keystore_text), SYNCHDB_CONNINFO_KEYSTORE_SIZE);
+
+	if (VARSIZE(ssl_keystore_pass_text) - VARHDRSZ == 0)
+		strlcpy(extraconninfo.ssl_keystore_pass, "null", SYNCHDB_CONNINFO_PASSWORD_SIZE);
+	else if (VARSIZE(ssl_keystore_pass_text) - VARHDRSZ > SYNCHDB_CONNINFO_PASSWORD_SIZE)
+		ereport(ERROR,
+				(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+				 errmsg("ssl_keystore_pass cannot be longer than %d",
+						 SYNCHDB_CONNINFO_PASSWORD_SIZE)));
+	else
+		strlcpy(extraconninfo.ssl_keystore_pass, text_to_cstring(ssl_keystore_pass_text), SYNCHDB_CONNINFO_PASSWORD_SIZE);
+
+	if (VARSIZE(ssl_truststore_text) - VARHDRSZ == 0)
+		strlcpy(extraconninfo.ssl_truststore, "null", SYNCHDB_CONNINFO_KEYSTORE_SIZE);
+	else if (VARSIZE(ssl_truststore_text) - VARHDRSZ > SYNCHDB_CONNINFO_KEYSTORE_SIZE)
+		ereport(ERROR,
+				(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+				 errmsg("ssl_truststore cannot be longer than %d",
+						 SYNCHDB_CONNINFO_KEYSTORE_SIZE)));
+	else
+		strlcpy(extraconninfo.ssl_truststore, text_to_cstring(ssl_truststore_text), SYNCHDB_CONNINFO_KEYSTORE_SIZE);
+
+	if (VARSIZE(ssl_truststore_pass_text) - VARHDRSZ == 0)
+		strlcpy(extraconninfo.ssl_truststore_pass, "null", SYNCHDB_CONNINFO_PASSWORD_SIZE);
+	else if (VARSIZE(ssl_truststore_pass_text) - VARHDRSZ > SYNCHDB_CONNINFO_PASSWORD_SIZE)
+		ereport(ERROR,
+				(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+				 errmsg("ssl_truststore_pass cannot be longer than %d",
+						 SYNCHDB_CONNINFO_PASSWORD_SIZE)));
+	else
+		strlcpy(extraconninfo.ssl_truststore_pass, text_to_cstring(ssl_truststore_pass_text), SYNCHDB_CONNINFO_PASSWORD_SIZE);
+
+	appendStringInfo(&strinfo, "UPDATE %s SET data = data || json_build_object("
+			"'ssl_mode', '%s', "
+			"'ssl_keystore',  (CASE WHEN '%s' = 'null' THEN null ELSE '%s' END), "
+			"'ssl_keystore_pass', (CASE WHEN '%s' = 'null' THEN null ELSE pgp_sym_encrypt('%s', '%s') END), "
+			"'ssl_truststore', (CASE WHEN '%s' = 'null' THEN null ELSE '%s' END), "
+			"'ssl_truststore_pass', (CASE WHEN '%s' = 'null' THEN null ELSE pgp_sym_encrypt('%s', '%s') END))::jsonb "
+			"WHERE name = '%s'",
+			SYNCHDB_CONNINFO_TABLE,
+			extraconninfo.ssl_mode,
+			extraconninfo.ssl_keystore,
+			extraconninfo.ssl_keystore,
+			extraconninfo.ssl_keystore_pass,
+			extraconninfo.ssl_keystore_pass,
+			SYNCHDB_SECRET,
+			extraconninfo.ssl_truststore,
+			extraconninfo.ssl_truststore,
+			extraconninfo.ssl_truststore_pass,
+			extraconninfo.ssl_truststore_pass,
+			SYNCHDB_SECRET,
+			NameStr(*name));
+
+	PG_RETURN_INT32(ra_executeCommand(strinfo.data));
+}
+
+/*
+ * synchdb_del_extra_conninfo
+ *
+ * This function deletes all extra connector parameters created by synchdb_add_extra_conninfo()
+ */
+Datum
+synchdb_del_extra_conninfo(PG_FUNCTION_ARGS)
+{
+	Name name = PG_GETARG_NAME(0);
+	StringInfoData strinfo;
+	initStringInfo(&strinfo);
+
+	appendStringInfo(&strinfo, "UPDATE %s SET data = data - ARRAY["
+			"'ssl_mode', "
+			"'ssl_keystore', "
+			"'ssl_keystore_pass', "
+			"'ssl_truststore', "
+			"'ssl_truststore_pass'] "
+			"WHERE name = '%s'",
+			SYNCHDB_CONNINFO_TABLE,
+			NameStr(*name));
+	PG_RETURN_INT32(ra_executeCommand(strinfo.data));
+}
+
+/*
+ * synchdb_add_jmx_conninfo
+ *
+ * This function configures extra JMX related parameters to a connector
+ */
+Datum
+synchdb_add_jmx_conninfo(PG_FUNCTION_ARGS)
+{
+	Name name = PG_GETARG_NAME(0);
+
+	/* jmx and rmi server addresses and ports (for jconsole and similar) */
+	text * jmx_listenaddr_text = PG_GETARG_TEXT_PP(1);
+	unsigned int jmx_port = PG_GETARG_UINT32(2);
+	text * jmx_rmiserver_text = PG_GETARG_TEXT_PP(3);
+	unsigned int jmx_rmiport = PG_GETARG_UINT32(4);
 
-	ConnectionInfo connInfo = {0};
+	/* jmx authentication options */
+	bool jmx_authenticate = PG_GETARG_BOOL(5);
+	text * jmx_passwdfile_text = PG_GETARG_TEXT_PP(6);
+	text * jmx_accessfile_text = PG_GETARG_TEXT_PP(7);
+
+	/* jmx ssl options */
+	bool jmx_ssl = PG_GETARG_BOOL(8);
+	text * jmx_keystore_text = PG_GETARG_TEXT_PP(9);
+	text * jmx_keystore_pass_text = PG_GETARG_TEXT_PP(10);
+	text * jmx_truststore_text = PG_GETARG_TEXT_PP(11);
+	text * jmx_truststore_pass_text = PG_GETARG_TEXT_PP(12);
+
+	JMXConnectionInfo jmxconninfo = {0};
 	StringInfoData strinfo;
 	initStringInfo(&strinfo);
 
-	strlcpy(connInfo.name, NameStr(*name), SYNCHDB_CONNINFO_NAME_SIZE);
-
-	/* Sanity check on input arguments */
-	if (VARSIZE(hostname_text) - VARHDRSZ == 0 ||
-			VARSIZE(hostname_text) - VARHDRSZ > SYNCHDB_CONNINFO_HOSTNAME_SIZE)
+	if (VARSIZE(jmx_listenaddr_text) - VARHDRSZ == 0 ||
+			VARSIZE(jmx_listenaddr_text) - VARHDRSZ > SYNCHDB_CONNINFO_HOSTNAME_SIZE)
 	{
 		ereport(ERROR,
 				(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
-				 errmsg("hostname cannot be empty or longer than %d",
+				 errmsg("jmx listen address cannot be empty or longer than %d",
 						 SYNCHDB_CONNINFO_HOSTNAME_SIZE)));
 	}
-	strlcpy(connInfo.hostname, text_to_cstring(hostname_text), SYNCHDB_CONNINFO_HOSTNAME_SIZE);
+	strlcpy(jmxconninfo.jmx_listenaddr, text_to_cstring(jmx_listenaddr_text), SYNCHDB_CONNINFO_HOSTNAME_SIZE);
 
-	connInfo.port = port;
-	if (connInfo.port == 0 || connInfo.port > 65535)
+	jmxconninfo.jmx_port = jmx_port;
+	if (jmxconninfo.jmx_port == 0 || jmxconninfo.jmx_port > 65535)
 	{
 		ereport(ERROR,
 				(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
 				 errmsg("invalid port number")));
 	}
 
-	if (VARSIZE(user_text) - VARHDRSZ == 0 ||
-			VARSIZE(user_text) - VARHDRSZ > SYNCHDB_CONNINFO_USERNAME_SIZE)
+	if (VARSIZE(jmx_rmiserver_text) - VARHDRSZ == 0 ||
+			VARSIZE(jmx_rmiserver_text) - VARHDRSZ > SYNCHDB_CONNINFO_HOSTNAME_SIZE)
 	{
 		ereport(ERROR,
 				(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
-				 errmsg("username cannot be empty or longer than %d",
-						 SYNCHDB_CONNINFO_USERNAME_SIZE)));
+				 errmsg("jmx rmi server address cannot be empty or longer than %d",
+						 SYNCHDB_CONNINFO_HOSTNAME_SIZE)));
 	}
-	strlcpy(connInfo.user, text_to_cstring(user_text), SYNCHDB_CONNINFO_USERNAME_SIZE);
+	strlcpy(jmxconninfo.jmx_rmiserveraddr, text_to_cstring(jmx_rmiserver_text), SYNCHDB_CONNINFO_HOSTNAME_SIZE);
 
-	if (VARSIZE(pwd_text) - VARHDRSZ == 0 ||
-			VARSIZE(pwd_text) - VARHDRSZ > SYNCHDB_CONNINFO_PASSWORD_SIZE)
+	jmxconninfo.jmx_rmiport = jmx_rmiport;
+	if (jmxconninfo.jmx_rmiport == 0 || jmxconninfo.jmx_rmiport > 65535)
 	{
 		ereport(ERROR,
 				(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
-				 errmsg("password cannot be empty or longer than %d",
-						 SYNCHDB_CONNINFO_PASSWORD_SIZE)));
+				 errmsg("invalid port number")));
 	}
-	strlcpy(connInfo.pwd, text_to_cstring(pwd_text), SYNCHDB_CONNINFO_PASSWORD_SIZE);
 
-	/* source database can be empty or NULL */
-	if (VARSIZE(src_db_text) - VARHDRSZ == 0)
-		strlcpy(connInfo.srcdb, "null", SYNCHDB_CONNINFO_DB_NAME_SIZE);
-	else if (VARSIZE(src_db_text) - VARHDRSZ > SYNCHDB_CONNINFO_DB_NAME_SIZE)
-		ereport(ERROR,
-				(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
-				 errmsg("source database cannot be longer than %d",
-						 SYNCHDB_CONNINFO_DB_NAME_SIZE)));
-	else
-		strlcpy(connInfo.srcdb, text_to_cstring(src_db_text), SYNCHDB_CONNINFO_DB_NAME_SIZE);
+	jmxconninfo.jmx_auth = jmx_authenticate;
+	if (jmxconninfo.jmx_auth)
+	{
+		if (VARSIZE(jmx_passwdfile_text) - VARHDRSZ == 0 ||
+				VARSIZE(jmx_passwdfile_text) - VARHDRSZ > SYNCHDB_METADATA_PATH_SIZE)
+		{
+			ereport(ERROR,
+					(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+					 errmsg("jmx auth password file cannot be empty or longer than %d",
+							 SYNCHDB_METADATA_PATH_SIZE)));
+		}
+		strlcpy(jmxconninfo.jmx_auth_passwdfile, text_to_cstring(jmx_passwdfile_text), SYNCHDB_METADATA_PATH_SIZE);
 
-	if (VARSIZE(dst_db_text) - VARHDRSZ == 0 ||
-			VARSIZE(dst_db_text) - VARHDRSZ > SYNCHDB_CONNINFO_DB_NAME_SIZE)
+		if (VARSIZE(jmx_accessfile_text) - VARHDRSZ == 0 ||
+				VARSIZE(jmx_accessfile_text) - VARHDRSZ > SYNCHDB_METADATA_PATH_SIZE)
+		{
+			ereport(ERROR,
+					(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+					 errmsg("jmx auth password file cannot be empty or longer than %d",
+							 SYNCHDB_METADATA_PATH_SIZE)));
+		}
+		strlcpy(jmxconninfo.jmx_auth_accessfile, text_to_cstring(jmx_accessfile_text), SYNCHDB_METADATA_PATH_SIZE);
+	}
+	else
 	{
-		ereport(ERROR,
-				(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
-				 errmsg("destination database cannot be empty or longer than %d",
-						 SYNCHDB_CONNINFO_DB_NAME_SIZE)));
+		strlcpy(jmxconninfo.jmx_auth_passwdfile, "null", SYNCHDB_METADATA_PATH_SIZE);
+		strlcpy(jmxconninfo.jmx_auth_accessfile, "null", SYNCHDB_METADATA_PATH_SIZE);
 	}
 
-	if (strcasecmp(text_to_cstring(dst_db_text), get_database_name(MyDatabaseId)))
+	jmxconninfo.jmx_ssl = jmx_ssl;
+	if (jmxconninfo.jmx_ssl)
 	{
-		elog(WARNING, "adjusting destination database from %s to the current database %s",
-				text_to_cstring(dst_db_text),
-				get_database_name(MyDatabaseId));
-		strlcpy(connInfo.dstdb, get_database_name(MyDatabaseId), SYNCHDB_CONNINFO_DB_NAME_SIZE);
-	}
-	else
-		strlcpy(connInfo.dstdb, text_to_cstring(dst_db_text), SYNCHDB_CONNINFO_DB_NAME_SIZE);
+		if (VARSIZE(jmx_keystore_text) - VARHDRSZ == 0)
+			strlcpy(jmxconninfo.jmx_ssl_keystore, "null", SYNCHDB_CONNINFO_KEYSTORE_SIZE);
+		else if (VARSIZE(jmx_keystore_text) - VARHDRSZ > SYNCHDB_CONNINFO_KEYSTORE_SIZE)
+			ereport(ERROR,
+					(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+					 errmsg("ssl_keystore cannot be longer than %d",
+							 SYNCHDB_CONNINFO_KEYSTORE_SIZE)));
+		else
+			strlcpy(jmxconninfo.jmx_ssl_keystore, text_to_cstring(jmx_keystore_text), SYNCHDB_CONNINFO_KEYSTORE_SIZE);
 
-	/* table can be empty or NULL */
-	if (VARSIZE(table_text) - VARHDRSZ == 0)
-		strlcpy(connInfo.table, "null", SYNCHDB_CONNINFO_TABLELIST_SIZE);
-	else if (VARSIZE(table_text) - VARHDRSZ > SYNCHDB_CONNINFO_TABLELIST_SIZE)
-		ereport(ERROR,
-				(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
-				 errmsg("table list cannot be longer than %d",
-						 SYNCHDB_CONNINFO_TABLELIST_SIZE)));
-	else
-		strlcpy(connInfo.table, text_to_cstring(table_text), SYNCHDB_CONNINFO_TABLELIST_SIZE);
+		if (VARSIZE(jmx_keystore_pass_text) - VARHDRSZ == 0)
+			strlcpy(jmxconninfo.jmx_ssl_keystore_pass, "null", SYNCHDB_CONNINFO_PASSWORD_SIZE);
+		else if (VARSIZE(jmx_keystore_pass_text) - VARHDRSZ > SYNCHDB_CONNINFO_PASSWORD_SIZE)
+			ereport(ERROR,
+					(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+					 errmsg("ssl_keystore_pass cannot be longer than %d",
+							 SYNCHDB_CONNINFO_PASSWORD_SIZE)));
+		else
+			strlcpy(jmxconninfo.jmx_ssl_keystore_pass, text_to_cstring(jmx_keystore_pass_text), SYNCHDB_CONNINFO_PASSWORD_SIZE);
 
-	/* snapshot table can be empty or NULL */
-	if (VARSIZE(snapshottable_text) - VARHDRSZ == 0)
-		strlcpy(connInfo.snapshottable, "null", SYNCHDB_CONNINFO_TABLELIST_SIZE);
-	else if (VARSIZE(snapshottable_text) - VARHDRSZ > SYNCHDB_CONNINFO_TABLELIST_SIZE)
-		ereport(ERROR,
-				(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
-				 errmsg("snapshot table cannot be longer than %d",
-						 SYNCHDB_CONNINFO_TABLELIST_SIZE)));
-	else
-		strlcpy(connInfo.snapshottable, text_to_cstring(snapshottable_text),
-				SYNCHDB_CONNINFO_TABLELIST_SIZE);
+		if (VARSIZE(jmx_truststore_text) - VARHDRSZ == 0)
+			strlcpy(jmxconninfo.jmx_ssl_truststore, "null", SYNCHDB_CONNINFO_KEYSTORE_SIZE);
+		else if (VARSIZE(jmx_truststore_text) - VARHDRSZ > SYNCHDB_CONNINFO_KEYSTORE_SIZE)
+			ereport(ERROR,
+					(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+					 errmsg("ssl_truststore cannot be longer than %d",
+							 SYNCHDB_CONNINFO_KEYSTORE_SIZE)));
+		else
+			strlcpy(jmxconninfo.jmx_ssl_truststore, text_to_cstring(jmx_truststore_text), SYNCHDB_CONNINFO_KEYSTORE_SIZE);
 
-	if (VARSIZE(connector_text) - VARHDRSZ == 0)
+		if (VARSIZE(jmx_truststore_pass_text) - VARHDRSZ == 0)
+			strlcpy(jmxconninfo.jmx_ssl_truststore_pass, "null", SYNCHDB_CONNINFO_PASSWORD_SIZE);
+		else if (VARSIZE(jmx_truststore_pass_text) - VARHDRSZ > SYNCHDB_CONNINFO_PASSWORD_SIZE)
+			ereport(ERROR,
+					(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+					 errmsg("ssl_truststore_pass cannot be longer than %d",
+							 SYNCHDB_CONNINFO_PASSWORD_SIZE)));
+		else
+			strlcpy(jmxconninfo.jmx_ssl_truststore_pass, text_to_cstring(jmx_truststore_pass_text), SYNCHDB_CONNINFO_PASSWORD_SIZE);
+	}
+	else
 	{
-		ereport(ERROR,
-				(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
-				 errmsg("connector type cannot be empty")));
+		strlcpy(jmxconninfo.jmx_ssl_keystore, "null", SYNCHDB_CONNINFO_KEYSTORE_SIZE);
+		strlcpy(jmxconninfo.jmx_ssl_keystore_pass, "null", SYNCHDB_CONNINFO_PASSWORD_SIZE);
+		strlcpy(jmxconninfo.jmx_ssl_truststore, "null", SYNCHDB_CONNINFO_KEYSTORE_SIZE);
+		strlcpy(jmxconninfo.jmx_ssl_truststore_pass, "null", SYNCHDB_CONNINFO_PASSWORD_SIZE);
 	}
-	connector = text_to_cstring(connector_text);
-
-#ifdef WITH_OLR
-	if (strcasecmp(connector, "mysql") && strcasecmp(connector, "sqlserver")
-			&& strcasecmp(connector, "oracle") && strcasecmp(connector, "olr"))
-		ereport(ERROR,
-				(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
-				 errmsg("unsupported connector")));
-#else
-	if (strcasecmp(connector, "mysql") && strcasecmp(connector, "sqlserver")
-			&& strcasecmp(connector, "oracle"))
-		ereport(ERROR,
-				(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
-				 errmsg("unsupported connector")));
-#endif
 
-	appendStringInfo(&strinfo, "INSERT INTO %s (name, isactive, data)"
-			" VALUES ('%s', %s, jsonb_build_object("
-			"'hostname', '%s', "
-			"'port', %d, "
-			"'user', '%s', "
-			"'pwd', pgp_sym_encrypt('%s', '%s'), "
-			"'srcdb', '%s', "
-			"'dstdb', '%s', "
-			"'table', (CASE WHEN '%s' = 'null' THEN null ELSE '%s' END), "
-			"'snapshottable', (CASE WHEN '%s' = 'null' THEN null ELSE '%s' END), "
-			"'connector', '%s'));",
+	appendStringInfo(&strinfo, "UPDATE %s SET data = data || json_build_object("
+			"'jmx_listenaddr', '%s', "
+			"'jmx_port', %u, "
+			"'jmx_rmi_address', '%s', "
+			"'jmx_rmi_port', %u, "
+			"'jmx_auth', %s, "
+			"'jmx_auth_passwdfile', (CASE WHEN '%s' = 'null' THEN null ELSE '%s' END), "
+			"'jmx_auth_accessfile', (CASE WHEN '%s' = 'null' THEN null ELSE '%s' END), "
+			"'jmx_ssl', %s, "
+			"'jmx_ssl_keystore', (CASE WHEN '%s' = 'null' THEN null ELSE '%s' END), "
+			"'jmx_ssl_keystore_pass', (CASE WHEN '%s' = 'null' THEN null ELSE pgp_sym_encrypt('%s', '%s') END), "
+			"'jmx_ssl_truststore', (CASE WHEN '%s' = 'null' THEN null ELSE '%s' END), "
+			"'jmx_ssl_truststore_pass', (CASE WHEN '%s' = 'null' THEN null ELSE pgp_sym_encrypt('%s', '%s') END))::jsonb "
+			"WHERE name = '%s'",
 			SYNCHDB_CONNINFO_TABLE,
-			connInfo.name,
-			"false",
-			connInfo.hostname,
-			connInfo.port,
-			connInfo.user,
-			connInfo.pwd,
+			jmxconninfo.jmx_listenaddr,
+			jmxconninfo.jmx_port,
+			jmxconninfo.jmx_rmiserveraddr,
+			jmxconninfo.jmx_rmiport,
+			jmxconninfo.jmx_auth ? "true" : "false",
+			jmxconninfo.jmx_auth_passwdfile,
+			jmxconninfo.jmx_auth_passwdfile,
+			jmxconninfo.jmx_auth_accessfile,
+			jmxconninfo.jmx_auth_accessfile,
+			jmxconninfo.jmx_ssl ? "true" : "false",
+			jmxconninfo.jmx_ssl_keystore,
+			jmxconninfo.jmx_ssl_keystore,
+			jmxconninfo.jmx_ssl_keystore_pass,
+			jmxconninfo.jmx_ssl_keystore_pass,
 			SYNCHDB_SECRET,
-			connInfo.srcdb,
-			connInfo.dstdb,
-			connInfo.table,
-			connInfo.table,
-			connInfo.snapshottable,
-			connInfo.snapshottable,
-			connector);
+			jmxconninfo.jmx_ssl_truststore,
+			jmxconninfo.jmx_ssl_truststore,
+			jmxconninfo.jmx_ssl_truststore_pass,
+			jmxconninfo.jmx_ssl_truststore_pass,
+			SYNCHDB_SECRET,
+			NameStr(*name));
+
+	PG_RETURN_INT32(ra_executeCommand(strinfo.data));
+}
+
+/*
+ * synchdb_del_extra_conninfo
+ *
+ * This function deletes all extra connector parameters created by synchdb_add_extra_conninfo()
+ */
+Datum
+synchdb_del_jmx_conninfo(PG_FUNCTION_ARGS)
+{
+	Name name = PG_GETARG_NAME(0);
+	StringInfoData strinfo;
+	initStringInfo(&strinfo);
 
+	appendStringInfo(&strinfo, "UPDATE %s SET data = data - ARRAY["
+			"'jmx_listenaddr', "
+			"'jmx_port', "
+			"'jmx_rmi_address', "
+			"'jmx_rmi_port', "
+			"'jmx_auth', "
+			"'jmx_auth_passwdfile', "
+			"'jmx_auth_accessfile', "
+			"'jmx_ssl', "
+			"'jmx_ssl_keystore', "
+			"'jmx_ssl_keystore_pass', "
+			"'jmx_ssl_truststore', "
+			"'jmx_ssl_truststore_pass', "
+			"'jmx_exporter', "
+			"'jmx_exporter_port', "
+			"'jmx_exporter_conf'] "
+			"WHERE name = '%s'",
+			SYNCHDB_CONNINFO_TABLE,
+			NameStr(*name));
 	PG_RETURN_INT32(ra_executeCommand(strinfo.data));
 }
 
 /*
- * synchdb_restart_connector
+ * synchdb_add_jmx_exporter_conninfo
  *
- * This function restarts a connector with given snapshot mode
+ * This function configures extra JMX exporter related parameters to a connector
  */
 Datum
-synchdb_restart_connector(PG_FUNCTION_ARGS)
+synchdb_add_jmx_exporter_conninfo(PG_FUNCTION_ARGS)
 {
 	Name name = PG_GETARG_NAME(0);
-	Name snapshot_mode = PG_GETARG_NAME(1);
-	ConnectionInfo connInfo;
-	int ret = -1, connectorId = -1;
-	pid_t pid;
-	char * _snapshot_mode;
-	char *connector = NULL;
 
-	SynchdbRequest *req;
+	/* jmx exporter options (for prometheus and graphana) */
+	text * jmx_exporterpath_text = PG_GETARG_TEXT_PP(1);
+	unsigned int jmx_exporterport =  PG_GETARG_UINT32(2);
+	text * jmx_exporterconf_text = PG_GETARG_TEXT_PP(3);
+
+	JMXConnectionInfo jmxconninfo = {0};
+	StringInfoData strinfo;
+	initStringInfo(&strinfo);
 
 	/* Sanity check on input arguments */
-	if (VARSIZE(name_text) - VARHDRSZ == 0)
+	if (VARSIZE(jmx_exporterpath_text) - VARHDRSZ == 0 ||
+			VARSIZE(jmx_exporterpath_text) - VARHDRSZ > SYNCHDB_METADATA_PATH_SIZE)
 	{
 		ereport(ERROR,
 				(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
-				 errmsg("connection name cannot be empty")));
+				 errmsg("jmx exporter jar library path cannot be empty or longer than %d",
+						 SYNCHDB_METADATA_PATH_SIZE)));
 	}
+	strlcpy(jmxconninfo.jmx_exporter, text_to_cstring(jmx_exporterpath_text),
+			SYNCHDB_METADATA_PATH_SIZE);
 
-	/* snapshot_mode can be empty or NULL */
-	if (strlen(NameStr(*snapshot_mode)) == 0)
-		_snapshot_mode = "null";
-	else
-		_snapshot_mode = NameStr(*snapshot_mode);
-
-	ret = ra_getConninfoByName(NameStr(*name), &connInfo, &connector);
-	if (ret)
+	jmxconninfo.jmx_exporter_port = jmx_exporterport;
+	if (jmxconninfo.jmx_exporter_port == 0 || jmxconninfo.jmx_exporter_port > 65535)
+	{
 		ereport(ERROR,
 				(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
-				 errmsg("connection name does not exist"),
-				 errhint("use synchdb_add_conninfo to add one first")));
-
-	/*
-	 * attach or initialize synchdb shared memory area so we know what is
-	 * going on
-	 */
-	synchdb_init_shmem();
-	if (!sdb_state)
-		ereport(ERROR,
-				(errcode(ERRCODE_INTERNAL_ERROR),
-				 errmsg("failed to init or attach to synchdb shared memory")));
-
-	connectorId = get_shm_connector_id_by_name(NameStr(*name), get_database_name(MyDatabaseId));
-	if (connectorId < 0)
-		ereport(ERROR,
-				(errmsg("dbz connector (%s) does not have connector ID assigned",
-						NameStr(*name)),
-				 errhint("use synchdb_start_engine_bgw() to assign one first")));
+				 errmsg("invalid jmx exporter port number")));
+	}
 
-	pid = get_shm_connector_pid(connectorId);
-	if (pid == InvalidPid)
+	if (VARSIZE(jmx_exporterconf_text) - VARHDRSZ == 0 ||
+			VARSIZE(jmx_exporterconf_text) - VARHDRSZ > SYNCHDB_METADATA_PATH_SIZE)
+	{
 		ereport(ERROR,
-				(errmsg("dbz connector (%s) is not running",
-						NameStr(*name)),
-				 errhint("use synchdb_start_engine_bgw() to start a worker first")));
-
-	/* point to the right construct based on type */
-	req = &(sdb_state->connectors[connectorId].req);
+				(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+				 errmsg("jmx exporter conf file path cannot be empty or longer than %d",
+						 SYNCHDB_METADATA_PATH_SIZE)));
+	}
+	strlcpy(jmxconninfo.jmx_exporter_conf, text_to_cstring(jmx_exporterconf_text),
+			SYNCHDB_METADATA_PATH_SIZE);
 
-	/* an active state change request is currently in progress */
-	if (req->reqstate != STATE_UNDEF)
-		ereport(ERROR,
-				(errmsg("an active request is currently active for connector %s",
-						NameStr(*name)),
-				 errhint("wait for it to finish and try again later")));
 
-	/*
-	 * connector info may have been changed, so let's pass the latest conninfo
-	 * to the connector worker in the same way as synchdb_start_engine_bgw()
-	 */
-	LWLockAcquire(&sdb_state->lock, LW_EXCLUSIVE);
-	req->reqstate = STATE_RESTARTING;
+	appendStringInfo(&strinfo, "UPDATE %s SET data = data || json_build_object("
+			"'jmx_exporter', '%s', "
+			"'jmx_exporter_port', %u, "
+			"'jmx_exporter_conf', '%s')::jsonb "
+			"WHERE name = '%s'",
+			SYNCHDB_CONNINFO_TABLE,
+			jmxconninfo.jmx_exporter,
+			jmxconninfo.jmx_exporter_port,
+			jmxconninfo.jmx_exporter_conf,
+			NameStr(*name));
 
-	/* reqdata contains snapshot mode */
-	memset(req->reqdata, 0, SYNCHDB_ERRMSG_SIZE);
-	snprintf(req->reqdata, SYNCHDB_ERRMSG_SIZE,"%s", _snapshot_mode);
+	PG_RETURN_INT32(ra_executeCommand(strinfo.data));
+}
 
-	/*
-	 * reqconninfo contains a copy of conninfo recently read in case it has been
-	 * changed since connector start
-	 */
-	memcpy(&req->reqconninfo, &connInfo, sizeof(ConnectionInfo));
-	LWLockRelease(&sdb_state->lock);
+/*
+ * synchdb_del_extra_conninfo
+ *
+ * This function deletes all extra connector parameters created by synchdb_add_extra_conninfo()
+ */
+Datum
+synchdb_del_jmx_exporter_conninfo(PG_FUNCTION_ARGS)
+{
+	Name name = PG_GETARG_NAME(0);
+	StringInfoData strinfo;
+	initStringInfo(&strinfo);
 
-	elog(WARNING, "sent restart request interrupt to dbz connector (%s)",
+	appendStringInfo(&strinfo, "UPDATE %s SET data = data - ARRAY["
+			"'jmx_exporter', "
+			"'jmx_exporter_port', "
+			"'jmx_exporter_conf'] "
+			"WHERE name = '%s'",
+			SYNCHDB_CONNINFO_TABLE,
 			NameStr(*name));
-	PG_RETURN_INT32(0);
+	PG_RETURN_INT32(ra_executeCommand(strinfo.data));
 }
 
 /*
- * synchdb_log_jvm_meminfo
+ * synchdb_add_olr_conninfo
  *
- * This function dumps JVM memory usage info in PostgreSQL log
+ * This function configures optional Openlog Replicator parameters to a Oracle
+ * connector. Having this enables Openlog Replicator adapter instead of the default
+ * Logminer.
  */
 Datum
-synchdb_log_jvm_meminfo(PG_FUNCTION_ARGS)
+synchdb_add_olr_conninfo(PG_FUNCTION_ARGS)
 {
-	int connectorId = -1;
-	pid_t pid;
-	SynchdbRequest *req;
-
-	/* Parse input arguments */
 	Name name = PG_GETARG_NAME(0);
+	text * olr_host_text = PG_GETARG_TEXT_PP(1);
+	unsigned int olr_port = PG_GETARG_UINT32(2);
+	text * olr_source_text = PG_GETARG_TEXT_PP(3);
 
-	/*
-	 * attach or initialize synchdb shared memory area so we know what is
-	 * going on
-	 */
-	synchdb_init_shmem();
-	if (!sdb_state)
+	OLRConnectionInfo olrconninfo = {0};
+	StringInfoData strinfo;
+	initStringInfo(&strinfo);
+
+	if (VARSIZE(olr_host_text) - VARHDRSZ == 0 ||
+			VARSIZE(olr_host_text) - VARHDRSZ > SYNCHDB_CONNINFO_HOSTNAME_SIZE)
+	{
 		ereport(ERROR,
-				(errcode(ERRCODE_INTERNAL_ERROR),
-				 errmsg("failed to init or attach to synchdb shared memory")));
+				(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+				 errmsg("Openlog Replicator host address cannot be empty or longer than %d",
+						 SYNCHDB_CONNINFO_HOSTNAME_SIZE)));
+	}
+	strlcpy(olrconninfo.olr_host, text_to_cstring(olr_host_text), SYNCHDB_CONNINFO_HOSTNAME_SIZE);
 
-	connectorId = get_shm_connector_id_by_name(NameStr(*name), get_database_name(MyDatabaseId));
-	if (connectorId < 0)
+	olrconninfo.olr_port = olr_port;
+	if (olrconninfo.olr_port == 0 || olrconninfo.olr_port > 65535)
+	{
 		ereport(ERROR,
-				(errmsg("dbz connector (%s) does not have connector ID assigned",
-						NameStr(*name)),
-				 errhint("use synchdb_start_engine_bgw() to assign one first")));
+				(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+				 errmsg("invalid port number")));
+	}
 
-	pid = get_shm_connector_pid(connectorId);
-	if (pid == InvalidPid)
+	if (VARSIZE(olr_source_text) - VARHDRSZ == 0 ||
+			VARSIZE(olr_source_text) - VARHDRSZ > SYNCHDB_CONNINFO_NAME_SIZE)
+	{
 		ereport(ERROR,
-				(errmsg("dbz connector (%s) is not running", NameStr(*name)),
-				 errhint("use synchdb_start_engine_bgw() to start a worker first")));
+				(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+				 errmsg("Openlog Replicator data source cannot be empty or longer than %d",
+						 SYNCHDB_CONNINFO_NAME_SIZE)));
+	}
+	strlcpy(olrconninfo.olr_source, text_to_cstring(olr_source_text), SYNCHDB_CONNINFO_NAME_SIZE);
 
-	/* point to the right construct based on type */
-	req = &(sdb_state->connectors[connectorId].req);
+	appendStringInfo(&strinfo, "UPDATE %s SET data = data || json_build_object("
+			"'olr_host', '%s', "
+			"'olr_port', %u, "
+			"'olr_source', '%s')::jsonb "
+			"WHERE name = '%s'",
+			SYNCHDB_CONNINFO_TABLE,
+			olrconninfo.olr_host,
+			olrconninfo.olr_port,
+			olrconninfo.olr_source,
+			NameStr(*name));
 
-	/* an active state change request is currently in progress */
-	if (req->reqstate != STATE_UNDEF)
-		ereport(ERROR,
-				(errmsg("an active request is currently active for connector %s",
-						NameStr(*name)),
-				 errhint("wait for it to finish and try again later")));
+	PG_RETURN_INT32(ra_executeCommand(strinfo.data));
+}
 
-	LWLockAcquire(&sdb_state->lock, LW_EXCLUSIVE);
-	req->reqstate = STATE_MEMDUMP;
-	LWLockRelease(&sdb_state->lock);
+/*
+ * synchdb_del_olr_conninfo
+ *
+ * This function deletes all Openlog Replicator parameters created by synchdb_add_olr_conninfo()
+ */
+Datum
+synchdb_del_olr_conninfo(PG_FUNCTION_ARGS)
+{
+	Name name = PG_GETARG_NAME(0);
+	StringInfoData strinfo;
+	initStringInfo(&strinfo);
 
-	elog(WARNING, "sent memdump request interrupt to dbz connector %s (%d)",
-			NameStr(*name), connectorId);
-	PG_RETURN_INT32(0);
+	appendStringInfo(&strinfo, "UPDATE %s SET data = data - ARRAY["
+			"'olr_host', "
+			"'olr_port', "
+			"'olr_source'] "
+			"WHERE name = '%s'",
+			SYNCHDB_CONNINFO_TABLE,
+			NameStr(*name));
+	PG_RETURN_INT32(ra_executeCommand(strinfo.data));
 }
 
+/*
+ * synchdb_del_conninfo
+ *
+ * This function deletes a connector info record created by synchdb_add_conninfo()
+ */
 Datum
-synchdb_add_objmap(PG_FUNCTION_ARGS)
+synchdb_del_conninfo(PG_FUNCTION_ARGS)
 {
-	/* Parse input arguments */
 	Name name = PG_GETARG_NAME(0);
-	Name objtype = PG_GETARG_NAME(1);
-	Name srcobj = PG_GETARG_NAME(2);
-	text * dstobj = PG_GETARG_TEXT_PP(3);
-
+	int connectorId = -1;
+	pid_t pid = InvalidPid;
 	StringInfoData strinfo;
 	initStringInfo(&strinfo);
-	/*
-	 * attach or initialize synchdb shared memory area so we know what is
-	 * going on
-	 */
 	synchdb_init_shmem();
+
 	if (!sdb_state)
 		ereport(ERROR,
 				(errcode(ERRCODE_INTERNAL_ERROR),
 				 errmsg("failed to init or attach to synchdb shared memory")));
 
-	if (strcasecmp(NameStr(*objtype), "table") && strcasecmp(NameStr(*objtype), "column") &&
-		strcasecmp(NameStr(*objtype), "datatype") && strcasecmp(NameStr(*objtype), "transform"))
+	/* if connector is running, we will attemppt to shut it down */
+	connectorId = get_shm_connector_id_by_name(NameStr(*name), get_database_name(MyDatabaseId));
+	if (connectorId >= 0)
 	{
-		ereport(ERROR,
-				(errcode(ERRCODE_INTERNAL_ERROR),
-				 errmsg("unsupported object type %s", NameStr(*objtype))));
+		pid = get_shm_connector_pid(connectorId);
+		if (pid != InvalidPid)
+		{
+			stop_connector_worker(connectorId, NameStr(*name), pid);
+
+		}
 	}
-	appendStringInfo(&strinfo, "INSERT INTO %s (name, objtype, enabled, srcobj, dstobj)"
-			" VALUES (trim(lower('%s')), trim(lower('%s')), true, trim(lower('%s')), '%s')",
+
+	/* remove the connector info record */
+	appendStringInfo(&strinfo, "DELETE FROM %s WHERE name = '%s';"
+			"DELETE FROM %s WHERE name = '%s';"
+			"DELETE FROM %s WHERE name = '%s';"
+			"DELETE FROM %s WHERE name = '%s';",
+			SYNCHDB_CONNINFO_TABLE,
+			NameStr(*name),
+			SYNCHDB_ATTRIBUTE_TABLE,
+			NameStr(*name),
 			SYNCHDB_OBJECT_MAPPING_TABLE,
 			NameStr(*name),
-			NameStr(*objtype),
-			NameStr(*srcobj),
-			escapeSingleQuote(text_to_cstring(dstobj), false));
+			SYNCHDB_OFFSETS_TABLE,
+			NameStr(*name));
 
-	appendStringInfo(&strinfo, " ON CONFLICT(name, objtype, srcobj) "
-			"DO UPDATE SET "
-			"enabled = EXCLUDED.enabled,"
-			"dstobj = EXCLUDED.dstobj;");
+	ra_executeCommand(strinfo.data);
+	remove_dbz_metadata_files(NameStr(*name));
 
-	PG_RETURN_INT32(ra_executeCommand(strinfo.data));
+	PG_RETURN_INT32(0);
 }
 
 /*
- * synchdb_reload_objmap
+ * synchdb_del_objmap
  *
- * This function forces a connector to reload objmap table entries
+ * This function marks a objmap rule as disabled
  */
 Datum
-synchdb_reload_objmap(PG_FUNCTION_ARGS)
+synchdb_del_objmap(PG_FUNCTION_ARGS)
 {
-	int connectorId = -1;
-	pid_t pid;
-	SynchdbRequest *req;
-
 	/* Parse input arguments */
 	Name name = PG_GETARG_NAME(0);
+	Name objtype = PG_GETARG_NAME(1);
+	Name srcobj = PG_GETARG_NAME(2);
 
-	/*
-	 * attach or initialize synchdb shared memory area so we know what is
-	 * going on
-	 */
-	synchdb_init_shmem();
-	if (!sdb_state)
-		ereport(ERROR,
-				(errcode(ERRCODE_INTERNAL_ERROR),
-				 errmsg("failed to init or attach to synchdb shared memory")));
-
-	connectorId = get_shm_connector_id_by_name(NameStr(*name), get_database_name(MyDatabaseId));
-	if (connectorId < 0)
-		ereport(ERROR,
-				(errmsg("dbz connector (%s) does not have connector ID assigned",
-						NameStr(*name)),
-				 errhint("use synchdb_start_engine_bgw() to assign one first")));
-
-	pid = get_shm_connector_pid(connectorId);
-	if (pid == InvalidPid)
-		ereport(ERROR,
-				(errmsg("dbz connector (%s) is not running", NameStr(*name)),
-				 errhint("use synchdb_start_engine_bgw() to start a worker first")));
-
-	/* point to the right construct based on type */
-	req = &(sdb_state->connectors[connectorId].req);
+	StringInfoData strinfo;
+	initStringInfo(&strinfo);
 
-	/* an active state change request is currently in progress */
-	if (req->reqstate != STATE_UNDEF)
+	if (strcasecmp(NameStr(*objtype), "table") && strcasecmp(NameStr(*objtype), "column") &&
+		strcasecmp(NameStr(*objtype), "datatype") && strcasecmp(NameStr(*objtype), "transform"))
+	{
 		ereport(ERROR,
-				(errmsg("an active request is currently active for connector %s",
-						NameStr(*name)),
-				 errhint("wait for it to finish and try again later")));
+				(errcode(ERRCODE_INTERNAL_ERROR),
+				 errmsg("unsupported object type %s", NameStr(*objtype))));
+	}
 
-	LWLockAcquire(&sdb_state->lock, LW_EXCLUSIVE);
-	req->reqstate = STATE_RELOAD_OBJMAP;
-	LWLockRelease(&sdb_state->lock);
+	appendStringInfo(&strinfo, "UPDATE %s SET "
+			"enabled = false WHERE "
+			"name = '%s' AND objtype = trim(lower('%s')) AND "
+			"srcobj = trim(lower('%s'));",
+			SYNCHDB_OBJECT_MAPPING_TABLE,
+			NameStr(*name),
+			NameStr(*objtype),
+			NameStr(*srcobj));
 
-	elog(WARNING, "sent reload objmap request interrupt to dbz connector %s (%d)",
-			NameStr(*name), connectorId);
-	PG_RETURN_INT32(0);
+	PG_RETURN_INT32(ra_executeCommand(strinfo.data));
 }
 
 /*
- * synchdb_add_extra_conninfo
+ * synchdb_add_infinispan
  *
- * This function configures extra connector parameters and stores them to synchdb_conninfo table
+ * This function configures an existing oracle connector to use infinispan as
+ * cache mechanism to support potentiall large transactions
  */
 Datum
-synchdb_add_extra_conninfo(PG_FUNCTION_ARGS)
+synchdb_add_infinispan(PG_FUNCTION_ARGS)
 {
+	/* Parse input arguments */
 	Name name = PG_GETARG_NAME(0);
-	Name sslmode = PG_GETARG_NAME(1);
-	text * ssl_keystore_text = PG_GETARG_TEXT_PP(2);
-	text * ssl_keystore_pass_text = PG_GETARG_TEXT_PP(3);
-	text * ssl_truststore_text = PG_GETARG_TEXT_PP(4);
-	text * ssl_truststore_pass_text = PG_GETARG_TEXT_PP(5);
+	Name memoryType = PG_GETARG_NAME(1);	/* heap or off heap*/
+	unsigned int memorySize = PG_GETARG_UINT32(2);
 
-	ExtraConnectionInfo extraconninfo = {0};
+	IspnInfo ispninfo = {0};
 	StringInfoData strinfo;
 	initStringInfo(&strinfo);
 
-	strlcpy(extraconninfo.ssl_mode, NameStr(*sslmode), SYNCHDB_CONNINFO_NAME_SIZE);
-
-	if (VARSIZE(ssl_keystore_text) - VARHDRSZ == 0)
-		strlcpy(extraconninfo.ssl_keystore, "null", SYNCHDB_CONNINFO_KEYSTORE_SIZE);
-	else if (VARSIZE(ssl_keystore_text) - VARHDRSZ > SYNCHDB_CONNINFO_KEYSTORE_SIZE)
-		ereport(ERROR,
-				(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
-				 errmsg("ssl_keystore cannot be longer than %d",
-						 SYNCHDB_CONNINFO_KEYSTORE_SIZE)));
-	else
-		strlcpy(extraconninfo.ssl_keystore, text_to_cstring(ssl_keystore_text), SYNCHDB_CONNINFO_KEYSTORE_SIZE);
-
-	if (VARSIZE(ssl_keystore_pass_text) - VARHDRSZ == 0)
-		strlcpy(extraconninfo.ssl_keystore_pass, "null", SYNCHDB_CONNINFO_PASSWORD_SIZE);
-	else if (VARSIZE(ssl_keystore_pass_text) - VARHDRSZ > SYNCHDB_CONNINFO_PASSWORD_SIZE)
-		ereport(ERROR,
-				(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
-				 errmsg("ssl_keystore_pass cannot be longer than %d",
-						 SYNCHDB_CONNINFO_PASSWORD_SIZE)));
-	else
-		strlcpy(extraconninfo.ssl_keystore_pass, text_to_cstring(ssl_keystore_pass_text), SYNCHDB_CONNINFO_PASSWORD_SIZE);
+	/* only embedded infinispan is supported as of now */
+	strlcpy(ispninfo.ispn_cache_type, "embedded", INFINISPAN_TYPE_SIZE);
 
-	if (VARSIZE(ssl_truststore_text) - VARHDRSZ == 0)
-		strlcpy(extraconninfo.ssl_truststore, "null", SYNCHDB_CONNINFO_KEYSTORE_SIZE);
-	else if (VARSIZE(ssl_truststore_text) - VARHDRSZ > SYNCHDB_CONNINFO_KEYSTORE_SIZE)
+	if (strcasecmp(NameStr(*memoryType), "heap") && strcasecmp(NameStr(*memoryType), "off heap"))
+	{
 		ereport(ERROR,
 				(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
-				 errmsg("ssl_truststore cannot be longer than %d",
-						 SYNCHDB_CONNINFO_KEYSTORE_SIZE)));
-	else
-		strlcpy(extraconninfo.ssl_truststore, text_to_cstring(ssl_truststore_text), SYNCHDB_CONNINFO_KEYSTORE_SIZE);
+				 errmsg("invalid infinispan memory type: expect 'heap' or 'off heap'")));
+	}
+	strlcpy(ispninfo.ispn_memory_type, NameStr(*memoryType), INFINISPAN_TYPE_SIZE);
 
-	if (VARSIZE(ssl_truststore_pass_text) - VARHDRSZ == 0)
-		strlcpy(extraconninfo.ssl_truststore_pass, "null", SYNCHDB_CONNINFO_PASSWORD_SIZE);
-	else if (VARSIZE(ssl_truststore_pass_text) - VARHDRSZ > SYNCHDB_CONNINFO_PASSWORD_SIZE)
+	if (memorySize == 0)
+	{
 		ereport(ERROR,
 				(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
-				 errmsg("ssl_truststore_pass cannot be longer than %d",
-						 SYNCHDB_CONNINFO_PASSWORD_SIZE)));
-	else
-		strlcpy(extraconninfo.ssl_truststore_pass, text_to_cstring(ssl_truststore_pass_text), SYNCHDB_CONNINFO_PASSWORD_SIZE);
+				 errmsg("invalid infinispan memory size")));
+	}
+	ispninfo.ispn_memory_size = memorySize;
 
 	appendStringInfo(&strinfo, "UPDATE %s SET data = data || json_build_object("
-			"'ssl_mode', '%s', "
-			"'ssl_keystore',  (CASE WHEN '%s' = 'null' THEN null ELSE '%s' END), "
-			"'ssl_keystore_pass', (CASE WHEN '%s' = 'null' THEN null ELSE pgp_sym_encrypt('%s', '%s') END), "
-			"'ssl_truststore', (CASE WHEN '%s' = 'null' THEN null ELSE '%s' END), "
-			"'ssl_truststore_pass', (CASE WHEN '%s' = 'null' THEN null ELSE pgp_sym_encrypt('%s', '%s') END))::jsonb "
+			"'ispn_cache_type', '%s', "	/* only embedded infinispan is supported */
+			"'ispn_memory_type', '%s', "
+			"'ispn_memory_size', %u)::jsonb "
 			"WHERE name = '%s'",
 			SYNCHDB_CONNINFO_TABLE,
-			extraconninfo.ssl_mode,
-			extraconninfo.ssl_keystore,
-			extraconninfo.ssl_keystore,
-			extraconninfo.ssl_keystore_pass,
-			extraconninfo.ssl_keystore_pass,
-			SYNCHDB_SECRET,
-			extraconninfo.ssl_truststore,
-			extraconninfo.ssl_truststore,
-			extraconninfo.ssl_truststore_pass,
-			extraconninfo.ssl_truststore_pass,
-			SYNCHDB_SECRET,
+			ispninfo.ispn_cache_type,
+			ispninfo.ispn_memory_type,
+			ispninfo.ispn_memory_size,
 			NameStr(*name));
 
 	PG_RETURN_INT32(ra_executeCommand(strinfo.data));
 }
 
 /*
- * synchdb_del_extra_conninfo
+ * synchdb_del_infinispan
  *
- * This function deletes all extra connector parameters created by synchdb_add_extra_conninfo()
+ * This function deletes infinispan configuration from an existing oracle connector.
+ * This removes the configuration as well as the on-disk meta data and cached files.
  */
 Datum
-synchdb_del_extra_conninfo(PG_FUNCTION_ARGS)
+synchdb_del_infinispan(PG_FUNCTION_ARGS)
 {
+	/* Parse input arguments */
+	int connectorId;
+	pid_t pid;
+	char * ispn_dir = NULL;
 	Name name = PG_GETARG_NAME(0);
+
 	StringInfoData strinfo;
 	initStringInfo(&strinfo);
 
-	appendStringInfo(&strinfo, "UPDATE %s SET data = data - ARRAY["
-			"'ssl_mode', "
-			"'ssl_keystore', "
-			"'ssl_keystore_pass', "
-			"'ssl_truststore', "
-			"'ssl_truststore_pass'] "
+	/*
+	 * attach or initialize synchdb shared memory area so we know what is
+	 * going on
+	 */
+	synchdb_init_shmem();
+	if (!sdb_state)
+		ereport(ERROR,
+				(errcode(ERRCODE_INTERNAL_ERROR),
+				 errmsg("failed to init or attach to synchdb shared memory")));
+
+	connectorId = get_shm_connector_id_by_name(NameStr(*name), get_database_name(MyDatabaseId));
+	if (connectorId > 0)
+	{
+		pid = get_shm_connector_pid(connectorId);
+		if (pid != InvalidPid)
+		{
+			/* still running, check the connector state */
+			ereport(ERROR,
+					(errmsg("the connector needs to be in stopped state before infinispan "
+							"settings can be removed"),
+					errhint("use synchdb_stop_engine_bgw() to stop it first")));
+		}
+	}
+
+	/* remove on-disk cache and metadata created by infinispan */
+	ispn_dir = psprintf(SYNCHDB_INFINISPAN_DIR, NameStr(*name), get_database_name(MyDatabaseId));
+
+	if (!rmtree(ispn_dir, true))
+		elog(WARNING, "some infinispan metadata files may be left behind in %s",
+				ispn_dir);
+
+	appendStringInfo(&strinfo, "UPDATE %s SET data = data - ARRAY["
+			"'ispn_cache_type', "
+			"'ispn_memory_type', "
+			"'ispn_memory_size'] "
 			"WHERE name = '%s'",
 			SYNCHDB_CONNINFO_TABLE,
 			NameStr(*name));
 	PG_RETURN_INT32(ra_executeCommand(strinfo.data));
 }
 
-/*
- * synchdb_add_jmx_conninfo
- *
- * This function configures extra JMX related parameters to a connector
- */
 Datum
-synchdb_add_jmx_conninfo(PG_FUNCTION_ARGS)
+synchdb_translate_datatype(PG_FUNCTION_ARGS)
 {
-	Name name = PG_GETARG_NAME(0);
-
-	/* jmx and rmi server addresses and ports (for jconsole and similar) */
-	text * jmx_listenaddr_text = PG_GETARG_TEXT_PP(1);
-	unsigned int jmx_port = PG_GETARG_UINT32(2);
-	text * jmx_rmiserver_text = PG_GETARG_TEXT_PP(3);
-	unsigned int jmx_rmiport = PG_GETARG_UINT32(4);
-
-	/* jmx authentication options */
-	bool jmx_authenticate = PG_GETARG_BOOL(5);
-	text * jmx_passwdfile_text = PG_GETARG_TEXT_PP(6);
-	text * jmx_accessfile_text = PG_GETARG_TEXT_PP(7);
-
-	/* jmx ssl options */
-	bool jmx_ssl = PG_GETARG_BOOL(8);
-	text * jmx_keystore_text = PG_GETARG_TEXT_PP(9);
-	text * jmx_keystore_pass_text = PG_GETARG_TEXT_PP(10);
-	text * jmx_truststore_text = PG_GETARG_TEXT_PP(11);
-	text * jmx_truststore_pass_text = PG_GETARG_TEXT_PP(12);
+	Name type = PG_GETARG_NAME(0);
+	Name ext_datatype = PG_GETARG_NAME(1);
+	int ext_datatype_len = PG_GETARG_INT32(2);
+	int ext_datatype_scale = PG_GETARG_INT32(3);
+	int ext_datatype_precision = PG_GETARG_INT32(4);
 
-	JMXConnectionInfo jmxconninfo = {0};
+	char * pg_datatype = NULL;
+	int pg_datatype_len = 0;
 	StringInfoData strinfo;
-	initStringInfo(&strinfo);
+	ConnectorType connectorType = TYPE_UNDEF;
 
-	if (VARSIZE(jmx_listenaddr_text) - VARHDRSZ == 0 ||
-			VARSIZE(jmx_listenaddr_text) - VARHDRSZ > SYNCHDB_CONNINFO_HOSTNAME_SIZE)
-	{
-		ereport(ERROR,
-				(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
-				 errmsg("jmx listen address cannot be empty or longer than %d",
-						 SYNCHDB_CONNINFO_HOSTNAME_SIZE)));
-	}
-	strlcpy(jmxconninfo.jmx_listenaddr, text_to_cstring(jmx_listenaddr_text), SYNCHDB_CONNINFO_HOSTNAME_SIZE);
+	(void)ext_datatype_precision;
+	initStringInfo(&strinfo);
 
-	jmxconninfo.jmx_port = jmx_port;
-	if (jmxconninfo.jmx_port == 0 || jmxconninfo.jmx_port > 65535)
+	connectorType = stringToConnectorType(NameStr(*type));
+	if (connectorType == TYPE_UNDEF)
 	{
-		ereport(ERROR,
-				(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
-				 errmsg("invalid port number")));
+		elog(WARNING, "unsupported connector type %s", NameStr(*type));
+		PG_RETURN_TEXT_P(cstring_to_text("text"));
 	}
 
-	if (VARSIZE(jmx_rmiserver_text) - VARHDRSZ == 0 ||
-			VARSIZE(jmx_rmiserver_text) - VARHDRSZ > SYNCHDB_CONNINFO_HOSTNAME_SIZE)
+	if (fc_translate_datatype(connectorType, NameStr(*ext_datatype),
+			ext_datatype_len, ext_datatype_scale,
+			&pg_datatype, &pg_datatype_len))
 	{
-		ereport(ERROR,
-				(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
-				 errmsg("jmx rmi server address cannot be empty or longer than %d",
-						 SYNCHDB_CONNINFO_HOSTNAME_SIZE)));
-	}
-	strlcpy(jmxconninfo.jmx_rmiserveraddr, text_to_cstring(jmx_rmiserver_text), SYNCHDB_CONNINFO_HOSTNAME_SIZE);
+		appendStringInfo(&strinfo, "%s", pg_datatype);
 
-	jmxconninfo.jmx_rmiport = jmx_rmiport;
-	if (jmxconninfo.jmx_rmiport == 0 || jmxconninfo.jmx_rmiport > 65535)
-	{
-		ereport(ERROR,
-				(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
-				 errmsg("invalid port number")));
-	}
+		/* pg_datatype_len == -1 means to use original length */
+		if (pg_datatype_len == -1)
+			pg_datatype_len = ext_datatype_len;
 
-	jmxconninfo.jmx_auth = jmx_authenticate;
-	if (jmxconninfo.jmx_auth)
-	{
-		if (VARSIZE(jmx_passwdfile_text) - VARHDRSZ == 0 ||
-				VARSIZE(jmx_passwdfile_text) - VARHDRSZ > SYNCHDB_METADATA_PATH_SIZE)
+		if (pg_datatype_len > 0 && ext_datatype_scale > 0)
 		{
-			ereport(ERROR,
-					(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
-					 errmsg("jmx auth password file cannot be empty or longer than %d",
-							 SYNCHDB_METADATA_PATH_SIZE)));
+			appendStringInfo(&strinfo, "(%d, %d)",
+					pg_datatype_len, ext_datatype_scale);
+			PG_RETURN_TEXT_P(cstring_to_text(strinfo.data));
 		}
-		strlcpy(jmxconninfo.jmx_auth_passwdfile, text_to_cstring(jmx_passwdfile_text), SYNCHDB_METADATA_PATH_SIZE);
 
-		if (VARSIZE(jmx_accessfile_text) - VARHDRSZ == 0 ||
-				VARSIZE(jmx_accessfile_text) - VARHDRSZ > SYNCHDB_METADATA_PATH_SIZE)
+		if (pg_datatype_len > 0 && (ext_datatype_scale == 0 || ext_datatype_scale == -1))
 		{
-			ereport(ERROR,
-					(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
-					 errmsg("jmx auth password file cannot be empty or longer than %d",
-							 SYNCHDB_METADATA_PATH_SIZE)));
+			appendStringInfo(&strinfo, "(%d)",
+					pg_datatype_len);
+			PG_RETURN_TEXT_P(cstring_to_text(strinfo.data));
 		}
-		strlcpy(jmxconninfo.jmx_auth_accessfile, text_to_cstring(jmx_accessfile_text), SYNCHDB_METADATA_PATH_SIZE);
-	}
-	else
-	{
-		strlcpy(jmxconninfo.jmx_auth_passwdfile, "null", SYNCHDB_METADATA_PATH_SIZE);
-		strlcpy(jmxconninfo.jmx_auth_accessfile, "null", SYNCHDB_METADATA_PATH_SIZE);
-	}
-
-	jmxconninfo.jmx_ssl = jmx_ssl;
-	if (jmxconninfo.jmx_ssl)
-	{
-		if (VARSIZE(jmx_keystore_text) - VARHDRSZ == 0)
-			strlcpy(jmxconninfo.jmx_ssl_keystore, "null", SYNCHDB_CONNINFO_KEYSTORE_SIZE);
-		else if (VARSIZE(jmx_keystore_text) - VARHDRSZ > SYNCHDB_CONNINFO_KEYSTORE_SIZE)
-			ereport(ERROR,
-					(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
-					 errmsg("ssl_keystore cannot be longer than %d",
-							 SYNCHDB_CONNINFO_KEYSTORE_SIZE)));
-		else
-			strlcpy(jmxconninfo.jmx_ssl_keystore, text_to_cstring(jmx_keystore_text), SYNCHDB_CONNINFO_KEYSTORE_SIZE);
-
-		if (VARSIZE(jmx_keystore_pass_text) - VARHDRSZ == 0)
-			strlcpy(jmxconninfo.jmx_ssl_keystore_pass, "null", SYNCHDB_CONNINFO_PASSWORD_SIZE);
-		else if (VARSIZE(jmx_keystore_pass_text) - VARHDRSZ > SYNCHDB_CONNINFO_PASSWORD_SIZE)
-			ereport(ERROR,
-					(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
-					 errmsg("ssl_keystore_pass cannot be longer than %d",
-							 SYNCHDB_CONNINFO_PASSWORD_SIZE)));
-		else
-			strlcpy(jmxconninfo.jmx_ssl_keystore_pass, text_to_cstring(jmx_keystore_pass_text), SYNCHDB_CONNINFO_PASSWORD_SIZE);
-
-		if (VARSIZE(jmx_truststore_text) - VARHDRSZ == 0)
-			strlcpy(jmxconninfo.jmx_ssl_truststore, "null", SYNCHDB_CONNINFO_KEYSTORE_SIZE);
-		else if (VARSIZE(jmx_truststore_text) - VARHDRSZ > SYNCHDB_CONNINFO_KEYSTORE_SIZE)
-			ereport(ERROR,
-					(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
-					 errmsg("ssl_truststore cannot be longer than %d",
-							 SYNCHDB_CONNINFO_KEYSTORE_SIZE)));
-		else
-			strlcpy(jmxconninfo.jmx_ssl_truststore, text_to_cstring(jmx_truststore_text), SYNCHDB_CONNINFO_KEYSTORE_SIZE);
 
-		if (VARSIZE(jmx_truststore_pass_text) - VARHDRSZ == 0)
-			strlcpy(jmxconninfo.jmx_ssl_truststore_pass, "null", SYNCHDB_CONNINFO_PASSWORD_SIZE);
-		else if (VARSIZE(jmx_truststore_pass_text) - VARHDRSZ > SYNCHDB_CONNINFO_PASSWORD_SIZE)
-			ereport(ERROR,
-					(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
-					 errmsg("ssl_truststore_pass cannot be longer than %d",
-							 SYNCHDB_CONNINFO_PASSWORD_SIZE)));
-		else
-			strlcpy(jmxconninfo.jmx_ssl_truststore_pass, text_to_cstring(jmx_truststore_pass_text), SYNCHDB_CONNINFO_PASSWORD_SIZE);
-	}
-	else
-	{
-		strlcpy(jmxconninfo.jmx_ssl_keystore, "null", SYNCHDB_CONNINFO_KEYSTORE_SIZE);
-		strlcpy(jmxconninfo.jmx_ssl_keystore_pass, "null", SYNCHDB_CONNINFO_PASSWORD_SIZE);
-		strlcpy(jmxconninfo.jmx_ssl_truststore, "null", SYNCHDB_CONNINFO_KEYSTORE_SIZE);
-		strlcpy(jmxconninfo.jmx_ssl_truststore_pass, "null", SYNCHDB_CONNINFO_PASSWORD_SIZE);
+		PG_RETURN_TEXT_P(cstring_to_text(strinfo.data));
 	}
 
-	appendStringInfo(&strinfo, "UPDATE %s SET data = data || json_build_object("
-			"'jmx_listenaddr', '%s', "
-			"'jmx_port', %u, "
-			"'jmx_rmi_address', '%s', "
-			"'jmx_rmi_port', %u, "
-			"'jmx_auth', %s, "
-			"'jmx_auth_passwdfile', (CASE WHEN '%s' = 'null' THEN null ELSE '%s' END), "
-			"'jmx_auth_accessfile', (CASE WHEN '%s' = 'null' THEN null ELSE '%s' END), "
-			"'jmx_ssl', %s, "
-			"'jmx_ssl_keystore', (CASE WHEN '%s' = 'null' THEN null ELSE '%s' END), "
-			"'jmx_ssl_keystore_pass', (CASE WHEN '%s' = 'null' THEN null ELSE pgp_sym_encrypt('%s', '%s') END), "
-			"'jmx_ssl_truststore', (CASE WHEN '%s' = 'null' THEN null ELSE '%s' END), "
-			"'jmx_ssl_truststore_pass', (CASE WHEN '%s' = 'null' THEN null ELSE pgp_sym_encrypt('%s', '%s') END))::jsonb "
-			"WHERE name = '%s'",
-			SYNCHDB_CONNINFO_TABLE,
-			jmxconninfo.jmx_listenaddr,
-			jmxconninfo.jmx_port,
-			jmxconninfo.jmx_rmiserveraddr,
-			jmxconninfo.jmx_rmiport,
-			jmxconninfo.jmx_auth ? "true" : "false",
-			jmxconninfo.jmx_auth_passwdfile,
-			jmxconninfo.jmx_auth_passwdfile,
-			jmxconninfo.jmx_auth_accessfile,
-			jmxconninfo.jmx_auth_accessfile,
-			jmxconninfo.jmx_ssl ? "true" : "false",
-			jmxconninfo.jmx_ssl_keystore,
-			jmxconninfo.jmx_ssl_keystore,
-			jmxconninfo.jmx_ssl_keystore_pass,
-			jmxconninfo.jmx_ssl_keystore_pass,
-			SYNCHDB_SECRET,
-			jmxconninfo.jmx_ssl_truststore,
-			jmxconninfo.jmx_ssl_truststore,
-			jmxconninfo.jmx_ssl_truststore_pass,
-			jmxconninfo.jmx_ssl_truststore_pass,
-			SYNCHDB_SECRET,
-			NameStr(*name));
-
-	PG_RETURN_INT32(ra_executeCommand(strinfo.data));
+	/* no mapping available, default to text */
+	PG_RETURN_TEXT_P(cstring_to_text("text"));
 }
 
-/*
- * synchdb_del_extra_conninfo
- *
- * This function deletes all extra connector parameters created by synchdb_add_extra_conninfo()
- */
 Datum
-synchdb_del_jmx_conninfo(PG_FUNCTION_ARGS)
+synchdb_set_snapstats(PG_FUNCTION_ARGS)
 {
 	Name name = PG_GETARG_NAME(0);
-	StringInfoData strinfo;
-	initStringInfo(&strinfo);
+	int64 tables_inc = PG_GETARG_INT64(1);
+	int64 rows_inc = PG_GETARG_INT64(2);
+	int64 begintime = PG_GETARG_INT64(3);
+	int64 endtime = PG_GETARG_INT64(4);
+	SnapshotStatistics mysnapstats;
+	int connectorId = -1;
 
-	appendStringInfo(&strinfo, "UPDATE %s SET data = data - ARRAY["
-			"'jmx_listenaddr', "
-			"'jmx_port', "
-			"'jmx_rmi_address', "
-			"'jmx_rmi_port', "
-			"'jmx_auth', "
-			"'jmx_auth_passwdfile', "
-			"'jmx_auth_accessfile', "
-			"'jmx_ssl', "
-			"'jmx_ssl_keystore', "
-			"'jmx_ssl_keystore_pass', "
-			"'jmx_ssl_truststore', "
-			"'jmx_ssl_truststore_pass', "
-			"'jmx_exporter', "
-			"'jmx_exporter_port', "
-			"'jmx_exporter_conf'] "
-			"WHERE name = '%s'",
-			SYNCHDB_CONNINFO_TABLE,
-			NameStr(*name));
-	PG_RETURN_INT32(ra_executeCommand(strinfo.data));
+	/*
+	 * attach or initialize synchdb shared memory area so we know what is
+	 * going on
+	 */
+	synchdb_init_shmem();
+	if (!sdb_state)
+		ereport(ERROR,
+				(errcode(ERRCODE_INTERNAL_ERROR),
+				 errmsg("failed to init or attach to synchdb shared memory")));
+
+	connectorId = get_shm_connector_id_by_name(NameStr(*name), get_database_name(MyDatabaseId));
+	if (connectorId < 0)
+	{
+		ereport(ERROR,
+				(errcode(ERRCODE_INTERNAL_ERROR),
+				 errmsg("no connector id assigned for connector %s", NameStr(*name))));
+	}
+
+	mysnapstats.snapstats_tables = (unsigned long long) tables_inc;
+	mysnapstats.snapstats_rows = (unsigned long long) rows_inc;
+	mysnapstats.snapstats_begintime_ts = (unsigned long long) begintime;
+	mysnapstats.snapstats_endtime_ts = (unsigned long long) endtime;
+
+	set_shm_connector_snapshot_statistics(connectorId, &mysnapstats);
+
+	PG_RETURN_VOID();
 }
 
 /*
- * synchdb_add_jmx_exporter_conninfo
+ * synchdb_insert_frozen
  *
- * This function configures extra JMX exporter related parameters to a connector
+ * insert the result of a SELECT query into a table as pre-frozen tuples,
+ * used by FDW based initial snapshot. Returns number of rows inserted
  */
 Datum
-synchdb_add_jmx_exporter_conninfo(PG_FUNCTION_ARGS)
+synchdb_insert_frozen(PG_FUNCTION_ARGS)
 {
-	Name name = PG_GETARG_NAME(0);
+	Oid relid = PG_GETARG_OID(0);
+	char * dstlist = text_to_cstring(PG_GETARG_TEXT_PP(1));
+	char * query = text_to_cstring(PG_GETARG_TEXT_PP(2));
+	int64 nrows = 0;
 
-	/* jmx exporter options (for prometheus and graphana) */
-	text * jmx_exporterpath_text = PG_GETARG_TEXT_PP(1);
-	unsigned int jmx_exporterport =  PG_GETARG_UINT32(2);
-	text * jmx_exporterconf_text = PG_GETARG_TEXT_PP(3);
+	nrows = ra_bulkInsertFrozen(relid, dstlist, query);
 
-	JMXConnectionInfo jmxconninfo = {0};
-	StringInfoData strinfo;
-	initStringInfo(&strinfo);
+	pfree(dstlist);
+	pfree(query);
+	PG_RETURN_INT64(nrows);
+}
 
-	/* Sanity check on input arguments */
-	if (VARSIZE(jmx_exporterpath_text) - VARHDRSZ == 0 ||
-			VARSIZE(jmx_exporterpath_text) - VARHDRSZ > SYNCHDB_METADATA_PATH_SIZE)
+/*
+ * synchdb_capture_batch - append a change event batch to the capture file
+ *
+ * When synchdb.event_capture_dir is set, the connector worker appends every
+ * 'B' framed batch it receives verbatim to <dir>/<name>_<dstdb>.batch. The
+ * file can then be fed to synchdb_replay_events() to reproduce or benchmark
+ * the change event pipeline without the source database.
+ *
+ * @param connectorId: Connector ID of interest
+ * @param marker: The batch marker to write, always 'B' in a capture file
+ * @param data: The batch following its marker byte
+ * @param len: Length of data in bytes
+ */
+void
+synchdb_capture_batch(int connectorId, char marker, const char * data, Size len)
+{
+	static FILE * capfile = NULL;
+	static char cappath[MAXPGPATH] = {0};
+	char path[MAXPGPATH] = {0};
+
+	if (!synchdb_event_capture_dir || strlen(synchdb_event_capture_dir) == 0)
 	{
-		ereport(ERROR,
-				(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
-				 errmsg("jmx exporter jar library path cannot be empty or longer than %d",
-						 SYNCHDB_METADATA_PATH_SIZE)));
+		if (capfile)
+		{
+			fclose(capfile);
+			capfile = NULL;
+			memset(cappath, 0, MAXPGPATH);
+		}
+		return;
 	}
-	strlcpy(jmxconninfo.jmx_exporter, text_to_cstring(jmx_exporterpath_text),
-			SYNCHDB_METADATA_PATH_SIZE);
 
-	jmxconninfo.jmx_exporter_port = jmx_exporterport;
-	if (jmxconninfo.jmx_exporter_port == 0 || jmxconninfo.jmx_exporter_port > 65535)
+	snprintf(path, MAXPGPATH, "%s/%s_%s.batch", synchdb_event_capture_dir,
+			get_shm_connector_name_by_id(connectorId),
+			sdb_state->connectors[connectorId].conninfo.dstdb);
+
+	/* capture directory has been changed by a reload */
+	if (capfile && strcmp(path, cappath) != 0)
 	{
-		ereport(ERROR,
-				(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
-				 errmsg("invalid jmx exporter port number")));
+		fclose(capfile);
+		capfile = NULL;
 	}
 
-	if (VARSIZE(jmx_exporterconf_text) - VARHDRSZ == 0 ||
-			VARSIZE(jmx_exporterconf_text) - VARHDRSZ > SYNCHDB_METADATA_PATH_SIZE)
+	if (!capfile)
 	{
-		ereport(ERROR,
-				(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
-				 errmsg("jmx exporter conf file path cannot be empty or longer than %d",
-						 SYNCHDB_METADATA_PATH_SIZE)));
+		capfile = fopen(path, PG_BINARY_A);
+		if (!capfile)
+		{
+			ereport(WARNING,
+					(errcode_for_file_access(),
+					 errmsg("could not open capture file \"%s\": %m", path)));
+			return;
+		}
+		strlcpy(cappath, path, MAXPGPATH);
+		elog(LOG, "capturing change event batches to %s", path);
 	}
-	strlcpy(jmxconninfo.jmx_exporter_conf, text_to_cstring(jmx_exporterconf_text),
-			SYNCHDB_METADATA_PATH_SIZE);
-
-
-	appendStringInfo(&strinfo, "UPDATE %s SET data = data || json_build_object("
-			"'jmx_exporter', '%s', "
-			"'jmx_exporter_port', %u, "
-			"'jmx_exporter_conf', '%s')::jsonb "
-			"WHERE name = '%s'",
-			SYNCHDB_CONNINFO_TABLE,
-			jmxconninfo.jmx_exporter,
-			jmxconninfo.jmx_exporter_port,
-			jmxconninfo.jmx_exporter_conf,
-			NameStr(*name));
 
-	PG_RETURN_INT32(ra_executeCommand(strinfo.data));
+	if (fputc(marker, capfile) == EOF || fwrite(data, 1, len, capfile) != len ||
+		fflush(capfile) != 0)
+		ereport(WARNING,
+				(errcode_for_file_access(),
+				 errmsg("could not write to capture file \"%s\": %m", path)));
 }
 
 /*
- * synchdb_del_extra_conninfo
+ * replay_charge_state - charge CPU time used so far to the current replay state
  *
- * This function deletes all extra connector parameters created by synchdb_add_extra_conninfo()
+ * @param next: The connector state that starts now
  */
-Datum
-synchdb_del_jmx_exporter_conninfo(PG_FUNCTION_ARGS)
+static void
+replay_charge_state(ConnectorState next)
 {
-	Name name = PG_GETARG_NAME(0);
-	StringInfoData strinfo;
-	initStringInfo(&strinfo);
+	struct rusage now;
 
-	appendStringInfo(&strinfo, "UPDATE %s SET data = data - ARRAY["
-			"'jmx_exporter', "
-			"'jmx_exporter_port', "
-			"'jmx_exporter_conf'] "
-			"WHERE name = '%s'",
-			SYNCHDB_CONNINFO_TABLE,
-			NameStr(*name));
-	PG_RETURN_INT32(ra_executeCommand(strinfo.data));
+	getrusage(RUSAGE_SELF, &now);
+	replayStateCpuMs[replayState] +=
+		(now.ru_utime.tv_sec - replayLastUsage.ru_utime.tv_sec) * 1000.0 +
+		(now.ru_utime.tv_usec - replayLastUsage.ru_utime.tv_usec) / 1000.0 +
+		(now.ru_stime.tv_sec - replayLastUsage.ru_stime.tv_sec) * 1000.0 +
+		(now.ru_stime.tv_usec - replayLastUsage.ru_stime.tv_usec) / 1000.0;
+
+	replayLastUsage = now;
+	replayState = next;
 }
 
 /*
- * synchdb_add_olr_conninfo
+ * replay_release_connector - give back the connector slot borrowed by a replay
  *
- * This function configures optional Openlog Replicator parameters to a Oracle
- * connector. Having this enables Openlog Replicator adapter instead of the default
- * Logminer.
+ * Registered as error cleanup callback so the slot does not stay owned by
+ * this backend if the replay fails half way. The object mappings loaded for
+ * the replay are released as well.
+ *
+ * @param code: exit code, unused
+ * @param arg: A Datum containing the connector ID
  */
-Datum
-synchdb_add_olr_conninfo(PG_FUNCTION_ARGS)
+static void
+replay_release_connector(int code, Datum arg)
 {
-	Name name = PG_GETARG_NAME(0);
-	text * olr_host_text = PG_GETARG_TEXT_PP(1);
-	unsigned int olr_port = PG_GETARG_UINT32(2);
-	text * olr_source_text = PG_GETARG_TEXT_PP(3);
+	int connectorId = DatumGetInt32(arg);
 
-	OLRConnectionInfo olrconninfo = {0};
-	StringInfoData strinfo;
-	initStringInfo(&strinfo);
+	replayTiming = false;
+	g_eventStr = NULL;
 
-	if (VARSIZE(olr_host_text) - VARHDRSZ == 0 ||
-			VARSIZE(olr_host_text) - VARHDRSZ > SYNCHDB_CONNINFO_HOSTNAME_SIZE)
+	if (get_shm_connector_pid(connectorId) == MyProcPid)
 	{
-		ereport(ERROR,
-				(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
-				 errmsg("Openlog Replicator host address cannot be empty or longer than %d",
-						 SYNCHDB_CONNINFO_HOSTNAME_SIZE)));
+		set_shm_connector_pid(connectorId, InvalidPid);
+		set_shm_connector_state(connectorId, STATE_UNDEF);
 	}
-	strlcpy(olrconninfo.olr_host, text_to_cstring(olr_host_text), SYNCHDB_CONNINFO_HOSTNAME_SIZE);
+	myConnectorId = -1;
 
-	olrconninfo.olr_port = olr_port;
-	if (olrconninfo.olr_port == 0 || olrconninfo.olr_port > 65535)
+	fc_deinitDataCache();
+	fc_unload_objmap();
+	if (replayObjmapContext)
 	{
-		ereport(ERROR,
-				(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
-				 errmsg("invalid port number")));
+		MemoryContextDelete(replayObjmapContext);
+		replayObjmapContext = NULL;
 	}
+}
 
-	if (VARSIZE(olr_source_text) - VARHDRSZ == 0 ||
-			VARSIZE(olr_source_text) - VARHDRSZ > SYNCHDB_CONNINFO_NAME_SIZE)
-	{
-		ereport(ERROR,
-				(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
-				 errmsg("Openlog Replicator data source cannot be empty or longer than %d",
-						 SYNCHDB_CONNINFO_NAME_SIZE)));
-	}
-	strlcpy(olrconninfo.olr_source, text_to_cstring(olr_source_text), SYNCHDB_CONNINFO_NAME_SIZE);
+/*
+ * replay_read_uint32 - read a network order 4 bytes integer from a replay file
+ *
+ * @param fp: The replay file
+ * @param val: Set to the integer read in host order
+ *
+ * @return: true on success, false if the file is truncated
+ */
+static bool
+replay_read_uint32(FILE * fp, uint32 * val)
+{
+	uint32 netval = 0;
 
-	appendStringInfo(&strinfo, "UPDATE %s SET data = data || json_build_object("
-			"'olr_host', '%s', "
-			"'olr_port', %u, "
-			"'olr_source', '%s')::jsonb "
-			"WHERE name = '%s'",
-			SYNCHDB_CONNINFO_TABLE,
-			olrconninfo.olr_host,
-			olrconninfo.olr_port,
-			olrconninfo.olr_source,
-			NameStr(*name));
+	if (fread(&netval, 1, 4, fp) != 4)
+		return false;
 
-	PG_RETURN_INT32(ra_executeCommand(strinfo.data));
+	*val = ntohl(netval);
+	return true;
 }
 
 /*
- * synchdb_del_olr_conninfo
+ * replay_process_event - hand one replayed change event to its event handler
  *
- * This function deletes all Openlog Replicator parameters created by synchdb_add_olr_conninfo()
+ * @param type: The connector type the events were captured from
+ * @param connInfo: Connection info of the connector
+ * @param event: The null-terminated change event
+ * @param len: Length of the change event without the null terminator
+ * @param myBatchStats: update connector statistics to this struct
+ * @param isfirst: true if this is the first event of the batch
+ * @param islast: true if this is the last event of the batch
  */
-Datum
-synchdb_del_olr_conninfo(PG_FUNCTION_ARGS)
+static void
+replay_process_event(ConnectorType type, const ConnectionInfo * connInfo, char * event,
+		int len, SynchdbStatistics * myBatchStats, bool isfirst, bool islast)
 {
-	Name name = PG_GETARG_NAME(0);
-	StringInfoData strinfo;
-	initStringInfo(&strinfo);
+	if (synchdb_log_event_on_error)
+		g_eventStr = event;
 
-	appendStringInfo(&strinfo, "UPDATE %s SET data = data - ARRAY["
-			"'olr_host', "
-			"'olr_port', "
-			"'olr_source'] "
-			"WHERE name = '%s'",
-			SYNCHDB_CONNINFO_TABLE,
-			NameStr(*name));
-	PG_RETURN_INT32(ra_executeCommand(strinfo.data));
+	if (type != TYPE_OLR)
+	{
+		fc_processDBZChangeEvent(event, myBatchStats, connInfo->flag, connInfo->name,
+				isfirst, islast);
+	}
+#ifdef WITH_OLR
+	else
+	{
+		bool sendconfirm = false;
+
+		if (olr_payload_format == OLR_PAYLOAD_PROTOBUF)
+		{
+			OpenLogReplicator__Pb__RedoResponse * response =
+				open_log_replicator__pb__redo_response__unpack(NULL, len,
+						(unsigned char *) event);
+
+			if (response)
+			{
+				fc_processOLRProtobufEvent(response, myBatchStats, connInfo->name,
+						&sendconfirm, isfirst, islast);
+				open_log_replicator__pb__redo_response__free_unpacked(response, NULL);
+			}
+			else
+			{
+				elog(WARNING,"malformed protobuf message - NULL response");
+				increment_connector_statistics(myBatchStats, STATS_BAD_CHANGE_EVENT, 1);
+			}
+		}
+		else
+		{
+#if SYNCHDB_PG_MAJOR_VERSION >= 1700
+			text * json_payload = cstring_to_text_with_len(event, len);
+
+			fc_processOLRChangeEvent(json_payload, myBatchStats, connInfo->name,
+					&sendconfirm, isfirst, islast);
+			pfree(json_payload);
+#else
+			fc_processOLRChangeEvent(event, myBatchStats, connInfo->name,
+					&sendconfirm, isfirst, islast);
+#endif
+		}
+	}
+#endif
+	g_eventStr = NULL;
 }
 
 /*
- * synchdb_del_conninfo
+ * synchdb_replay_events
  *
- * This function deletes a connector info record created by synchdb_add_conninfo()
+ * This function feeds a file of 'B' framed change event batches, as written by
+ * synchdb.event_capture_dir, through the event handlers of the given connector
+ * in the current transaction and reports throughput and the CPU time spent
+ * parsing, converting and executing the events. The connector must not be
+ * running while its events are replayed.
  */
 Datum
-synchdb_del_conninfo(PG_FUNCTION_ARGS)
+synchdb_replay_events(PG_FUNCTION_ARGS)
 {
 	Name name = PG_GETARG_NAME(0);
+	char * path = text_to_cstring(PG_GETARG_TEXT_PP(1));
+	ConnectionInfo connInfo = {0};
+	char * connector = NULL;
+	ConnectorType type;
 	int connectorId = -1;
-	pid_t pid = InvalidPid;
-	StringInfoData strinfo;
-	initStringInfo(&strinfo);
-	synchdb_init_shmem();
+	pid_t pid;
+	TupleDesc tupdesc;
+	Datum values[11];
+	bool nulls[11] = {0};
+	SynchdbStatistics myBatchStats = {0};
+	MemoryContext oldContext;
+	FILE * fp = NULL;
+	StringInfoData event;
+	instr_time starttime, duration;
+	struct rusage startusage;
+	int64 nbatches = 0, nevents = 0, nbytes = 0;
+	double elapsed_ms = 0, cpu_ms = 0;
+	int marker = 0;
+
+	if (!has_privs_of_role(GetUserId(), ROLE_PG_READ_SERVER_FILES))
+		ereport(ERROR,
+				(errcode(ERRCODE_INSUFFICIENT_PRIVILEGE),
+				 errmsg("permission denied to replay change events from a file"),
+				 errdetail("Only roles with privileges of the \"%s\" role may replay change events.",
+						   "pg_read_server_files")));
+
+	if (get_call_result_type(fcinfo, NULL, &tupdesc) != TYPEFUNC_COMPOSITE)
+		elog(ERROR, "return type must be a row type");
+
+	if (ra_getConninfoByName(NameStr(*name), &connInfo, &connector))
+		ereport(ERROR,
+				(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+				 errmsg("connection name does not exist"),
+				 errhint("use synchdb_add_conninfo to add one first")));
+
+	type = fc_get_connector_type(connector);
+#ifndef WITH_OLR
+	if (type == TYPE_OLR)
+		ereport(ERROR,
+				(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+				 errmsg("synchdb is not built with openlog replicator support")));
+#endif
 
+	synchdb_init_shmem();
 	if (!sdb_state)
 		ereport(ERROR,
 				(errcode(ERRCODE_INTERNAL_ERROR),
 				 errmsg("failed to init or attach to synchdb shared memory")));
 
-	/* if connector is running, we will attemppt to shut it down */
-	connectorId = get_shm_connector_id_by_name(NameStr(*name), get_database_name(MyDatabaseId));
-	if (connectorId >= 0)
-	{
-		pid = get_shm_connector_pid(connectorId);
-		if (pid != InvalidPid)
+	connectorId = assign_connector_id(connInfo.name, connInfo.dstdb);
+	if (connectorId == -1)
+		ereport(ERROR,
+				(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+				 errmsg("max number of connectors reached"),
+				 errhint("use synchdb_stop_engine_bgw to stop some active connectors")));
+
+	pid = get_shm_connector_pid(connectorId);
+	if (pid != InvalidPid)
+		ereport(ERROR,
+				(errmsg("dbz connector (%s) is running under PID %d", NameStr(*name), (int) pid),
+				 errhint("use synchdb_stop_engine_bgw() to stop it before replaying its events")));
+
+	/* borrow the connector slot so the event handlers see a regular connector */
+	save_shm_conninfo(&connInfo, type, connectorId, "never");
+	set_shm_connector_pid(connectorId, MyProcPid);
+	set_shm_connector_stage(connectorId, STAGE_CHANGE_DATA_CAPTURE);
+	set_shm_connector_errmsg(connectorId, NULL);
+	myConnectorId = connectorId;
+
+	PG_ENSURE_ERROR_CLEANUP(replay_release_connector, Int32GetDatum(connectorId));
+	{
+		/* object mappings only live for this call, the backend may replay again */
+		replayObjmapContext = AllocSetContextCreate(TopMemoryContext,
+				"synchdb replay objmap", ALLOCSET_DEFAULT_SIZES);
+		oldContext = MemoryContextSwitchTo(replayObjmapContext);
+		fc_load_objmap(connInfo.name, type);
+		MemoryContextSwitchTo(oldContext);
+		fc_initDataCache();
+
+		fp = AllocateFile(path, PG_BINARY_R);
+		if (!fp)
+			ereport(ERROR,
+					(errcode_for_file_access(),
+					 errmsg("could not open file \"%s\" for reading: %m", path)));
+
+		initStringInfo(&event);
+
+		memset(replayStateCpuMs, 0, sizeof(replayStateCpuMs));
+		memset(&myLatencyStats, 0, sizeof(LatencyStatistics));
+		INSTR_TIME_SET_CURRENT(starttime);
+		getrusage(RUSAGE_SELF, &startusage);
+		replayLastUsage = startusage;
+		replayState = STATE_SYNCING;
+		replayTiming = true;
+		set_shm_connector_state(connectorId, STATE_SYNCING);
+
+		while ((marker = fgetc(fp)) != EOF)
 		{
-			elog(WARNING, "terminating dbz connector (%s) with pid %d. Shutdown timeout: %d ms",
-					NameStr(*name), (int)pid, DEBEZIUM_SHUTDOWN_TIMEOUT_MSEC);
-			DirectFunctionCall2(pg_terminate_backend, UInt32GetDatum(pid), Int64GetDatum(DEBEZIUM_SHUTDOWN_TIMEOUT_MSEC));
-			set_shm_connector_pid(connectorId, InvalidPid);
+			uint32 batchid = 0, batchsize = 0, curr = 0;
+
+			if (marker != 'B')
+				ereport(ERROR,
+						(errcode(ERRCODE_DATA_CORRUPTED),
+						 errmsg("unexpected batch marker 0x%02x at offset " INT64_FORMAT " of \"%s\"",
+								 marker, nbytes, path)));
 
+			if (!replay_read_uint32(fp, &batchid) || !replay_read_uint32(fp, &batchsize))
+				ereport(ERROR,
+						(errcode(ERRCODE_DATA_CORRUPTED),
+						 errmsg("truncated batch header at offset " INT64_FORMAT " of \"%s\"",
+								 nbytes, path)));
+			nbytes += 9;
+
+			elog(DEBUG1, "replaying batch id %u with %u change events", batchid, batchsize);
+
+			for (curr = 0; curr < batchsize; curr++)
+			{
+				uint32 json_len = 0;
+
+				CHECK_FOR_INTERRUPTS();
+
+				if (!replay_read_uint32(fp, &json_len))
+					ereport(ERROR,
+							(errcode(ERRCODE_DATA_CORRUPTED),
+							 errmsg("truncated change event at offset " INT64_FORMAT " of \"%s\"",
+									 nbytes, path)));
+				nbytes += 4;
+
+				/* json_len includes the null terminator */
+				if (json_len == 0)
+					continue;
+
+				if (json_len >= MaxAllocSize)
+					ereport(ERROR,
+							(errcode(ERRCODE_DATA_CORRUPTED),
+							 errmsg("invalid change event length %u at offset " INT64_FORMAT " of \"%s\"",
+									 json_len, nbytes, path)));
+
+				resetStringInfo(&event);
+				enlargeStringInfo(&event, json_len);
+				if (fread(event.data, 1, json_len, fp) != json_len)
+					ereport(ERROR,
+							(errcode(ERRCODE_DATA_CORRUPTED),
+							 errmsg("truncated change event at offset " INT64_FORMAT " of \"%s\"",
+									 nbytes, path)));
+				event.len = json_len - 1;
+				event.data[event.len] = '\0';
+				nbytes += json_len;
+
+				replay_process_event(type, &connInfo, event.data, event.len, &myBatchStats,
+						(curr == 0), (curr == batchsize - 1));
+				nevents++;
+			}
+			nbatches++;
 		}
-	}
 
-	/* remove the connector info record */
-	appendStringInfo(&strinfo, "DELETE FROM %s WHERE name = '%s';"
-			"DELETE FROM %s WHERE name = '%s';"
-			"DELETE FROM %s WHERE name = '%s';",
-			SYNCHDB_CONNINFO_TABLE,
-			NameStr(*name),
-			SYNCHDB_ATTRIBUTE_TABLE,
-			NameStr(*name),
-			SYNCHDB_OBJECT_MAPPING_TABLE,
-			NameStr(*name));
+		/* charge whatever is left to the polling state and stop accounting */
+		replay_charge_state(STATE_SYNCING);
+		replayTiming = false;
+
+		/* replayed events show up in synchdb_latency_stats like live ones */
+		set_shm_connector_latency(connectorId);
+
+		INSTR_TIME_SET_CURRENT(duration);
+		INSTR_TIME_SUBTRACT(duration, starttime);
+		elapsed_ms = INSTR_TIME_GET_MILLISEC(duration);
+		cpu_ms = (replayLastUsage.ru_utime.tv_sec - startusage.ru_utime.tv_sec) * 1000.0 +
+				 (replayLastUsage.ru_utime.tv_usec - startusage.ru_utime.tv_usec) / 1000.0 +
+				 (replayLastUsage.ru_stime.tv_sec - startusage.ru_stime.tv_sec) * 1000.0 +
+				 (replayLastUsage.ru_stime.tv_usec - startusage.ru_stime.tv_usec) / 1000.0;
+
+		FreeFile(fp);
+		pfree(event.data);
+	}
+	PG_END_ENSURE_ERROR_CLEANUP(replay_release_connector, Int32GetDatum(connectorId));
+	replay_release_connector(0, Int32GetDatum(connectorId));
+
+	elog(LOG, "replayed " INT64_FORMAT " change events (" INT64_FORMAT " bad) in "
+			INT64_FORMAT " batches from %s in %.3f ms",
+			nevents, (int64) myBatchStats.genstats.stats_bad_change_event, nbatches,
+			path, elapsed_ms);
+
+	values[0] = Int64GetDatum(nbatches);
+	values[1] = Int64GetDatum(nevents);
+	values[2] = Int64GetDatum(nbytes);
+	values[3] = Float8GetDatum(elapsed_ms);
+	values[4] = Float8GetDatum(cpu_ms);
+	values[5] = Float8GetDatum(elapsed_ms > 0 ? nevents * 1000.0 / elapsed_ms : 0);
+	values[6] = Float8GetDatum(elapsed_ms > 0 ? nbytes * 1000.0 / elapsed_ms : 0);
+	values[7] = Float8GetDatum(replayStateCpuMs[STATE_PARSING]);
+	values[8] = Float8GetDatum(replayStateCpuMs[STATE_CONVERTING]);
+	values[9] = Float8GetDatum(replayStateCpuMs[STATE_EXECUTING]);
+	values[10] = Float8GetDatum(replayStateCpuMs[STATE_SYNCING]);
+
+	PG_RETURN_DATUM(HeapTupleGetDatum(heap_form_tuple(tupdesc, values, nulls)));
+}
 
-	ra_executeCommand(strinfo.data);
-	remove_dbz_metadata_files(NameStr(*name));
+/*
+ * latency_op_from_char - map a change event operation to its latency histogram
+ *
+ * @param op: c, r, u, d or t as used by debezium and openlog replicator
+ *
+ * @return: the LatencyOp of the operation
+ */
+LatencyOp
+latency_op_from_char(char op)
+{
+	switch (op)
+	{
+		case 'r':
+			return LATENCY_OP_SNAPSHOT;
+		case 'u':
+			return LATENCY_OP_UPDATE;
+		case 'd':
+			return LATENCY_OP_DELETE;
+		case 't':
+			return LATENCY_OP_TRUNCATE;
+		case 'c':
+		default:
+			return LATENCY_OP_INSERT;
+	}
+}
 
-	PG_RETURN_INT32(0);
+/*
+ * start_connector_latency - start timing a pipeline stage
+ *
+ * @param since: set to the current time, or zero when latency tracking is off
+ */
+void
+start_connector_latency(instr_time * since)
+{
+	if (synchdb_track_latency)
+		INSTR_TIME_SET_CURRENT(*since);
+	else
+		INSTR_TIME_SET_ZERO(*since);
 }
 
 /*
- * synchdb_del_objmap
+ * add_latency_sample - add the time elapsed since *since to a histogram
  *
- * This function marks a objmap rule as disabled
+ * *since is moved to the current time so consecutive stages can be timed
+ * with one clock. Nothing is recorded if timing was never started.
+ *
+ * @param hist: The histogram to update
+ * @param since: Start time of the stage
  */
-Datum
-synchdb_del_objmap(PG_FUNCTION_ARGS)
+static void
+add_latency_sample(LatencyHistogram * hist, instr_time * since)
 {
-	/* Parse input arguments */
-	Name name = PG_GETARG_NAME(0);
-	Name objtype = PG_GETARG_NAME(1);
-	Name srcobj = PG_GETARG_NAME(2);
+	instr_time now, elapsed;
+	uint64 us = 0;
+	int bucket = 0;
 
-	StringInfoData strinfo;
-	initStringInfo(&strinfo);
+	if (!synchdb_track_latency || INSTR_TIME_IS_ZERO(*since))
+		return;
 
-	if (strcasecmp(NameStr(*objtype), "table") && strcasecmp(NameStr(*objtype), "column") &&
-		strcasecmp(NameStr(*objtype), "datatype") && strcasecmp(NameStr(*objtype), "transform"))
-	{
-		ereport(ERROR,
-				(errcode(ERRCODE_INTERNAL_ERROR),
-				 errmsg("unsupported object type %s", NameStr(*objtype))));
-	}
+	INSTR_TIME_SET_CURRENT(now);
+	elapsed = now;
+	INSTR_TIME_SUBTRACT(elapsed, *since);
+	*since = now;
+
+	us = INSTR_TIME_GET_MICROSEC(elapsed);
+	if (us > 0)
+		bucket = Min(pg_leftmost_one_pos64(us) + 1, SYNCHDB_LATENCY_BUCKETS - 1);
+
+	hist->count++;
+	hist->total_us += us;
+	if (us > hist->max_us)
+		hist->max_us = us;
+	hist->buckets[bucket]++;
+	myLatencyPending = true;
+}
 
-	appendStringInfo(&strinfo, "UPDATE %s SET "
-			"enabled = false WHERE "
-			"name = '%s' AND objtype = trim(lower('%s')) AND "
-			"srcobj = trim(lower('%s'));",
-			SYNCHDB_OBJECT_MAPPING_TABLE,
-			NameStr(*name),
-			NameStr(*objtype),
-			NameStr(*srcobj));
+/*
+ * record_event_latency - record the latency of one stage of a change event
+ *
+ * @param op: The operation of the change event
+ * @param stage: LATENCY_STAGE_PARSE, LATENCY_STAGE_CONVERT or LATENCY_STAGE_EXECUTE
+ * @param since: Start time of the stage, moved to the current time
+ */
+void
+record_event_latency(LatencyOp op, LatencyStage stage, instr_time * since)
+{
+	Assert(op < LATENCY_OP_NUM && stage < LATENCY_EVENT_STAGE_NUM);
 
-	PG_RETURN_INT32(ra_executeCommand(strinfo.data));
+	add_latency_sample(&myLatencyStats.events[op][stage], since);
 }
 
 /*
- * synchdb_add_infinispan
+ * record_batch_latency - record the latency of fetching or committing a batch
  *
- * This function configures an existing oracle connector to use infinispan as
- * cache mechanism to support potentiall large transactions
+ * @param stage: LATENCY_STAGE_FETCH or LATENCY_STAGE_COMMIT
+ * @param since: Start time of the stage, moved to the current time
  */
-Datum
-synchdb_add_infinispan(PG_FUNCTION_ARGS)
+void
+record_batch_latency(LatencyStage stage, instr_time * since)
 {
-	/* Parse input arguments */
-	Name name = PG_GETARG_NAME(0);
-	Name memoryType = PG_GETARG_NAME(1);	/* heap or off heap*/
-	unsigned int memorySize = PG_GETARG_UINT32(2);
+	if (stage == LATENCY_STAGE_FETCH)
+		add_latency_sample(&myLatencyStats.fetch, since);
+	else if (stage == LATENCY_STAGE_COMMIT)
+		add_latency_sample(&myLatencyStats.commit, since);
+}
 
-	IspnInfo ispninfo = {0};
-	StringInfoData strinfo;
-	initStringInfo(&strinfo);
+/*
+ * set_shm_connector_latency - adds the pending latency samples to shared memory
+ *
+ * @param connectorId: Connector ID of interest
+ */
+static void
+set_shm_connector_latency(int connectorId)
+{
+	LatencyHistogram * from = (LatencyHistogram *) &myLatencyStats;
+	LatencyHistogram * to = NULL;
+	int nhist = sizeof(LatencyStatistics) / sizeof(LatencyHistogram);
+	int i = 0, j = 0;
 
-	/* only embedded infinispan is supported as of now */
-	strlcpy(ispninfo.ispn_cache_type, "embedded", INFINISPAN_TYPE_SIZE);
+	if (!myLatencyPending || !sdb_state)
+		return;
 
-	if (strcasecmp(NameStr(*memoryType), "heap") && strcasecmp(NameStr(*memoryType), "off heap"))
+	LWLockAcquire(&sdb_state->lock, LW_EXCLUSIVE);
+	to = (LatencyHistogram *) &sdb_state->connectors[connectorId].latency;
+	for (i = 0; i < nhist; i++)
 	{
-		ereport(ERROR,
-				(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
-				 errmsg("invalid infinispan memory type: expect 'heap' or 'off heap'")));
-	}
-	strlcpy(ispninfo.ispn_memory_type, NameStr(*memoryType), INFINISPAN_TYPE_SIZE);
+		if (from[i].count == 0)
+			continue;
 
-	if (memorySize == 0)
-	{
-		ereport(ERROR,
-				(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
-				 errmsg("invalid infinispan memory size")));
+		to[i].count += from[i].count;
+		to[i].total_us += from[i].total_us;
+		if (from[i].max_us > to[i].max_us)
+			to[i].max_us = from[i].max_us;
+		for (j = 0; j < SYNCHDB_LATENCY_BUCKETS; j++)
+			to[i].buckets[j] += from[i].buckets[j];
 	}
-	ispninfo.ispn_memory_size = memorySize;
+	LWLockRelease(&sdb_state->lock);
 
-	appendStringInfo(&strinfo, "UPDATE %s SET data = data || json_build_object("
-			"'ispn_cache_type', '%s', "	/* only embedded infinispan is supported */
-			"'ispn_memory_type', '%s', "
-			"'ispn_memory_size', %u)::jsonb "
-			"WHERE name = '%s'",
-			SYNCHDB_CONNINFO_TABLE,
-			ispninfo.ispn_cache_type,
-			ispninfo.ispn_memory_type,
-			ispninfo.ispn_memory_size,
-			NameStr(*name));
+	memset(&myLatencyStats, 0, sizeof(LatencyStatistics));
+	myLatencyPending = false;
+}
 
-	PG_RETURN_INT32(ra_executeCommand(strinfo.data));
+/*
+ * latency_percentile - estimate a percentile from a latency histogram
+ *
+ * @param hist: The histogram
+ * @param fraction: The percentile as a fraction between 0 and 1
+ *
+ * @return: the upper bound in microseconds of the bucket holding the percentile
+ */
+static uint64
+latency_percentile(const LatencyHistogram * hist, double fraction)
+{
+	uint64 target = (uint64) ceil(hist->count * fraction);
+	uint64 seen = 0;
+	int i = 0;
+
+	for (i = 0; i < SYNCHDB_LATENCY_BUCKETS - 1; i++)
+	{
+		seen += hist->buckets[i];
+		if (seen >= target)
+			return Min(UINT64CONST(1) << i, hist->max_us);
+	}
+	return hist->max_us;
 }
 
 /*
- * synchdb_del_infinispan
+ * synchdb_get_latency_stats
  *
- * This function deletes infinispan configuration from an existing oracle connector.
- * This removes the configuration as well as the on-disk meta data and cached files.
+ * This function dumps the latency histograms of all connectors, one row per
+ * connector, operation and stage that has seen at least one sample
  */
 Datum
-synchdb_del_infinispan(PG_FUNCTION_ARGS)
+synchdb_get_latency_stats(PG_FUNCTION_ARGS)
 {
-	/* Parse input arguments */
-	int connectorId;
-	pid_t pid;
-	char * ispn_dir = NULL;
-	Name name = PG_GETARG_NAME(0);
-
-	StringInfoData strinfo;
-	initStringInfo(&strinfo);
+	static const char * opnames[LATENCY_OP_NUM] =
+		{"insert", "update", "delete", "truncate", "snapshot", "ddl"};
+	static const char * stagenames[LATENCY_EVENT_STAGE_NUM] =
+		{"parse", "convert", "execute"};
+	ReturnSetInfo * rsinfo = (ReturnSetInfo *) fcinfo->resultinfo;
+	char * dbname = get_database_name(MyDatabaseId);
+	int i = 0, op = 0, stage = 0;
 
-	/*
-	 * attach or initialize synchdb shared memory area so we know what is
-	 * going on
-	 */
 	synchdb_init_shmem();
 	if (!sdb_state)
 		ereport(ERROR,
 				(errcode(ERRCODE_INTERNAL_ERROR),
 				 errmsg("failed to init or attach to synchdb shared memory")));
 
-	connectorId = get_shm_connector_id_by_name(NameStr(*name), get_database_name(MyDatabaseId));
-	if (connectorId > 0)
+	InitMaterializedSRF(fcinfo, 0);
+
+	for (i = 0; i < count_active_connectors(); i++)
 	{
-		pid = get_shm_connector_pid(connectorId);
-		if (pid != InvalidPid)
+		LatencyStatistics latency;
+		char name[SYNCHDB_CONNINFO_NAME_SIZE] = {0};
+
+		/* we only want to show the connectors created in current database */
+		if (strcasecmp(sdb_state->connectors[i].conninfo.dstdb, dbname))
+			continue;
+
+		LWLockAcquire(&sdb_state->lock, LW_SHARED);
+		strlcpy(name, sdb_state->connectors[i].conninfo.name, SYNCHDB_CONNINFO_NAME_SIZE);
+		memcpy(&latency, &sdb_state->connectors[i].latency, sizeof(LatencyStatistics));
+		LWLockRelease(&sdb_state->lock);
+
+		for (op = 0; op <= LATENCY_OP_NUM; op++)
 		{
-			/* still running, check the connector state */
-			ereport(ERROR,
-					(errmsg("the connector needs to be in stopped state before infinispan "
-							"settings can be removed"),
-					errhint("use synchdb_stop_engine_bgw() to stop it first")));
+			for (stage = 0; stage < LATENCY_EVENT_STAGE_NUM; stage++)
+			{
+				const LatencyHistogram * hist = NULL;
+				const char * opname = NULL;
+				const char * stagename = NULL;
+				Datum values[10];
+				bool nulls[10] = {0};
+				Datum buckets[SYNCHDB_LATENCY_BUCKETS];
+				int j = 0;
+
+				if (op < LATENCY_OP_NUM)
+				{
+					hist = &latency.events[op][stage];
+					opname = opnames[op];
+					stagename = stagenames[stage];
+				}
+				else if (stage == 0)
+				{
+					hist = &latency.fetch;
+					opname = "batch";
+					stagename = "fetch";
+				}
+				else if (stage == 1)
+				{
+					hist = &latency.commit;
+					opname = "batch";
+					stagename = "commit";
+				}
+				else
+					break;
+
+				if (hist->count == 0)
+					continue;
+
+				for (j = 0; j < SYNCHDB_LATENCY_BUCKETS; j++)
+					buckets[j] = Int64GetDatum((int64) hist->buckets[j]);
+
+				values[0] = CStringGetTextDatum(name);
+				values[1] = CStringGetTextDatum(opname);
+				values[2] = CStringGetTextDatum(stagename);
+				values[3] = Int64GetDatum((int64) hist->count);
+				values[4] = Int64GetDatum((int64) (hist->total_us / hist->count));
+				values[5] = Int64GetDatum((int64) hist->max_us);
+				values[6] = Int64GetDatum((int64) latency_percentile(hist, 0.50));
+				values[7] = Int64GetDatum((int64) latency_percentile(hist, 0.90));
+				values[8] = Int64GetDatum((int64) latency_percentile(hist, 0.99));
+				values[9] = PointerGetDatum(construct_array_builtin(buckets,
+						SYNCHDB_LATENCY_BUCKETS, INT8OID));
+
+				tuplestore_putvalues(rsinfo->setResult, rsinfo->setDesc, values, nulls);
+			}
 		}
 	}
+	return (Datum) 0;
+}
 
-	/* remove on-disk cache and metadata created by infinispan */
-	ispn_dir = psprintf(SYNCHDB_INFINISPAN_DIR, NameStr(*name), get_database_name(MyDatabaseId));
-
-	if (!rmtree(ispn_dir, true))
-		elog(WARNING, "some infinispan metadata files may be left behind in %s",
-				ispn_dir);
-
-	appendStringInfo(&strinfo, "UPDATE %s SET data = data - ARRAY["
-			"'ispn_cache_type', "
-			"'ispn_memory_type', "
-			"'ispn_memory_size'] "
-			"WHERE name = '%s'",
-			SYNCHDB_CONNINFO_TABLE,
-			NameStr(*name));
-	PG_RETURN_INT32(ra_executeCommand(strinfo.data));
+/*
+ * codec_benchmark_row
+ *
+ * add one result row of synchdb_codec_benchmark
+ */
+static void
+codec_benchmark_row(ReturnSetInfo * rsinfo, const char * codec, const char * impl,
+		instr_time elapsed, int64 nbytes)
+{
+	Datum values[4];
+	bool nulls[4] = {0};
+	double ms = INSTR_TIME_GET_MILLISEC(elapsed);
+
+	values[0] = CStringGetTextDatum(codec);
+	values[1] = CStringGetTextDatum(impl);
+	values[2] = Float8GetDatum(ms);
+	values[3] = Float8GetDatum(ms > 0 ? (nbytes / (1024.0 * 1024.0)) / (ms / 1000.0) : 0);
+	tuplestore_putvalues(rsinfo->setResult, rsinfo->setDesc, values, nulls);
 }
 
+/*
+ * synchdb_codec_benchmark
+ *
+ * This function decodes base64 text and hex encodes binary data of the given
+ * size the given number of times, once with the routines change events used
+ * to be converted with and once with the ones in use now, verifies that both
+ * produce the same output and reports the time each took
+ */
 Datum
-synchdb_translate_datatype(PG_FUNCTION_ARGS)
+synchdb_codec_benchmark(PG_FUNCTION_ARGS)
 {
-	Name type = PG_GETARG_NAME(0);
-	Name ext_datatype = PG_GETARG_NAME(1);
-	int ext_datatype_len = PG_GETARG_INT32(2);
-	int ext_datatype_scale = PG_GETARG_INT32(3);
-	int ext_datatype_precision = PG_GETARG_INT32(4);
+	int32 nbytes = PG_GETARG_INT32(0);
+	int32 iterations = PG_GETARG_INT32(1);
+	ReturnSetInfo * rsinfo = (ReturnSetInfo *) fcinfo->resultinfo;
+	unsigned char * data, * decoded1, * decoded2;
+	char * encoded, * hex1, * hex2;
+	int encodedlen, decodedlen, decodedlen1 = 0, decodedlen2 = 0;
+	instr_time starttime, elapsed;
+	int i, j;
+
+	if (nbytes <= 0 || nbytes > 64 * 1024 * 1024)
+		ereport(ERROR,
+				(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+				 errmsg("nbytes must be between 1 and %d", 64 * 1024 * 1024)));
+	if (iterations <= 0)
+		ereport(ERROR,
+				(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+				 errmsg("iterations must be positive")));
 
-	char * pg_datatype = NULL;
-	int pg_datatype_len = 0;
-	StringInfoData strinfo;
-	ConnectorType connectorType = TYPE_UNDEF;
+	InitMaterializedSRF(fcinfo, 0);
 
-	(void)ext_datatype_precision;
-	initStringInfo(&strinfo);
+	data = palloc(nbytes);
+	for (i = 0; i < nbytes; i++)
+		data[i] = (unsigned char) random();
 
-	connectorType = stringToConnectorType(NameStr(*type));
-	if (connectorType == TYPE_UNDEF)
+	encodedlen = pg_b64_enc_len(nbytes);
+	encoded = palloc(encodedlen + 1);
+#if SYNCHDB_PG_MAJOR_VERSION >= 1800
+	encodedlen = pg_b64_encode(data, nbytes, encoded, encodedlen);
+#else
+	encodedlen = pg_b64_encode((const char *) data, nbytes, encoded, encodedlen);
+#endif
+	decodedlen = pg_b64_dec_len(encodedlen);
+	decoded1 = palloc(decodedlen);
+	decoded2 = palloc(decodedlen);
+	hex1 = palloc(nbytes * 2 + 1);
+	hex2 = palloc(nbytes * 2 + 1);
+
+	/* base64 decoding, as done by the core routine before */
+	INSTR_TIME_SET_CURRENT(starttime);
+	for (j = 0; j < iterations; j++)
 	{
-		elog(WARNING, "unsupported connector type %s", NameStr(*type));
-		PG_RETURN_TEXT_P(cstring_to_text("text"));
+		CHECK_FOR_INTERRUPTS();
+#if SYNCHDB_PG_MAJOR_VERSION >= 1800
+		decodedlen1 = pg_b64_decode(encoded, encodedlen, decoded1, decodedlen);
+#else
+		decodedlen1 = pg_b64_decode(encoded, encodedlen, (char *) decoded1, decodedlen);
+#endif
 	}
+	INSTR_TIME_SET_CURRENT(elapsed);
+	INSTR_TIME_SUBTRACT(elapsed, starttime);
+	codec_benchmark_row(rsinfo, "base64_decode", "pg_b64_decode", elapsed,
+			(int64) nbytes * iterations);
 
-	if (fc_translate_datatype(connectorType, NameStr(*ext_datatype),
-			ext_datatype_len, ext_datatype_scale,
-			&pg_datatype, &pg_datatype_len))
+	INSTR_TIME_SET_CURRENT(starttime);
+	for (j = 0; j < iterations; j++)
 	{
-		appendStringInfo(&strinfo, "%s", pg_datatype);
-
-		/* pg_datatype_len == -1 means to use original length */
-		if (pg_datatype_len == -1)
-			pg_datatype_len = ext_datatype_len;
-
-		if (pg_datatype_len > 0 && ext_datatype_scale > 0)
-		{
-			appendStringInfo(&strinfo, "(%d, %d)",
-					pg_datatype_len, ext_datatype_scale);
-			PG_RETURN_TEXT_P(cstring_to_text(strinfo.data));
-		}
-
-		if (pg_datatype_len > 0 && (ext_datatype_scale == 0 || ext_datatype_scale == -1))
-		{
-			appendStringInfo(&strinfo, "(%d)",
-					pg_datatype_len);
-			PG_RETURN_TEXT_P(cstring_to_text(strinfo.data));
-		}
-
-		PG_RETURN_TEXT_P(cstring_to_text(strinfo.data));
+		CHECK_FOR_INTERRUPTS();
+		decodedlen2 = codec_b64_decode(encoded, encodedlen, decoded2, decodedlen);
 	}
+	INSTR_TIME_SET_CURRENT(elapsed);
+	INSTR_TIME_SUBTRACT(elapsed, starttime);
+	codec_benchmark_row(rsinfo, "base64_decode", codec_impl_name(), elapsed,
+			(int64) nbytes * iterations);
 
-	/* no mapping available, default to text */
-	PG_RETURN_TEXT_P(cstring_to_text("text"));
-}
-
-Datum
-synchdb_set_snapstats(PG_FUNCTION_ARGS)
-{
-	Name name = PG_GETARG_NAME(0);
-	int64 tables_inc = PG_GETARG_INT64(1);
-	int64 rows_inc = PG_GETARG_INT64(2);
-	int64 begintime = PG_GETARG_INT64(3);
-	int64 endtime = PG_GETARG_INT64(4);
-	SnapshotStatistics mysnapstats;
-	int connectorId = -1;
-
-	/*
-	 * attach or initialize synchdb shared memory area so we know what is
-	 * going on
-	 */
-	synchdb_init_shmem();
-	if (!sdb_state)
-		ereport(ERROR,
-				(errcode(ERRCODE_INTERNAL_ERROR),
-				 errmsg("failed to init or attach to synchdb shared memory")));
+	if (decodedlen1 != nbytes || decodedlen2 != decodedlen1 ||
+		memcmp(decoded1, decoded2, decodedlen1) != 0)
+		elog(ERROR, "%s base64 decoder output differs from pg_b64_decode", codec_impl_name());
 
-	connectorId = get_shm_connector_id_by_name(NameStr(*name), get_database_name(MyDatabaseId));
-	if (connectorId < 0)
+	/* hex encoding, as done byte by byte for bytea literals before */
+	INSTR_TIME_SET_CURRENT(starttime);
+	for (j = 0; j < iterations; j++)
 	{
-		ereport(ERROR,
-				(errcode(ERRCODE_INTERNAL_ERROR),
-				 errmsg("no connector id assigned for connector %s", NameStr(*name))));
+		CHECK_FOR_INTERRUPTS();
+		for (i = 0; i < nbytes; i++)
+			sprintf(hex1 + i * 2, "%02X", data[i]);
 	}
+	INSTR_TIME_SET_CURRENT(elapsed);
+	INSTR_TIME_SUBTRACT(elapsed, starttime);
+	codec_benchmark_row(rsinfo, "hex_encode", "sprintf", elapsed,
+			(int64) nbytes * iterations);
 
-	mysnapstats.snapstats_tables = (unsigned long long) tables_inc;
-	mysnapstats.snapstats_rows = (unsigned long long) rows_inc;
-	mysnapstats.snapstats_begintime_ts = (unsigned long long) begintime;
-	mysnapstats.snapstats_endtime_ts = (unsigned long long) endtime;
+	INSTR_TIME_SET_CURRENT(starttime);
+	for (j = 0; j < iterations; j++)
+	{
+		CHECK_FOR_INTERRUPTS();
+		codec_hex_encode(data, nbytes, hex2);
+	}
+	INSTR_TIME_SET_CURRENT(elapsed);
+	INSTR_TIME_SUBTRACT(elapsed, starttime);
+	codec_benchmark_row(rsinfo, "hex_encode", codec_impl_name(), elapsed,
+			(int64) nbytes * iterations);
 
-	set_shm_connector_snapshot_statistics(connectorId, &mysnapstats);
+	if (memcmp(hex1, hex2, nbytes * 2) != 0)
+		elog(ERROR, "%s hex encoder output differs from sprintf", codec_impl_name());
 
-	PG_RETURN_VOID();
+	return (Datum) 0;
 }
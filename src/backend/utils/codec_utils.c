@@ -0,0 +1,316 @@
+/*
+ * codec_utils.c
+ *
+ * Implementation of base64 decoding and hex encoding routines
+ *
+ * Debezium delivers DECIMAL, BIT, binary and some temporal values as base64
+ * text, and binary values are applied as hex escaped bytea literals. On x86-64
+ * these routines process 16 or 32 bytes at a time with SSE4.1 or AVX2, chosen
+ * at first use according to what the CPU supports. Elsewhere, and for input
+ * the vector loops do not handle, they fall back to scalar code.
+ *
+ * Copyright (c) Hornetlabs Technology, Inc.
+ *
+ */
+
+#include "postgres.h"
+#include "common/base64.h"
+#include "utils/codec_utils.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define CODEC_X86_SIMD
+#include <immintrin.h>
+#endif
+
+static const char hexdigits[] = "0123456789ABCDEF";
+
+static int codec_b64_decode_choose(const char *src, int len, unsigned char *dst, int dstlen);
+static void codec_hex_encode_choose(const unsigned char *src, size_t len, char *dst);
+
+/* implementations in use, resolved at first call */
+static int (*codec_b64_decode_impl) (const char *src, int len, unsigned char *dst,
+		int dstlen) = codec_b64_decode_choose;
+static void (*codec_hex_encode_impl) (const unsigned char *src, size_t len,
+		char *dst) = codec_hex_encode_choose;
+static const char * codec_impl = "scalar";
+
+/*
+ * codec_b64_decode_scalar
+ *
+ * decode with the core routine, which also skips whitespace and validates
+ * padding
+ */
+static int
+codec_b64_decode_scalar(const char *src, int len, unsigned char *dst, int dstlen)
+{
+#if SYNCHDB_PG_MAJOR_VERSION >= 1800
+	return pg_b64_decode(src, len, dst, dstlen);
+#else
+	return pg_b64_decode(src, len, (char *) dst, dstlen);
+#endif
+}
+
+static void
+codec_hex_encode_scalar(const unsigned char *src, size_t len, char *dst)
+{
+	size_t		i;
+
+	for (i = 0; i < len; i++)
+	{
+		*dst++ = hexdigits[src[i] >> 4];
+		*dst++ = hexdigits[src[i] & 0x0F];
+	}
+}
+
+#ifdef CODEC_X86_SIMD
+
+/*
+ * The vector base64 decoder follows Muła and Lemire, "Faster Base64 Encoding
+ * and Decoding Using AVX2 Instructions". A block of characters is translated
+ * to 6-bit values with nibble lookups that also detect characters outside the
+ * alphabet, including padding and whitespace. Such a block and everything
+ * after it is left to the scalar decoder. Blocks always start on a 4 character
+ * boundary, so the scalar decoder takes over at a quantum boundary.
+ */
+__attribute__((target("sse4.1")))
+static int
+codec_b64_decode_sse41(const char *src, int len, unsigned char *dst, int dstlen)
+{
+	const __m128i lut_lo = _mm_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+										 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+	const __m128i lut_hi = _mm_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+										 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+	const __m128i lut_roll = _mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71,
+										   0, 0, 0, 0, 0, 0, 0, 0);
+	const __m128i mask_2f = _mm_set1_epi8(0x2F);
+	const __m128i pack = _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12,
+									   -1, -1, -1, -1);
+	int			i = 0;
+	int			o = 0;
+	int			ret;
+
+	/* each block yields 12 bytes but stores 16 */
+	while (len - i >= 16 && dstlen - o >= 16)
+	{
+		__m128i		str = _mm_loadu_si128((const __m128i *) (src + i));
+		__m128i		hi_nibbles = _mm_and_si128(_mm_srli_epi32(str, 4), mask_2f);
+		__m128i		lo_nibbles = _mm_and_si128(str, mask_2f);
+		__m128i		hi = _mm_shuffle_epi8(lut_hi, hi_nibbles);
+		__m128i		lo = _mm_shuffle_epi8(lut_lo, lo_nibbles);
+		__m128i		eq_2f;
+		__m128i		roll;
+
+		if (!_mm_testz_si128(lo, hi))
+			break;
+
+		eq_2f = _mm_cmpeq_epi8(str, mask_2f);
+		roll = _mm_shuffle_epi8(lut_roll, _mm_add_epi8(eq_2f, hi_nibbles));
+		str = _mm_add_epi8(str, roll);
+
+		/* pack four 6-bit values into three bytes */
+		str = _mm_maddubs_epi16(str, _mm_set1_epi32(0x01400140));
+		str = _mm_madd_epi16(str, _mm_set1_epi32(0x00011000));
+		str = _mm_shuffle_epi8(str, pack);
+
+		_mm_storeu_si128((__m128i *) (dst + o), str);
+		i += 16;
+		o += 12;
+	}
+
+	if (i == len)
+		return o;
+
+	ret = codec_b64_decode_scalar(src + i, len - i, dst + o, dstlen - o);
+	return ret < 0 ? ret : o + ret;
+}
+
+__attribute__((target("avx2")))
+static int
+codec_b64_decode_avx2(const char *src, int len, unsigned char *dst, int dstlen)
+{
+	const __m256i lut_lo = _mm256_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+											0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A,
+											0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+											0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+	const __m256i lut_hi = _mm256_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+											0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+											0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+											0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+	const __m256i lut_roll = _mm256_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71,
+											  0, 0, 0, 0, 0, 0, 0, 0,
+											  0, 16, 19, 4, -65, -65, -71, -71,
+											  0, 0, 0, 0, 0, 0, 0, 0);
+	const __m256i mask_2f = _mm256_set1_epi8(0x2F);
+	const __m256i pack = _mm256_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12,
+										  -1, -1, -1, -1,
+										  2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12,
+										  -1, -1, -1, -1);
+	const __m256i join = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, -1, -1);
+	int			i = 0;
+	int			o = 0;
+	int			ret;
+
+	/* each block yields 24 bytes but stores 32 */
+	while (len - i >= 32 && dstlen - o >= 32)
+	{
+		__m256i		str = _mm256_loadu_si256((const __m256i *) (src + i));
+		__m256i		hi_nibbles = _mm256_and_si256(_mm256_srli_epi32(str, 4), mask_2f);
+		__m256i		lo_nibbles = _mm256_and_si256(str, mask_2f);
+		__m256i		hi = _mm256_shuffle_epi8(lut_hi, hi_nibbles);
+		__m256i		lo = _mm256_shuffle_epi8(lut_lo, lo_nibbles);
+		__m256i		eq_2f;
+		__m256i		roll;
+
+		if (!_mm256_testz_si256(lo, hi))
+			break;
+
+		eq_2f = _mm256_cmpeq_epi8(str, mask_2f);
+		roll = _mm256_shuffle_epi8(lut_roll, _mm256_add_epi8(eq_2f, hi_nibbles));
+		str = _mm256_add_epi8(str, roll);
+
+		/* pack four 6-bit values into three bytes, then join the two lanes */
+		str = _mm256_maddubs_epi16(str, _mm256_set1_epi32(0x01400140));
+		str = _mm256_madd_epi16(str, _mm256_set1_epi32(0x00011000));
+		str = _mm256_shuffle_epi8(str, pack);
+		str = _mm256_permutevar8x32_epi32(str, join);
+
+		_mm256_storeu_si256((__m256i *) (dst + o), str);
+		i += 32;
+		o += 24;
+	}
+
+	if (i == len)
+		return o;
+
+	/* finish 16 characters at a time before going scalar */
+	ret = codec_b64_decode_sse41(src + i, len - i, dst + o, dstlen - o);
+	return ret < 0 ? ret : o + ret;
+}
+
+__attribute__((target("sse4.1")))
+static void
+codec_hex_encode_sse41(const unsigned char *src, size_t len, char *dst)
+{
+	const __m128i lut = _mm_loadu_si128((const __m128i *) hexdigits);
+	const __m128i mask_0f = _mm_set1_epi8(0x0F);
+	size_t		i = 0;
+
+	for (; i + 16 <= len; i += 16)
+	{
+		__m128i		in = _mm_loadu_si128((const __m128i *) (src + i));
+		__m128i		hi = _mm_shuffle_epi8(lut, _mm_and_si128(_mm_srli_epi16(in, 4), mask_0f));
+		__m128i		lo = _mm_shuffle_epi8(lut, _mm_and_si128(in, mask_0f));
+
+		_mm_storeu_si128((__m128i *) dst, _mm_unpacklo_epi8(hi, lo));
+		_mm_storeu_si128((__m128i *) (dst + 16), _mm_unpackhi_epi8(hi, lo));
+		dst += 32;
+	}
+	codec_hex_encode_scalar(src + i, len - i, dst);
+}
+
+__attribute__((target("avx2")))
+static void
+codec_hex_encode_avx2(const unsigned char *src, size_t len, char *dst)
+{
+	const __m256i lut = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *) hexdigits));
+	const __m256i mask_0f = _mm256_set1_epi8(0x0F);
+	size_t		i = 0;
+
+	for (; i + 32 <= len; i += 32)
+	{
+		__m256i		in = _mm256_loadu_si256((const __m256i *) (src + i));
+		__m256i		hi = _mm256_shuffle_epi8(lut, _mm256_and_si256(_mm256_srli_epi16(in, 4), mask_0f));
+		__m256i		lo = _mm256_shuffle_epi8(lut, _mm256_and_si256(in, mask_0f));
+		__m256i		a = _mm256_unpacklo_epi8(hi, lo);	/* bytes 0-7 and 16-23 */
+		__m256i		b = _mm256_unpackhi_epi8(hi, lo);	/* bytes 8-15 and 24-31 */
+
+		_mm256_storeu_si256((__m256i *) dst, _mm256_permute2x128_si256(a, b, 0x20));
+		_mm256_storeu_si256((__m256i *) (dst + 32), _mm256_permute2x128_si256(a, b, 0x31));
+		dst += 64;
+	}
+	codec_hex_encode_sse41(src + i, len - i, dst);
+}
+
+#endif							/* CODEC_X86_SIMD */
+
+/*
+ * codec_choose
+ *
+ * pick the widest implementation the CPU supports
+ */
+static void
+codec_choose(void)
+{
+	codec_b64_decode_impl = codec_b64_decode_scalar;
+	codec_hex_encode_impl = codec_hex_encode_scalar;
+	codec_impl = "scalar";
+
+#ifdef CODEC_X86_SIMD
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2"))
+	{
+		codec_b64_decode_impl = codec_b64_decode_avx2;
+		codec_hex_encode_impl = codec_hex_encode_avx2;
+		codec_impl = "avx2";
+	}
+	else if (__builtin_cpu_supports("sse4.1"))
+	{
+		codec_b64_decode_impl = codec_b64_decode_sse41;
+		codec_hex_encode_impl = codec_hex_encode_sse41;
+		codec_impl = "sse4.1";
+	}
+#endif
+	elog(DEBUG1, "using %s base64 decoder and hex encoder", codec_impl);
+}
+
+static int
+codec_b64_decode_choose(const char *src, int len, unsigned char *dst, int dstlen)
+{
+	codec_choose();
+	return codec_b64_decode_impl(src, len, dst, dstlen);
+}
+
+static void
+codec_hex_encode_choose(const unsigned char *src, size_t len, char *dst)
+{
+	codec_choose();
+	codec_hex_encode_impl(src, len, dst);
+}
+
+/*
+ * codec_b64_decode
+ *
+ * decode len characters of base64 text into dst, which must hold at least
+ * pg_b64_dec_len(len) bytes. Returns the number of bytes decoded or -1 on
+ * invalid input, like pg_b64_decode.
+ */
+int
+codec_b64_decode(const char *src, int len, unsigned char *dst, int dstlen)
+{
+	return codec_b64_decode_impl(src, len, dst, dstlen);
+}
+
+/*
+ * codec_hex_encode
+ *
+ * write len bytes as 2 * len upper case hex digits to dst, without a
+ * terminating null
+ */
+void
+codec_hex_encode(const unsigned char *src, size_t len, char *dst)
+{
+	codec_hex_encode_impl(src, len, dst);
+}
+
+/*
+ * codec_impl_name
+ *
+ * name of the implementation in use
+ */
+const char *
+codec_impl_name(void)
+{
+	if (codec_b64_decode_impl == codec_b64_decode_choose)
+		codec_choose();
+	return codec_impl;
+}
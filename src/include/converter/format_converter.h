@@ -89,6 +89,7 @@ typedef struct
 	int position;
 	int typemod;
 	bool ispk;
+	bool iskey;
 	char typcategory;
 	bool typispreferred;
 	char typname[NAMEDATALEN];
@@ -115,6 +116,7 @@ typedef struct dbz_dml_column_value
 	int timerep;	/* how dbz represents time related fields */
 	int typemod;	/* extra data type modifier */
 	bool ispk;		/* indicate if this column is a primary key*/
+	bool iskey;		/* indicate if this column is part of the index used to locate old tuple */
 	int dbztype;	/* data literal type as defined by dbz */
 	char typcategory;	/* type category defined by pg */
 	bool typispreferred;	/* wether type category is preferred by pg */
@@ -131,6 +133,7 @@ typedef struct dbz_dml
 	char * mappedObjectId;		/* schema.table, or just table on PG side */
 	Oid tableoid;
 	int natts;					/* number of columns of this pg table */
+	bool haskeyidx;				/* replica identity or primary key index exists */
 	List * columnValuesBefore;	/* list of DBZ_DML_COLUMN_VALUE */
 	List * columnValuesAfter;	/* list of DBZ_DML_COLUMN_VALUE */
 	unsigned long long dbz_ts_ms;	/* time(ms) when this DML is processed by DBZ */
@@ -154,8 +157,24 @@ typedef struct dataCacheEntry
 	HTAB * typeidhash;
 	HTAB * namejsonposhash;
 	int natts;
+	bool haskeyidx;
+	bool valid;			/* false once the target table has changed */
 } DataCacheEntry;
 
+/* source object resolution cache structure */
+typedef struct objResolveHashKey
+{
+	char srcObjId[SYNCHDB_OBJ_NAME_SIZE * 2];	/* db.schema.table as sent by the source */
+} ObjResolveHashKey;
+typedef struct objResolveHashEntry
+{
+	ObjResolveHashKey key;
+	uint32 generation;			/* valid while it equals the current generation */
+	DataCacheEntry * centry;	/* resolved target table */
+	char remoteObjectId[SYNCHDB_OBJ_NAME_SIZE * 2];
+	char mappedObjectId[SYNCHDB_OBJ_NAME_SIZE * 2];
+} ObjResolveHashEntry;
+
 typedef struct datatypeHashKey
 {
 	char extTypeName[SYNCHDB_DATATYPE_NAME_SIZE];
@@ -199,7 +218,12 @@ void fc_deinitFormatConverter(ConnectorType connectorType);
 void fc_initDataCache(void);
 void fc_deinitDataCache(void);
 void fc_resetDataCache(void);
+void fc_clear_data_cache_entry(DataCacheEntry * entry);
+DataCacheEntry * fc_get_resolved_object(const char * srcobjid, DBZ_DML * dml);
+void fc_set_resolved_object(const char * srcobjid, const DBZ_DML * dml, DataCacheEntry * centry);
+void fc_invalidate_resolved_objects(void);
 bool fc_load_objmap(const char * name, ConnectorType connectorType);
+void fc_unload_objmap(void);
 char * escapeSingleQuote(const char * in, bool addquote);
 int getPathElementString(Jsonb * jb, char * path, StringInfoData * strinfoout, bool removequotes);
 void remove_double_quotes(StringInfoData * str);
@@ -26,6 +26,8 @@ typedef enum _OlrType
 
 int fc_processOLRChangeEvent(void * event, SynchdbStatistics * myBatchStats,
 		const char * name, bool * sendconfirm, bool isfirst, bool islast);
+int fc_processOLRProtobufEvent(void * event, SynchdbStatistics * myBatchStats,
+		const char * name, bool * sendconfirm, bool isfirst, bool islast);
 
 void unload_oracle_parser(void);
 
@@ -19,6 +19,7 @@
 #define SYNCHDB_REPLICATION_AGENT_H_
 
 #include "executor/tuptable.h"
+#include "utils/relcache.h"
 #include "synchdb/synchdb.h"
 
 /* Data structures representing PostgreSQL data formats */
@@ -52,6 +53,8 @@ typedef struct pg_dml_column_value
 					 */
 	Oid datatype;
 	int position;	/* position of this value's attribute in tupdesc */
+	bool isdatum;	/* value was converted to datum already, value is NULL */
+	Datum datum;
 } PG_DML_COLUMN_VALUE;
 
 typedef struct pg_dml
@@ -61,6 +64,11 @@ typedef struct pg_dml
 	char op;
 	Oid tableoid;
 	int natts;					/* number of columns of this pg table */
+	/*
+	 * for UPDATE and DELETE via heap AM, columnValuesBefore only contains key
+	 * columns when target has replica identity or primary key index, and
+	 * columnValuesAfter of an UPDATE only contains the changed columns
+	 */
 	List * columnValuesBefore;	/* list of PG_DML_COLUMN_VALUE */
 	List * columnValuesAfter;	/* list of PG_DML_COLUMN_VALUE */
 } PG_DML;
@@ -72,15 +80,26 @@ int ra_executePGDML(PG_DML * pgdml, ConnectorType type, SynchdbStatistics * myBa
 int ra_getConninfoByName(const char * name, ConnectionInfo * conninfo, char ** connector);
 int ra_executeCommand(const char * query);
 int ra_listConnInfoNames(char ** out, int * numout);
+int ra_saveOffset(const char * name, const char * offset);
+char * ra_getOffset(const char * name);
 char * ra_transformDataExpression(char * data, char * wkb, char * srid, char * expression);
 int ra_listObjmaps(const char * name, ObjectMap ** out, int * numout);
+char * ra_findGroupObjmapConflict(char ** names, int nnames);
 
 void destroyPGDDL(PG_DDL * ddlinfo);
 void destroyPGDML(PG_DML * dmlinfo);
 orascn ra_run_orafdw_initial_snapshot_spi(ConnectionInfo * conninfo, int flag,
 		const char * snapshot_tables, orascn scn_req, bool fdw_use_subtx,
 		bool write_schema_hist, const char * snapshotMode);
+int ra_split_orafdw_snapshot_tables(ConnectionInfo * conninfo);
+orascn ra_finish_orafdw_parallel_snapshot(ConnectionInfo * conninfo);
+int ra_fdwSnapshotWorkerLoop(const char * name);
 int ra_get_fdw_snapshot_err_table_list(const char *name, char **out, int *numout, orascn * scn_out);
 int dump_schema_history_to_file(const char * connector_name, const char *out_path);
+int ra_deferSecondaryIndexes(const char * name, Oid tableoid);
+int ra_buildDeferredIndexes(const char * name);
+int ra_buildPendingDeferredIndexes(void);
+bool ra_canInsertFrozen(Relation rel);
+int64 ra_bulkInsertFrozen(Oid tableoid, const char * dstlist, const char * query);
 
 #endif /* SYNCHDB_REPLICATION_AGENT_H_ */
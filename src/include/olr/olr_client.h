@@ -40,6 +40,7 @@ orascn olr_client_get_scn(void);
 orascn olr_client_get_c_idx(void);
 int olr_client_confirm_scn(char * source);
 bool olr_client_write_scn_state(ConnectorType type, const char * name, const char * srcdb, bool force);
+void olr_client_save_scn_state(const char * name);
 bool olr_client_init_scn_state(ConnectorType type, const char * name, const char * srcdb);
 bool olr_client_get_connect_status(void);
 bool olr_client_write_snapshot_state(ConnectorType type, const char * name, const char * dstdb, bool done);
@@ -19,6 +19,7 @@
 #define SYNCHDB_SYNCHDB_H_
 
 #include "storage/lwlock.h"
+#include "portability/instr_time.h"
 
 /* Constants */
 #define SYNCHDB_CONNINFO_NAME_SIZE 64
@@ -38,10 +39,18 @@
 #define SYNCHDB_METADATA_PATH_SIZE 256
 #define SYNCHDB_DATATYPE_NAME_SIZE 64
 #define SYNCHDB_OBJ_NAME_SIZE 128
+#define SYNCHDB_LATENCY_BUCKETS 24
+#define SYNCHDB_METRICS_REQUEST_SIZE 4096
+#define SYNCHDB_METRICS_SAMPLE_MS 5000
+#define SYNCHDB_LAUNCHER_POLL_MS 100
+#define SYNCHDB_LAUNCHER_READY_TIMEOUT_MS 300000
+#define SYNCHDB_LAUNCHER_REPORT_SLOWEST 5
+#define SYNCHDB_GROUP_MAX_CONNECTORS 24
 #define SYNCHDB_OBJ_TYPE_SIZE 32
 #define SYNCHDB_TRANSFORM_EXPRESSION_SIZE 256
 #define SYNCHDB_JSON_PATH_SIZE 128
 #define SYNCHDB_INVALID_BATCH_ID -1
+#define SYNCHDB_TUNE_REASON_SIZE 128
 #define SYNCHDB_MAX_TZ_LEN 16
 #define SYNCHDB_MAX_TIMESTAMP_LEN 64
 
@@ -68,6 +77,7 @@
 
 #define SYNCHDB_METADATA_DIR "pg_synchdb"
 #define DBZ_ENGINE_JAR_FILE "dbz-engine-1.0.0.jar"
+#define DBZ_ENGINE_CDS_FILE "dbz-engine-1.0.0.jsa"
 #define ORACLE_RAW_PARSER_LIB "libsynchdb_oracle_parser.so"
 #define MAX_PATH_LENGTH 1024
 #define MAX_JAVA_OPTION_LENGTH 256
@@ -78,6 +88,7 @@
 #define SYNCHDB_CONNINFO_TABLE "synchdb_conninfo"
 #define SYNCHDB_ATTRIBUTE_TABLE "synchdb_attribute"
 #define SYNCHDB_OBJECT_MAPPING_TABLE "synchdb_objmap"
+#define SYNCHDB_OFFSETS_TABLE "synchdb_offsets"
 #define SYNCHDB_ATTRIBUTE_VIEW "synchdb_att_view"
 
 typedef unsigned long long orascn;
@@ -150,7 +161,10 @@ typedef enum _connectorStatistics
 	STATS_AVERAGE_BATCH_SIZE,
 	STATS_TRUNCATE,
 	STATS_TABLES,
-	STATS_ROWS
+	STATS_ROWS,
+	STATS_LOCATOR_HIT,
+	STATS_LOCATOR_MISS,
+	STATS_SPILL_COUNT
 } ConnectorStatistics;
 
 /**
@@ -228,6 +242,15 @@ typedef enum _SnapshotEngine
 	ENGINE_FDW
 } SnapshotEngine;
 
+/*
+ * enum that represents how openlog replicator encodes change events
+ */
+typedef enum _OlrPayloadFormat
+{
+	OLR_PAYLOAD_JSON,
+	OLR_PAYLOAD_PROTOBUF
+} OlrPayloadFormat;
+
 /**
  * BatchInfo - Structure containing the metadata of a batch change request
  */
@@ -235,6 +258,9 @@ typedef struct _BatchInfo
 {
 	 int batchId;
 	 int batchSize;
+	 Size batchBytes;		/* bytes of change events received */
+	 double elapsedMs;		/* time from fetch to commit */
+	 double commitMs;		/* time spent committing */
 } BatchInfo;
 
 /**
@@ -363,6 +389,8 @@ typedef struct _CDCStatistics
 	unsigned long long stats_delete;			/* DELETE events generated during CDC */
 	unsigned long long stats_tx;				/* transaction boundary events like BEGIN and COMMIT */
 	unsigned long long stats_truncate;			/* TRUNCATE events generated during CDC */
+	unsigned long long stats_locator_hit;		/* old tuples found by tuple locator */
+	unsigned long long stats_locator_miss;		/* tuple locator misses falling back to seq scan */
 } CDCStatistics;
 
 typedef struct _GeneralStatistics
@@ -375,6 +403,8 @@ typedef struct _GeneralStatistics
 	unsigned long long stats_first_pg_ts;	/* timestamp(ms) of last batch's first event processed by postgresql */
 	unsigned long long stats_last_src_ts;	/* timestamp(ms) of last batch's last event generation in source db */
 	unsigned long long stats_last_pg_ts;	/* timestamp(ms) of last batch's last event processed by postgresql */
+	unsigned long long stats_spill_count;	/* number of batches spilled to a temporary file */
+	unsigned long long stats_spill_bytes;	/* bytes of change events spilled to a temporary file */
 } GeneralStatistics;
 
 /**
@@ -391,6 +421,56 @@ typedef struct _SynchdbStatistics
 	CDCStatistics cdcstats;
 } SynchdbStatistics;
 
+/**
+ * LatencyOp - Change event operations that have their own latency histograms
+ */
+typedef enum _LatencyOp
+{
+	LATENCY_OP_INSERT = 0,
+	LATENCY_OP_UPDATE,
+	LATENCY_OP_DELETE,
+	LATENCY_OP_TRUNCATE,
+	LATENCY_OP_SNAPSHOT,	/* rows read during initial snapshot */
+	LATENCY_OP_DDL,
+	LATENCY_OP_NUM
+} LatencyOp;
+
+/**
+ * LatencyStage - Timed stages of the change event pipeline
+ */
+typedef enum _LatencyStage
+{
+	/* per change event */
+	LATENCY_STAGE_PARSE = 0,
+	LATENCY_STAGE_CONVERT,
+	LATENCY_STAGE_EXECUTE,
+	/* per batch */
+	LATENCY_STAGE_FETCH,
+	LATENCY_STAGE_COMMIT
+} LatencyStage;
+
+#define LATENCY_EVENT_STAGE_NUM (LATENCY_STAGE_EXECUTE + 1)
+
+/**
+ * LatencyHistogram - log2 bucketed latency histogram. Bucket 0 counts samples
+ * below 1 microsecond, bucket n counts samples in [2^(n-1), 2^n) microseconds
+ * and the last bucket counts everything above.
+ */
+typedef struct _LatencyHistogram
+{
+	uint64 count;
+	uint64 total_us;
+	uint64 max_us;
+	uint32 buckets[SYNCHDB_LATENCY_BUCKETS];
+} LatencyHistogram;
+
+typedef struct _LatencyStatistics
+{
+	LatencyHistogram events[LATENCY_OP_NUM][LATENCY_EVENT_STAGE_NUM];
+	LatencyHistogram fetch;		/* getting a batch from debezium or openlog replicator */
+	LatencyHistogram commit;	/* committing the transaction of a batch */
+} LatencyStatistics;
+
 /**
  *  Structure holding state information for connectors
  */
@@ -406,6 +486,14 @@ typedef struct _ActiveConnectors
 	char snapshotMode[SYNCHDB_SNAPSHOT_MODE_SIZE];
 	ConnectionInfo conninfo;
 	SynchdbStatistics stats;
+	LatencyStatistics latency;
+	uint32 jvm_startup_ms;		/* time to create the JVM and init the engine, 0 if none */
+	uint32 startup_ms;			/* time from worker start to leaving initializing state */
+	bool shared_jvm;			/* hosted by a connector group worker */
+	uint32 group_id;			/* connector group the slot was started in, 0 if none */
+	int32 batch_size;			/* effective change events applied per transaction */
+	int32 queue_kb;				/* effective batch queue memory of Debezium runner */
+	char tune_reason[SYNCHDB_TUNE_REASON_SIZE];	/* why they were last changed */
 } ActiveConnectors;
 
 /**
@@ -415,6 +503,7 @@ typedef struct _SynchdbSharedState
 {
 	LWLock		lock;		/* mutual exclusion */
 	ActiveConnectors * connectors;
+	uint32		last_group_id;	/* last id given to a connector group */
 } SynchdbSharedState;
 
 typedef struct _ObjectMap
@@ -448,5 +537,11 @@ ConnectorStage get_shm_connector_stage_enum(int connectorId);
 void increment_connector_statistics(SynchdbStatistics * myStats, ConnectorStatistics which, int incby);
 ConnectorType stringToConnectorType(const char * type);
 bool get_shm_ora_compat(int connectorId);
+int synchdb_run_fdw_snapshot_workers(const ConnectionInfo * connInfo, int nworkers);
+void synchdb_capture_batch(int connectorId, char marker, const char * data, Size len);
+LatencyOp latency_op_from_char(char op);
+void start_connector_latency(instr_time * since);
+void record_event_latency(LatencyOp op, LatencyStage stage, instr_time * since);
+void record_batch_latency(LatencyStage stage, instr_time * since);
 
 #endif /* SYNCHDB_SYNCHDB_H_ */
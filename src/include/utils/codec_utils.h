@@ -0,0 +1,18 @@
+/*
+ * codec_utils.h
+ *
+ * Implementation of base64 decoding and hex encoding routines
+ *
+ * Copyright (c) Hornetlabs Technology, Inc.
+ *
+ */
+#ifndef SYNCHDB_CODEC_UTILS_H_
+#define SYNCHDB_CODEC_UTILS_H_
+
+#include "synchdb/synchdb.h"
+
+int codec_b64_decode(const char *src, int len, unsigned char *dst, int dstlen);
+void codec_hex_encode(const unsigned char *src, size_t len, char *dst);
+const char * codec_impl_name(void);
+
+#endif /* SYNCHDB_CODEC_UTILS_H_ */
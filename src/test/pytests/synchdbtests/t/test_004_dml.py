@@ -1,6 +1,9 @@
 import common
+import json
+import os
+import struct
 import time
-from common import run_pg_query, run_pg_query_one, run_remote_query, create_synchdb_connector, getConnectorName, getDbname, create_and_start_synchdb_connector, stop_and_delete_synchdb_connector, drop_default_pg_schema
+from common import run_pg_query, run_pg_query_one, run_remote_query, create_synchdb_connector, getConnectorName, getDbname, create_and_start_synchdb_connector, stop_and_delete_synchdb_connector, drop_default_pg_schema, update_guc_conf
 
 def test_Insert(pg_cursor, dbvendor):
     name = getConnectorName(dbvendor) + "_insert"
@@ -54,6 +57,11 @@ def test_Insert(pg_cursor, dbvendor):
         assert int(row[0]) == int(extrow[0])
         assert str(row[1]) == str(extrow[1])
 
+    # every stage of the insert has been timed
+    rows = run_pg_query(pg_cursor, f"SELECT stage, count FROM synchdb_latency_stats WHERE name = '{name}' AND operation = 'insert'")
+    assert sorted(row[0] for row in rows) == ["convert", "execute", "parse"]
+    assert all(int(row[1]) > 0 for row in rows)
+
     extrows = run_remote_query(dbvendor, f"DROP TABLE inserttable")
     stop_and_delete_synchdb_connector(pg_cursor, name)
     drop_default_pg_schema(pg_cursor, dbvendor)
@@ -61,6 +69,68 @@ def test_Insert(pg_cursor, dbvendor):
 def test_InsertWithError(pg_cursor, dbvendor):
     assert True
 
+def test_InsertAfterTargetAlter(pg_cursor, dbvendor):
+    name = getConnectorName(dbvendor) + "_tgtalter"
+    dbname = getDbname(dbvendor).lower()
+
+    result = create_and_start_synchdb_connector(pg_cursor, dbvendor, name, "no_data")
+    assert result == 0
+
+    if dbvendor == "mysql":
+        query = """
+        CREATE TABLE tgtaltertable(
+            a INT PRIMARY KEY,
+            b VARCHAR(255));
+        """
+    elif dbvendor == "sqlserver":
+        query = """
+        CREATE TABLE tgtaltertable(
+            a INT NOT NULL PRIMARY KEY,
+            b VARCHAR(255));
+        EXEC sys.sp_cdc_enable_table @source_schema = 'dbo',
+            @source_name = 'tgtaltertable', @role_name = NULL,
+            @supports_net_changes = 0;
+        """
+    else:
+        query = """
+        CREATE TABLE tgtaltertable(
+            a NUMBER PRIMARY KEY,
+            b VARCHAR(255));
+        """
+
+    run_remote_query(dbvendor, query)
+    if dbvendor == "oracle" or dbvendor == "olr":
+        time.sleep(30)
+    else:
+        time.sleep(10)
+
+    run_remote_query(dbvendor, "INSERT INTO tgtaltertable (a, b) VALUES (1, 'Hello')")
+    run_remote_query(dbvendor, "COMMIT")
+    if dbvendor == "oracle":
+        time.sleep(75)
+    else:
+        time.sleep(15)
+
+    # alter the target table behind synchdb's back; its cached table info must be rebuilt
+    run_pg_query_one(pg_cursor, f"ALTER TABLE {dbname}.tgtaltertable ADD COLUMN c INT DEFAULT 7")
+
+    run_remote_query(dbvendor, "INSERT INTO tgtaltertable (a, b) VALUES (2, 'SynchDB')")
+    run_remote_query(dbvendor, "COMMIT")
+    if dbvendor == "oracle":
+        time.sleep(75)
+    else:
+        time.sleep(15)
+
+    rows = run_pg_query(pg_cursor, f"SELECT a, b, c FROM {dbname}.tgtaltertable ORDER BY a")
+    assert len(rows) == 2
+    assert int(rows[1][0]) == 2
+    assert str(rows[1][1]) == "SynchDB"
+    assert int(rows[1][2]) == 7
+
+    run_remote_query(dbvendor, f"DROP TABLE tgtaltertable")
+    stop_and_delete_synchdb_connector(pg_cursor, name)
+    drop_default_pg_schema(pg_cursor, dbvendor)
+
 def test_Update(pg_cursor, dbvendor):
     name = getConnectorName(dbvendor) + "_update"
     dbname = getDbname(dbvendor).lower()
@@ -203,6 +273,75 @@ def test_Delete(pg_cursor, dbvendor):
 def test_DeleteWithError(pg_cursor, dbvendor):
     assert True
 
+def test_UpdateDeleteWithoutPrimaryKey(pg_cursor, dbvendor):
+    name = getConnectorName(dbvendor) + "_nopk"
+    dbname = getDbname(dbvendor).lower()
+
+    update_guc_conf(pg_cursor, "synchdb.tuple_locator_mem", "'64MB'", True)
+
+    result = create_and_start_synchdb_connector(pg_cursor, dbvendor, name, "no_data")
+    assert result == 0
+
+    if dbvendor == "mysql":
+        query = """
+        CREATE TABLE nopktable(
+            a INT,
+            b VARCHAR(255));
+        """
+    elif dbvendor == "sqlserver":
+        query = """
+        CREATE TABLE nopktable(
+            a INT,
+            b VARCHAR(255));
+        EXEC sys.sp_cdc_enable_table @source_schema = 'dbo',
+            @source_name = 'nopktable', @role_name = NULL,
+            @supports_net_changes = 0;
+        """
+    else:
+        query = """
+        CREATE TABLE nopktable(
+            a NUMBER,
+            b VARCHAR(255));
+        """
+
+    run_remote_query(dbvendor, query)
+    if dbvendor == "oracle" or dbvendor == "olr":
+        run_remote_query(dbvendor, "ALTER TABLE nopktable ADD SUPPLEMENTAL LOG DATA (ALL) COLUMNS")
+        time.sleep(30)
+    else:
+        time.sleep(10)
+
+    run_remote_query(dbvendor, "INSERT INTO nopktable (a, b) VALUES (1, 'Hello')")
+    run_remote_query(dbvendor, "INSERT INTO nopktable (a, b) VALUES (2, 'SynchDB')")
+    run_remote_query(dbvendor, "INSERT INTO nopktable (a, b) VALUES (3, 'Pytest')")
+    run_remote_query(dbvendor, "UPDATE nopktable SET b = 'olleH' WHERE a = 1")
+    run_remote_query(dbvendor, "UPDATE nopktable SET b = 'BDhcnyS' WHERE a = 2")
+    run_remote_query(dbvendor, "DELETE FROM nopktable WHERE a = 3")
+    run_remote_query(dbvendor, "COMMIT")
+
+    if dbvendor == "oracle":
+        time.sleep(75)
+    else:
+        time.sleep(15)
+
+    extrows = run_remote_query(dbvendor, f"SELECT a, b FROM nopktable ORDER BY a")
+    rows = run_pg_query(pg_cursor, f"SELECT a, b FROM {dbname}.nopktable ORDER BY a")
+    assert len(extrows) == 2
+    assert len(rows) == 2
+
+    for row, extrow in zip(rows, extrows):
+        assert int(row[0]) == int(extrow[0])
+        assert str(row[1]) == str(extrow[1])
+
+    # the first UPDATE builds the locator, the rest must be found with it
+    row = run_pg_query_one(pg_cursor, f"SELECT locator_hits FROM synchdb_cdcstats WHERE name = '{name}'")
+    assert int(row[0]) > 0
+
+    extrows = run_remote_query(dbvendor, f"DROP TABLE nopktable")
+    stop_and_delete_synchdb_connector(pg_cursor, name)
+    drop_default_pg_schema(pg_cursor, dbvendor)
+    update_guc_conf(pg_cursor, "synchdb.tuple_locator_mem", "0", True)
+
 def test_SPIInsert(pg_cursor, dbvendor):
     assert True
 
@@ -221,3 +360,246 @@ def test_SPIDelete(pg_cursor, dbvendor):
 def test_SPIDeleteWithError(pg_cursor, dbvendor):
     assert True
 
+
+def test_OffsetRecordedWithBatch(pg_cursor, dbvendor):
+    name = getConnectorName(dbvendor) + "_txoffset"
+    dbname = getDbname(dbvendor).lower()
+
+    result = create_and_start_synchdb_connector(pg_cursor, dbvendor, name, "no_data")
+    assert result == 0
+
+    if dbvendor == "mysql":
+        query = """
+        CREATE TABLE txoffsettable(
+            a INT PRIMARY KEY,
+            b VARCHAR(255));
+        """
+    elif dbvendor == "sqlserver":
+        query = """
+        CREATE TABLE txoffsettable(
+            a INT NOT NULL PRIMARY KEY,
+            b VARCHAR(255));
+        EXEC sys.sp_cdc_enable_table @source_schema = 'dbo',
+            @source_name = 'txoffsettable', @role_name = NULL,
+            @supports_net_changes = 0;
+        """
+    else:
+        query = """
+        CREATE TABLE txoffsettable(
+            a NUMBER PRIMARY KEY,
+            b VARCHAR(255));
+        """
+
+    run_remote_query(dbvendor, query)
+    if dbvendor == "oracle" or dbvendor == "olr":
+        time.sleep(30)
+    else:
+        time.sleep(10)
+
+    run_remote_query(dbvendor, "INSERT INTO txoffsettable (a, b) VALUES (1, 'Hello')")
+    run_remote_query(dbvendor, "COMMIT")
+    if dbvendor == "oracle":
+        time.sleep(75)
+    else:
+        time.sleep(15)
+
+    # the offset reached by the applied batch is committed along with it
+    row = run_pg_query_one(pg_cursor, f"SELECT count(*) FROM {dbname}.txoffsettable")
+    assert int(row[0]) == 1
+    row = run_pg_query_one(pg_cursor, f"SELECT data FROM synchdb_offsets WHERE name = '{name}'")
+    assert row is not None
+    assert len(row[0]) > 0
+
+    run_remote_query(dbvendor, f"DROP TABLE txoffsettable")
+    stop_and_delete_synchdb_connector(pg_cursor, name)
+    row = run_pg_query_one(pg_cursor, f"SELECT count(*) FROM synchdb_offsets WHERE name = '{name}'")
+    assert int(row[0]) == 0
+    drop_default_pg_schema(pg_cursor, dbvendor)
+
+def test_PartitionedTarget(pg_cursor, dbvendor):
+    name = getConnectorName(dbvendor) + "_parttarget"
+    dbname = getDbname(dbvendor).lower()
+
+    result = create_and_start_synchdb_connector(pg_cursor, dbvendor, name, "no_data")
+    assert result == 0
+
+    if dbvendor == "mysql":
+        query = """
+        CREATE TABLE parttable(
+            a INT PRIMARY KEY,
+            b INT);
+        """
+    elif dbvendor == "sqlserver":
+        query = """
+        CREATE TABLE parttable(
+            a INT NOT NULL PRIMARY KEY,
+            b INT);
+        EXEC sys.sp_cdc_enable_table @source_schema = 'dbo',
+            @source_name = 'parttable', @role_name = NULL,
+            @supports_net_changes = 0;
+        """
+    else:
+        query = """
+        CREATE TABLE parttable(
+            a NUMBER PRIMARY KEY,
+            b NUMBER);
+        """
+
+    run_remote_query(dbvendor, query)
+    if dbvendor == "oracle" or dbvendor == "olr":
+        time.sleep(30)
+    else:
+        time.sleep(10)
+
+    # replace the target with one range partitioned by b
+    run_pg_query(pg_cursor, f"ALTER TABLE {dbname}.parttable RENAME TO parttable_old")
+    run_pg_query(pg_cursor, f"CREATE TABLE {dbname}.parttable (LIKE {dbname}.parttable_old) PARTITION BY RANGE (b)")
+    run_pg_query(pg_cursor, f"ALTER TABLE {dbname}.parttable ADD PRIMARY KEY (a, b)")
+    run_pg_query(pg_cursor, f"CREATE TABLE {dbname}.parttable_p1 PARTITION OF {dbname}.parttable FOR VALUES FROM (MINVALUE) TO (100)")
+    run_pg_query(pg_cursor, f"CREATE TABLE {dbname}.parttable_p2 PARTITION OF {dbname}.parttable FOR VALUES FROM (100) TO (MAXVALUE)")
+
+    run_remote_query(dbvendor, "INSERT INTO parttable (a, b) VALUES (1, 10)")
+    run_remote_query(dbvendor, "INSERT INTO parttable (a, b) VALUES (2, 150)")
+    run_remote_query(dbvendor, "INSERT INTO parttable (a, b) VALUES (3, 20)")
+    run_remote_query(dbvendor, "UPDATE parttable SET b = 200 WHERE a = 1")
+    run_remote_query(dbvendor, "DELETE FROM parttable WHERE a = 2")
+    run_remote_query(dbvendor, "COMMIT")
+    if dbvendor == "oracle":
+        time.sleep(75)
+    else:
+        time.sleep(15)
+
+    # rows are routed to their partitions and the update moved a = 1
+    rows = run_pg_query(pg_cursor, f"SELECT a, b FROM {dbname}.parttable_p1 ORDER BY a")
+    assert len(rows) == 1
+    assert int(rows[0][0]) == 3
+    rows = run_pg_query(pg_cursor, f"SELECT a, b FROM {dbname}.parttable_p2 ORDER BY a")
+    assert len(rows) == 1
+    assert int(rows[0][0]) == 1 and int(rows[0][1]) == 200
+
+    run_remote_query(dbvendor, f"DROP TABLE parttable")
+    stop_and_delete_synchdb_connector(pg_cursor, name)
+    drop_default_pg_schema(pg_cursor, dbvendor)
+
+## change events replayed through synchdb_replay_events(), so the openlog
+## replicator event handlers are tested without a running replicator
+REPLAY_COLUMNS = [("ID", "number", 2), ("NAME", "varchar2", 1), ("NOTE", "varchar2", 1)]
+REPLAY_EVENTS = [
+    ("c", None, {"ID": 1, "NAME": "it's \"quoted\"", "NOTE": None}),
+    ("c", None, {"ID": 2, "NAME": "", "NOTE": "x"}),
+    ("c", None, {"ID": 3, "NAME": "c", "NOTE": "y"}),
+    ("c", None, {"ID": 4, "NAME": "d", "NOTE": "z"}),
+    ("u", {"ID": 3, "NAME": "c", "NOTE": "y"}, {"ID": 3, "NAME": "c2", "NOTE": None}),
+    ("d", {"ID": 4, "NAME": "d", "NOTE": "z"}, None),
+]
+# oracle has no empty strings, so both NULL and '' columns are applied as NULL
+REPLAY_EXPECTED = [(1, "it's \"quoted\"", None), (2, None, "x"), (3, "c2", None)]
+
+def write_replay_file(path, events):
+    with open(path, "wb") as f:
+        f.write(b"B" + struct.pack("!II", 1, len(events)))
+        for event in events:
+            f.write(struct.pack("!I", len(event) + 1) + event + b"\0")
+
+def olr_json_event(scn, op, before, after):
+    payload = {"op": op,
+               "schema": {"owner": "SYNCHDB", "table": "T_REPLAY",
+                          "columns": [{"name": c[0], "type": c[1]} for c in REPLAY_COLUMNS]}}
+    if before is not None:
+        payload["before"] = before
+    if after is not None:
+        payload["after"] = after
+    return json.dumps({"scn": scn, "tm": 1700000000000000000, "c_scn": scn, "c_idx": 0,
+                       "db": "REPLAYDB", "payload": [payload]}).encode()
+
+def pb_varint(n):
+    out = b""
+    while n > 0x7f:
+        out += bytes([(n & 0x7f) | 0x80])
+        n >>= 7
+    return out + bytes([n])
+
+def pb_field(num, value):
+    if isinstance(value, int):
+        return pb_varint(num << 3) + pb_varint(value)
+    if isinstance(value, str):
+        value = value.encode()
+    return pb_varint((num << 3) | 2) + pb_varint(len(value)) + value
+
+def pb_values(row):
+    out = []
+    for name, val in row.items():
+        msg = pb_field(1, name)
+        if isinstance(val, int):
+            msg += pb_field(2, val)
+        elif isinstance(val, str):
+            # an empty string is still a set value_string in the datum oneof
+            msg += pb_field(5, val)
+        out.append(msg)
+    return out
+
+def olr_protobuf_event(scn, op, before, after):
+    schema = pb_field(1, "SYNCHDB") + pb_field(2, "T_REPLAY")
+    for c in REPLAY_COLUMNS:
+        schema += pb_field(6, pb_field(1, c[0]) + pb_field(2, c[2]))
+    payload = pb_field(1, {"c": 2, "u": 3, "d": 4}[op]) + pb_field(2, schema)
+    for value in pb_values(before or {}):
+        payload += pb_field(4, value)
+    for value in pb_values(after or {}):
+        payload += pb_field(5, value)
+    # code PAYLOAD, scn, tm, db, payload, c_scn, c_idx
+    return (pb_field(1, 5) + pb_field(2, scn) + pb_field(4, 1700000000000000000) +
+            pb_field(8, "REPLAYDB") + pb_field(9, payload) + pb_field(10, scn) + pb_field(11, 0))
+
+def replay_olr_events(pg_cursor, name, fmt, encoder):
+    path = os.path.abspath(f"replay_{name}_{fmt}.bin")
+    write_replay_file(path, [encoder(100 + i, *e) for i, e in enumerate(REPLAY_EVENTS)])
+
+    run_pg_query(pg_cursor, "DROP SCHEMA IF EXISTS replaydb CASCADE")
+    run_pg_query(pg_cursor, "CREATE SCHEMA replaydb")
+    run_pg_query(pg_cursor, "CREATE TABLE replaydb.t_replay (id numeric PRIMARY KEY, name varchar(255), note varchar(255))")
+
+    row = run_pg_query_one(pg_cursor, f"SELECT events FROM synchdb_replay_events('{name}', '{path}')")
+    assert row[0] == len(REPLAY_EVENTS)
+    os.remove(path)
+
+    rows = run_pg_query(pg_cursor, "SELECT id, name, note FROM replaydb.t_replay ORDER BY id")
+    run_pg_query(pg_cursor, "DROP SCHEMA replaydb CASCADE")
+    return [(int(r[0]), r[1], r[2]) for r in rows]
+
+def test_OLRJsonReplay(pg_cursor, dbvendor):
+    if dbvendor != "olr":
+        return
+
+    name = getConnectorName(dbvendor) + "_jsonreplay"
+    result = create_synchdb_connector(pg_cursor, dbvendor, name)
+    assert result[0] == 0
+
+    # rows applied from JSON events, as before the handlers were shared with protobuf
+    assert replay_olr_events(pg_cursor, name, "json", olr_json_event) == REPLAY_EXPECTED
+
+    run_pg_query_one(pg_cursor, f"SELECT synchdb_del_conninfo('{name}')")
+
+def test_OLRProtobufReplay(pg_cursor, dbvendor):
+    if dbvendor != "olr":
+        return
+
+    name = getConnectorName(dbvendor) + "_pbreplay"
+    result = create_synchdb_connector(pg_cursor, dbvendor, name)
+    assert result[0] == 0
+
+    json_rows = replay_olr_events(pg_cursor, name, "json", olr_json_event)
+
+    update_guc_conf(pg_cursor, "synchdb.olr_payload_format", "'protobuf'", True)
+    time.sleep(1)
+    try:
+        pb_rows = replay_olr_events(pg_cursor, name, "protobuf", olr_protobuf_event)
+    finally:
+        update_guc_conf(pg_cursor, "synchdb.olr_payload_format", "'json'", True)
+        time.sleep(1)
+
+    # unset datums and empty strings are applied like JSON nulls and empty strings
+    assert pb_rows == json_rows
+    assert pb_rows == REPLAY_EXPECTED
+
+    run_pg_query_one(pg_cursor, f"SELECT synchdb_del_conninfo('{name}')")
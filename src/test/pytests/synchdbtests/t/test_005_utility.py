@@ -1,5 +1,8 @@
+import pytest
+import psycopg2
 import common
-from common import run_pg_query, run_pg_query_one, run_remote_query, create_synchdb_connector, getConnectorName, getDbname, verify_default_type_mappings
+import time
+from common import run_pg_query, run_pg_query_one, run_remote_query, create_synchdb_connector, getConnectorName, getDbname, verify_default_type_mappings, stop_and_delete_synchdb_connector, drop_default_pg_schema
 
 def test_ConnectorPause(pg_cursor, dbvendor):
     assert True
@@ -36,3 +39,57 @@ def test_OffsetFileRemoval(pg_cursor, dbvendor):
 
 def test_SchemaHistoryFileRemoval(pg_cursor, dbvendor):
     assert True
+
+def test_ConnectorGroup(pg_cursor, dbvendor):
+    if dbvendor == "olr":
+        return
+
+    name = getConnectorName(dbvendor) + "_group"
+
+    result = create_synchdb_connector(pg_cursor, dbvendor, name)
+    assert result[0] == 0
+
+    row = run_pg_query_one(pg_cursor, f"SELECT synchdb_start_engine_group(ARRAY['{name}']::name[])")
+    assert row[0] == 0
+
+    if dbvendor == "oracle":
+        time.sleep(20)
+    else:
+        time.sleep(10)
+
+    row = run_pg_query_one(pg_cursor, f"SELECT pid, state, err FROM synchdb_state_view WHERE name = '{name}'")
+    assert row[0] > -1
+    assert row[1] == "polling"
+    assert row[2] == "no error"
+
+    # a group member is stopped without terminating its worker
+    row = run_pg_query_one(pg_cursor, f"SELECT synchdb_stop_engine_bgw('{name}')")
+    assert row[0] == 0
+    row = run_pg_query_one(pg_cursor, f"SELECT pid FROM synchdb_state_view WHERE name = '{name}'")
+    assert row[0] is None or row[0] == -1
+
+    stop_and_delete_synchdb_connector(pg_cursor, name)
+    drop_default_pg_schema(pg_cursor, dbvendor)
+
+def test_ConnectorGroupConflict(pg_cursor, dbvendor):
+    if dbvendor == "olr":
+        return
+
+    name1 = getConnectorName(dbvendor) + "_grp1"
+    name2 = getConnectorName(dbvendor) + "_grp2"
+
+    result = create_synchdb_connector(pg_cursor, dbvendor, name1)
+    assert result[0] == 0
+    result = create_synchdb_connector(pg_cursor, dbvendor, name2)
+    assert result[0] == 0
+
+    # both replicate the same source database, so their source objects would collide
+    with pytest.raises(psycopg2.Error) as excinfo:
+        run_pg_query_one(pg_cursor, f"SELECT synchdb_start_engine_group(ARRAY['{name1}', '{name2}']::name[])")
+    assert "replicate the same source database" in str(excinfo.value)
+
+    row = run_pg_query_one(pg_cursor, f"SELECT count(*) FROM synchdb_state_view WHERE name IN ('{name1}', '{name2}') AND pid > 0")
+    assert row[0] == 0
+
+    run_pg_query_one(pg_cursor, f"SELECT synchdb_del_conninfo('{name1}')")
+    run_pg_query_one(pg_cursor, f"SELECT synchdb_del_conninfo('{name2}')")
@@ -9,6 +9,10 @@ CREATE OR REPLACE FUNCTION synchdb_start_engine_bgw(name, name) RETURNS int
 AS '$libdir/synchdb', 'synchdb_start_engine_bgw_snapshot_mode'
 LANGUAGE C IMMUTABLE STRICT;
 
+CREATE OR REPLACE FUNCTION synchdb_start_engine_group(name[]) RETURNS int
+AS '$libdir/synchdb'
+LANGUAGE C IMMUTABLE STRICT;
+
 CREATE OR REPLACE FUNCTION synchdb_stop_engine_bgw(name) RETURNS int
 AS '$libdir/synchdb'
 LANGUAGE C IMMUTABLE STRICT;
@@ -17,7 +21,7 @@ CREATE OR REPLACE FUNCTION synchdb_get_state() RETURNS SETOF record
 AS '$libdir/synchdb'
 LANGUAGE C IMMUTABLE STRICT;
 
-CREATE VIEW synchdb_state_view AS SELECT * FROM synchdb_get_state() AS (name text, connector_type text, pid int, stage text, state text, err text, last_dbz_offset text);
+CREATE VIEW synchdb_state_view AS SELECT * FROM synchdb_get_state() AS (name text, connector_type text, pid int, stage text, state text, err text, last_dbz_offset text, jvm_startup_ms int, startup_ms int, batch_size int, queue_kb int, tune_reason text);
 
 CREATE OR REPLACE FUNCTION synchdb_pause_engine(name) RETURNS int
 AS '$libdir/synchdb'
@@ -61,7 +65,9 @@ SELECT
   first_src_ts,
   first_pg_ts,
   last_src_ts,
-  last_pg_ts
+  last_pg_ts,
+  spilled_batches,
+  spilled_bytes
 FROM synchdb_get_stats() AS (
   name               text,
   ddls               bigint,
@@ -82,7 +88,11 @@ FROM synchdb_get_stats() AS (
   tables             bigint,
   rows               bigint,
   snapshot_begin_ts  bigint,
-  snapshot_end_ts    bigint
+  snapshot_end_ts    bigint,
+  locator_hits       bigint,
+  locator_misses     bigint,
+  spilled_batches    bigint,
+  spilled_bytes      bigint
 );
 
 CREATE OR REPLACE VIEW synchdb_snapstats AS
@@ -112,7 +122,11 @@ FROM synchdb_get_stats() AS (
   tables             bigint,
   rows               bigint,
   snapshot_begin_ts  bigint,
-  snapshot_end_ts    bigint
+  snapshot_end_ts    bigint,
+  locator_hits       bigint,
+  locator_misses     bigint,
+  spilled_batches    bigint,
+  spilled_bytes      bigint
 );
 
 CREATE OR REPLACE VIEW synchdb_cdcstats AS
@@ -124,7 +138,9 @@ SELECT
   updates,
   deletes,
   txs,
-  truncates
+  truncates,
+  locator_hits,
+  locator_misses
 FROM synchdb_get_stats() AS (
   name               text,
   ddls               bigint,
@@ -145,11 +161,46 @@ FROM synchdb_get_stats() AS (
   tables             bigint,
   rows               bigint,
   snapshot_begin_ts  bigint,
-  snapshot_end_ts    bigint
+  snapshot_end_ts    bigint,
+  locator_hits       bigint,
+  locator_misses     bigint,
+  spilled_batches    bigint,
+  spilled_bytes      bigint
+);
+
+CREATE OR REPLACE FUNCTION synchdb_get_latency_stats() RETURNS SETOF record
+AS '$libdir/synchdb'
+LANGUAGE C VOLATILE STRICT;
+
+CREATE OR REPLACE VIEW synchdb_latency_stats AS
+SELECT
+  name,
+  operation,
+  stage,
+  count,
+  avg_us,
+  max_us,
+  p50_us,
+  p90_us,
+  p99_us,
+  buckets
+FROM synchdb_get_latency_stats() AS (
+  name               text,
+  operation          text,
+  stage              text,
+  count              bigint,
+  avg_us             bigint,
+  max_us             bigint,
+  p50_us             bigint,
+  p90_us             bigint,
+  p99_us             bigint,
+  buckets            bigint[]
 );
 
 CREATE TABLE IF NOT EXISTS synchdb_conninfo(name TEXT PRIMARY KEY, isactive BOOL, data JSONB);
 
+CREATE TABLE IF NOT EXISTS synchdb_offsets(name TEXT PRIMARY KEY, data TEXT NOT NULL, updated TIMESTAMPTZ NOT NULL DEFAULT now());
+
 CREATE TABLE IF NOT EXISTS synchdb_attribute (
     name name,
     type name,
@@ -252,6 +303,39 @@ CREATE OR REPLACE FUNCTION synchdb_set_snapstats(name, bigint, bigint, bigint, b
 AS '$libdir/synchdb'
 LANGUAGE C IMMUTABLE STRICT;
 
+CREATE OR REPLACE FUNCTION synchdb_insert_frozen(regclass, text, text) RETURNS bigint
+AS '$libdir/synchdb'
+LANGUAGE C VOLATILE STRICT;
+
+CREATE OR REPLACE FUNCTION synchdb_replay_events(
+    connector_name name,
+    path text,
+    OUT batches bigint,
+    OUT events bigint,
+    OUT bytes bigint,
+    OUT elapsed_ms float8,
+    OUT cpu_ms float8,
+    OUT events_per_sec float8,
+    OUT bytes_per_sec float8,
+    OUT parse_cpu_ms float8,
+    OUT convert_cpu_ms float8,
+    OUT execute_cpu_ms float8,
+    OUT other_cpu_ms float8)
+RETURNS record
+AS '$libdir/synchdb'
+LANGUAGE C VOLATILE STRICT;
+
+CREATE OR REPLACE FUNCTION synchdb_codec_benchmark(
+    nbytes int DEFAULT 65536,
+    iterations int DEFAULT 1000,
+    OUT codec text,
+    OUT impl text,
+    OUT elapsed_ms float8,
+    OUT mb_per_sec float8)
+RETURNS SETOF record
+AS '$libdir/synchdb'
+LANGUAGE C VOLATILE STRICT;
+
 CREATE OR REPLACE FUNCTION read_snapshot_table_list(file_uri text)
 RETURNS text
 LANGUAGE plpgsql
@@ -2100,7 +2184,8 @@ BEGIN
       WHEN duplicate_object THEN   -- constraint name already exists
         RAISE NOTICE 'Skipping %.%: constraint % already exists', p_dst_schema, r.tbl, v_cname;
       WHEN OTHERS THEN
-        RAISE WARNING 'Failed to add PK on %.%: %', p_dst_schema, r.tbl, SQLERRM;
+        -- a target without its key silently falls back to slow row lookups during CDC
+        RAISE EXCEPTION 'Failed to add PK on %.%: %', p_dst_schema, r.tbl, SQLERRM;
     END;
   END LOOP;
 END;
@@ -2314,6 +2399,104 @@ $$;
 COMMENT ON FUNCTION synchdb_apply_column_mappings(name, name, name, name) IS
    'transform column name mappings based on synchdb_objmap';
 
+CREATE TABLE IF NOT EXISTS synchdb_fdw_snapshot_progress (
+    connector_name  name        NOT NULL,
+    tbl             text        NOT NULL,   -- destination schema.table
+    last_key        text[]      NOT NULL,   -- last key loaded, in key column order
+    rows_loaded     bigint      NOT NULL,
+    scn             numeric     NOT NULL,
+    ts              timestamptz NOT NULL DEFAULT now(),
+    PRIMARY KEY (connector_name, tbl)
+);
+
+CREATE OR REPLACE FUNCTION synchdb_fdw_key_columns(
+    p_dst_schema name,
+    p_tbl        name
+) RETURNS name[]
+LANGUAGE sql STABLE
+AS $$
+  -- primary key (or replica identity) columns of the destination table, in key order.
+  -- Deferring index builds (p_defer_index) keeps primary keys, so chunking still works
+  SELECT array_agg(lower(a.attname)::name ORDER BY k.ord)
+  FROM (
+    SELECT i.indrelid, i.indkey
+    FROM   pg_index i
+    WHERE  i.indrelid = format('%I.%I', p_dst_schema, p_tbl)::regclass
+      AND  (i.indisprimary OR i.indisreplident)
+    ORDER  BY i.indisprimary DESC
+    LIMIT  1
+  ) x
+  CROSS JOIN LATERAL unnest(x.indkey::int2[]) WITH ORDINALITY AS k(attnum, ord)
+  JOIN pg_attribute a ON a.attrelid = x.indrelid AND a.attnum = k.attnum;
+$$;
+
+COMMENT ON FUNCTION synchdb_fdw_key_columns(name, name) IS
+   'return primary key or replica identity columns of a table in key order';
+
+CREATE OR REPLACE FUNCTION synchdb_fdw_keyset_batch(
+    p_src_schema name,
+    p_dst_schema name,
+    p_tbl        name,
+    p_dst_list   text,
+    p_src_list   text,
+    p_key_cols   text[],       -- quoted source key columns
+    p_last_key   text[],       -- NULL to start from the beginning
+    p_rows       integer,
+    OUT rows_loaded bigint,
+    OUT last_key    text[]
+)
+LANGUAGE plpgsql
+AS $$
+DECLARE
+  v_pred  text := 'true';
+  v_conj  text;
+  v_order text;
+  v_desc  text;
+  v_last  text;
+  i       int;
+  j       int;
+BEGIN
+  -- (k1 > v1) OR (k1 = v1 AND k2 > v2) OR ... so that oracle_fdw can push it down
+  IF p_last_key IS NOT NULL THEN
+    v_pred := '';
+    FOR i IN 1 .. array_length(p_key_cols, 1) LOOP
+      v_conj := '';
+      FOR j IN 1 .. i - 1 LOOP
+        v_conj := v_conj || format('%s = %L AND ', p_key_cols[j], p_last_key[j]);
+      END LOOP;
+      v_conj := v_conj || format('%s > %L', p_key_cols[i], p_last_key[i]);
+      v_pred := v_pred || CASE WHEN i > 1 THEN ' OR ' ELSE '' END || '(' || v_conj || ')';
+    END LOOP;
+  END IF;
+
+  SELECT string_agg(k, ', '),
+         string_agg(k || ' DESC', ', '),
+         'ARRAY[' || string_agg(k || '::text', ', ') || ']'
+  INTO v_order, v_desc, v_last
+  FROM unnest(p_key_cols) AS k;
+
+  EXECUTE format(
+    $sql$
+    WITH b AS MATERIALIZED (
+      SELECT * FROM %I.%I WHERE %s ORDER BY %s LIMIT %s
+    ),
+    ins AS (
+      INSERT INTO %I.%I (%s) SELECT %s FROM b RETURNING 1
+    )
+    SELECT (SELECT count(*) FROM ins),
+           (SELECT %s FROM b ORDER BY %s LIMIT 1)
+    $sql$,
+    p_src_schema, p_tbl, v_pred, v_order, p_rows,
+    p_dst_schema, p_tbl, p_dst_list, p_src_list,
+    v_last, v_desc
+  )
+  INTO rows_loaded, last_key;
+END;
+$$;
+
+COMMENT ON FUNCTION synchdb_fdw_keyset_batch(name, name, name, text, text, text[], text[], integer) IS
+   'load the next batch of rows after the given key from a foreign table';
+
 CREATE OR REPLACE FUNCTION synchdb_migrate_data_with_transforms(
     p_src_schema        name,                 -- e.g. 'ora_stage'
     p_connector_name    name,                 -- connector for stats + objmap filter
@@ -2324,8 +2507,11 @@ CREATE OR REPLACE FUNCTION synchdb_migrate_data_with_transforms(
     p_do_truncate       boolean DEFAULT false,
     p_rows_per_tick     integer DEFAULT 0,    -- 0/NULL = no batching; >0 = stats every N rows
     p_continue_on_error boolean DEFAULT true,
-    p_batch_subxact     boolean DEFAULT true  -- only used when batching
-) RETURNS void
+    p_batch_subxact     boolean DEFAULT true, -- only used when batching
+    p_frozen            boolean DEFAULT false, -- load pre-frozen tuples when possible, no batching only
+    p_only_table        name DEFAULT NULL,     -- migrate only this table, used by parallel snapshot
+    p_src_rel           name DEFAULT NULL      -- read p_only_table from this relation in p_src_schema
+) RETURNS integer                            -- number of tables that failed to load in this call
 LANGUAGE plpgsql
 AS $$
 DECLARE
@@ -2334,8 +2520,6 @@ DECLARE
   src_list          text;
   v_rows            bigint;
   v_total           bigint;
-  v_off             bigint;
-  ins_sql           text;
 
   err_state         text;
   err_msg           text;
@@ -2352,6 +2536,20 @@ DECLARE
   v_err_count       bigint;     -- summary count at end
 
   v_any_batch_failed boolean;   -- tracks data failures in batching mode
+  v_empty           boolean;    -- destination is empty, used by frozen load
+
+  v_key_dst         name[];     -- destination key columns used for keyset batching
+  v_key_src         text[];     -- matching quoted source columns
+  v_last_key        text[];     -- last key loaded in batching mode
+  v_next_key        text[];
+  v_progress_rows   bigint;
+  v_dst_rows        bigint;
+  v_src_tbl         name;       -- source relation to read r.tbl from
+  v_failed          integer := 0;
+
+  -- a range of a split table does not decide whether the whole table is loaded,
+  -- so its success must not clear an error recorded by another range
+  v_clear_err       boolean := p_src_rel IS NULL;
 BEGIN
   -- sanitize connector name to identifier suffix
   v_err_tbl_ident :=
@@ -2375,6 +2573,7 @@ BEGIN
     JOIN   pg_class        c ON c.oid = ft.ftrelid
     JOIN   pg_namespace    n ON n.oid = c.relnamespace
     WHERE  n.nspname = p_src_schema
+      AND  (p_only_table IS NULL OR lower(c.relname) = lower(p_only_table))
       AND  EXISTS (
              SELECT 1
              FROM pg_class c2
@@ -2393,7 +2592,11 @@ BEGIN
 
     v_any_batch_failed := false;
 
+    v_src_tbl := COALESCE(p_src_rel, r.tbl);
+
     BEGIN
+      v_key_dst := synchdb_fdw_key_columns(p_dst_schema, r.tbl::name);
+
       -- Build column/expr lists
       WITH dst_cols AS (
         SELECT c.ordinal_position, lower(c.column_name) AS dst_col
@@ -2489,6 +2692,7 @@ BEGIN
         SELECT
           m.ordinal_position,
           m.dst_col,
+          m.src_col,
           CASE
             WHEN NOT EXISTS (
               SELECT 1 FROM src_presence sp
@@ -2507,13 +2711,15 @@ BEGIN
       )
       SELECT
         string_agg(quote_ident(dst_col), ', ' ORDER BY ordinal_position),
-        string_agg(src_expr,              ', ' ORDER BY ordinal_position)
-      INTO dst_list, src_list
+        string_agg(src_expr,              ', ' ORDER BY ordinal_position),
+        array_agg(quote_ident(src_col) ORDER BY array_position(v_key_dst, dst_col::name))
+          FILTER (WHERE dst_col::name = ANY (v_key_dst) AND src_expr <> 'NULL')
+      INTO dst_list, src_list, v_key_src
       FROM exprs;
 
       IF dst_list IS NULL OR src_list IS NULL THEN
         RAISE NOTICE 'Skipping %.%: no column metadata', p_dst_schema, r.tbl;
-        RETURN;
+        RETURN v_failed;
       END IF;
 
       -- Optional truncate
@@ -2564,17 +2770,40 @@ BEGIN
       END IF;
 
       -- Insert path
-      IF COALESCE(p_rows_per_tick,0) <= 0 THEN
+      IF COALESCE(p_rows_per_tick,0) <= 0 AND p_frozen THEN
+        -- an empty table truncated in this subtransaction can take frozen tuples
+        EXECUTE format('SELECT NOT EXISTS (SELECT 1 FROM %I.%I)', p_dst_schema, r.tbl)
+          INTO v_empty;
+        IF v_empty THEN
+          EXECUTE format('TRUNCATE %I.%I', p_dst_schema, r.tbl);
+        END IF;
+
+        v_rows := synchdb_insert_frozen(
+                    format('%I.%I', p_dst_schema, r.tbl)::regclass,
+                    dst_list,
+                    format('SELECT %s FROM %I.%I', src_list, p_src_schema, v_src_tbl));
+        PERFORM synchdb_set_snapstats(p_connector_name, 0::bigint, v_rows::bigint, 0::bigint, 0::bigint);
+        RAISE NOTICE 'Loaded %.% from %.% (rows=%)', p_dst_schema, r.tbl, p_src_schema, v_src_tbl, v_rows;
+
+        IF v_err_tbl_exists AND v_clear_err THEN
+          EXECUTE format(
+            'DELETE FROM %I.%I WHERE connector_name = $1 AND tbl = $2',
+            'public', v_err_tbl_ident
+          )
+          USING p_connector_name, v_tbl_display;
+        END IF;
+
+      ELSIF COALESCE(p_rows_per_tick,0) <= 0 THEN
         EXECUTE format(
           'INSERT INTO %I.%I (%s) SELECT %s FROM %I.%I',
-          p_dst_schema, r.tbl, dst_list, src_list, p_src_schema, r.tbl
+          p_dst_schema, r.tbl, dst_list, src_list, p_src_schema, v_src_tbl
         );
         GET DIAGNOSTICS v_rows = ROW_COUNT;
         PERFORM synchdb_set_snapstats(p_connector_name, 0::bigint, v_rows::bigint, 0::bigint, 0::bigint);
-        RAISE NOTICE 'Loaded %.% from %.% (rows=%)', p_dst_schema, r.tbl, p_src_schema, r.tbl, v_rows;
+        RAISE NOTICE 'Loaded %.% from %.% (rows=%)', p_dst_schema, r.tbl, p_src_schema, v_src_tbl, v_rows;
 
         -- success for the whole table (non-batch): delete error row if table exists
-        IF v_err_tbl_exists THEN
+        IF v_err_tbl_exists AND v_clear_err THEN
           EXECUTE format(
             'DELETE FROM %I.%I WHERE connector_name = $1 AND tbl = $2',
             'public', v_err_tbl_ident
@@ -2582,38 +2811,62 @@ BEGIN
           USING p_connector_name, v_tbl_display;
         END IF;
 
-      ELSE
-        -- Batching path
+      ELSIF v_key_src IS NULL OR array_length(v_key_src, 1) <> array_length(v_key_dst, 1) THEN
+        -- no key to chunk on: load the table in one pass
+        RAISE NOTICE 'No primary key on %.% to chunk on, loading in one pass', p_dst_schema, r.tbl;
         EXECUTE format(
-          'SELECT count(*) FROM (SELECT %s FROM %I.%I) q',
-          src_list, p_src_schema, r.tbl
-        )
-        INTO v_total;
-
-        v_off := 0;
-        WHILE v_off < v_total LOOP
-          ins_sql := format(
-            $sql$
-            INSERT INTO %I.%I (%s)
-            SELECT %s
-            FROM (
-              SELECT %s, row_number() OVER () AS rn
-              FROM %I.%I
-            ) t
-            WHERE t.rn > %s AND t.rn <= %s
-            $sql$,
-            p_dst_schema, r.tbl,
-            dst_list,
-            src_list,
-            src_list,
-            p_src_schema, r.tbl,
-            v_off, v_off + p_rows_per_tick
-          );
+          'INSERT INTO %I.%I (%s) SELECT %s FROM %I.%I',
+          p_dst_schema, r.tbl, dst_list, src_list, p_src_schema, v_src_tbl
+        );
+        GET DIAGNOSTICS v_rows = ROW_COUNT;
+        PERFORM synchdb_set_snapstats(p_connector_name, 0::bigint, v_rows::bigint, 0::bigint, 0::bigint);
+        RAISE NOTICE 'Loaded %.% from %.% (rows=%)', p_dst_schema, r.tbl, p_src_schema, v_src_tbl, v_rows;
+
+        IF v_err_tbl_exists AND v_clear_err THEN
+          EXECUTE format(
+            'DELETE FROM %I.%I WHERE connector_name = $1 AND tbl = $2',
+            'public', v_err_tbl_ident
+          )
+          USING p_connector_name, v_tbl_display;
+        END IF;
+
+      ELSE
+        -- Batching path: keyset chunks in key order. Resume after the last key
+        -- recorded by a previous run at the same SCN if the destination still
+        -- holds exactly the rows loaded so far.
+        v_last_key := NULL;
+        v_progress_rows := NULL;
+        v_total := 0;
+
+        SELECT p.last_key, p.rows_loaded
+          INTO v_last_key, v_progress_rows
+          FROM synchdb_fdw_snapshot_progress p
+         WHERE p.connector_name = p_connector_name
+           AND p.tbl = v_tbl_display
+           AND p.scn = p_scn;
+
+        IF v_last_key IS NOT NULL THEN
+          EXECUTE format('SELECT count(*) FROM %I.%I', p_dst_schema, r.tbl) INTO v_dst_rows;
+          IF v_dst_rows = v_progress_rows THEN
+            v_total := v_progress_rows;
+            RAISE NOTICE 'Resuming %.% after key % (% rows already loaded)',
+                         p_dst_schema, r.tbl, v_last_key, v_progress_rows;
+          ELSE
+            v_last_key := NULL;
+          END IF;
+        END IF;
+
+        LOOP
+          v_rows := 0;
+          v_next_key := NULL;
 
           IF p_batch_subxact THEN
             BEGIN
-              EXECUTE ins_sql;
-              GET DIAGNOSTICS v_rows = ROW_COUNT;
+              SELECT b.rows_loaded, b.last_key
+                INTO v_rows, v_next_key
+                FROM synchdb_fdw_keyset_batch(p_src_schema, p_dst_schema, r.tbl::name,
+                                              dst_list, src_list, v_key_src,
+                                              v_last_key, p_rows_per_tick) b;
             EXCEPTION WHEN OTHERS THEN
               v_any_batch_failed := true;
 
@@ -2652,32 +2905,55 @@ BEGIN
               IF NOT p_continue_on_error THEN
                 RAISE;
               ELSE
-                RAISE WARNING 'Batch insert %.% rows (%-%) failed: % [%]',
-                              p_dst_schema, r.tbl, v_off+1, v_off+p_rows_per_tick, err_msg, err_state;
-                v_rows := 0;
+                -- stop this table here, a later run resumes after the last loaded key
+                RAISE WARNING 'Batch insert %.% after key % failed: % [%]',
+                              p_dst_schema, r.tbl, v_last_key, err_msg, err_state;
               END IF;
             END;
           ELSE
-            EXECUTE ins_sql;
-            GET DIAGNOSTICS v_rows = ROW_COUNT;
+            SELECT b.rows_loaded, b.last_key
+              INTO v_rows, v_next_key
+              FROM synchdb_fdw_keyset_batch(p_src_schema, p_dst_schema, r.tbl::name,
+                                            dst_list, src_list, v_key_src,
+                                            v_last_key, p_rows_per_tick) b;
           END IF;
 
-          IF v_rows > 0 THEN
-            PERFORM synchdb_set_snapstats(p_connector_name, 0::bigint, v_rows::bigint, 0::bigint, 0::bigint);
-            RAISE NOTICE 'Loaded batch: %.% (+% rows, offset % / %)',
-                         p_dst_schema, r.tbl, v_rows, v_off, v_total;
-          END IF;
+          EXIT WHEN v_any_batch_failed OR COALESCE(v_rows, 0) = 0;
 
-          v_off := v_off + p_rows_per_tick;
+          v_last_key := v_next_key;
+          v_total := v_total + v_rows;
+
+          PERFORM synchdb_set_snapstats(p_connector_name, 0::bigint, v_rows::bigint, 0::bigint, 0::bigint);
+
+          INSERT INTO synchdb_fdw_snapshot_progress (connector_name, tbl, last_key, rows_loaded, scn)
+          VALUES (p_connector_name, v_tbl_display, v_last_key, v_total, p_scn)
+          ON CONFLICT (connector_name, tbl)
+          DO UPDATE SET last_key    = EXCLUDED.last_key,
+                        rows_loaded = EXCLUDED.rows_loaded,
+                        scn         = EXCLUDED.scn,
+                        ts          = now();
+
+          RAISE NOTICE 'Loaded batch: %.% (+% rows, % total, last key %)',
+                       p_dst_schema, r.tbl, v_rows, v_total, v_last_key;
+
+          EXIT WHEN v_rows < p_rows_per_tick;
         END LOOP;
 
-        -- If no batch failed, delete error row for this table (if the table exists)
-        IF NOT v_any_batch_failed AND v_err_tbl_exists THEN
-          EXECUTE format(
-            'DELETE FROM %I.%I WHERE connector_name = $1 AND tbl = $2',
-            'public', v_err_tbl_ident
-          )
-          USING p_connector_name, v_tbl_display;
+        -- If no batch failed, the table is complete: drop its progress and error rows
+        IF v_any_batch_failed THEN
+          v_failed := v_failed + 1;
+        ELSE
+          DELETE FROM synchdb_fdw_snapshot_progress
+           WHERE connector_name = p_connector_name
+             AND tbl = v_tbl_display;
+
+          IF v_err_tbl_exists AND v_clear_err THEN
+            EXECUTE format(
+              'DELETE FROM %I.%I WHERE connector_name = $1 AND tbl = $2',
+              'public', v_err_tbl_ident
+            )
+            USING p_connector_name, v_tbl_display;
+          END IF;
         END IF;
       END IF;
 
@@ -2716,6 +2992,8 @@ BEGIN
         )
         USING p_connector_name, v_tbl_display, err_state, err_msg, p_scn;
 
+        v_failed := v_failed + 1;
+
         IF NOT p_continue_on_error THEN
           RAISE;
         ELSE
@@ -2741,10 +3019,12 @@ BEGIN
   ELSE
     RAISE NOTICE 'Migration finished. No errors recorded this run.';
   END IF;
+
+  RETURN v_failed;
 END;
 $$;
 
-COMMENT ON FUNCTION synchdb_migrate_data_with_transforms(name, name, name, name, numeric, name, boolean, int, boolean, boolean) IS
+COMMENT ON FUNCTION synchdb_migrate_data_with_transforms(name, name, name, name, numeric, name, boolean, int, boolean, boolean, boolean, name, name) IS
    'migrate data while applying transform expressions if available - sub-transaction mode';
 
 CREATE OR REPLACE FUNCTION synchdb_migrate_data_with_transforms_nosubs(
@@ -2754,7 +3034,8 @@ CREATE OR REPLACE FUNCTION synchdb_migrate_data_with_transforms_nosubs(
     p_desired_db      name,                 -- e.g. 'free'
     p_desired_schema  name DEFAULT NULL,    -- e.g. 'dbzuser'
     p_do_truncate     boolean DEFAULT false,
-    p_rows_per_tick   integer DEFAULT 0     -- 0/NULL = no batching; >0 = call stats every N rows
+    p_rows_per_tick   integer DEFAULT 0,    -- 0/NULL = no batching; >0 = call stats every N rows
+    p_frozen          boolean DEFAULT false -- load pre-frozen tuples when possible, no batching only
 ) RETURNS void
 LANGUAGE plpgsql
 AS $$
@@ -2764,10 +3045,11 @@ DECLARE
   src_list    text;
   v_rows      bigint;
   v_total     bigint;
-  v_off       bigint;
   -- helpers for batching
-  base_select text;
-  ins_sql     text;
+  v_empty     boolean;
+  v_key_dst   name[];
+  v_key_src   text[];
+  v_last_key  text[];
 BEGIN
   -- Iterate all source FTs that have a same-named real table in the destination schema
   FOR r IN
@@ -2785,6 +3067,8 @@ BEGIN
                AND c2.relkind = 'r'
            )
   LOOP
+    v_key_dst := synchdb_fdw_key_columns(p_dst_schema, r.tbl::name);
+
     -- Build per-table column lists (destination names and source expressions)
     WITH dst_cols AS (
       SELECT c.ordinal_position, lower(c.column_name) AS dst_col
@@ -2880,6 +3164,7 @@ BEGIN
       SELECT
         m.ordinal_position,
         m.dst_col,
+        m.src_col,
         CASE
           WHEN NOT EXISTS (
             SELECT 1 FROM src_presence sp WHERE sp.tbl = r.tbl AND sp.src_col = m.src_col
@@ -2897,8 +3182,10 @@ BEGIN
     )
     SELECT
       string_agg(quote_ident(dst_col), ', ' ORDER BY ordinal_position),
-      string_agg(src_expr,              ', ' ORDER BY ordinal_position)
-    INTO dst_list, src_list
+      string_agg(src_expr,              ', ' ORDER BY ordinal_position),
+      array_agg(quote_ident(src_col) ORDER BY array_position(v_key_dst, dst_col::name))
+        FILTER (WHERE dst_col::name = ANY (v_key_dst) AND src_expr <> 'NULL')
+    INTO dst_list, src_list, v_key_src
     FROM exprs;
 
     IF dst_list IS NULL OR src_list IS NULL THEN
@@ -2910,8 +3197,23 @@ BEGIN
       EXECUTE format('TRUNCATE %I.%I', p_dst_schema, r.tbl);
     END IF;
 
+    -- === No batching, frozen: empty table truncated in this transaction takes frozen tuples ===
+    IF COALESCE(p_rows_per_tick, 0) <= 0 AND p_frozen THEN
+      EXECUTE format('SELECT NOT EXISTS (SELECT 1 FROM %I.%I)', p_dst_schema, r.tbl)
+        INTO v_empty;
+      IF v_empty THEN
+        EXECUTE format('TRUNCATE %I.%I', p_dst_schema, r.tbl);
+      END IF;
+
+      v_rows := synchdb_insert_frozen(
+                  format('%I.%I', p_dst_schema, r.tbl)::regclass,
+                  dst_list,
+                  format('SELECT %s FROM %I.%I', src_list, p_src_schema, r.tbl));
+      PERFORM synchdb_set_snapstats(p_connector_name, 0::bigint, v_rows::bigint, 0::bigint, 0::bigint);
+      RAISE NOTICE 'Loaded %.% from %.% (rows=%)', p_dst_schema, r.tbl, p_src_schema, r.tbl, v_rows;
+
     -- === No batching: one-shot insert, then report actual row count ===
-    IF COALESCE(p_rows_per_tick, 0) <= 0 THEN
+    ELSIF COALESCE(p_rows_per_tick, 0) <= 0 THEN
       EXECUTE format(
         'INSERT INTO %I.%I (%s) SELECT %s FROM %I.%I',
         p_dst_schema, r.tbl, dst_list, src_list, p_src_schema, r.tbl
@@ -2922,48 +3224,36 @@ BEGIN
       RAISE NOTICE 'Loaded %.% from %.% (rows=%)', p_dst_schema, r.tbl, p_src_schema, r.tbl, v_rows;
 
     ELSE
-      -- === Batching mode: insert in chunks; call stats after each chunk ===
-      -- 1) Count total rows to process using the same SELECT list
-      EXECUTE format(
-        'SELECT count(*) FROM (SELECT %s FROM %I.%I) q',
-        src_list, p_src_schema, r.tbl
-      )
-      INTO v_total;
-
-      v_off := 0;
-      WHILE v_off < v_total LOOP
-        ins_sql := format(
-          $sql$
-          INSERT INTO %I.%I (%s)
-          SELECT %s
-          FROM (
-            SELECT %s, row_number() OVER () AS rn
-            FROM %I.%I
-          ) t
-          WHERE t.rn > %s AND t.rn <= %s
-          $sql$,
-          p_dst_schema, r.tbl,
-          dst_list,
-          src_list,
-          src_list,
-          p_src_schema, r.tbl,
-          v_off, v_off + p_rows_per_tick
+      -- === Batching mode: insert keyset chunks in key order; call stats after each chunk ===
+      IF v_key_src IS NULL OR array_length(v_key_src, 1) <> array_length(v_key_dst, 1) THEN
+        RAISE NOTICE 'No primary key on %.% to chunk on, loading in one pass', p_dst_schema, r.tbl;
+        EXECUTE format(
+          'INSERT INTO %I.%I (%s) SELECT %s FROM %I.%I',
+          p_dst_schema, r.tbl, dst_list, src_list, p_src_schema, r.tbl
         );
-
-        EXECUTE ins_sql;
         GET DIAGNOSTICS v_rows = ROW_COUNT;
+        PERFORM synchdb_set_snapstats(p_connector_name, 0::bigint, v_rows::bigint, 0::bigint, 0::bigint);
+        RAISE NOTICE 'Loaded %.% from %.% (rows=%)', p_dst_schema, r.tbl, p_src_schema, r.tbl, v_rows;
+        CONTINUE;
+      END IF;
 
-        IF v_rows > 0 THEN
-          PERFORM synchdb_set_snapstats(p_connector_name, 0::bigint, v_rows::bigint, 0::bigint, 0::bigint);
-          RAISE NOTICE 'Loaded batch: %.% (+% rows, offset % / %)',
-                       p_dst_schema, r.tbl, v_rows, v_off, v_total;
-        END IF;
+      v_last_key := NULL;
+      v_total := 0;
+      LOOP
+        SELECT b.rows_loaded, b.last_key
+          INTO v_rows, v_last_key
+          FROM synchdb_fdw_keyset_batch(p_src_schema, p_dst_schema, r.tbl::name,
+                                        dst_list, src_list, v_key_src,
+                                        v_last_key, p_rows_per_tick) b;
 
-        v_off := v_off + p_rows_per_tick;
-        -- Optional: exit early if no rows inserted (safety)
-        IF v_rows = 0 THEN
-          EXIT;
-        END IF;
+        EXIT WHEN COALESCE(v_rows, 0) = 0;
+
+        v_total := v_total + v_rows;
+        PERFORM synchdb_set_snapstats(p_connector_name, 0::bigint, v_rows::bigint, 0::bigint, 0::bigint);
+        RAISE NOTICE 'Loaded batch: %.% (+% rows, % total)',
+                     p_dst_schema, r.tbl, v_rows, v_total;
+
+        EXIT WHEN v_rows < p_rows_per_tick;
       END LOOP;
     END IF;
 
@@ -2971,7 +3261,7 @@ BEGIN
 END;
 $$;
 
-COMMENT ON FUNCTION synchdb_migrate_data_with_transforms_nosubs(name, name, name, name, name, boolean, int) IS
+COMMENT ON FUNCTION synchdb_migrate_data_with_transforms_nosubs(name, name, name, name, name, boolean, int, boolean) IS
    'migrate data while applying transform expressions if available - all or nothing mode';
 
 CREATE OR REPLACE FUNCTION synchdb_apply_table_mappings(
@@ -3199,6 +3489,532 @@ $$;
 COMMENT ON FUNCTION synchdb_finalize_initial_snapshot(name, name, name, name) IS
    'finalize initial snapshot by cleaning up resources and objects';
 
+CREATE TABLE IF NOT EXISTS synchdb_fdw_snapshot_job (
+    connector_name  name PRIMARY KEY,
+    source_schema   name        NOT NULL,   -- holds the source catalog foreign tables
+    stage_schema    name        NOT NULL,
+    dest_schema     name        NOT NULL,
+    lookup_db       name        NOT NULL,
+    lookup_schema   name,
+    scn             numeric     NOT NULL,   -- all workers read stage tables AS OF this SCN
+    frozen          boolean     NOT NULL DEFAULT false,
+    ts              timestamptz NOT NULL DEFAULT now()
+);
+
+CREATE TABLE IF NOT EXISTS synchdb_fdw_snapshot_tables (
+    connector_name  name        NOT NULL,
+    tbl             name        NOT NULL,
+    range_no        int         NOT NULL DEFAULT 0,   -- 0: whole table, >0: ROWID range of a split table
+    src_rel         name,                             -- staging foreign table of this range
+    range_lo        text,                             -- first Oracle ROWID of this range
+    range_hi        text,                             -- last Oracle ROWID of this range
+    state           text        NOT NULL DEFAULT 'pending'
+                    CHECK (state IN ('pending', 'running', 'done', 'failed')),
+    attempts        int         NOT NULL DEFAULT 0,
+    worker_pid      int,
+    started_at      timestamptz,
+    finished_at     timestamptz,
+    PRIMARY KEY (connector_name, tbl, range_no)
+);
+
+CREATE OR REPLACE FUNCTION synchdb_fdw_snapshot_err_table(
+    p_connector_name name
+) RETURNS text
+LANGUAGE plpgsql
+AS $$
+DECLARE
+  v_err_tbl_ident text;
+BEGIN
+  v_err_tbl_ident :=
+      'synchdb_fdw_snapshot_errors_'
+      || regexp_replace(lower(p_connector_name::text), '[^a-z0-9_]', '_', 'g');
+
+  EXECUTE format(
+    'CREATE TABLE IF NOT EXISTS %I.%I (
+       connector_name name        NOT NULL,
+       tbl            text        NOT NULL,
+       err_state      text        NOT NULL,
+       err_msg        text        NOT NULL,
+       scn            numeric     NOT NULL,
+       ts             timestamptz NOT NULL DEFAULT now(),
+       CONSTRAINT %I UNIQUE (connector_name, tbl)
+     )',
+    'public', v_err_tbl_ident, ('uq_'||v_err_tbl_ident)
+  );
+  RETURN v_err_tbl_ident;
+END;
+$$;
+
+COMMENT ON FUNCTION synchdb_fdw_snapshot_err_table(name) IS
+   'create the per-connector FDW snapshot error table if needed and return its name';
+
+CREATE OR REPLACE FUNCTION synchdb_fdw_snapshot_prepare_tables(
+    p_connector_name name,
+    p_source_schema  name,
+    p_stage_schema   name,
+    p_dest_schema    name,
+    p_lookup_db      name,
+    p_lookup_schema  name,
+    p_scn            numeric,
+    p_frozen         boolean DEFAULT false
+) RETURNS int
+LANGUAGE plpgsql
+AS $$
+DECLARE
+  v_count int;
+BEGIN
+  INSERT INTO synchdb_fdw_snapshot_job
+         (connector_name, source_schema, stage_schema, dest_schema, lookup_db, lookup_schema, scn, frozen)
+  VALUES (p_connector_name, p_source_schema, p_stage_schema, p_dest_schema, p_lookup_db, p_lookup_schema,
+          p_scn, p_frozen)
+  ON CONFLICT (connector_name)
+  DO UPDATE SET source_schema = EXCLUDED.source_schema,
+                stage_schema  = EXCLUDED.stage_schema,
+                dest_schema   = EXCLUDED.dest_schema,
+                lookup_db     = EXCLUDED.lookup_db,
+                lookup_schema = EXCLUDED.lookup_schema,
+                scn           = EXCLUDED.scn,
+                frozen        = EXCLUDED.frozen,
+                ts            = now();
+
+  DELETE FROM synchdb_fdw_snapshot_tables WHERE connector_name = p_connector_name;
+
+  -- same table selection as synchdb_migrate_data_with_transforms
+  INSERT INTO synchdb_fdw_snapshot_tables (connector_name, tbl)
+  SELECT p_connector_name, lower(c.relname)
+  FROM   pg_foreign_table ft
+  JOIN   pg_class        c ON c.oid = ft.ftrelid
+  JOIN   pg_namespace    n ON n.oid = c.relnamespace
+  WHERE  n.nspname = p_stage_schema
+    AND  EXISTS (
+           SELECT 1
+           FROM pg_class c2
+           JOIN pg_namespace n2 ON n2.oid = c2.relnamespace
+           WHERE n2.nspname = p_dest_schema
+             AND lower(c2.relname) = lower(c.relname)
+             AND c2.relkind = 'r'
+         );
+  GET DIAGNOSTICS v_count = ROW_COUNT;
+
+  -- created up front so concurrent workers never race to create it
+  PERFORM synchdb_fdw_snapshot_err_table(p_connector_name);
+
+  RETURN v_count;
+END;
+$$;
+
+COMMENT ON FUNCTION synchdb_fdw_snapshot_prepare_tables(name, name, name, name, name, name, numeric, boolean) IS
+   'record a parallel FDW snapshot job and queue its tables for snapshot workers';
+
+CREATE OR REPLACE FUNCTION synchdb_fdw_snapshot_split_tables(
+    p_connector_name name,
+    p_split_bytes    bigint,    -- tables at least twice this size are split
+    p_max_ranges     int
+) RETURNS int
+LANGUAGE plpgsql
+AS $$
+DECLARE
+  j           record;
+  t           record;
+  b           record;
+  v_opt       text;
+  v_server    name;
+  v_ftoid     oid;
+  v_match     text[];
+  v_owner     text;
+  v_table     text;
+  v_bytes     bigint;
+  v_nranges   int;
+  v_cols      text;
+  v_ext_ft    name;
+  v_range_ft  name;
+  v_created   int;
+  v_split     int := 0;
+BEGIN
+  IF COALESCE(p_split_bytes, 0) <= 0 OR COALESCE(p_max_ranges, 0) < 2 THEN
+    RETURN 0;
+  END IF;
+
+  SELECT * INTO j FROM synchdb_fdw_snapshot_job WHERE connector_name = p_connector_name;
+  IF NOT FOUND THEN
+    RAISE EXCEPTION 'no FDW snapshot job found for connector %', p_connector_name;
+  END IF;
+
+  -- one round trip for the sizes of all candidate tables. Partitioned tables
+  -- have TABLE PARTITION segments only, so they are not split and load whole
+  EXECUTE format(
+    'CREATE TEMP TABLE synchdb_split_segments ON COMMIT DROP AS
+       SELECT schema, segment_name, bytes
+         FROM %I.segments
+        WHERE segment_type = ''TABLE'' AND bytes >= $1',
+    j.source_schema)
+  USING p_split_bytes * 2;
+
+  FOR t IN
+    SELECT q.tbl
+      FROM synchdb_fdw_snapshot_tables q
+     WHERE q.connector_name = p_connector_name
+       AND q.range_no = 0
+       AND q.state = 'pending'
+  LOOP
+    SELECT c.oid, ft.ftserver::regclass::text, opt.v
+      INTO v_ftoid, v_server, v_opt
+      FROM pg_foreign_table ft
+      JOIN pg_class c ON c.oid = ft.ftrelid
+      JOIN pg_namespace n ON n.oid = c.relnamespace
+      CROSS JOIN LATERAL (
+        SELECT substr(o, length('table=') + 1) AS v
+          FROM unnest(ft.ftoptions) o
+         WHERE o LIKE 'table=%'
+      ) opt
+     WHERE n.nspname = j.stage_schema
+       AND c.relname = t.tbl;
+
+    -- staging tables read "(SELECT ... FROM owner.table AS OF SCN n)", see synchdb_create_ora_stage_fts
+    v_match := regexp_match(v_opt, '^\(SELECT .* FROM ("[^"]+"|[^ ."]+)\.("[^"]+"|[^ ."]+) AS OF SCN [0-9]+\)$');
+    IF v_match IS NULL THEN
+      CONTINUE;
+    END IF;
+
+    -- unquoted identifiers are upper case in Oracle
+    v_owner := CASE WHEN left(v_match[1], 1) = '"' THEN btrim(v_match[1], '"') ELSE upper(v_match[1]) END;
+    v_table := CASE WHEN left(v_match[2], 1) = '"' THEN btrim(v_match[2], '"') ELSE upper(v_match[2]) END;
+
+    SELECT s.bytes INTO v_bytes
+      FROM synchdb_split_segments s
+     WHERE s.schema = v_owner AND s.segment_name = v_table;
+    IF NOT FOUND THEN
+      CONTINUE;
+    END IF;
+
+    v_nranges := LEAST(ceil(v_bytes::numeric / p_split_bytes)::int, p_max_ranges);
+    IF v_nranges < 2 THEN
+      CONTINUE;
+    END IF;
+
+    -- extents of the table with the first and last ROWID each of them can hold
+    v_ext_ft := format('synchdb_extents_%s', v_ftoid)::name;
+    EXECUTE format('DROP FOREIGN TABLE IF EXISTS %I.%I', j.stage_schema, v_ext_ft);
+    EXECUTE format(
+      'CREATE FOREIGN TABLE %I.%I (fno bigint, block_id bigint, blocks bigint, lo_rid text, hi_rid text)
+         SERVER %I OPTIONS ("table" %L)',
+      j.stage_schema, v_ext_ft, v_server,
+      format('(SELECT e.relative_fno AS fno, e.block_id, e.blocks, '
+             'ROWIDTOCHAR(DBMS_ROWID.ROWID_CREATE(1, o.data_object_id, e.relative_fno, e.block_id, 0)) AS lo_rid, '
+             'ROWIDTOCHAR(DBMS_ROWID.ROWID_CREATE(1, o.data_object_id, e.relative_fno, e.block_id + e.blocks - 1, 32767)) AS hi_rid '
+             'FROM dba_extents e JOIN dba_objects o ON o.owner = e.owner AND o.object_name = e.segment_name '
+             'AND o.object_type = ''TABLE'' '
+             'WHERE e.owner = %L AND e.segment_name = %L AND e.segment_type = ''TABLE'')',
+             v_owner, v_table));
+
+    v_created := 0;
+    SELECT string_agg(format('%I %s', a.attname, format_type(a.atttypid, a.atttypmod)), ', ' ORDER BY a.attnum)
+      INTO v_cols
+      FROM pg_attribute a
+     WHERE a.attrelid = v_ftoid AND a.attnum > 0 AND NOT a.attisdropped;
+
+    -- contiguous extents in ROWID order, grouped into ranges of about the same number of blocks
+    FOR b IN
+      EXECUTE format(
+        'SELECT rno,
+                (array_agg(lo_rid ORDER BY fno, block_id))[1]           AS lo,
+                (array_agg(hi_rid ORDER BY fno DESC, block_id DESC))[1] AS hi
+           FROM (SELECT lo_rid, hi_rid, fno, block_id,
+                        1 + floor((sum(blocks) OVER w - blocks) * $1
+                                  / sum(blocks) OVER ())::int AS rno
+                   FROM %I.%I
+                 WINDOW w AS (ORDER BY fno, block_id)) x
+          GROUP BY rno
+          ORDER BY rno',
+        j.stage_schema, v_ext_ft)
+      USING v_nranges
+    LOOP
+      v_range_ft := format('synchdb_range_%s_%s', v_ftoid, b.rno)::name;
+      EXECUTE format('DROP FOREIGN TABLE IF EXISTS %I.%I', j.stage_schema, v_range_ft);
+      EXECUTE format(
+        'CREATE FOREIGN TABLE %I.%I (%s) SERVER %I OPTIONS ("table" %L)',
+        j.stage_schema, v_range_ft, v_cols, v_server,
+        left(v_opt, -1) || format(' WHERE ROWID BETWEEN CHARTOROWID(%L) AND CHARTOROWID(%L))', b.lo, b.hi));
+
+      INSERT INTO synchdb_fdw_snapshot_tables (connector_name, tbl, range_no, src_rel, range_lo, range_hi)
+      VALUES (p_connector_name, t.tbl, b.rno, v_range_ft, b.lo, b.hi);
+      v_created := v_created + 1;
+    END LOOP;
+
+    EXECUTE format('DROP FOREIGN TABLE %I.%I', j.stage_schema, v_ext_ft);
+
+    -- without extents the table stays queued as a whole
+    IF v_created > 0 THEN
+      DELETE FROM synchdb_fdw_snapshot_tables
+       WHERE connector_name = p_connector_name AND tbl = t.tbl AND range_no = 0;
+      RAISE NOTICE 'Split %.% (% bytes) into % ROWID ranges', v_owner, v_table, v_bytes, v_created;
+      v_split := v_split + 1;
+    END IF;
+  END LOOP;
+
+  RETURN v_split;
+END;
+$$;
+
+COMMENT ON FUNCTION synchdb_fdw_snapshot_split_tables(name, bigint, int) IS
+   'split large queued tables of a parallel FDW snapshot into Oracle ROWID ranges';
+
+CREATE OR REPLACE FUNCTION synchdb_fdw_snapshot_claim_table(
+    p_connector_name name
+) RETURNS TABLE (tbl name, range_no int)
+LANGUAGE sql
+AS $$
+  -- ranges of split tables go first so the largest tables start early
+  UPDATE synchdb_fdw_snapshot_tables t
+     SET state = 'running',
+         attempts = t.attempts + 1,
+         worker_pid = pg_backend_pid(),
+         started_at = now()
+   WHERE (t.connector_name, t.tbl, t.range_no) = (
+           SELECT q.connector_name, q.tbl, q.range_no
+             FROM synchdb_fdw_snapshot_tables q
+            WHERE q.connector_name = p_connector_name
+              AND q.state = 'pending'
+            ORDER BY q.range_no DESC, q.tbl
+            LIMIT 1
+              FOR UPDATE SKIP LOCKED)
+  RETURNING t.tbl, t.range_no;
+$$;
+
+COMMENT ON FUNCTION synchdb_fdw_snapshot_claim_table(name) IS
+   'claim the next pending table or range of a parallel FDW snapshot, no row when none is left';
+
+CREATE OR REPLACE FUNCTION synchdb_fdw_snapshot_load_table(
+    p_connector_name name,
+    p_tbl            name,
+    p_range_no       int DEFAULT 0,
+    p_max_attempts   int DEFAULT 3   -- a failed range is queued again until this many attempts
+) RETURNS boolean
+LANGUAGE plpgsql
+AS $$
+DECLARE
+  j             record;
+  q             record;
+  v_failed      boolean;
+BEGIN
+  SELECT * INTO j FROM synchdb_fdw_snapshot_job WHERE connector_name = p_connector_name;
+  IF NOT FOUND THEN
+    RAISE EXCEPTION 'no FDW snapshot job found for connector %', p_connector_name;
+  END IF;
+
+  SELECT * INTO q
+    FROM synchdb_fdw_snapshot_tables
+   WHERE connector_name = p_connector_name AND tbl = p_tbl AND range_no = p_range_no;
+
+  -- ranges of one table are loaded concurrently, which rules out frozen load.
+  -- The error table has one row per table shared by all its ranges, so the
+  -- outcome of this range is taken from the call itself.
+  v_failed := synchdb_migrate_data_with_transforms(
+      j.stage_schema, p_connector_name, j.dest_schema, j.lookup_db, j.scn,
+      j.lookup_schema, false, 0, true, true, j.frozen AND p_range_no = 0,
+      p_tbl, q.src_rel) > 0;
+
+  -- rows of a failed load are rolled back, so a range can simply be loaded again
+  UPDATE synchdb_fdw_snapshot_tables
+     SET state = CASE WHEN NOT v_failed THEN 'done'
+                      WHEN p_range_no > 0 AND attempts < p_max_attempts THEN 'pending'
+                      ELSE 'failed' END,
+         finished_at = now()
+   WHERE connector_name = p_connector_name
+     AND tbl = p_tbl
+     AND range_no = p_range_no;
+
+  IF v_failed AND p_range_no > 0 AND q.attempts < p_max_attempts THEN
+    RAISE WARNING 'Range % of %.% failed on attempt %, queued for retry',
+                  p_range_no, j.dest_schema, p_tbl, q.attempts;
+  END IF;
+
+  RETURN NOT v_failed;
+END;
+$$;
+
+COMMENT ON FUNCTION synchdb_fdw_snapshot_load_table(name, name, int, int) IS
+   'load one claimed table or range of a parallel FDW snapshot';
+
+CREATE OR REPLACE FUNCTION synchdb_fdw_snapshot_finish_parallel(
+    p_connector_name name,
+    p_defer_index    boolean DEFAULT false
+) RETURNS numeric
+LANGUAGE plpgsql
+AS $$
+DECLARE
+  j             record;
+  r             record;
+  v_err_tbl     text;
+BEGIN
+  SELECT * INTO j FROM synchdb_fdw_snapshot_job WHERE connector_name = p_connector_name;
+  IF NOT FOUND THEN
+    RAISE EXCEPTION 'no FDW snapshot job found for connector %', p_connector_name;
+  END IF;
+
+  -- tables never claimed or abandoned by a worker that exited early count as failed
+  v_err_tbl := synchdb_fdw_snapshot_err_table(p_connector_name);
+  UPDATE synchdb_fdw_snapshot_tables
+     SET state = 'failed', finished_at = now()
+   WHERE connector_name = p_connector_name
+     AND state IN ('pending', 'running');
+
+  -- a table is failed if any of its ranges is, even if a sibling range cleared its error row
+  FOR r IN
+    SELECT DISTINCT tbl
+      FROM synchdb_fdw_snapshot_tables
+     WHERE connector_name = p_connector_name
+       AND state = 'failed'
+  LOOP
+    EXECUTE format(
+      'INSERT INTO %I.%I (connector_name, tbl, err_state, err_msg, scn)
+       VALUES ($1,$2,$3,$4,$5)
+       ON CONFLICT (connector_name, tbl) DO NOTHING',
+      'public', v_err_tbl
+    )
+    USING p_connector_name,
+          CASE
+            WHEN j.lookup_schema IS NULL OR btrim(j.lookup_schema::text) = ''
+              THEN lower(j.lookup_db::text) || '.' || r.tbl
+            ELSE lower(j.lookup_db::text) || '.' || lower(j.lookup_schema::text) || '.' || r.tbl
+          END,
+          'XX000', 'table or some of its ranges were not loaded by snapshot workers', j.scn;
+    RAISE WARNING 'Table %.% was not completely loaded by snapshot workers', j.dest_schema, r.tbl;
+  END LOOP;
+
+  -- ranges do not clear the error row of their table, do it once all of them are loaded
+  FOR r IN
+    SELECT tbl
+      FROM synchdb_fdw_snapshot_tables
+     WHERE connector_name = p_connector_name
+       AND range_no > 0
+     GROUP BY tbl
+    HAVING bool_and(state = 'done')
+  LOOP
+    EXECUTE format('DELETE FROM %I.%I WHERE connector_name = $1 AND tbl = $2',
+                   'public', v_err_tbl)
+    USING p_connector_name,
+          CASE
+            WHEN j.lookup_schema IS NULL OR btrim(j.lookup_schema::text) = ''
+              THEN lower(j.lookup_db::text) || '.' || r.tbl
+            ELSE lower(j.lookup_db::text) || '.' || lower(j.lookup_schema::text) || '.' || r.tbl
+          END;
+  END LOOP;
+
+  IF p_defer_index THEN
+    RAISE NOTICE 'Step 8.5: Building deferred indexes on "%"', j.dest_schema;
+    PERFORM synchdb_build_deferred_indexes(p_connector_name);
+  END IF;
+
+  RAISE NOTICE 'Step 9: Applying table mappings on destination schema "%" (lookup: %.% for connector %)',
+               j.dest_schema, j.lookup_db, j.lookup_schema, p_connector_name;
+  PERFORM synchdb_apply_table_mappings(j.dest_schema, p_connector_name, j.lookup_db, j.lookup_schema);
+
+  RAISE NOTICE 'Initial snapshot completed successfully at SCN %', j.scn;
+
+  PERFORM synchdb_finalize_initial_snapshot(j.source_schema, j.stage_schema, p_connector_name,
+                                            ('metaschema_' || p_connector_name)::name);
+
+  PERFORM synchdb_set_snapstats(p_connector_name, 0::bigint, 0::bigint, 0::bigint,
+                                (extract(epoch from clock_timestamp()) * 1000)::bigint);
+
+  DELETE FROM synchdb_fdw_snapshot_job WHERE connector_name = p_connector_name;
+  RETURN j.scn;
+END;
+$$;
+
+COMMENT ON FUNCTION synchdb_fdw_snapshot_finish_parallel(name, boolean) IS
+   'complete a parallel FDW snapshot after all snapshot workers have exited';
+
+CREATE TABLE IF NOT EXISTS synchdb_deferred_index (
+    name        name NOT NULL,    -- connector name
+    schemaname  name NOT NULL,
+    tablename   name NOT NULL,
+    indexname   name NOT NULL,
+    indexdef    text NOT NULL,    -- as returned by pg_get_indexdef()
+    ts          timestamptz NOT NULL DEFAULT now(),
+    PRIMARY KEY (name, schemaname, indexname)
+);
+
+CREATE OR REPLACE FUNCTION synchdb_defer_secondary_indexes(
+    p_connector_name name,
+    p_relid          oid
+) RETURNS int
+LANGUAGE plpgsql
+AS $$
+DECLARE
+  r        record;
+  v_count  int := 0;
+BEGIN
+  -- plain secondary indexes only: primary key, unique, replica identity
+  -- and constraint backing indexes are kept during the snapshot
+  FOR r IN
+    SELECT n.nspname      AS nsp,
+           c.relname      AS tbl,
+           ic.relname     AS idx,
+           pg_get_indexdef(i.indexrelid) AS def
+    FROM   pg_index     i
+    JOIN   pg_class     ic ON ic.oid = i.indexrelid
+    JOIN   pg_class     c  ON c.oid  = i.indrelid
+    JOIN   pg_namespace n  ON n.oid  = c.relnamespace
+    WHERE  i.indrelid = p_relid
+      AND  NOT i.indisprimary
+      AND  NOT i.indisunique
+      AND  NOT i.indisreplident
+      AND  NOT EXISTS (SELECT 1 FROM pg_constraint con WHERE con.conindid = i.indexrelid)
+  LOOP
+    INSERT INTO synchdb_deferred_index (name, schemaname, tablename, indexname, indexdef)
+    VALUES (p_connector_name, r.nsp, r.tbl, r.idx, r.def)
+    ON CONFLICT (name, schemaname, indexname) DO NOTHING;
+
+    EXECUTE format('DROP INDEX %I.%I', r.nsp, r.idx);
+    RAISE NOTICE 'Deferred index %.% on % until snapshot completes', r.nsp, r.idx, r.tbl;
+    v_count := v_count + 1;
+  END LOOP;
+
+  RETURN v_count;
+END;
+$$;
+
+COMMENT ON FUNCTION synchdb_defer_secondary_indexes(name, oid) IS
+   'drop secondary indexes of a table and record them in synchdb_deferred_index for later build';
+
+CREATE OR REPLACE FUNCTION synchdb_build_deferred_indexes(
+    p_connector_name name
+) RETURNS int
+LANGUAGE plpgsql
+AS $$
+DECLARE
+  r        record;
+  v_count  int := 0;
+BEGIN
+  -- CREATE INDEX uses up to max_parallel_maintenance_workers parallel workers
+  FOR r IN
+    SELECT schemaname, tablename, indexname, indexdef
+    FROM   synchdb_deferred_index
+    WHERE  name = p_connector_name
+    ORDER  BY schemaname, tablename, indexname
+  LOOP
+    IF to_regclass(format('%I.%I', r.schemaname, r.indexname)) IS NULL AND
+       to_regclass(format('%I.%I', r.schemaname, r.tablename)) IS NOT NULL THEN
+      EXECUTE r.indexdef;
+      RAISE NOTICE 'Built deferred index %.% on %', r.schemaname, r.indexname, r.tablename;
+      v_count := v_count + 1;
+    END IF;
+
+    DELETE FROM synchdb_deferred_index
+     WHERE name = p_connector_name
+       AND schemaname = r.schemaname
+       AND indexname = r.indexname;
+  END LOOP;
+
+  RETURN v_count;
+END;
+$$;
+
+COMMENT ON FUNCTION synchdb_build_deferred_indexes(name) IS
+   'build the indexes deferred by synchdb_defer_secondary_indexes for a connector';
+
 CREATE OR REPLACE FUNCTION synchdb_do_initial_snapshot(
     p_connector_name  name,               -- e.g. 'oracleconn'
     p_secret          text,               -- master key for decrypting connector password
@@ -3212,7 +4028,10 @@ CREATE OR REPLACE FUNCTION synchdb_do_initial_snapshot(
     p_scn             numeric DEFAULT 0,          -- >0 to force a specific SCN; else auto-read
 	p_snapshot_tables text    DEFAULT null,
 	p_use_subtx         boolean DEFAULT true,
-	p_write_schema_hist boolean	DEFAULT false
+	p_write_schema_hist boolean	DEFAULT false,
+	p_defer_index       boolean DEFAULT false, -- build secondary indexes after data load, keys are kept
+	p_frozen_load       boolean DEFAULT false, -- load pre-frozen tuples
+	p_parallel          boolean DEFAULT false  -- stop after step 7 and queue tables for snapshot workers
 )
 RETURNS numeric
 LANGUAGE plpgsql
@@ -3223,6 +4042,7 @@ DECLARE
     v_effective_scn numeric;
     v_server_name   text;   -- will be set by synchdb_prepare_initial_snapshot()
 	v_meta_schema 	name;
+    r               record;
 BEGIN
     ----------------------------------------------------------------------
     -- Step 0: Prepare FDW server & user mapping from connector metadata
@@ -3285,6 +4105,8 @@ BEGIN
     RAISE NOTICE 'Step 5: Materializing staging foreign tables from "%"" to "%"', p_stage_schema, p_dest_schema;
     PERFORM synchdb_materialize_schema(p_connector_name, p_stage_schema, p_dest_schema, p_on_exists);
 
+    -- primary keys are built from source column names, so before the column mappings.
+    -- They are never deferred: keyset chunking needs them to batch the load
     RAISE NOTICE 'Step 6: Migrating primary keys from metadata schema "%" to "%"', p_source_schema, p_dest_schema;
     PERFORM synchdb_migrate_primary_keys(p_source_schema, p_dest_schema);
 
@@ -3292,6 +4114,32 @@ BEGIN
                  p_dest_schema, p_lookup_db, p_lookup_schema, p_connector_name;
     PERFORM synchdb_apply_column_mappings(p_dest_schema, p_connector_name, p_lookup_db, p_lookup_schema);
 
+    -- only tables kept from an earlier run can have secondary indexes, recorded
+    -- after the column mappings so the rebuilt definitions use the new names
+    IF p_defer_index THEN
+        RAISE NOTICE 'Step 7.5: Deferring secondary indexes of "%" until data is loaded', p_dest_schema;
+        FOR r IN
+            SELECT c.oid
+            FROM pg_class c
+            JOIN pg_namespace n ON n.oid = c.relnamespace
+            WHERE n.nspname = p_dest_schema
+              AND c.relkind = 'r'
+        LOOP
+            PERFORM synchdb_defer_secondary_indexes(p_connector_name, r.oid);
+        END LOOP;
+    END IF;
+
+    IF p_parallel THEN
+        -- step 8 onwards is driven by snapshot workers and synchdb_fdw_snapshot_finish_parallel()
+        RAISE NOTICE 'Step 8: Queued % tables for parallel snapshot workers at SCN %',
+                     synchdb_fdw_snapshot_prepare_tables(p_connector_name, p_source_schema,
+                                                         p_stage_schema, p_dest_schema,
+                                                         p_lookup_db::name, p_lookup_schema,
+                                                         v_effective_scn, p_frozen_load),
+                     v_effective_scn;
+        RETURN v_effective_scn;
+    END IF;
+
     RAISE NOTICE 'Step 8: Migrating data with transforms from "%" to "%" (lookup: %.% for connector %)',
                  p_stage_schema, p_dest_schema, p_lookup_db, p_lookup_schema, p_connector_name;
 
@@ -3306,7 +4154,8 @@ BEGIN
 		    p_lookup_schema,
 		    false, 0,
 		    true,
-		    true
+		    true,
+		    p_frozen_load
         );
     ELSE
         -- All-or-nothing (no subtransactions)
@@ -3317,10 +4166,16 @@ BEGIN
 		    p_lookup_db,
 		    p_lookup_schema,
 		    false,
-		    0
+		    0,
+		    p_frozen_load
 	    );
     END IF;
 
+    IF p_defer_index THEN
+        RAISE NOTICE 'Step 8.5: Building deferred indexes on "%"', p_dest_schema;
+        PERFORM synchdb_build_deferred_indexes(p_connector_name);
+    END IF;
+
     RAISE NOTICE 'Step 9: Applying table mappings on destination schema "%" (lookup: %.% for connector %)',
                  p_dest_schema, p_lookup_db, p_lookup_schema, p_connector_name;
     PERFORM synchdb_apply_table_mappings(p_dest_schema, p_connector_name, p_lookup_db, p_lookup_schema);
@@ -3340,7 +4195,7 @@ EXCEPTION
 END;
 $$;
 
-COMMENT ON FUNCTION synchdb_do_initial_snapshot(name, text, name, name, name, text, name, boolean, text, numeric, text, boolean, boolean) IS
+COMMENT ON FUNCTION synchdb_do_initial_snapshot(name, text, name, name, name, text, name, boolean, text, numeric, text, boolean, boolean, boolean, boolean, boolean) IS
    'perform initial snapshot procedure + data transforms using a oracle_fdw server';
 
 CREATE OR REPLACE FUNCTION synchdb_do_schema_sync(